@@ -58,6 +58,8 @@ typedef BYTE IIF;
 #define IIFERR_BAD_ORG       22
 #define IIFERR_BAD_SIZE      23
 #define IIFERR_BAD_MODE      24
+#define IIFERR_NOT_MAPPED    25
+#define IIFERR_NO_COMPRESS   26
 #define IIFERR_NOT_A_VAR     30
 #define IIFERR_RES_VAR       31
 #define IIFERR_VAR_TOO_BIG   32
@@ -65,6 +67,7 @@ typedef BYTE IIF;
 #define IIFWARN_NO_SWAP      40
 #define IIFWARN_OVERWRTN     41
 #define IIFWARN_INITIALIZED  42
+#define IIFWARN_CONVERT      43
 #define IIFWARN_STRING_DATA  50
 #define IIFWARN_BINARY_DATA  51
 
@@ -73,6 +76,12 @@ typedef BYTE IIF;
 #define IIF_FORMAT_IIFF       1
 #define IIF_FORMAT_TIFF       2
 #define IIF_FORMAT_GIF        3
+#define IIF_FORMAT_TILE       4
+
+ /* COMPRESSION METHODS OF IIF_FORMAT_TILE FILES */
+
+#define IIF_COMPRESS_NONE     0
+#define IIF_COMPRESS_ZLIB     1
 
 
 #ifndef  NO_PROTOTYPES
@@ -105,6 +114,18 @@ int     iif_read_line(IIF*, VPTR, int, int, int);
 int     iif_fill(IIF*, int, int, int, int);
 int     iif_setlocale(char*);
 char   *iif_getlocale(VOID);
+int     iif_map(IIF*);
+int     iif_unmap(IIF*);
+VPTR    iif_map_line(IIF*, int, int);
+int     iif_set_tile_size(IIF*, int, int);
+int     iif_get_tile_size(IIF*, int*, int*);
+int     iif_write_tile(IIF*, VPTR, int, int);
+int     iif_read_tile(IIF*, VPTR, int, int);
+int     iif_set_compression(IIF*, int, int);
+int     iif_get_compression(IIF*);
+int     iif_write_image(IIF*, VPTR, int, int, int, int, INT64*, INT64, INT64);
+int     iif_read_image(IIF*, VPTR, int, int, int, int, INT64*, INT64, INT64);
+int     iif_set_async(IIF*, int);
 
 #else
 int     iif_put_var();
@@ -136,6 +157,18 @@ int     iif_read_line();
 int     iif_fill();
 int     iif_setlocale();
 char   *iif_getlocale();
+int     iif_map();
+int     iif_unmap();
+VPTR    iif_map_line();
+int     iif_set_tile_size();
+int     iif_get_tile_size();
+int     iif_write_tile();
+int     iif_read_tile();
+int     iif_set_compression();
+int     iif_get_compression();
+int     iif_write_image();
+int     iif_read_image();
+int     iif_set_async();
 
 #endif
 
@@ -70,6 +70,8 @@
 #define MEM_MODE_WARNING  0x04
 #define MEM_MODE_CONTINUE 0x08
 #define MEM_MODE_MODIFY   0x10
+#define MEM_MODE_FAST     0x20  /* Small blocks from pools, works */
+                                /* without debug/trace/modify     */
 
    /*  Values of parameter mode of mem_block_size/mem_class_size */
 
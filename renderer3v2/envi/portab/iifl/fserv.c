@@ -98,6 +98,7 @@ char  *fl_get_types(IIFL*);
 BOOL   fl_is_correct_ver(IIFL*);
 int    fl_check_file_format(IIFL*);
 int    fl_read_sys_vars(IIFL*);
+INT64  fl_image_size(IIFL*);
 */
 
 /* LOCAL FUNCTIONS PROTOTYPES */
@@ -149,7 +150,8 @@ IIFL  *ifp;                                      /* a pointer to IIF file */
   {
   BYTE *hbuff;                                 /* pointer to header buffer */
   BYTE *tptr;                                   /* auxiliary pointer       */
-  static char buf[1024];   /* a buffer for value - to - string conversions */
+  char buf[1024];          /* a buffer for value - to - string conversions */
+  char *new_ver;                                /* IIF_NewVer value        */
   int  err;                                     /* an error code           */
   int  swap;                                    /* swap field value        */
   int  wrtn;                                    /* amount of written items */
@@ -175,7 +177,7 @@ IIFL  *ifp;                                      /* a pointer to IIF file */
 
     single_write(hbuff + OSFLAG_FIELD_OFFS, tptr, OSFLAG_FIELD_LEN);
 
-    buf[0] = 1;
+    buf[0] = (char)ifp->format;
     single_write(hbuff + FMT_FIELD_OFFS, (BYTE *)buf, FMT_FIELD_LEN);
 
     buf[0] = (char)ifp->cmps_number;
@@ -236,7 +238,12 @@ IIFL  *ifp;                                      /* a pointer to IIF file */
     if ((err = put_sys_var(ifp, IIFVAR_FLOAT_VER, buf)) != IIF_OK)
       return err;
 
-    if ((err = put_sys_var(ifp, IIFVAR_NEW_VER, "1")) != IIF_OK)
+    /* older libraries reject tiled files and packed component types */
+    if (ifp->format == IIF_FORMAT_TILE || strpbrk(ifp->types, "he") != NULL)
+      new_ver = "2";
+    else
+      new_ver = "1";
+    if ((err = put_sys_var(ifp, IIFVAR_NEW_VER, new_ver)) != IIF_OK)
       return err;
 
     if ((err = put_sys_var(ifp, IIFVAR_TYPES, ifp->types)) != IIF_OK)
@@ -255,6 +262,16 @@ IIFL  *ifp;                                      /* a pointer to IIF file */
         return err;
       }
 
+    if (ifp->format == IIF_FORMAT_TILE)
+      {
+      sprintf(buf, "%d,%d", ifp->tile_w, ifp->tile_h);
+      if ((err = put_sys_var(ifp, IIFVAR_TILE_SIZE, buf)) != IIF_OK)
+        return err;
+      if (ifp->compress == IIF_COMPRESS_ZLIB)
+        if ((err = put_sys_var(ifp, IIFVAR_COMPRESS, "zlib")) != IIF_OK)
+          return err;
+      }
+
     if ((err = write_sys_vars(ifp)) != IIF_OK)
       return err;
     }
@@ -348,6 +365,10 @@ IIFL  *ifp;                                      /* a pointer to IIF file */
       ifp->cmps_number = (BYTE) buf[0];
       }
 
+    single_read(hbuff + FMT_FIELD_OFFS, buf, FMT_FIELD_LEN);
+    if (buf[0] == IIF_FORMAT_TILE)
+      ifp->format = IIF_FORMAT_TILE;
+
     single_read(hbuff + XSIZ_FIELD_OFFS, buf, XSIZ_FIELD_LEN);
     ifp->xres = ASCII_to_int((char *)buf);
 
@@ -412,6 +433,25 @@ IIFL  *ifp;                                      /* a pointer to IIF file */
       }
 #endif
     ifp->buffer_size = buff_size;
+
+    if (ifp->format == IIF_FORMAT_TILE)
+      {
+      if ((lst = find_var_name(ifp->syst_var, IIFVAR_TILE_SIZE)) == NULL ||
+          sscanf(lst->value, "%d,%d", &(ifp->tile_w), &(ifp->tile_h)) != 2)
+        return IIFERR_BAD_FILE;
+      if ((lst = find_var_name(ifp->syst_var, IIFVAR_COMPRESS)) == NULL)
+        ifp->compress = IIF_COMPRESS_NONE;
+      else if (strcmp(lst->value, "zlib") == 0)
+#ifdef IIF_HAVE_ZLIB
+        ifp->compress = IIF_COMPRESS_ZLIB;
+#else
+        return IIFERR_NO_COMPRESS;             /* built without zlib   */
+#endif
+      else
+        return IIFERR_BAD_FORMAT;              /* unknown compression  */
+      if ((err = fl_tile_read_index(ifp)) != IIF_OK)
+        return err;
+      }
     }
   return IIF_OK;
   }
@@ -491,6 +531,12 @@ int   number;                /* amount of lines to read.                   */
   if (ifp->format == IIF_FORMAT_TIFF ||
       ifp->format == IIF_FORMAT_GIF)
     return IIFERR_BAD_FORMAT;
+  else if (ifp->format == IIF_FORMAT_TILE)
+    {
+    if ((err = fl_tile_read_lines(ifp, first, number)) != IIF_OK)
+      ifp->error = err;
+    return err;
+    }
   else      /*  for IIF_FORMAT_IIFF  */
     {
     bytes_per_line = (unsigned long)(ifp->buffer_size / ifp->num_of_lines);
@@ -557,8 +603,11 @@ int   number;               /* amount of lines to write                    */
   BYTE  *bufptr;          /* an auxiliary pointer to image data to write   */
 
   if (ifp->format == IIF_FORMAT_TIFF ||
-      ifp->format == IIF_FORMAT_GIF)
+      ifp->format == IIF_FORMAT_GIF  ||
+      ifp->format == IIF_FORMAT_TILE)
     return IIFERR_BAD_FORMAT;
+  else if (ifp->async != NULL)          /* written by background thread */
+    return fl_async_write(ifp, first, number);
   else      /*  for IIF_FORMAT_IIFF  */
     {
     bytes_per_line = (unsigned long)(ifp->buffer_size / ifp->num_of_lines);
@@ -631,13 +680,12 @@ IIFL  *ifp;                         /* a pointer to IIF file */
   INT64   image_size;               /* an image area size                    */
   unsigned int vars_in_header;      /* a size of vars area in header area    */
   INT64  vars_ptr;                  /* current pointer position in a file    */
-  unsigned long bytes_per_line;     /* size of one line in bytes             */
   BOOL   done;                      /* flag; TRUE - if '\0''\0' marker found */
   BYTE type;                        /* type of data stored in 'value'        */
   BYTE nam_len;                     /* length of 'name' string including \0  */
   BYTE tmp;                         /* temporary value                       */
   unsigned short int val_len;       /* length of 'value' area                */
-  VLIST *tmp_ptr, *list;            /* vorking pointers                      */
+  VLIST *tmp_ptr;                   /* a working pointer                     */
   BYTE  *var_ptr;                   /* a pointer to swapped value            */
 
   if (ifp->format == IIF_FORMAT_TIFF ||
@@ -677,9 +725,7 @@ IIFL  *ifp;                         /* a pointer to IIF file */
       else
         if (type == MVM)   /* there are more vars beyond image area */
           {
-          bytes_per_line = 
-            (unsigned long)(ifp->buffer_size / ifp->num_of_lines);
-          image_size = (INT64)bytes_per_line * ifp->yres;
+          image_size = fl_image_size(ifp);
           vars_ptr = image_size + ifp->image_area_offs;
 
           if (os_fseek(ifp->file_handle, vars_ptr, SEEK_SET) != 0)
@@ -745,20 +791,11 @@ IIFL  *ifp;                         /* a pointer to IIF file */
         }
 
       *(tmp_ptr->name + nam_len - 1) = '\0';
-      tmp_ptr->next = NULL;
       tmp_ptr->type = type;
       tmp_ptr->nam_len = nam_len;
       tmp_ptr->val_len = val_len;
 
-      if (ifp->first_var == NULL)
-         ifp->first_var = tmp_ptr;
-      else  /* seek to the end of the list */
-        {
-        list = ifp->first_var;
-        while (list->next != NULL)
-          list = list->next;
-        list->next = tmp_ptr;
-        }
+      fl_add_var(ifp, tmp_ptr);       /* to the end of the list and index */
 
       } /* end of WHILE statement */
     }   /* end of ELSE  statement */
@@ -778,7 +815,6 @@ IIFL  *ifp;                         /* a pointer to IIF file  */
   INT64 image_size;                 /* an image area size                    */
   unsigned int vars_in_header;      /* a size of vars area in header area    */
   INT64  vars_ptr;                  /* current pointer position in a file    */
-  unsigned long bytes_per_line;     /* size of one line in bytes             */
   VLIST *var;                       /* a pointer to  VLIST list              */
   BYTE   marker;                    /* a marker buffer                       */
   BYTE  *var_ptr;                   /* an auxiliary pointer                  */
@@ -808,8 +844,7 @@ IIFL  *ifp;                         /* a pointer to IIF file  */
             vars_in_header)
           {
           vars_in_header = 0;
-          bytes_per_line = (unsigned long)(ifp->buffer_size / ifp->num_of_lines);
-          image_size = (INT64)bytes_per_line * ifp->yres;
+          image_size = fl_image_size(ifp);
           vars_ptr = image_size + (INT64)ifp->image_area_offs;
 
           marker = (BYTE)MVM;
@@ -981,7 +1016,7 @@ IIFL  *ifp;                                       /* a pointer to IIF file */
     {
     if ((new_version = iif_get_var((IIF *)ifp, IIFVAR_NEW_VER)) == NULL)
       return FALSE;
-    if (strcmp(new_version, "1") == 0)
+    if (strcmp(new_version, "1") == 0 || strcmp(new_version, "2") == 0)
       return TRUE;
     else
       return FALSE;
@@ -1112,6 +1147,27 @@ IIFL *ifp;                            /* a pointer to IIF file              */
   return IIF_OK;
   }
 
+/*--------------------------------------------------------------------------
+ * NAME         fl_image_size
+ * PURPOSE      returns size of image area of the file; variables which do
+ *              not fit the header follow this area.
+ * ARGUMENTS    ifp     a pointer to IIF  file.
+ * RETURNS      size of image area in bytes.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+INT64  fl_image_size(ifp)
+IIFL  *ifp;                                       /* a pointer to IIF file */
+  {
+  unsigned long bytes_per_line;               /* size of one line in bytes */
+
+  if (ifp->format == IIF_FORMAT_TILE)         /* the end of tiles is kept  */
+    return ifp->tile_index[2 * ifp->tiles_x * ifp->tiles_y] -
+           ifp->image_area_offs;              /* in the last index entry   */
+
+  bytes_per_line = (unsigned long)(ifp->buffer_size / ifp->num_of_lines);
+  return (INT64)bytes_per_line * ifp->yres;
+  }
+
 /*========================= LOCAL FUNCTIONS ==============================*/
 
 /*--------------------------------------------------------------------------
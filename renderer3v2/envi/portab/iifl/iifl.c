@@ -22,8 +22,20 @@ static char *sccsid =
 
 #define DEFINE_GLOBALS
 
+#ifdef TIPE
+#undef TIPE
+#endif
+
+#if (OS_MARK == 'I')
+#include <windows.h>
+#endif
+
 #include "integra.h"
 
+#if (OS_MARK != 'I')
+#include <pthread.h>
+#endif
+
 /* COMPANY INCLUDES */
 
 #include "iifl.h"
@@ -66,10 +78,17 @@ typedef struct msg_txt
 
 /* STATICS */
 
-static BYTE new_files_format = IIF_FORMAT_IIFF;
-static char err_msg_buff[MAX_ERR_MSG_LEN];
-static int  os_name_locale_initialized = 0; /* flag; 1 if locale were initial.*/
-static char IIF_locale_str_buf[MAX_ENV_STRING_LEN];
+static BYTE new_files_format = IIF_FORMAT_IIFF; /* under fl_lock_global */
+static IIF_THREAD char err_msg_buff[MAX_ERR_MSG_LEN];
+static char IIF_locale_str_buf[MAX_ENV_STRING_LEN]; /* under fl_lock_global */
+static IIF_THREAD char locale_buf[MAX_ENV_STRING_LEN];
+#if (OS_MARK == 'I')
+static INIT_ONCE fl_global_once = INIT_ONCE_STATIC_INIT;
+static CRITICAL_SECTION fl_global_section;
+#else
+static pthread_once_t fl_global_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t fl_global_mutex;
+#endif
 static ERR_TXT errtab[] = {
  {IIF_OK, "No error" },
  {IIFERR_BAD_DISK, "Disk error" },
@@ -88,12 +107,15 @@ static ERR_TXT errtab[] = {
  {IIFERR_BAD_ORG, "Bad image origin or size" },
  {IIFERR_BAD_SIZE, "Bad pixel origin in image line" },
  {IIFERR_BAD_MODE, "Function not allowed in current file access mode" },
+ {IIFERR_NOT_MAPPED, "File is not mapped into memory" },
+ {IIFERR_NO_COMPRESS, "Compression is not supported by the library" },
  {IIFERR_NOT_A_VAR, "Variable not found" },
  {IIFERR_RES_VAR, "Reserved variable name used" },
  {IIFERR_VAR_TOO_BIG, "Size of variable name or value exceeds allowed limit" },
  {IIFWARN_NO_SWAP, "Cannot control byte swapping in current file access mode" },
  {IIFWARN_OVERWRTN, "An existing variable has been overwritten" },
  {IIFWARN_INITIALIZED, "File has been already initialized" },
+ {IIFWARN_CONVERT, "Component data need conversion; read them by lines" },
  {IIFWARN_STRING_DATA, "Variable has assigned string data" },
  {IIFWARN_BINARY_DATA, "Variable has assigned binary data" },
  {0, NULL}};
@@ -124,6 +146,13 @@ VOID    fl_get_comp_name(char*, char*, int);
 int     fl_first_access(IIFL*, int);
 VOID    fl_free_VLIST(VLIST*);
 long    fl_get_comp_offset(IIFL*, int);
+int     fl_user_comp_size(int);
+int     fl_lock_create(IIFL*);
+VOID    fl_lock_destroy(IIFL*);
+VOID    fl_lock(IIFL*);
+VOID    fl_unlock(IIFL*);
+VOID    fl_lock_global(VOID);
+VOID    fl_unlock_global(VOID);
 */
 
 /* LOCAL FUNCTIONS PROTOTYPES */
@@ -143,7 +172,12 @@ static  int    get_num_of_lines(VOID);
 static  int    check_allowed_types(char*);
 static  int    env_atol(char *, long *);
 static  int    env_atoi(char *, int *);
-static  char  *ui_env_get_from(char *, char *);
+static  char  *ui_env_get_from(char *, char *, char *);
+#if (OS_MARK == 'I')
+static  BOOL CALLBACK global_lock_create(PINIT_ONCE, PVOID, PVOID *);
+#else
+static  VOID   global_lock_create(VOID);
+#endif
 
 #else
 
@@ -161,6 +195,11 @@ static  int    check_allowed_types();
 static  int    env_atol();
 static  int    env_atoi();
 static  char  *ui_env_get_from();
+#if (OS_MARK == 'I')
+static  BOOL CALLBACK global_lock_create();
+#else
+static  VOID   global_lock_create();
+#endif
 
 #endif
 
@@ -284,7 +323,9 @@ char  *mode;                    /* a mode in which file should be opened   */
       return NULL;
       }
     ifp->initialized = 0;
+    fl_lock_global();
     ifp->format = new_files_format;
+    fl_unlock_global();
     ifp->swap = TRUE;        /* new files always in UNIX mode! */
     }
   return (IIF *)ifp;
@@ -294,7 +335,8 @@ char  *mode;                    /* a mode in which file should be opened   */
  * NAME         iif_close
  * PURPOSE      closes previously opened image file.
  * ARGUMENTS    ifp    a pointer to IIF file.
- * RETURNS      an error code
+ * RETURNS      an error code; it includes errors of lines written by
+ *              background thread (see iif_set_async).
  * EXTERNS      None
  --------------------------------------------------------------------------*/
 
@@ -316,11 +358,25 @@ IIF *iflp;                      /* a pointer to IIF file */
       if ((res = fl_write_lines(ifp, ifp->first_line, ifp->valid_lines)) !=
            IIF_OK )
         {
+        fl_async_finish(ifp);
         ifp->error = res;
         return res;
         }
       }
 
+    if ((res = fl_async_finish(ifp)) != IIF_OK)   /* wait for the writer */
+      {
+      ifp->error = res;
+      return res;
+      }
+
+    if (ifp->attrib != 'r' && ifp->format == IIF_FORMAT_TILE)
+      if ((res = fl_tile_write_index(ifp)) != IIF_OK)
+        {
+        ifp->error = res;
+        return res;
+        }
+
     if (ifp->attrib != 'r')
       if ((res = fl_finish_var_access(ifp)) != IIF_OK)
         {
@@ -329,6 +385,8 @@ IIF *iflp;                      /* a pointer to IIF file */
         }
     }
 
+  fl_async_finish(ifp);
+  fl_unmap(ifp);
   os_fclose(ifp->file_handle);
   (ifp->marker)[0] = '\0';
   free_IIF_struct(ifp);
@@ -345,6 +403,9 @@ IIF *iflp;                      /* a pointer to IIF file */
  *                    with commas.
  *              types a pointer to buffer with components types.
  * RETURNS      an error code.
+ * NOTE         Types 'h' (half precision) and 'e' (RGBE color) are packed
+ *              in the file; they are read and written as one float and
+ *              three floats per pixel respectively.
  * EXTERNS      None
  --------------------------------------------------------------------------*/
 int  iif_init_file(iflp, xres, yres, cmps, types)
@@ -417,6 +478,8 @@ char  *types;                    /* a pointer to buffer with components   */
 
   if (((res = set_lengths(ifp, types)) != IIF_OK) ||
       ((res = fl_write_header(ifp)) != IIF_OK)       ||
+      (ifp->format == IIF_FORMAT_TILE &&
+       (res = fl_tile_init(ifp)) != IIF_OK)         ||
       ((res = iif_def_components((IIF *)ifp, 0, cmps)) != IIF_OK))
     {
     free(ifp->cmps);
@@ -690,7 +753,7 @@ int  *y;               /* a pointer to variable that will be set to amount */
 /*--------------------------------------------------------------------------
  * NAME         iif_get_size
  * PURPOSE      function retrieves amount of components per pixel and lengths
- *              of each component.
+ *              of each component (in the file, see fl_user_comp_size).
  * ARGUMENTS    ifp          a pointer to IIF file.
  *              n_bytes      a pointer to BYTE pointer that will be set to
  *                           address of buffer with component lengths.
@@ -764,8 +827,8 @@ IIF  *iflp;                                /* a pointer to opened IIF file */
 /*--------------------------------------------------------------------------
  * NAME         iif_set_format
  * PURPOSE      function sets one of allowed formats, i.e. IIF_FORMAT_IIFF,
- *              IIF_FORMAT_TIFF, IIF_FORMAT_GIF for all subsequent created
- *              files.
+ *              IIF_FORMAT_TIFF, IIF_FORMAT_GIF, IIF_FORMAT_TILE for all
+ *              subsequent files created by all threads.
  * ARGUMENTS    format       required format.
  * RETURNS      error code.
  * EXTERNS      None
@@ -775,13 +838,16 @@ int   format;               /* an output format for all new created files */
   {
   if (format != IIF_FORMAT_IIFF &&
       format != IIF_FORMAT_TIFF &&
-      format != IIF_FORMAT_GIF)
+      format != IIF_FORMAT_GIF  &&
+      format != IIF_FORMAT_TILE)
     {
     IIF_errno = IIFERR_BAD_FORMAT;
     return IIFERR_BAD_FORMAT;
     }
 
+  fl_lock_global();
   new_files_format = (BYTE)format;
+  fl_unlock_global();
   return IIF_OK;
   }
 
@@ -1017,7 +1083,8 @@ BYTE *swap;    /* a pointer to variable which will be set to proper value */
 
 /* --------------------------------------------------------------------------
  * NAME         iif_error
- * PURPOSE      retrieves error flag for given file, or IIF_errno value;
+ * PURPOSE      retrieves error flag for given file, or IIF_errno value
+ *              of the calling thread;
  * ARGUMENTS    ifp     a pointer to IIF file.
  * RETURNS      an error code
  * EXTERNS      None
@@ -1039,7 +1106,8 @@ IIF  *iflp;                                       /* a pointer to IIF file */
 
 /* --------------------------------------------------------------------------
  * NAME         iif_clrerror
- * PURPOSE      clears error flag for given file, or IIF_errno value;
+ * PURPOSE      clears error flag for given file, or IIF_errno value
+ *              of the calling thread;
  * ARGUMENTS    iflp     a pointer to IIF file.
  * RETURNS      an error code
  * EXTERNS      None
@@ -1088,11 +1156,10 @@ IIF  *iflp;                                    /*  a pointer to IIF file */
       return NULL;
     err = ifp->error;
     }
-  if ((messg = find_messg_err(err)) == NULL)    /* this should never happen */
-    sprintf(err_msg_buff, "%s #%d ", "UNKNOWN Error: ", err);
-  else
-    strcpy(err_msg_buff, messg);
-  return err_msg_buff;
+  if ((messg = find_messg_err(err)) != NULL)
+    return messg;
+  sprintf(err_msg_buff, "%s #%d ", "UNKNOWN Error: ", err);  /* should never */
+  return err_msg_buff;                                    /* happen         */
   }
 
 /* --------------------------------------------------------------------------
@@ -1106,6 +1173,8 @@ IIF  *iflp;                                    /*  a pointer to IIF file */
  * ARGUMENTS    new_settings     a pointer to buffer with string that
  *                               describes new values for locale
  * RETURNS      an error code
+ * NOTE         The locale is common for all threads; it should be set
+ *              before other threads start to use the library.
  * EXTERNS      None
 --------------------------------------------------------------------------*/
 int iif_setlocale(new_settings)
@@ -1117,41 +1186,41 @@ char* new_settings;               /* a pointer to buffer with string that */
     int  loc_fp_format;                           /* floating poin format */
     char loc_os_name[20];                         /* OS name              */
     char tmpbuf[MAX_ENV_STRING_LEN + 1];          /* a temporary buffer   */  
+    char field[MAX_ENV_STRING_LEN + 1];           /* an extracted field   */
     char *v;                      /* a pointer to buffer with field value */
 
   if (new_settings == NULL)
     return IIFERR_BAD_PARMS;
 
-  if ((v = ui_env_get_from(new_settings, OS_NAME_FIELD)) == NULL)
+  if ((v = ui_env_get_from(new_settings, OS_NAME_FIELD, field)) == NULL)
     return IIFERR_BAD_PARMS;
   else
     strcpy(loc_os_name, v);
 
-  if ((v = ui_env_get_from(new_settings, OS_MARK_FIELD)) == NULL)
+  if ((v = ui_env_get_from(new_settings, OS_MARK_FIELD, field)) == NULL)
     return IIFERR_BAD_PARMS;
   else
     loc_os_mark = (BYTE)(*v);
 
-  v = ui_env_get_from(new_settings, OS_BYTE_ORDER_FIELD);
+  v = ui_env_get_from(new_settings, OS_BYTE_ORDER_FIELD, field);
 
   if (v == NULL || env_atoi(v, &loc_byte_order))
     return IIFERR_BAD_PARMS;
 
-  v = ui_env_get_from(new_settings, OS_FP_FORMAT_FIELD);
+  v = ui_env_get_from(new_settings, OS_FP_FORMAT_FIELD, field);
 
   if (v == NULL || env_atoi(v, &loc_fp_format))
     return IIFERR_BAD_PARMS;
 
                /* set IIFL locale to retrieved values */
+  strcpy(tmpbuf, new_settings);
+  fl_lock_global();
   strcpy(IIF_os_name, loc_os_name);
   IIF_os_fp_format = (BYTE)loc_fp_format;
   IIF_os_byte_order = (BYTE)loc_byte_order;
   IIF_os_mark = loc_os_mark;
-
-  if (os_name_locale_initialized == 0)
-      os_name_locale_initialized = 1;
-  strcpy(tmpbuf, new_settings);
   strcpy(IIF_locale_str_buf, tmpbuf);
+  fl_unlock_global();
   return IIF_OK;
   }
 
@@ -1164,43 +1233,38 @@ char* new_settings;               /* a pointer to buffer with string that */
  *              IIF_os_fp_format
  *
  * ARGUMENTS    none
- * RETURNS      a pointer to valid string
+ * RETURNS      a pointer to valid string in the buffer of the calling
+ *              thread
  * EXTERNS      None
 --------------------------------------------------------------------------*/
 char *iif_getlocale()
   {
   char buffer[20];
 
-  if (os_name_locale_initialized == 0)     /* in first action of IIFL, locale */
-    {                                      /* IIF_os_name is initialized      */
-    strcpy(IIF_os_name, OS_NAME);
-    IIF_locale_str_buf[0] = '\0';
-    os_name_locale_initialized = 1;
-    }
-
+  fl_lock_global();
   if (IIF_locale_str_buf[0] != '\0')  /* after valid call to iif_setlocale,  */
-    return IIF_locale_str_buf;        /* this buffer already contains proper */
-  else                                    /* string                              */
-    {
-    strcpy(IIF_locale_str_buf, OS_NAME_FIELD);
-    strcat(IIF_locale_str_buf, ENV_DEF_FIELD);
-    strcat(IIF_locale_str_buf, IIF_os_name);
-    strcat(IIF_locale_str_buf, ENV_SEP_FIELD);
-    strcat(IIF_locale_str_buf, OS_MARK_FIELD);
-    strcat(IIF_locale_str_buf, ENV_DEF_FIELD);
+    strcpy(locale_buf, IIF_locale_str_buf);  /* it contains proper string */
+  else
+    {                          /* built in the buffer of the calling thread */
+    strcpy(locale_buf, OS_NAME_FIELD);
+    strcat(locale_buf, ENV_DEF_FIELD);
+    strcat(locale_buf, IIF_os_name);
+    strcat(locale_buf, ENV_SEP_FIELD);
+    strcat(locale_buf, OS_MARK_FIELD);
+    strcat(locale_buf, ENV_DEF_FIELD);
     buffer[0] = IIF_os_mark;
     buffer[1] = '\0';
-    strcat(IIF_locale_str_buf, buffer);
-    strcat(IIF_locale_str_buf, ENV_SEP_FIELD);
-    strcat(IIF_locale_str_buf, OS_BYTE_ORDER_FIELD);
+    strcat(locale_buf, buffer);
+    strcat(locale_buf, ENV_SEP_FIELD);
+    strcat(locale_buf, OS_BYTE_ORDER_FIELD);
     sprintf(buffer, ":%d,", (int)IIF_os_byte_order);
-    strcat(IIF_locale_str_buf, buffer);
-    strcat(IIF_locale_str_buf, OS_FP_FORMAT_FIELD);
+    strcat(locale_buf, buffer);
+    strcat(locale_buf, OS_FP_FORMAT_FIELD);
     sprintf(buffer, ":%d", (int)IIF_os_fp_format);
-    strcat(IIF_locale_str_buf, buffer);
-
-    return IIF_locale_str_buf;
+    strcat(locale_buf, buffer);
     }
+  fl_unlock_global();
+  return locale_buf;
   }
 
 /* --------------------------------------------------------------------------
@@ -1368,8 +1432,182 @@ int   num;                 /* an order number of component in a scan-line */
   return offs;
   }
 
+/*--------------------------------------------------------------------------
+ * NAME         fl_user_comp_size
+ * PURPOSE      returns size (in bytes) of one value of component in user's
+ *              buffer; it differs from the size in the file for packed
+ *              types: 'h' (half) is read and written as float, 'e' (RGBE)
+ *              as three floats (red, green, blue).
+ * ARGUMENTS    type           a type of component.
+ * RETURNS      size of the value in user's buffer.
+ * EXTERNS      None
+--------------------------------------------------------------------------*/
+int  fl_user_comp_size(type)
+int   type;                /* a type of component                         */
+  {
+  char types[2];           /* type as a string of types                   */
+
+  if (type == 'h')
+    return sizeof(float);
+  else if (type == 'e')
+    return 3 * sizeof(float);
+
+  types[0] = (char)type;
+  types[1] = '\0';
+  return get_comp_size(types, 0);
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_lock_create
+ * PURPOSE      creates lock of IIF structure, which serializes access to
+ *              the lines buffer of the file shared by several threads.
+ * ARGUMENTS    ifp            a pointer to IIF structure.
+ * RETURNS      an error code.
+ * EXTERNS      None
+--------------------------------------------------------------------------*/
+int  fl_lock_create(ifp)
+IIFL  *ifp;                /* a pointer to IIF structure                  */
+  {
+#if (OS_MARK == 'I')
+  CRITICAL_SECTION  *lock;            /* the lock                         */
+
+  if ((lock = (CRITICAL_SECTION *)malloc(sizeof(CRITICAL_SECTION))) == NULL)
+    return IIFERR_NO_MEM;
+  InitializeCriticalSection(lock);
+#else
+  pthread_mutex_t  *lock;             /* the lock                         */
+
+  if ((lock = (pthread_mutex_t *)malloc(sizeof(pthread_mutex_t))) == NULL)
+    return IIFERR_NO_MEM;
+  if (pthread_mutex_init(lock, NULL) != 0)
+    {
+    free(lock);
+    return IIFERR_NO_MEM;
+    }
+#endif
+  ifp->lock = (VPTR)lock;
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_lock_destroy
+ * PURPOSE      destroys lock of IIF structure.
+ * ARGUMENTS    ifp            a pointer to IIF structure.
+ * RETURNS      None
+ * EXTERNS      None
+--------------------------------------------------------------------------*/
+VOID  fl_lock_destroy(ifp)
+IIFL  *ifp;                /* a pointer to IIF structure                  */
+  {
+  if (ifp->lock == NULL)
+    return;
+#if (OS_MARK == 'I')
+  DeleteCriticalSection((CRITICAL_SECTION *)ifp->lock);
+#else
+  pthread_mutex_destroy((pthread_mutex_t *)ifp->lock);
+#endif
+  free(ifp->lock);
+  ifp->lock = NULL;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_lock
+ * PURPOSE      locks IIF structure; waits while other thread keeps it.
+ * ARGUMENTS    ifp            a pointer to IIF structure.
+ * RETURNS      None
+ * EXTERNS      None
+--------------------------------------------------------------------------*/
+VOID  fl_lock(ifp)
+IIFL  *ifp;                /* a pointer to IIF structure                  */
+  {
+#if (OS_MARK == 'I')
+  EnterCriticalSection((CRITICAL_SECTION *)ifp->lock);
+#else
+  pthread_mutex_lock((pthread_mutex_t *)ifp->lock);
+#endif
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_unlock
+ * PURPOSE      unlocks IIF structure.
+ * ARGUMENTS    ifp            a pointer to IIF structure.
+ * RETURNS      None
+ * EXTERNS      None
+--------------------------------------------------------------------------*/
+VOID  fl_unlock(ifp)
+IIFL  *ifp;                /* a pointer to IIF structure                  */
+  {
+#if (OS_MARK == 'I')
+  LeaveCriticalSection((CRITICAL_SECTION *)ifp->lock);
+#else
+  pthread_mutex_unlock((pthread_mutex_t *)ifp->lock);
+#endif
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_lock_global
+ * PURPOSE      locks the library data common for all files (format of new
+ *              files, locale); waits while other thread keeps it.
+ * ARGUMENTS    None
+ * RETURNS      None
+ * EXTERNS      None
+ * NOTE         The lock is created by the first call and is never
+ *              destroyed.
+--------------------------------------------------------------------------*/
+VOID  fl_lock_global()
+  {
+#if (OS_MARK == 'I')
+  InitOnceExecuteOnce(&fl_global_once, global_lock_create, NULL, NULL);
+  EnterCriticalSection(&fl_global_section);
+#else
+  pthread_once(&fl_global_once, global_lock_create);
+  pthread_mutex_lock(&fl_global_mutex);
+#endif
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_unlock_global
+ * PURPOSE      unlocks the library data common for all files.
+ * ARGUMENTS    None
+ * RETURNS      None
+ * EXTERNS      None
+--------------------------------------------------------------------------*/
+VOID  fl_unlock_global()
+  {
+#if (OS_MARK == 'I')
+  LeaveCriticalSection(&fl_global_section);
+#else
+  pthread_mutex_unlock(&fl_global_mutex);
+#endif
+  }
+
 /*========================= LOCAL FUNCTIONS ==============================*/
 
+/* --------------------------------------------------------------------------
+ * NAME         global_lock_create
+ * PURPOSE      creates the lock of the library data common for all files
+ *              (called once).
+ * ARGUMENTS    None (Windows: arguments of InitOnceExecuteOnce callback,
+ *              not used)
+ * RETURNS      None (Windows: TRUE)
+ * EXTERNS      None
+--------------------------------------------------------------------------*/
+#if (OS_MARK == 'I')
+static BOOL CALLBACK global_lock_create(once, param, context)
+PINIT_ONCE once;
+PVOID param;
+PVOID *context;
+  {
+  InitializeCriticalSection(&fl_global_section);
+  return TRUE;
+  }
+#else
+static VOID global_lock_create()
+  {
+  pthread_mutex_init(&fl_global_mutex, NULL);
+  }
+#endif
+
 /* --------------------------------------------------------------------------
  * NAME         alloc_IIF_struct
  * PURPOSE      allocates IIF structure and initializes part of it's fields.
@@ -1382,16 +1620,15 @@ static IIFL *alloc_IIF_struct()
   {
   IIFL *ifp;                               /* a pointer to the structure */
 
-  if (os_name_locale_initialized == 0)     /* in first action of IIFL, locale */
-    {                                      /* IIF_os_name is initialized      */
-    strcpy(IIF_os_name, OS_NAME);
-    IIF_locale_str_buf[0] = '\0';
-    os_name_locale_initialized = 1;
-    }
-
   if ((ifp = (IIFL *)malloc(sizeof(IIFL))) == NULL)
     return NULL;
 
+  if (fl_lock_create(ifp) != IIF_OK)
+    {
+    free(ifp);
+    return NULL;
+    }
+
   ifp->buffer = NULL;
   ifp->cmps   = NULL;
   ifp->types  = NULL;
@@ -1405,6 +1642,10 @@ static IIFL *alloc_IIF_struct()
   ifp->syst_var = NULL;
   ifp->first_var = NULL;
   ifp->curr_var = NULL;
+  ifp->last_var = NULL;
+  ifp->var_hash = NULL;
+  ifp->hash_size = 0;
+  ifp->vars_amount = 0;
   ifp->filename = NULL;
   ifp->changed_lines = NULL;
   ifp->error = IIF_OK;
@@ -1417,6 +1658,18 @@ static IIFL *alloc_IIF_struct()
   ifp->valid_lines = 0;
   ifp->vars_offset = 0;
   ifp->enable_swap = TRUE;
+  ifp->map_base = NULL;
+  ifp->map_handle = NULL;
+  ifp->map_size = 0;
+  ifp->tile_w = IIF_DEF_TILE_SIZE;
+  ifp->tile_h = IIF_DEF_TILE_SIZE;
+  ifp->tiles_x = 0;
+  ifp->tiles_y = 0;
+  ifp->tile_bytes = 0;
+  ifp->tile_index = NULL;
+  ifp->compress = IIF_COMPRESS_NONE;
+  ifp->comp_level = 0;
+  ifp->async = NULL;
   strcpy(ifp->marker, "IFS");
   fl_default_header_sizes(ifp);
   return ifp;
@@ -1462,6 +1715,10 @@ IIFL *ifp;                                /* a pointer to the structure */
     fl_free_VLIST(ifp->syst_var);
   if (ifp->first_var != NULL)
     fl_free_VLIST(ifp->first_var);
+  fl_free_var_hash(ifp);
+  if (ifp->tile_index != NULL)
+    free(ifp->tile_index);
+  fl_lock_destroy(ifp);
   free(ifp);
   }
 
@@ -1643,6 +1900,10 @@ int   num;                   /* a number of component                     */
     return sizeof(float);
   else if (type == 'd')
     return sizeof(double);
+  else if (type == 'h')
+    return 2;                                 /* IEEE 754 half precision */
+  else if (type == 'e')
+    return 4;                                 /* RGB with shared exponent */
 
 #ifdef DEBUG
   printf(" MODULE: iifl.c FUNC.: get_comp_size; Unknown component type!\n");
@@ -1741,6 +2002,8 @@ static int  get_num_of_lines()
  *              b - byte
  *              f - float
  *              d - double
+ *              h - half precision float
+ *              e - RGB with shared exponent (Ward's RGBE)
  *              Function returns immediately if any component don't match
  * ARGUMENTS    types     a pointer to buffer witch types to check
  * RETURNS      an error code
@@ -1756,7 +2019,8 @@ char  *types;     /* a character buffer with types of components to check */
   for (n = 0; n < len; n++)
     {
     if (types[n] != 'a' && types[n] != 'b' && types[n] != 'd' &&
-        types[n] != 'f' && types[n] != 'l' && types[n] != 's')
+        types[n] != 'f' && types[n] != 'l' && types[n] != 's' &&
+        types[n] != 'h' && types[n] != 'e')
       return IIFERR_BAD_COMPS;
     }
   return IIF_OK;
@@ -1848,17 +2112,17 @@ int *val;
  * PURPOSE      extracts option from environment string
  * ARGUMENTS    env  - pointer to environment string
  *              name - name of option from given environment string
+ *              field_buf - a buffer for extracted string
  * RETURNS      NULL of pointer to buffer with extracted string.
  * EXTERNS      None
 --------------------------------------------------------------------------*/
-static char *ui_env_get_from(env, name)
+static char *ui_env_get_from(env, name, field_buf)
 char *env;
 char *name;
+char *field_buf;      /* a place for extracted string, MAX_ENV_STRING_LEN+1 */
   {
   char *ee;  /* current position in 'env' string  */
   char *nn;  /* current position in 'name' string */
-  static char field_buf[MAX_ENV_STRING_LEN + 1];
-                                            /* a place for extracted string */
 
 #ifdef DEBUG
   printf("GETTING \"%s\" FROM \"%s\"\n", name, env);
@@ -1899,7 +2163,8 @@ char *name;
 
       /* copy characters starting from 'ee' to 'buf' */
       b = field_buf;
-      while (*ee != ENV_SEP && *ee != '\0')
+      while (*ee != ENV_SEP && *ee != '\0' &&
+             b < field_buf + MAX_ENV_STRING_LEN)
         *b++ = *ee++;
 
       /* mark end of string in 'buf' */
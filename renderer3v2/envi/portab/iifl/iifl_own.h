@@ -32,6 +32,7 @@ typedef struct vars_list
   unsigned short int   val_len;
   BYTE                 type;
   struct vars_list    *next;
+  struct vars_list    *hash_next;
   }VLIST;
 
 /* TYPE DEFINITION OF IIF STRUCTURE: */
@@ -71,6 +72,10 @@ typedef struct iifstr
   VLIST   *syst_var;
   VLIST   *first_var;
   VLIST   *curr_var;
+  VLIST   *last_var;
+  VLIST  **var_hash;
+  unsigned int  hash_size;
+  unsigned int  vars_amount;
   long    vars_offset;
   BOOL    new_header_sizes;
   long    lcmp_field_offs;
@@ -80,6 +85,19 @@ typedef struct iifstr
   long    image_area_offs;
   long    cmnt_field_len;
   long    iiff_header_size;
+  BYTE   *map_base;
+  VPTR    map_handle;
+  INT64   map_size;
+  int     tile_w;
+  int     tile_h;
+  int     tiles_x;
+  int     tiles_y;
+  long    tile_bytes;
+  INT64  *tile_index;
+  int     compress;
+  int     comp_level;
+  VPTR    async;
+  VPTR    lock;
   }IIFL;
 
 /* MARKERS FOR USER VARS AREA */
@@ -93,6 +111,11 @@ typedef struct iifstr
 #define LINE_NOT_CHANGED    0
 #define LINE_CHANGED        1
 
+/* TILES OF IIF_FORMAT_TILE FILES */
+
+#define IIF_DEF_TILE_SIZE  64   /* default width and height of tile           */
+#define TILE_INDEX_ENTRY   16   /* size of tile index entry: offset, length   */
+
  /* variables in IIFL file */
 #define IIFVAR_TYPES       "IIF_Types"
 #define IIFVAR_FLOAT_VER   "IIF_FloatVer"
@@ -100,10 +123,21 @@ typedef struct iifstr
 #define IIFVAR_SYST_VER    "IIF_SystVer"
 #define IIFVAR_NEW_XRES    "IIF_NewXRes"
 #define IIFVAR_NEW_YRES    "IIF_NewYRes"
+#define IIFVAR_TILE_SIZE   "IIF_TileSize"
+#define IIFVAR_COMPRESS    "IIF_Compress"
+
+     /* THREAD LOCAL STORAGE */
+
+#if (OS_MARK == 'I')
+#define  IIF_THREAD  __declspec(thread)
+#else
+#define  IIF_THREAD  __thread
+#endif
 
      /* GLOBAL VARIABLES  */
 
-GLOBAL int IIF_errno
+          /* an error not related to any file; separate in every thread */
+GLOBAL IIF_THREAD int IIF_errno
 #ifdef INITIALIZE
             = IIF_OK
 #endif
@@ -125,7 +159,11 @@ GLOBAL BYTE IIF_os_fp_format
 #endif
              ;
 
-GLOBAL char IIF_os_name[20];
+GLOBAL char IIF_os_name[20]
+#ifdef INITIALIZE
+            = OS_NAME
+#endif
+             ;
 
 
       /* FLOATING POINT FORMAT ERROR CODE */
@@ -136,6 +174,9 @@ GLOBAL char IIF_os_name[20];
            /* var_serv.c */
 BOOL    fl_check_registered_names(char*);
 VLIST  *find_var_name(VLIST*, char*);
+VOID    fl_add_var(IIFL*, VLIST*);
+VLIST  *fl_find_var(IIFL*, char*);
+VOID    fl_free_var_hash(IIFL*);
 
            /* iifl.c */
 int     fl_check_iifstr_ptr(IIFL*);
@@ -144,6 +185,13 @@ VOID    fl_get_comp_name(char*, char*, int);
 int     fl_first_access(IIFL*, int);
 VOID    fl_free_VLIST(VLIST*);
 long    fl_get_comp_offset(IIFL*, int);
+int     fl_user_comp_size(int);
+int     fl_lock_create(IIFL*);
+VOID    fl_lock_destroy(IIFL*);
+VOID    fl_lock(IIFL*);
+VOID    fl_unlock(IIFL*);
+VOID    fl_lock_global(VOID);
+VOID    fl_unlock_global(VOID);
 
            /* fserv.c */
 int     fl_write_header(IIFL*);
@@ -160,12 +208,41 @@ char   *fl_get_types(IIFL*);
 BOOL    fl_is_correct_ver(IIFL*);
 int     fl_check_file_format(IIFL*);
 int     fl_read_sys_vars(IIFL*);
+INT64   fl_image_size(IIFL*);
 
            /* img_buf.c */
+BOOL    fl_swap_needed(IIFL*);
+VOID    fl_swap_area(BYTE*, int, int);
+VOID    fl_narrow_values(BYTE*, BYTE*, int, int, BOOL);
+VOID    fl_widen_values(BYTE*, BYTE*, int, int, BOOL);
+
+           /* img_map.c */
+BYTE   *fl_map_line(IIFL*, int);
+VOID    fl_unmap(IIFL*);
+
+           /* img_tile.c */
+int     fl_tile_init(IIFL*);
+long    fl_tile_index_size(IIFL*);
+int     fl_tile_read_index(IIFL*);
+int     fl_tile_write_index(IIFL*);
+int     fl_tile_read_lines(IIFL*, int, int);
+int     fl_file_io(IIFL*, BYTE*, long, INT64, int);
+
+           /* img_async.c */
+int     fl_async_write(IIFL*, int, int);
+int     fl_async_finish(IIFL*);
+
+           /* img_comp.c */
+long    fl_comp_bound(IIFL*);
+int     fl_comp_pack(IIFL*, BYTE*, BYTE*, long*);
+int     fl_comp_unpack(IIFL*, BYTE*, long, BYTE*);
 
 #else
            /* var_serv.c */
 BOOL    fl_check_registered_names();
+VOID    fl_add_var();
+VLIST  *fl_find_var();
+VOID    fl_free_var_hash();
 
            /* iifl.c */
 int     fl_check_iifstr_ptr();
@@ -174,6 +251,13 @@ VOID    fl_get_comp_name();
 int     fl_first_access();
 VOID    fl_free_VLIST();
 long    fl_get_comp_offset();
+int     fl_user_comp_size();
+int     fl_lock_create();
+VOID    fl_lock_destroy();
+VOID    fl_lock();
+VOID    fl_unlock();
+VOID    fl_lock_global();
+VOID    fl_unlock_global();
 
            /* fserv.c */
 int     fl_write_header();
@@ -190,8 +274,34 @@ char   *fl_get_types();
 BOOL    fl_is_correct_ver();
 int     fl_check_file_format();
 int     fl_read_sys_vars();
+INT64   fl_image_size();
 
            /* img_buf.c */
+BOOL    fl_swap_needed();
+VOID    fl_swap_area();
+VOID    fl_narrow_values();
+VOID    fl_widen_values();
+
+           /* img_map.c */
+BYTE   *fl_map_line();
+VOID    fl_unmap();
+
+           /* img_tile.c */
+int     fl_tile_init();
+long    fl_tile_index_size();
+int     fl_tile_read_index();
+int     fl_tile_write_index();
+int     fl_tile_read_lines();
+int     fl_file_io();
+
+           /* img_async.c */
+int     fl_async_write();
+int     fl_async_finish();
+
+           /* img_comp.c */
+long    fl_comp_bound();
+int     fl_comp_pack();
+int     fl_comp_unpack();
 
 #endif
 
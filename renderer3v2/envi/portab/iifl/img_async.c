@@ -0,0 +1,529 @@
+/*
+ * MODULE NAME  IMG_ASYNC.C
+ * PURPOSE      writing of lines buffer by background thread (write-behind)
+ *              for IIF files opened for writing.
+ *
+ * CODING                                             2026.10.18
+ * LAST UPDATED
+ *
+ * NOTE         When the window of the lines buffer moves, its changed lines
+ *              are copied to one of 'depth' spare buffers and the writer
+ *              thread stores them to the file by positional i/o; the
+ *              calling thread waits only if all spare buffers are busy.
+ *              The buffers are written in the order of handing over, so
+ *              the line written twice gets its last values. An error of
+ *              the writer is reported by the next hand-over and by
+ *              iif_close(), which waits for the end of writing.
+ */
+
+/* CONDITIONAL COMPILATION SWITCHES */
+
+#define TEST  0  /* testing   switch */
+
+#ifdef TIPE
+#undef TIPE
+#endif
+
+#if (OS_MARK == 'I')
+#include <windows.h>
+#endif
+
+#include "integra.h"
+
+#if (OS_MARK != 'I')
+#include <pthread.h>
+#endif
+
+/* COMPANY INCLUDES */
+
+#include "iifl.h"
+
+/* PROGRAM INCLUDES */
+
+#include "iifl_own.h"
+
+/* CONSTANTS */
+
+#define  MAX_ASYNC_DEPTH   8       /* maximal amount of spare buffers      */
+
+/* TYPES     */
+
+typedef struct                     /* lines handed over to the writer      */
+  {
+  BYTE  *buffer;                   /* copy of the lines                    */
+  BYTE  *changed;                  /* markers of changed lines             */
+  long   size;                     /* size of allocated buffer (bytes)     */
+  int    lines;                    /* size of allocated markers            */
+  int    first;                    /* first line of the copy               */
+  int    number;                   /* amount of lines in the copy          */
+  }ASYNC_SLOT;
+
+typedef struct                     /* state of write-behind                */
+  {
+  IIFL        *ifp;                /* a pointer to IIF file                */
+  ASYNC_SLOT   slots[MAX_ASYNC_DEPTH];   /* spare buffers                  */
+  int          depth;              /* amount of spare buffers              */
+  int          head;               /* next slot to be written              */
+  int          count;              /* amount of slots waiting for writing  */
+  int          err;                /* the first error of the writer        */
+  BOOL         stop;               /* TRUE - writer should finish          */
+  BOOL         started;            /* TRUE - writer thread is running      */
+#if (OS_MARK == 'I')
+  CRITICAL_SECTION    lock;        /* protects the fields above            */
+  CONDITION_VARIABLE  ready;       /* a slot is handed over or stop        */
+  CONDITION_VARIABLE  done;        /* a slot is written                    */
+  HANDLE              thread;      /* writer thread                        */
+#else
+  pthread_mutex_t     lock;        /* protects the fields above            */
+  pthread_cond_t      ready;       /* a slot is handed over or stop        */
+  pthread_cond_t      done;        /* a slot is written                    */
+  pthread_t           thread;      /* writer thread                        */
+#endif
+  }ASYNC;
+
+/* MACROS    */
+
+#if (OS_MARK == 'I')
+#define  LOCK(as)         EnterCriticalSection(&(as)->lock)
+#define  UNLOCK(as)       LeaveCriticalSection(&(as)->lock)
+#define  WAIT(as, cond)   SleepConditionVariableCS(&(as)->cond, &(as)->lock, \
+                                                   INFINITE)
+#define  SIGNAL(as, cond) WakeConditionVariable(&(as)->cond)
+#else
+#define  LOCK(as)         pthread_mutex_lock(&(as)->lock)
+#define  UNLOCK(as)       pthread_mutex_unlock(&(as)->lock)
+#define  WAIT(as, cond)   pthread_cond_wait(&(as)->cond, &(as)->lock)
+#define  SIGNAL(as, cond) pthread_cond_signal(&(as)->cond)
+#endif
+
+/* STATICS   */
+
+/* INTERFACE FUNCTIONS PROTOTYPES :
+
+int   iif_set_async(IIF*, int);
+*/
+
+/* LOCAL FUNCTIONS PROTOTYPES */
+
+#ifndef NO_PROTOTYPES
+
+static   ASYNC *create_async(IIFL*, int);
+static   int   start_writer(ASYNC*);
+static   VOID  writer_loop(ASYNC*);
+#if (OS_MARK == 'I')
+static   DWORD WINAPI writer_thread(LPVOID);
+#else
+static   void *writer_thread(void*);
+#endif
+static   int   write_slot(IIFL*, ASYNC_SLOT*);
+static   int   fill_slot(IIFL*, ASYNC_SLOT*, int, int);
+
+#else
+
+static   ASYNC *create_async();
+static   int   start_writer();
+static   VOID  writer_loop();
+#if (OS_MARK == 'I')
+static   DWORD WINAPI writer_thread();
+#else
+static   void *writer_thread();
+#endif
+static   int   write_slot();
+static   int   fill_slot();
+
+#endif
+
+/*************************** CODE ******************************/
+
+/*==================== PUBLIC FUNCTIONS =============================*/
+
+/* --------------------------------------------------------------------------
+ * NAME         iif_set_async
+ * PURPOSE      switches writing of image lines by background thread on or
+ *              off for IIF file opened for writing.
+ * ARGUMENTS    iflp         a pointer to IIF file opened for writing
+ *              depth        amount of windows of the lines buffer which may
+ *                           wait for writing (2 - double buffering, 3 -
+ *                           triple buffering ...); 0 - lines are written
+ *                           by the calling thread
+ * RETURNS      an error code; switching off returns the error of the lines
+ *              written before (if any).
+ * NOTE         Only IIF_FORMAT_IIFF files are written in background.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  iif_set_async(iflp, depth)
+IIF  *iflp;                                    /* a pointer to IIF file    */
+int   depth;                                   /* amount of spare buffers  */
+  {
+  int    err;                                             /* an error code */
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if (fl_check_iifstr_ptr(ifp) != IIF_OK)
+    {
+    IIF_errno = IIFERR_BAD_PTR;
+    return IIFERR_BAD_PTR;
+    }
+
+  if (ifp->attrib != 'w')
+    {
+    ifp->error = IIFERR_BAD_MODE;
+    return IIFERR_BAD_MODE;
+    }
+
+  if (ifp->format != IIF_FORMAT_IIFF)
+    {
+    ifp->error = IIFERR_BAD_FORMAT;
+    return IIFERR_BAD_FORMAT;
+    }
+
+  if (depth < 0 || depth > MAX_ASYNC_DEPTH)
+    {
+    ifp->error = IIFERR_BAD_PARMS;
+    return IIFERR_BAD_PARMS;
+    }
+
+  if (ifp->async != NULL && ((ASYNC *)ifp->async)->depth == depth)
+    return IIF_OK;
+
+  if ((err = fl_async_finish(ifp)) != IIF_OK)
+    {
+    ifp->error = err;
+    return err;
+    }
+
+  if (depth == 0)
+    return IIF_OK;
+
+  if ((ifp->async = (VPTR)create_async(ifp, depth)) == NULL)
+    {
+    ifp->error = IIFERR_NO_MEM;
+    return IIFERR_NO_MEM;
+    }
+  return IIF_OK;
+  }
+
+/*==================== INTERFACE FUNCTIONS =============================*/
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_async_write
+ * PURPOSE      hands changed lines of the lines buffer over to the writer
+ *              thread; called by fl_write_lines() in background mode.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              first        first line to be written
+ *              number       amount of lines to be written
+ * RETURNS      an error code; it may be the error of lines handed over
+ *              before.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  fl_async_write(ifp, first, number)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+int    first;                                  /* first line to be written */
+int    number;                                 /* amount of lines          */
+  {
+  ASYNC       *as;                             /* state of write-behind    */
+  ASYNC_SLOT  *slot;                           /* free spare buffer        */
+  int          line;                           /* an image line            */
+  int          err;                            /* an error code            */
+
+  as = (ASYNC *)ifp->async;
+
+  for (line = first; line < first + number; line++)
+    if (ifp->changed_lines[line] == LINE_CHANGED)
+      break;
+  if (line >= first + number)
+    {
+    LOCK(as);
+    err = as->err;
+    UNLOCK(as);
+    return err;                                   /* nothing to write */
+    }
+
+  if (as->started == FALSE)
+    if ((err = start_writer(as)) != IIF_OK)
+      return err;
+
+  LOCK(as);
+  while (as->count == as->depth)
+    WAIT(as, done);
+  slot = &as->slots[(as->head + as->count) % as->depth];
+  err = as->err;
+  UNLOCK(as);
+  if (err != IIF_OK)
+    return err;
+
+  /* the slot is not touched by the writer until it is handed over */
+  if ((err = fill_slot(ifp, slot, first, number)) != IIF_OK)
+    return err;
+
+  LOCK(as);
+  as->count++;
+  SIGNAL(as, ready);
+  UNLOCK(as);
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_async_finish
+ * PURPOSE      waits until all lines handed over are written, stops the
+ *              writer thread and frees the spare buffers.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ * RETURNS      an error code of the writer.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  fl_async_finish(ifp)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+  {
+  ASYNC  *as;                                  /* state of write-behind    */
+  int     err;                                 /* an error code            */
+  int     n;                                   /* slot number              */
+
+  if ((as = (ASYNC *)ifp->async) == NULL)
+    return IIF_OK;
+
+  if (as->started == TRUE)
+    {
+    LOCK(as);
+    as->stop = TRUE;
+    SIGNAL(as, ready);
+    UNLOCK(as);
+#if (OS_MARK == 'I')
+    WaitForSingleObject(as->thread, INFINITE);
+    CloseHandle(as->thread);
+#else
+    pthread_join(as->thread, NULL);
+#endif
+    }
+
+#if (OS_MARK == 'I')
+  DeleteCriticalSection(&as->lock);
+#else
+  pthread_mutex_destroy(&as->lock);
+  pthread_cond_destroy(&as->ready);
+  pthread_cond_destroy(&as->done);
+#endif
+
+  err = as->err;
+  for (n = 0; n < as->depth; n++)
+    {
+    if (as->slots[n].buffer != NULL)
+      free(as->slots[n].buffer);
+    if (as->slots[n].changed != NULL)
+      free(as->slots[n].changed);
+    }
+  free(as);
+  ifp->async = NULL;
+  return err;
+  }
+
+/*========================= LOCAL FUNCTIONS ==============================*/
+
+/* --------------------------------------------------------------------------
+ * NAME         create_async
+ * PURPOSE      allocates state of write-behind; spare buffers are allocated
+ *              at the first use and the writer is started at the first
+ *              hand-over.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              depth        amount of spare buffers
+ * RETURNS      a pointer to the state or NULL.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static ASYNC  *create_async(ifp, depth)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+int    depth;                                  /* amount of spare buffers  */
+  {
+  ASYNC  *as;                                  /* state of write-behind    */
+
+  if ((as = (ASYNC *)calloc(1, sizeof(ASYNC))) == NULL)
+    return NULL;
+
+  as->ifp = ifp;
+  as->depth = depth;
+  as->err = IIF_OK;
+  as->stop = FALSE;
+  as->started = FALSE;
+#if (OS_MARK == 'I')
+  InitializeCriticalSection(&as->lock);
+  InitializeConditionVariable(&as->ready);
+  InitializeConditionVariable(&as->done);
+#else
+  pthread_mutex_init(&as->lock, NULL);
+  pthread_cond_init(&as->ready, NULL);
+  pthread_cond_init(&as->done, NULL);
+#endif
+  return as;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         start_writer
+ * PURPOSE      starts the writer thread.
+ * ARGUMENTS    as           state of write-behind
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static int  start_writer(as)
+ASYNC  *as;                                    /* state of write-behind    */
+  {
+  fflush(as->ifp->file_handle);  /* header must precede positional i/o */
+
+#if (OS_MARK == 'I')
+  if ((as->thread = CreateThread(NULL, 0, writer_thread, as, 0, NULL)) ==
+      NULL)
+    return IIFERR_NO_MEM;
+#else
+  if (pthread_create(&as->thread, NULL, writer_thread, as) != 0)
+    return IIFERR_NO_MEM;
+#endif
+  as->started = TRUE;
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         writer_loop
+ * PURPOSE      writes handed over slots until the stop is requested and
+ *              all slots are written.
+ * ARGUMENTS    as           state of write-behind
+ * RETURNS      None; the first error is placed into the state.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static VOID  writer_loop(as)
+ASYNC  *as;                                    /* state of write-behind    */
+  {
+  ASYNC_SLOT  *slot;                           /* slot to be written       */
+  int          err;                            /* an error code            */
+
+  LOCK(as);
+  for (;;)
+    {
+    while (as->count == 0 && as->stop == FALSE)
+      WAIT(as, ready);
+    if (as->count == 0)
+      break;
+    slot = &as->slots[as->head];
+    UNLOCK(as);
+
+    err = write_slot(as->ifp, slot);
+
+    LOCK(as);
+    if (err != IIF_OK && as->err == IIF_OK)
+      as->err = err;
+    as->head = (as->head + 1) % as->depth;
+    as->count--;
+    SIGNAL(as, done);
+    }
+  UNLOCK(as);
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         writer_thread
+ * PURPOSE      entry point of the writer thread.
+ * ARGUMENTS    as           state of write-behind
+ * RETURNS      0
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+#if (OS_MARK == 'I')
+static DWORD WINAPI  writer_thread(as)
+LPVOID  as;                                    /* state of write-behind    */
+#else
+static void  *writer_thread(as)
+void  *as;                                     /* state of write-behind    */
+#endif
+  {
+  writer_loop((ASYNC *)as);
+  return 0;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         write_slot
+ * PURPOSE      writes changed lines of the slot to the file; contiguous
+ *              changed lines are written at once.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              slot         lines handed over
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static int  write_slot(ifp, slot)
+IIFL        *ifp;                              /* a pointer to IIF file    */
+ASYNC_SLOT  *slot;                             /* lines handed over        */
+  {
+  long   bytes_per_line;                       /* size of one line         */
+  int    line;                                 /* line in the slot         */
+  int    to_write;                             /* lines in one group       */
+  int    err;                                  /* an error code            */
+
+  bytes_per_line = slot->size / slot->lines;
+  for (line = 0; line < slot->number; )
+    {
+    if (slot->changed[line] == LINE_NOT_CHANGED)
+      {
+      line++;
+      continue;
+      }
+
+    for (to_write = 0; line + to_write < slot->number &&
+         slot->changed[line + to_write] == LINE_CHANGED; to_write++)
+      ;
+
+    if ((err = fl_file_io(ifp, slot->buffer + bytes_per_line * line,
+                          bytes_per_line * to_write,
+                          ifp->image_area_offs +
+                          (INT64)bytes_per_line * (slot->first + line), 1)) !=
+        IIF_OK)
+      return err;
+    line += to_write;
+    }
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fill_slot
+ * PURPOSE      copies lines of the lines buffer and their markers to the
+ *              slot; the markers of the lines buffer are cleared.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              slot         free slot
+ *              first        first line to be written
+ *              number       amount of lines to be written
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static int  fill_slot(ifp, slot, first, number)
+IIFL        *ifp;                              /* a pointer to IIF file    */
+ASYNC_SLOT  *slot;                             /* free slot                */
+int          first;                            /* first line to be written */
+int          number;                           /* amount of lines          */
+  {
+  long   bytes_per_line;                       /* size of one line         */
+
+  bytes_per_line = (long)(ifp->buffer_size / ifp->num_of_lines);
+
+  /* the lines buffer may be resized by iif_set_buffer() */
+  if (slot->lines < number || slot->size != bytes_per_line * slot->lines)
+    {
+    if (slot->buffer != NULL)
+      free(slot->buffer);
+    if (slot->changed != NULL)
+      free(slot->changed);
+    slot->lines = (ifp->num_of_lines > number) ? ifp->num_of_lines : number;
+    slot->size = bytes_per_line * slot->lines;
+    slot->buffer = (BYTE *)malloc((size_t)slot->size);
+    slot->changed = (BYTE *)malloc((size_t)slot->lines);
+    if (slot->buffer == NULL || slot->changed == NULL)
+      {
+      slot->size = 0;
+      slot->lines = 0;
+      return IIFERR_NO_MEM;
+      }
+    }
+
+  slot->first = first;
+  slot->number = number;
+  memcpy(slot->buffer, (BYTE *)ifp->buffer +
+         bytes_per_line * (first - ifp->first_line),
+         (size_t)bytes_per_line * number);
+  memcpy(slot->changed, ifp->changed_lines + first, (size_t)number);
+  memset(ifp->changed_lines + first, LINE_NOT_CHANGED, (size_t)number);
+  return IIF_OK;
+  }
+
+/*--------------------------- END OF MODULE -------------------------------*/
@@ -35,6 +35,16 @@ static char *sccsid =
 #define  SIZE_OF_TWO_BYTES    2
 #define  SIZE_OF_FOUR_BYTES   4
 #define  SIZE_OF_EIGHT_BYTES  8
+#define  RGBE_MIN      1e-32f      /* smaller RGBE colors are stored as 0  */
+#define  RGBE_MAX      1e38f       /* the largest RGBE color component     */
+
+/* TYPES     */
+
+typedef union                      /* bits of single precision float       */
+  {
+  float         f;
+  unsigned int  u;
+  }FP_BITS;
 
 /* MACROS    */
  
@@ -45,23 +55,49 @@ static char *sccsid =
 int  iif_write_line(IIF*, VPTR, int, int, int);
 int  iif_read_line(IIF*, VPTR, int, int, int);
 int  iif_fill(IIF*, int, int, int, int);
+int  iif_write_image(IIF*, VPTR, int, int, int, int, INT64*, INT64, INT64);
+int  iif_read_image(IIF*, VPTR, int, int, int, int, INT64*, INT64, INT64);
 */
 
 /* LOCAL FUNCTIONS PROTOTYPES */
 
 #ifndef NO_PROTOTYPES
 
-static   VOID move_data(IIFL*, VPTR, int, int, int, int);
+static   int  write_line(IIF*, VPTR, int, int, int);
+static   int  read_line(IIF*, VPTR, int, int, int);
+static   int  fill_lines(IIF*, int, int, int, int);
+static   VOID move_data(IIFL*, VPTR, BYTE*, int, int, int);
+static   int  move_image(IIFL*, BYTE*, int, int, int, int, INT64*, INT64, INT64,
+                         int);
+static   VOID move_strided(IIFL*, BYTE*, INT64*, INT64, BYTE*, int, int, int,
+                           BYTE*);
+static   VOID copy_values(BYTE*, INT64, BYTE*, INT64, int, int, BOOL);
+static   int  load_lines(IIFL*, int);
+static   BYTE *buffer_line(IIFL*, int);
 static   VOID fill_line(IIFL*, int, int, int);
 static   VOID convert_fp(BYTE*, BYTE*, int, int, int);
-static   VOID swap_area(BYTE*, int, int);
+static   VOID half_to_float(float*, BYTE*, int, BOOL);
+static   VOID float_to_half(BYTE*, float*, int, BOOL);
+static   VOID rgbe_to_float(float*, BYTE*, int);
+static   VOID float_to_rgbe(BYTE*, float*, int);
 
 #else
 
+static   int  write_line();
+static   int  read_line();
+static   int  fill_lines();
 static   VOID move_data();
+static   int  move_image();
+static   VOID move_strided();
+static   VOID copy_values();
+static   int  load_lines();
+static   BYTE *buffer_line();
 static   VOID fill_line();
 static   VOID convert_fp();
-static   VOID swap_area();
+static   VOID half_to_float();
+static   VOID float_to_half();
+static   VOID rgbe_to_float();
+static   VOID float_to_rgbe();
 
 #endif
 
@@ -85,6 +121,37 @@ IIF  *iflp;          /* a pointer to opened IIF file                       */
 VPTR  table;         /* a pointer to table with buffer addresses with data */
 int   y;             /* y origin of image area, line number                */
 int   fpix;          /* a number of first pixel in line to write/update;   */
+int   npix;          /* a number of pixels in line to write/update;        */
+  {
+  int    err;                                             /* an error code */
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if (fl_check_iifstr_ptr(ifp) != IIF_OK)
+    {
+    IIF_errno = IIFERR_BAD_PTR;
+    return IIFERR_BAD_PTR;
+    }
+
+  fl_lock(ifp);
+  err = write_line(iflp, table, y, fpix, npix);
+  fl_unlock(ifp);
+  return err;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         write_line
+ * PURPOSE      writes one line to IIF file; called with the file locked.
+ * ARGUMENTS    see iif_write_line()
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static int  write_line(iflp, table, y, fpix, npix)
+IIF  *iflp;          /* a pointer to opened IIF file                       */
+VPTR  table;         /* a pointer to table with buffer addresses with data */
+int   y;             /* y origin of image area, line number                */
+int   fpix;          /* a number of first pixel in line to write/update;   */
 int   npix;          /* a number of pixels in line to write/update;        */
   {
   int err;                                                /* an error code */
@@ -110,6 +177,12 @@ int   npix;          /* a number of pixels in line to write/update;        */
     return IIFERR_BAD_MODE;
     }
 
+  if (ifp->format == IIF_FORMAT_TILE)     /* written by iif_write_tile only */
+    {
+    ifp->error = IIFERR_BAD_FORMAT;
+    return IIFERR_BAD_FORMAT;
+    }
+
   if (table == NULL || fpix < -1)
     {
     ifp->error = IIFERR_BAD_PARMS;
@@ -128,46 +201,19 @@ int   npix;          /* a number of pixels in line to write/update;        */
     return IIFERR_BAD_ORG;
     }
 
-  if (ifp->buffer == NULL)
-    if ((err = fl_first_access(ifp, y)) != IIF_OK)
-      {
-      ifp->error = err;
-      return err;
-      }
-
   if (fpix != -1 && fpix > ifp->xres)
     {
     ifp->error = IIFERR_BAD_SIZE;
     return IIFERR_BAD_SIZE;
     }
 
-  if (y < ifp->first_line || y > (ifp->first_line + ifp->valid_lines - 1))
+  if ((err = load_lines(ifp, y)) != IIF_OK)
     {
-    if (ifp->affected == TRUE)
-      {
-      if ((err = fl_write_lines(ifp, ifp->first_line, ifp->valid_lines)) !=
-                 IIF_OK)
-        {
-        ifp->error = err;
-        return err;
-        }
-      }
-
-    ifp->first_line = y;
-    ifp->valid_lines = (y + ifp->num_of_lines <= ifp->yres) ?
-                        ifp->num_of_lines : ifp->yres - y;
-
-    if (ifp->attrib == 'u')
-      {
-      if ((err = fl_read_lines(ifp, y, ifp->valid_lines)) != IIF_OK)
-        {
-        ifp->error = err;
-        return err;
-        }
-      }
+    ifp->error = err;
+    return err;
     }
 
-  move_data(ifp, table, y - ifp->first_line, fpix, npix, 0);
+  move_data(ifp, table, buffer_line(ifp, y - ifp->first_line), fpix, npix, 0);
   ifp->changed_lines[y] = LINE_CHANGED;
   ifp->affected = TRUE;
   return IIF_OK;
@@ -189,6 +235,37 @@ IIF  *iflp;          /* a pointer to opened IIF file                       */
 VPTR  table;         /* a pointer to table with buffer addresses for  data */
 int   y;             /* y origin of image area, line number                */
 int   fpix;          /* a number of first pixel in line to read            */
+int   npix;          /* a number of pixels in line to read                 */
+  {
+  int    err;                                             /* an error code */
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if (fl_check_iifstr_ptr(ifp) != IIF_OK)
+    {
+    IIF_errno = IIFERR_BAD_PTR;
+    return IIFERR_BAD_PTR;
+    }
+
+  fl_lock(ifp);
+  err = read_line(iflp, table, y, fpix, npix);
+  fl_unlock(ifp);
+  return err;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         read_line
+ * PURPOSE      reads one line from IIF file; called with the file locked.
+ * ARGUMENTS    see iif_read_line()
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static int  read_line(iflp, table, y, fpix, npix)
+IIF  *iflp;          /* a pointer to opened IIF file                       */
+VPTR  table;         /* a pointer to table with buffer addresses for  data */
+int   y;             /* y origin of image area, line number                */
+int   fpix;          /* a number of first pixel in line to read            */
 int   npix;          /* a number of pixels in line to read                 */
   {
   int err;                                                /* an error code */
@@ -238,37 +315,19 @@ int   npix;          /* a number of pixels in line to read                 */
     return IIFERR_NOT_INIT;
     }
 
-  if (ifp->buffer == NULL)
-    if ((err = fl_first_access(ifp, y)) != IIF_OK)
-      {
-      ifp->error = err;
-      return err;
-      }
-
-  if (y < ifp->first_line || y > (ifp->first_line + ifp->valid_lines - 1))
+  if (ifp->map_base != NULL)         /* mapped file; lines buffer not used */
     {
-    if (ifp->affected == TRUE)
-      {
-      if ((err = fl_write_lines(ifp, ifp->first_line, ifp->valid_lines)) !=
-                 IIF_OK)
-        {
-        ifp->error = err;
-        return err;
-        }
-      }
-
-    ifp->first_line = y;
-    ifp->valid_lines = (y + ifp->num_of_lines <= ifp->yres) ?
-                        ifp->num_of_lines : ifp->yres - y;
+    move_data(ifp, table, fl_map_line(ifp, y), fpix, npix, 1);
+    return IIF_OK;
+    }
 
-    if ((err = fl_read_lines(ifp, y, ifp->valid_lines)) != IIF_OK)
-      {
-      ifp->error = err;
-      return err;
-      }
+  if ((err = load_lines(ifp, y)) != IIF_OK)
+    {
+    ifp->error = err;
+    return err;
     }
 
-  move_data(ifp, table, y - ifp->first_line, fpix, npix, 1);
+  move_data(ifp, table, buffer_line(ifp, y - ifp->first_line), fpix, npix, 1);
   return IIF_OK;
   }
 
@@ -288,6 +347,37 @@ IIF  *iflp;          /* a pointer to opened IIF file                       */
 int   y;             /* y origin of image area, line number                */
 int   h;             /* a heigth of the area                               */
 int   fpix;          /* a number of first pixel in line to read            */
+int   npix;          /* a number of pixels in line to read                 */
+  {
+  int    err;                                             /* an error code */
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if (fl_check_iifstr_ptr(ifp) != IIF_OK)
+    {
+    IIF_errno = IIFERR_BAD_PTR;
+    return IIFERR_BAD_PTR;
+    }
+
+  fl_lock(ifp);
+  err = fill_lines(iflp, y, h, fpix, npix);
+  fl_unlock(ifp);
+  return err;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fill_lines
+ * PURPOSE      fills 'h' lines of IIF file; called with the file locked.
+ * ARGUMENTS    see iif_fill()
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static int  fill_lines(iflp, y, h, fpix, npix)
+IIF  *iflp;          /* a pointer to opened IIF file                       */
+int   y;             /* y origin of image area, line number                */
+int   h;             /* a heigth of the area                               */
+int   fpix;          /* a number of first pixel in line to read            */
 int   npix;          /* a number of pixels in line to read                 */
   {
   int err;                                                /* an error code */
@@ -315,6 +405,12 @@ int   npix;          /* a number of pixels in line to read                 */
     return IIFERR_BAD_MODE;
     }
 
+  if (ifp->format == IIF_FORMAT_TILE)     /* written by iif_write_tile only */
+    {
+    ifp->error = IIFERR_BAD_FORMAT;
+    return IIFERR_BAD_FORMAT;
+    }
+
   if (y < 0 || y > ifp->yres)
     {
     ifp->error = IIFERR_BAD_ORG;
@@ -412,9 +508,525 @@ int   npix;          /* a number of pixels in line to read                 */
   return IIF_OK;
   }
 
+/* --------------------------------------------------------------------------
+ * NAME         iif_write_image
+ * PURPOSE      writes rectangle of image from one user's buffer; the buffer
+ *              may keep the components interleaved (pixel by pixel) or
+ *              planar (plane by plane), with any distance between pixels
+ *              and between lines.
+ * ARGUMENTS    iflp         a pointer to opened IIF file
+ *              data         a pointer to the buffer
+ *              x, y         origin of the rectangle in the image
+ *              w, h         width and height of the rectangle
+ *              offsets      table of offsets (in bytes) from 'data' to the
+ *                           value of pixel (x, y) for every defined
+ *                           component, in the order of the table used by
+ *                           iif_write_line (see iif_def_components)
+ *              pix_step     distance between neighbour pixels in the buffer
+ *                           (in bytes)
+ *              line_step    distance between neighbour lines in the buffer
+ *                           (in bytes)
+ * RETURNS      an error code.
+ * NOTE         Value of component 'n' of pixel (x + i, y + j) is taken from
+ *              data + offsets[n] + j * line_step + i * pix_step; values of
+ *              'h' and 'e' components are floats (see iif_init_file).
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  iif_write_image(iflp, data, x, y, w, h, offsets, pix_step, line_step)
+IIF   *iflp;           /* a pointer to opened IIF file                     */
+VPTR   data;           /* a pointer to user's buffer                       */
+int    x, y;           /* origin of the rectangle                          */
+int    w, h;           /* size of the rectangle                            */
+INT64 *offsets;        /* offsets to values of components                  */
+INT64  pix_step;       /* distance between pixels                          */
+INT64  line_step;      /* distance between lines                           */
+  {
+  int    err;                                             /* an error code */
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if (fl_check_iifstr_ptr(ifp) != IIF_OK)
+    {
+    IIF_errno = IIFERR_BAD_PTR;
+    return IIFERR_BAD_PTR;
+    }
+
+  if (ifp->attrib == 'r')
+    {
+    ifp->error = IIFERR_BAD_MODE;
+    return IIFERR_BAD_MODE;
+    }
+
+  if (ifp->format == IIF_FORMAT_TILE)     /* written by iif_write_tile only */
+    {
+    ifp->error = IIFERR_BAD_FORMAT;
+    return IIFERR_BAD_FORMAT;
+    }
+
+  fl_lock(ifp);
+  err = move_image(ifp, (BYTE *)data, x, y, w, h, offsets, pix_step,
+                   line_step, 0);
+  fl_unlock(ifp);
+  if (err != IIF_OK)
+    {
+    ifp->error = err;
+    return err;
+    }
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         iif_read_image
+ * PURPOSE      reads rectangle of image to one user's buffer; the buffer
+ *              may keep the components interleaved or planar.
+ * ARGUMENTS    iflp         a pointer to opened IIF file
+ *              data         a pointer to the buffer
+ *              x, y         origin of the rectangle in the image
+ *              w, h         width and height of the rectangle
+ *              offsets      table of offsets (in bytes) from 'data' to the
+ *                           value of pixel (x, y) for every defined
+ *                           component
+ *              pix_step     distance between neighbour pixels in the buffer
+ *                           (in bytes)
+ *              line_step    distance between neighbour lines in the buffer
+ *                           (in bytes)
+ * RETURNS      an error code.
+ * NOTE         See iif_write_image() for the layout of the buffer.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  iif_read_image(iflp, data, x, y, w, h, offsets, pix_step, line_step)
+IIF   *iflp;           /* a pointer to opened IIF file                     */
+VPTR   data;           /* a pointer to user's buffer                       */
+int    x, y;           /* origin of the rectangle                          */
+int    w, h;           /* size of the rectangle                            */
+INT64 *offsets;        /* offsets to values of components                  */
+INT64  pix_step;       /* distance between pixels                          */
+INT64  line_step;      /* distance between lines                           */
+  {
+  int    err;                                             /* an error code */
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if (fl_check_iifstr_ptr(ifp) != IIF_OK)
+    {
+    IIF_errno = IIFERR_BAD_PTR;
+    return IIFERR_BAD_PTR;
+    }
+
+  if (ifp->attrib == 'w')
+    {
+    ifp->error = IIFERR_BAD_MODE;
+    return IIFERR_BAD_MODE;
+    }
+
+  fl_lock(ifp);
+  err = move_image(ifp, (BYTE *)data, x, y, w, h, offsets, pix_step,
+                   line_step, 1);
+  fl_unlock(ifp);
+  if (err != IIF_OK)
+    {
+    ifp->error = err;
+    return err;
+    }
+  return IIF_OK;
+  }
+
+/*==================== INTERFACE FUNCTIONS ==========================*/
+
+/*--------------------------------------------------------------------------
+ * NAME         fl_swap_needed
+ * PURPOSE      checks if bytes of multi-byte components have to be swapped
+ *              when data are moved between the file and memory.
+ * ARGUMENTS    ifp          a pointer to opened IIF file
+ * RETURNS      TRUE if byte order of the file differs from the order of
+ *              current operating system and swapping is enabled.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+BOOL  fl_swap_needed(ifp)
+IIFL  *ifp;                                /* a pointer to opened IIF file */
+  {
+  if ((ifp->swap == TRUE  && IIF_os_byte_order == 0) ||
+      (ifp->swap == FALSE && IIF_os_byte_order == 1))
+    return ifp->enable_swap;
+  return FALSE;
+  }
+
+/*--------------------------------------------------------------------------
+ * NAME         fl_swap_area
+ * PURPOSE      swaps bytes in given area
+ * ARGUMENTS    buffer       a pointer of  beginning of swapped area
+ *              amount       amount of items to swap
+ *              size         a size of each item
+ * RETURNS      None
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+VOID  fl_swap_area(buffer, amount, size)
+BYTE  *buffer;                /* a pointer of  beginning of swapped area */
+int    amount;                /* amount of items to swap                 */
+int    size;                  /* a size of each item                     */
+  {
+  BYTE tmp;                   /* temporary value                         */
+  int  n;                     /* an auxiliary iteration counter          */
+
+  if (size == SIZE_OF_TWO_BYTES)
+    {
+    for (n = 0; n < amount; n++)
+       {
+       tmp = *buffer;
+       *buffer = *(buffer + 1);
+       *(buffer + 1) = tmp;
+       buffer += 2;
+       }
+    }
+  else
+    if (size == SIZE_OF_FOUR_BYTES)
+      for (n = 0; n < amount; n++)
+         {
+         tmp = *buffer;
+         *buffer = *(buffer + 3);
+         *(buffer + 3) = tmp;
+         tmp = *(buffer + 2);
+         *(buffer + 2) = *(buffer + 1);
+         *(buffer + 1) = tmp;
+         buffer += 4;
+         }
+  else
+    if (size == SIZE_OF_EIGHT_BYTES)
+      for (n = 0; n < amount; n++)
+         {
+         tmp = *buffer;
+         *buffer = *(buffer + 7);
+         *(buffer + 7) = tmp;
+         tmp = *(buffer + 6);
+         *(buffer + 6) = *(buffer + 1);
+         *(buffer + 1) = tmp;
+         tmp = *(buffer + 5);
+         *(buffer + 5) = *(buffer + 2);
+         *(buffer + 2) = tmp;
+         tmp = *(buffer + 4);
+         *(buffer + 4) = *(buffer + 3);
+         *(buffer + 3) = tmp;
+         buffer += 8;
+         }
+  }
+
+/*--------------------------------------------------------------------------
+ * NAME         fl_narrow_values
+ * PURPOSE      converts values of packed component type ('h' or 'e') from
+ *              user's floats to the file format.
+ * ARGUMENTS    dest         a pointer to values in the file format
+ *              src          a pointer to user's values
+ *              amount       amount of values
+ *              type         a type of component
+ *              swap_bytes   TRUE if byte order of the file differs
+ * RETURNS      None
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+VOID  fl_narrow_values(dest, src, amount, type, swap_bytes)
+BYTE  *dest;                  /* a pointer to values in the file format  */
+BYTE  *src;                   /* a pointer to user's values              */
+int    amount;                /* amount of values                        */
+int    type;                  /* a type of component                     */
+BOOL   swap_bytes;            /* TRUE if byte order of the file differs  */
+  {
+  if (type == 'h')
+    float_to_half(dest, (float *)src, amount, swap_bytes);
+  else if (type == 'e')                  /* bytes of RGBE are never swapped */
+    float_to_rgbe(dest, (float *)src, amount);
+  }
+
+/*--------------------------------------------------------------------------
+ * NAME         fl_widen_values
+ * PURPOSE      converts values of packed component type ('h' or 'e') from
+ *              the file format to user's floats.
+ * ARGUMENTS    dest         a pointer to user's values
+ *              src          a pointer to values in the file format
+ *              amount       amount of values
+ *              type         a type of component
+ *              swap_bytes   TRUE if byte order of the file differs
+ * RETURNS      None
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+VOID  fl_widen_values(dest, src, amount, type, swap_bytes)
+BYTE  *dest;                  /* a pointer to user's values              */
+BYTE  *src;                   /* a pointer to values in the file format  */
+int    amount;                /* amount of values                        */
+int    type;                  /* a type of component                     */
+BOOL   swap_bytes;            /* TRUE if byte order of the file differs  */
+  {
+  if (type == 'h')
+    half_to_float((float *)dest, src, amount, swap_bytes);
+  else if (type == 'e')
+    rgbe_to_float((float *)dest, src, amount);
+  }
 
 /*==================== LOCAL FUNCTIONS ==============================*/
 
+/*--------------------------------------------------------------------------
+ * NAME         move_image
+ * PURPOSE      copies rectangle of image between the file and user's
+ *              buffer, line by line through the lines buffer (or directly
+ *              from the mapped file)
+ * ARGUMENTS    ifp          a pointer to opened IIF file
+ *              data         a pointer to user's buffer
+ *              x, y         origin of the rectangle
+ *              w, h         size of the rectangle
+ *              offsets      offsets to values of components
+ *              pix_step     distance between pixels in the buffer
+ *              line_step    distance between lines in the buffer
+ *              dir          0 - from user's buffer to the file;
+ *                           1 - from the file to user's buffer
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static int  move_image(ifp, data, x, y, w, h, offsets, pix_step, line_step,
+                       dir)
+IIFL  *ifp;            /* a pointer to opened IIF file                     */
+BYTE  *data;           /* a pointer to user's buffer                       */
+int    x, y;           /* origin of the rectangle                          */
+int    w, h;           /* size of the rectangle                            */
+INT64 *offsets;        /* offsets to values of components                  */
+INT64  pix_step;       /* distance between pixels                          */
+INT64  line_step;      /* distance between lines                           */
+int    dir;            /* direction in which data are copied               */
+  {
+  BYTE  *scratch;      /* user's values of packed component of one line    */
+  BYTE  *line;         /* beginning of the line in the file format         */
+  int    j;            /* line of the rectangle                            */
+  int    err;          /* an error code                                    */
+
+  if (ifp->initialized != 1)
+    return IIFERR_NOT_INIT;
+
+  if (data == NULL || offsets == NULL)
+    return IIFERR_BAD_PARMS;
+
+  if (x < 0 || y < 0 || w <= 0 || h <= 0 ||
+      w > ifp->xres - x || h > ifp->yres - y)
+    return IIFERR_BAD_ORG;
+
+  scratch = NULL;
+  if (strpbrk(ifp->types, "he") != NULL)
+    if ((scratch = (BYTE *)malloc((size_t)w * 3 * sizeof(float))) == NULL)
+      return IIFERR_NO_MEM;
+
+  for (j = 0; j < h; j++)
+    {
+    if (dir == 1 && ifp->map_base != NULL)
+      line = fl_map_line(ifp, y + j);
+    else
+      {
+      if ((err = load_lines(ifp, y + j)) != IIF_OK)
+        {
+        if (scratch != NULL)
+          free(scratch);
+        return err;
+        }
+      line = buffer_line(ifp, y + j - ifp->first_line);
+      }
+
+    move_strided(ifp, data + j * line_step, offsets, pix_step, line, x, w,
+                 dir, scratch);
+
+    if (dir == 0)
+      {
+      ifp->changed_lines[y + j] = LINE_CHANGED;
+      ifp->affected = TRUE;
+      }
+    }
+
+  if (scratch != NULL)
+    free(scratch);
+  return IIF_OK;
+  }
+
+/*--------------------------------------------------------------------------
+ * NAME         move_strided
+ * PURPOSE      copies part of one line between the line in the file format
+ *              and user's buffer with given distance between pixels; bytes
+ *              are swapped during the copy
+ * ARGUMENTS    ifp          a pointer to opened IIF file
+ *              data         user's values of the first pixel of the line
+ *              offsets      offsets to values of components
+ *              pix_step     distance between pixels in the buffer
+ *              beginning    beginning of the line in the file format
+ *              fpix         a number of first pixel in line to access
+ *              npix         a number of pixels in line to access
+ *              dir          0 - from user's buffer to the line;
+ *                           1 - from the line to user's buffer
+ *              scratch      a buffer for npix values of packed component
+ * RETURNS      None
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static VOID move_strided(ifp, data, offsets, pix_step, beginning, fpix, npix,
+                         dir, scratch)
+IIFL  *ifp;            /* a pointer to opened IIF file                     */
+BYTE  *data;           /* user's values of the first pixel                 */
+INT64 *offsets;        /* offsets to values of components                  */
+INT64  pix_step;       /* distance between pixels                          */
+BYTE  *beginning;      /* beginning of the line in the file format         */
+int    fpix;           /* a number of first pixel in line to access        */
+int    npix;           /* a number of pixels in line to access             */
+int    dir;            /* direction in which data are copied               */
+BYTE  *scratch;        /* a buffer for values of packed component          */
+  {
+  BOOL   swap_bytes;              /* flag; TRUE if byte swapping is needed */
+  BYTE  *user;                    /* user's values of the component        */
+  BYTE  *file;                    /* values of the component in the line   */
+  char   type;                    /* a type of component                   */
+  int    size;                    /* a size of component (in bytes)        */
+  int    user_size;               /* a size of value in user's buffer      */
+  int    n;                       /* an iteration counter                  */
+
+  swap_bytes = fl_swap_needed(ifp);
+  for (n = 0; n < (int)ifp->def_cmps_amount; n++)
+    {
+    type = *(ifp->def_cmps_types + n);
+    size = *(ifp->def_cmps_sizes + n);
+    user_size = fl_user_comp_size(type);
+    user = data + offsets[*(ifp->def_cmps_position + n)];
+    file = beginning + *(ifp->def_cmps_offsets + n) + (long)fpix * size;
+
+    if (type == 'h' || type == 'e')          /* through contiguous floats */
+      {
+      if (dir == 0)
+        {
+        copy_values(scratch, user_size, user, pix_step, npix, user_size,
+                    FALSE);
+        fl_narrow_values(file, scratch, npix, type, swap_bytes);
+        }
+      else
+        {
+        fl_widen_values(scratch, file, npix, type, swap_bytes);
+        copy_values(user, pix_step, scratch, user_size, npix, user_size,
+                    FALSE);
+        }
+      }
+    else if (dir == 0)
+      copy_values(file, size, user, pix_step, npix, size,
+                  (BOOL)(swap_bytes == TRUE && size > 1));
+    else
+      copy_values(user, pix_step, file, size, npix, size,
+                  (BOOL)(swap_bytes == TRUE && size > 1));
+    }
+  }
+
+/*--------------------------------------------------------------------------
+ * NAME         copy_values
+ * PURPOSE      copies values with given distances between them, reversing
+ *              order of bytes of every value if required
+ * ARGUMENTS    dest         a pointer to the first destination value
+ *              dest_step    distance between destination values (in bytes)
+ *              src          a pointer to the first source value
+ *              src_step     distance between source values (in bytes)
+ *              amount       amount of values
+ *              size         a size of value (in bytes)
+ *              swap_bytes   TRUE if order of bytes has to be reversed
+ * RETURNS      None
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static VOID copy_values(dest, dest_step, src, src_step, amount, size,
+                        swap_bytes)
+BYTE  *dest;           /* a pointer to the first destination value         */
+INT64  dest_step;      /* distance between destination values              */
+BYTE  *src;            /* a pointer to the first source value              */
+INT64  src_step;       /* distance between source values                   */
+int    amount;         /* amount of values                                 */
+int    size;           /* a size of value                                  */
+BOOL   swap_bytes;     /* TRUE if order of bytes has to be reversed        */
+  {
+  int  n, k;                      /* an iteration counters                 */
+
+  if (swap_bytes == FALSE && dest_step == size && src_step == size)
+    {
+    memcpy(dest, src, (size_t)amount * size);
+    return;
+    }
+
+  if (swap_bytes == TRUE)
+    {
+    for (n = 0; n < amount; n++, dest += dest_step, src += src_step)
+      for (k = 0; k < size; k++)
+        dest[k] = src[size - 1 - k];
+    return;
+    }
+
+  switch (size)              /* fixed sizes let the compiler use moves */
+    {
+    case 1: for (n = 0; n < amount; n++, dest += dest_step, src += src_step)
+              *dest = *src;
+         break;
+    case 2: for (n = 0; n < amount; n++, dest += dest_step, src += src_step)
+              memcpy(dest, src, 2);
+         break;
+    case 4: for (n = 0; n < amount; n++, dest += dest_step, src += src_step)
+              memcpy(dest, src, 4);
+         break;
+    case 8: for (n = 0; n < amount; n++, dest += dest_step, src += src_step)
+              memcpy(dest, src, 8);
+         break;
+    default: for (n = 0; n < amount; n++, dest += dest_step, src += src_step)
+              memcpy(dest, src, size);
+         break;
+    }
+  }
+
+/*--------------------------------------------------------------------------
+ * NAME         load_lines
+ * PURPOSE      makes the line present in lines buffer; changed lines of the
+ *              buffer are written to the file before other lines are read
+ * ARGUMENTS    ifp          a pointer to opened IIF file
+ *              y            line number
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static int  load_lines(ifp, y)
+IIFL  *ifp;                                /* a pointer to opened IIF file */
+int    y;                                  /* line number                  */
+  {
+  int err;                                                /* an error code */
+
+  if (ifp->buffer == NULL)
+    return fl_first_access(ifp, y);
+
+  if (y >= ifp->first_line && y <= ifp->first_line + ifp->valid_lines - 1)
+    return IIF_OK;
+
+  if (ifp->affected == TRUE)
+    if ((err = fl_write_lines(ifp, ifp->first_line, ifp->valid_lines)) !=
+        IIF_OK)
+      return err;
+
+  ifp->first_line = y;
+  ifp->valid_lines = (y + ifp->num_of_lines <= ifp->yres) ?
+                      ifp->num_of_lines : ifp->yres - y;
+
+  if (ifp->attrib != 'w')            /* in write mode - no reading from file! */
+    if ((err = fl_read_lines(ifp, y, ifp->valid_lines)) != IIF_OK)
+      return err;
+  return IIF_OK;
+  }
+
+/*--------------------------------------------------------------------------
+ * NAME         buffer_line
+ * PURPOSE      returns address of line in lines buffer
+ * ARGUMENTS    ifp          a pointer to opened IIF file
+ *              line         line number in lines buffer
+ * RETURNS      a pointer to the first byte of the line.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static BYTE *buffer_line(ifp, line)
+IIFL  *ifp;                                /* a pointer to opened IIF file */
+int    line;                               /* line number in lines buffer  */
+  {
+  unsigned long bytes_per_line;            /* size of one line in bytes    */
+
+  bytes_per_line = (unsigned long)(ifp->buffer_size / ifp->num_of_lines);
+  return (BYTE*)(ifp->buffer) + bytes_per_line * line;
+  }
+
 /*--------------------------------------------------------------------------
  * NAME         fill_line
  * PURPOSE      fills one line in lines buffer
@@ -446,15 +1058,10 @@ int   npix;          /* a number of pixels in line to read                 */
   float  float_fill;             /* a temporary varable for fill value     */
   long   long_fill;              /* a temporary varable for fill value     */
   short  short_fill;             /* a temporary varable for fill value     */
+  BYTE   packed_fill[4];         /* fill value of packed type in file      */
   register BYTE *src, *dest;    /* pointers to data source and destination */
 
-  if ((ifp->swap == TRUE  && IIF_os_byte_order == 0) ||
-      (ifp->swap == FALSE && IIF_os_byte_order == 1))
-    {
-    swap_bytes = ifp->enable_swap;
-    }
-  else
-    swap_bytes = FALSE;
+  swap_bytes = fl_swap_needed(ifp);
 
   float_conv  = (BOOL)((fl_get_float_ver(ifp) == IIF_os_fp_format) ?
                                                               FALSE : TRUE);
@@ -507,6 +1114,14 @@ int   npix;          /* a number of pixels in line to read                 */
                 dest = (BYTE*)(beginning + fl_get_comp_offset(ifp, n));
                 src  = (BYTE*)&short_fill;
 
+           break;
+      case 'e':
+      case 'h': fl_narrow_values(packed_fill,
+                                 *((BYTE**)(ifp->fill_val) + n), 1,
+                                 *(ifp->types + n), FALSE);
+                dest = (BYTE*)(beginning + fl_get_comp_offset(ifp, n));
+                src  = packed_fill;
+
            break;
       default:
 #ifdef DEBUG
@@ -517,8 +1132,8 @@ printf("MODULE: img_buff, func.: fill_line - Unknown component type '%d'\n",
             break;
       }
 
-      if (size > 1 && swap_bytes == TRUE)
-        swap_area(src, 1, (int)size);
+      if (size > 1 && swap_bytes == TRUE && *(ifp->types + n) != 'e')
+        fl_swap_area(src, 1, (int)size);
 
       if (fpix != -1)
         dest += fpix * size;
@@ -529,72 +1144,14 @@ printf("MODULE: img_buff, func.: fill_line - Unknown component type '%d'\n",
     }
   }
 
-/*--------------------------------------------------------------------------
- * NAME         swap_area
- * PURPOSE      swaps bytes in given area
- * ARGUMENTS    buffer       a pointer of  beginning of swapped area
- *              amount       amount of items to swap
- *              size         a size of each item
- * RETURNS      None
- * EXTERNS      None
- --------------------------------------------------------------------------*/
-static VOID  swap_area(buffer, amount, size)
-BYTE  *buffer;                /* a pointer of  beginning of swapped area */
-int    amount;                /* amount of items to swap                 */
-int    size;                  /* a size of each item                     */
-  {
-  BYTE tmp;                   /* temporary value                         */
-  int  n;                     /* an auxiliary iteration counter          */
-
-  if (size == SIZE_OF_TWO_BYTES)
-    {
-    for (n = 0; n < amount; n++)
-       {
-       tmp = *buffer;
-       *buffer = *(buffer + 1);
-       *(buffer + 1) = tmp;
-       buffer += 2;
-       }
-    }
-  else
-    if (size == SIZE_OF_FOUR_BYTES)
-      for (n = 0; n < amount; n++)
-         {
-         tmp = *buffer;
-         *buffer = *(buffer + 3);
-         *(buffer + 3) = tmp;
-         tmp = *(buffer + 2);
-         *(buffer + 2) = *(buffer + 1);
-         *(buffer + 1) = tmp;
-         buffer += 4;
-         }
-  else
-    if (size == SIZE_OF_EIGHT_BYTES)
-      for (n = 0; n < amount; n++)
-         {
-         tmp = *buffer;
-         *buffer = *(buffer + 7);
-         *(buffer + 7) = tmp;
-         tmp = *(buffer + 6);
-         *(buffer + 6) = *(buffer + 1);
-         *(buffer + 1) = tmp;
-         tmp = *(buffer + 5);
-         *(buffer + 5) = *(buffer + 2);
-         *(buffer + 2) = tmp;
-         tmp = *(buffer + 4);
-         *(buffer + 4) = *(buffer + 3);
-         *(buffer + 3) = tmp;
-         buffer += 8;
-         }
-  }
-
 /*--------------------------------------------------------------------------
  * NAME         move_data
  * PURPOSE      copies pixel data between lines buffer and user's buffers
  * ARGUMENTS    ifp          a pointer to opened IIF file
  *              table        a pointer to a table with pointers to buffers
  *                           for data, one buffer for one component
- *              line         number of line in buffer to move
+ *              beginning    beginning of the line in lines buffer or in
+ *                           the mapped file
  *              fpix         a number of first pixel in line to access; if set
  *                           to -1, all pixels have to be accessed.
  *              npix         a number of pixels in line to access; has no
@@ -605,10 +1162,10 @@ int    size;                  /* a size of each item                     */
  * RETURNS       an error code.
  * EXTERNS       None
  --------------------------------------------------------------------------*/
-static VOID move_data(ifp, table, line, fpix, npix, dir)
+static VOID move_data(ifp, table, beginning, fpix, npix, dir)
 IIFL  *ifp;           /* a pointer to opened IIF file                      */
 VPTR  table;          /* a pointer to a table with pointers to buffers     */
-int   line;           /* line number in image buffer                       */
+BYTE *beginning;      /* beginning of the line to access                   */
 int   fpix;           /* for data, one buffer for one component            */
                       /* a number of first pixel in line to access; if set */
 int   npix;           /* to -1, all pixels have to be accessed.            */
@@ -618,45 +1175,36 @@ int   dir;            /* meaning if fpix is set to -1.                     */
                       /* 0 - from user's buffer to lines buffer;           */
                       /* 1 - from lines buffer to user's buffers;          */
   {
-  unsigned long bytes_per_line;   /* size of one line in bytes             */
-  BYTE  *beginning;               /* beginning of line in buffer to fill   */
   BOOL swap_bytes;                /* flag; TRUE if byte swapping is needed */
   BOOL float_conv;  /* flag; TRUE if floating point conversion is required */
   int all_cmps;                   /* amount of all components in ifp file  */
   int n;                          /* an iteration counters                 */
   unsigned short size;            /* a size of component (in bytes)        */
+  int  user_size;                 /* a size of value in user's buffer      */
   BYTE file_fp_format;     /* a floating point format obligatory in a file */
   BYTE   *src, *dest;
   BYTE   *temp;             /* a temporary pointer for exchange src<->dest */
 
-  if ((ifp->swap == TRUE  && IIF_os_byte_order == 0) ||
-      (ifp->swap == FALSE && IIF_os_byte_order == 1))
-    {
-    swap_bytes = ifp->enable_swap;
-    }
-  else
-    swap_bytes = FALSE;
-
+  swap_bytes = fl_swap_needed(ifp);
   float_conv  = (BOOL)((fl_get_float_ver(ifp) == IIF_os_fp_format) ?
                                                             FALSE : TRUE);
   file_fp_format =  fl_get_float_ver(ifp);
   all_cmps = ifp->def_cmps_amount;
-  bytes_per_line = (unsigned long)(ifp->buffer_size / ifp->num_of_lines);
-  beginning = (BYTE*)(ifp->buffer) + bytes_per_line * line;
   if (fpix == -1)
     npix = ifp->xres;
   else
-    npix = (fpix + npix <= ifp->xres) ? npix : ifp->xres;
+    npix = (fpix + npix <= ifp->xres) ? npix : ifp->xres - fpix;
 
   for (n = 0; n < all_cmps; n++)
     {
     size = *(ifp->def_cmps_sizes + n);
+    user_size = fl_user_comp_size(*(ifp->def_cmps_types + n));
     src = *((BYTE**)table + *(ifp->def_cmps_position + n));
     dest = (BYTE*)(beginning + *(ifp->def_cmps_offsets + n));
 
     if (fpix != -1)
       {
-      src += fpix * size;
+      src += fpix * user_size;
       dest += fpix * size;
       }
 
@@ -677,7 +1225,7 @@ int   dir;            /* meaning if fpix is set to -1.                     */
       case 's': memcpy(dest, src, npix * size);
 
                 if (swap_bytes == TRUE)
-                  swap_area(dest, npix, size);
+                  fl_swap_area(dest, npix, size);
            break;
       case 'f': if (float_conv == TRUE)
                   {
@@ -692,7 +1240,15 @@ int   dir;            /* meaning if fpix is set to -1.                     */
                   memcpy(dest, src, npix * size);
 
                 if (swap_bytes == TRUE)
-                  swap_area(dest, npix, size);
+                  fl_swap_area(dest, npix, size);
+           break;
+      case 'e':
+      case 'h': if (dir == 0)
+                  fl_narrow_values(dest, src, npix,
+                                   *(ifp->def_cmps_types + n), swap_bytes);
+                else
+                  fl_widen_values(dest, src, npix,
+                                  *(ifp->def_cmps_types + n), swap_bytes);
            break;
       default :
 #ifdef DEBUG
@@ -731,4 +1287,178 @@ int    out_format;                       /* output (required) format       */
 
   }
 
+/*--------------------------------------------------------------------------
+ * NAME         half_to_float
+ * PURPOSE      converts IEEE 754 half precision values to floats
+ * ARGUMENTS    dest         a pointer to floats
+ *              src          a pointer to 2-byte half values
+ *              amount       amount of values
+ *              swap_bytes   TRUE if bytes of half values are swapped
+ * RETURNS      None
+ * NOTE         Conversion is done by integer operations on the bits; both
+ *              variants are calculated and selected by masks, so the loop
+ *              body has no jumps and the compiler is able to vectorize it.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static VOID  half_to_float(dest, src, amount, swap_bytes)
+float  *dest;                 /* a pointer to floats                     */
+BYTE   *src;                  /* a pointer to half values                */
+int     amount;               /* amount of values                        */
+BOOL    swap_bytes;           /* TRUE if bytes are swapped               */
+  {
+  FP_BITS         o;          /* bits of the result                      */
+  FP_BITS         d;          /* bits of the denormal result             */
+  FP_BITS         magic;      /* 2^-14, the smallest normal half         */
+  unsigned short  half;       /* half value as stored                    */
+  unsigned int    h;          /* half value                              */
+  unsigned int    u;          /* bits of the normal result               */
+  unsigned int    exp;        /* exponent bits of the value              */
+  unsigned int    mask;       /* all ones to select the first variant    */
+  int             shift;      /* 8 if bytes are swapped, 0 otherwise     */
+  int             n;          /* an iteration counter                    */
+
+  magic.u = 113 << 23;
+  shift = (swap_bytes == TRUE) ? 8 : 0;
+  for (n = 0; n < amount; n++)
+    {
+    memcpy(&half, src + 2 * n, sizeof(half));       /* may be unaligned */
+    h = ((half << shift) | (half >> shift)) & 0xFFFF;   /* swap bytes */
+    exp = h & 0x7C00;
+    u = ((h & 0x7FFF) << 13) + ((127 - 15) << 23);   /* rebias exponent */
+    d.u = u + (1 << 23);                       /* zero, denormal          */
+    d.f -= magic.f;
+    mask = 0u - (unsigned int)(exp == 0x7C00);              /* Inf, NaN  */
+    u += ((128 - 16) << 23) & mask;
+    mask = 0u - (unsigned int)(exp == 0);
+    o.u = (d.u & mask) | (u & ~mask) | ((h & 0x8000) << 16);
+    dest[n] = o.f;
+    }
+  }
+
+/*--------------------------------------------------------------------------
+ * NAME         float_to_half
+ * PURPOSE      converts floats to IEEE 754 half precision values with
+ *              rounding to nearest even
+ * ARGUMENTS    dest         a pointer to 2-byte half values
+ *              src          a pointer to floats
+ *              amount       amount of values
+ *              swap_bytes   TRUE if bytes of half values have to be swapped
+ * RETURNS      None
+ * NOTE         Values too large for half become infinity; see also the note
+ *              to half_to_float().
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static VOID  float_to_half(dest, src, amount, swap_bytes)
+BYTE   *dest;                 /* a pointer to half values                */
+float  *src;                  /* a pointer to floats                     */
+int     amount;               /* amount of values                        */
+BOOL    swap_bytes;           /* TRUE if bytes have to be swapped        */
+  {
+  FP_BITS         f;          /* bits of the value                       */
+  FP_BITS         d;          /* denormal result in low bits             */
+  FP_BITS         magic;      /* moves denormal mantissa to low bits     */
+  unsigned short  half;       /* half value as stored                    */
+  unsigned int    u;          /* bits of the absolute value              */
+  unsigned int    sign;       /* sign bit of the value                   */
+  unsigned int    norm;       /* normal result                           */
+  unsigned int    h;          /* half value                              */
+  unsigned int    mask;       /* all ones to select the first variant    */
+  int             shift;      /* 8 if bytes are swapped, 0 otherwise     */
+  int             n;          /* an iteration counter                    */
+
+  magic.u = ((127 - 15) + (23 - 10) + 1) << 23;
+  shift = (swap_bytes == TRUE) ? 8 : 0;
+  for (n = 0; n < amount; n++)
+    {
+    f.f = src[n];
+    sign = f.u & 0x80000000;
+    u = f.u ^ sign;
+    f.u = u;
+    d.f = f.f + magic.f;                       /* denormal or zero        */
+    norm = (u + ((unsigned int)(15 - 127) << 23) + 0xFFF +
+            ((u >> 13) & 1)) >> 13;            /* round to nearest even   */
+    mask = 0u - (unsigned int)(u < (113 << 23));
+    h = ((d.u - magic.u) & mask) | (norm & ~mask);
+    mask = 0u - (unsigned int)(u >= ((127 + 16) << 23));    /* overflow  */
+    h = (0x7C00 & mask) | (h & ~mask);
+    mask = 0u - (unsigned int)(u > (255 << 23));             /* NaN       */
+    h = (0x7E00 & mask) | (h & ~mask);
+    h |= sign >> 16;
+    half = (unsigned short)((h << shift) | (h >> shift));  /* swap bytes */
+    memcpy(dest + 2 * n, &half, sizeof(half));      /* may be unaligned */
+    }
+  }
+
+/*--------------------------------------------------------------------------
+ * NAME         rgbe_to_float
+ * PURPOSE      converts colors in Ward's RGBE form (one byte of mantissa
+ *              for red, green and blue and common exponent byte) to floats
+ * ARGUMENTS    dest         a pointer to colors, three floats per color
+ *              src          a pointer to 4-byte RGBE colors
+ *              amount       amount of colors
+ * RETURNS      None
+ * NOTE         The same form is used by WardColor class of the SDK.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static VOID  rgbe_to_float(dest, src, amount)
+float  *dest;                 /* a pointer to colors                     */
+BYTE   *src;                  /* a pointer to RGBE colors                */
+int     amount;               /* amount of colors                        */
+  {
+  FP_BITS  scale;             /* 2^(exponent - 136)                      */
+  int      exp;               /* exponent byte                           */
+  int      n;                 /* an iteration counter                    */
+
+  for (n = 0; n < amount; n++)
+    {
+    exp = src[4 * n + 3];
+    scale.u = (exp > 9) ? (unsigned int)(exp - 9) << 23 : 0;
+    dest[3 * n]     = scale.f * src[4 * n];
+    dest[3 * n + 1] = scale.f * src[4 * n + 1];
+    dest[3 * n + 2] = scale.f * src[4 * n + 2];
+    }
+  }
+
+/*--------------------------------------------------------------------------
+ * NAME         float_to_rgbe
+ * PURPOSE      converts colors to Ward's RGBE form
+ * ARGUMENTS    dest         a pointer to 4-byte RGBE colors
+ *              src          a pointer to colors, three floats per color
+ *              amount       amount of colors
+ * RETURNS      None
+ * NOTE         Negative components are stored as 0. The exponent is taken
+ *              from the bits of the largest component instead of frexp().
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static VOID  float_to_rgbe(dest, src, amount)
+BYTE   *dest;                 /* a pointer to RGBE colors                */
+float  *src;                  /* a pointer to colors                     */
+int     amount;               /* amount of colors                        */
+  {
+  FP_BITS       max;          /* the largest component                   */
+  FP_BITS       scale;        /* 2^(134 - exponent of max)               */
+  float         r, g, b;      /* components of the color                 */
+  unsigned int  exp;          /* exponent bits of max                    */
+  int           n;            /* an iteration counter                    */
+
+  for (n = 0; n < amount; n++)
+    {
+    r = (src[3 * n] > 0.0f) ? src[3 * n] : 0.0f;         /* NaN too       */
+    g = (src[3 * n + 1] > 0.0f) ? src[3 * n + 1] : 0.0f;
+    b = (src[3 * n + 2] > 0.0f) ? src[3 * n + 2] : 0.0f;
+    r = (r < RGBE_MAX) ? r : RGBE_MAX;
+    g = (g < RGBE_MAX) ? g : RGBE_MAX;
+    b = (b < RGBE_MAX) ? b : RGBE_MAX;
+    max.f = (r > g) ? r : g;
+    max.f = (max.f > b) ? max.f : b;
+    exp = (max.u >> 23) & 0xFF;
+    scale.u = (261 - exp) << 23;
+    scale.f = (max.f < RGBE_MIN) ? 0.0f : scale.f;
+    dest[4 * n]     = (BYTE)(r * scale.f);
+    dest[4 * n + 1] = (BYTE)(g * scale.f);
+    dest[4 * n + 2] = (BYTE)(b * scale.f);
+    dest[4 * n + 3] = (BYTE)((max.f < RGBE_MIN) ? 0 : exp + 2);
+    }
+  }
+
 /*--------------------------- END OF MODULE -------------------------------*/
@@ -0,0 +1,409 @@
+/*
+ * MODULE NAME  IMG_COMP.C
+ * PURPOSE      lossless compression of tiles of IIF_FORMAT_TILE files.
+ *
+ * CODING                                             2026.10.18
+ * LAST UPDATED
+ *
+ * NOTE         Every component plane of the tile is compressed separately.
+ *              Before compression bytes of the values are regrouped: first
+ *              bytes of all values, then second bytes and so on (byte
+ *              planes), so nearly constant float layers give long runs of
+ *              equal bytes. Compressed tile is a sequence of component
+ *              planes in the file order, each one preceded by 8-byte
+ *              big-endian length of its data; the plane which does not
+ *              become shorter is stored as is (its length is equal to the
+ *              size of the plane).
+ *              zlib is used only if the library is built with IIF_HAVE_ZLIB
+ *              defined; otherwise compressed files can be neither written
+ *              nor read (IIFERR_NO_COMPRESS).
+ */
+
+/* CONDITIONAL COMPILATION SWITCHES */
+
+#define TEST  0  /* testing   switch */
+
+#include "integra.h"
+#ifdef IIF_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+/* COMPANY INCLUDES */
+
+#include "iifl.h"
+
+/* PROGRAM INCLUDES */
+
+#include "iifl_own.h"
+
+/* CONSTANTS */
+
+#define  PLANE_HEADER    8         /* size of component plane header       */
+#define  DEF_LEVEL       6         /* default compression level            */
+
+/* MACROS    */
+
+/* STATICS   */
+
+/* INTERFACE FUNCTIONS PROTOTYPES :
+
+int   iif_set_compression(IIF*, int, int);
+int   iif_get_compression(IIF*);
+*/
+
+/* LOCAL FUNCTIONS PROTOTYPES */
+
+#ifdef IIF_HAVE_ZLIB
+#ifndef NO_PROTOTYPES
+
+static   VOID  shuffle(BYTE*, BYTE*, long, int);
+static   VOID  unshuffle(BYTE*, BYTE*, long, int);
+static   VOID  put_length(BYTE*, INT64);
+static   INT64 get_length(BYTE*);
+
+#else
+
+static   VOID  shuffle();
+static   VOID  unshuffle();
+static   VOID  put_length();
+static   INT64 get_length();
+
+#endif
+#endif
+
+/*************************** CODE ******************************/
+
+/*==================== PUBLIC FUNCTIONS =============================*/
+
+/* --------------------------------------------------------------------------
+ * NAME         iif_set_compression
+ * PURPOSE      sets compression of tiles for new IIF_FORMAT_TILE file;
+ *              should be called before iif_init_file().
+ * ARGUMENTS    iflp         a pointer to IIF file opened for writing
+ *              method       IIF_COMPRESS_NONE or IIF_COMPRESS_ZLIB
+ *              level        compression level from 1 (fastest) to 9
+ *                           (smallest file); 0 selects the default one
+ * RETURNS      an error code; IIFERR_NO_COMPRESS if the library is built
+ *              without zlib.
+ * NOTE         Files of other formats are never compressed.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  iif_set_compression(iflp, method, level)
+IIF  *iflp;                                    /* a pointer to IIF file    */
+int   method;                                  /* compression method       */
+int   level;                                   /* compression level        */
+  {
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if (fl_check_iifstr_ptr(ifp) != IIF_OK)
+    {
+    IIF_errno = IIFERR_BAD_PTR;
+    return IIFERR_BAD_PTR;
+    }
+
+  if (ifp->attrib != 'w' || ifp->initialized == 1)
+    {
+    ifp->error = IIFERR_BAD_MODE;
+    return IIFERR_BAD_MODE;
+    }
+
+  if ((method != IIF_COMPRESS_NONE && method != IIF_COMPRESS_ZLIB) ||
+      level < 0 || level > 9)
+    {
+    ifp->error = IIFERR_BAD_PARMS;
+    return IIFERR_BAD_PARMS;
+    }
+
+#ifndef IIF_HAVE_ZLIB
+  if (method != IIF_COMPRESS_NONE)
+    {
+    ifp->error = IIFERR_NO_COMPRESS;
+    return IIFERR_NO_COMPRESS;
+    }
+#endif
+
+  ifp->compress = method;
+  ifp->comp_level = (level == 0) ? DEF_LEVEL : level;
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         iif_get_compression
+ * PURPOSE      retrieves compression method of tiles of the file.
+ * ARGUMENTS    iflp         a pointer to IIF file
+ * RETURNS      IIF_COMPRESS_NONE, IIF_COMPRESS_ZLIB or an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  iif_get_compression(iflp)
+IIF  *iflp;                                    /* a pointer to IIF file    */
+  {
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if (fl_check_iifstr_ptr(ifp) != IIF_OK)
+    {
+    IIF_errno = IIFERR_BAD_PTR;
+    return IIFERR_BAD_PTR;
+    }
+
+  if (ifp->format != IIF_FORMAT_TILE)
+    return IIF_COMPRESS_NONE;
+  return ifp->compress;
+  }
+
+/*==================== INTERFACE FUNCTIONS =============================*/
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_comp_bound
+ * PURPOSE      returns maximal size of compressed tile.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ * RETURNS      size of buffer for fl_comp_pack() in bytes.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+long  fl_comp_bound(ifp)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+  {
+  long bound;                                  /* size of the buffer       */
+  int  n;                                      /* component order number   */
+
+  bound = 0;
+  for (n = 0; n < (int)ifp->cmps_number; n++)
+#ifdef IIF_HAVE_ZLIB
+    bound += PLANE_HEADER + (long)compressBound(
+             (uLong)ifp->lcmps[n] * ifp->tile_w * ifp->tile_h);
+#else
+    bound += PLANE_HEADER + (long)ifp->lcmps[n] * ifp->tile_w * ifp->tile_h;
+#endif
+  return bound;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_comp_pack
+ * PURPOSE      compresses tile data in the file format.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              tile         tile data, tile_bytes
+ *              packed       a buffer of fl_comp_bound() size for the result
+ *              len          a pointer to size of the result
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  fl_comp_pack(ifp, tile, packed, len)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+BYTE  *tile;                                   /* tile data                */
+BYTE  *packed;                                 /* a buffer for the result  */
+long  *len;                                    /* size of the result       */
+  {
+#ifdef IIF_HAVE_ZLIB
+  BYTE  *planes;                  /* component plane split by bytes        */
+  BYTE  *dest;                    /* current position in the result        */
+  uLongf packed_len;              /* size of compressed plane              */
+  long   pixels;                  /* amount of pixels in tile              */
+  long   plane;                   /* size of component plane               */
+  int    size;                    /* a size of component (in bytes)        */
+  int    n;                       /* component order number                */
+
+  pixels = (long)ifp->tile_w * ifp->tile_h;
+  if ((planes = (BYTE *)malloc(pixels * 8)) == NULL)
+    return IIFERR_NO_MEM;
+
+  dest = packed;
+  for (n = 0; n < (int)ifp->cmps_number; n++)
+    {
+    size = ifp->lcmps[n];
+    plane = pixels * size;
+    shuffle(planes, tile, pixels, size);
+    packed_len = compressBound((uLong)plane);
+    if (compress2(dest + PLANE_HEADER, &packed_len, planes, (uLong)plane,
+                  ifp->comp_level) != Z_OK)
+      {
+      free(planes);
+      return IIFERR_NO_MEM;
+      }
+    if ((long)packed_len >= plane)            /* store the plane as is     */
+      {
+      memcpy(dest + PLANE_HEADER, tile, plane);
+      packed_len = (uLongf)plane;
+      }
+    put_length(dest, (INT64)packed_len);
+    dest += PLANE_HEADER + packed_len;
+    tile += plane;
+    }
+
+  free(planes);
+  *len = (long)(dest - packed);
+  return IIF_OK;
+#else
+  return IIFERR_NO_COMPRESS;
+#endif
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_comp_unpack
+ * PURPOSE      decompresses tile data packed by fl_comp_pack().
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              packed       compressed tile
+ *              len          size of compressed tile
+ *              tile         a buffer of tile_bytes size for the result
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  fl_comp_unpack(ifp, packed, len, tile)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+BYTE  *packed;                                 /* compressed tile          */
+long   len;                                    /* size of compressed tile  */
+BYTE  *tile;                                   /* a buffer for the result  */
+  {
+#ifdef IIF_HAVE_ZLIB
+  BYTE  *planes;                  /* component plane split by bytes        */
+  BYTE  *end;                     /* end of compressed tile                */
+  INT64  packed_len;              /* size of compressed plane              */
+  uLongf plane_len;               /* size of decompressed plane            */
+  long   pixels;                  /* amount of pixels in tile              */
+  long   plane;                   /* size of component plane               */
+  int    size;                    /* a size of component (in bytes)        */
+  int    n;                       /* component order number                */
+
+  pixels = (long)ifp->tile_w * ifp->tile_h;
+  if ((planes = (BYTE *)malloc(pixels * 8)) == NULL)
+    return IIFERR_NO_MEM;
+
+  end = packed + len;
+  for (n = 0; n < (int)ifp->cmps_number; n++)
+    {
+    size = ifp->lcmps[n];
+    plane = pixels * size;
+    if (end - packed < PLANE_HEADER)
+      break;
+    packed_len = get_length(packed);
+    packed += PLANE_HEADER;
+    if (packed_len > end - packed)
+      break;
+    if (packed_len == plane)                  /* plane is stored as is     */
+      memcpy(tile, packed, plane);
+    else
+      {
+      plane_len = (uLongf)plane;
+      if (uncompress(planes, &plane_len, packed, (uLong)packed_len) !=
+          Z_OK || plane_len != (uLongf)plane)
+        break;
+      unshuffle(tile, planes, pixels, size);
+      }
+    packed += packed_len;
+    tile += plane;
+    }
+
+  free(planes);
+  return (n == (int)ifp->cmps_number) ? IIF_OK : IIFERR_BAD_FILE;
+#else
+  return IIFERR_NO_COMPRESS;
+#endif
+  }
+
+/*========================= LOCAL FUNCTIONS ==============================*/
+
+#ifdef IIF_HAVE_ZLIB
+
+/* --------------------------------------------------------------------------
+ * NAME         shuffle
+ * PURPOSE      splits values of component plane into byte planes.
+ * ARGUMENTS    dest         a buffer for the result
+ *              src          component plane
+ *              pixels       amount of values
+ *              size         a size of component (in bytes)
+ * RETURNS      None
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static VOID  shuffle(dest, src, pixels, size)
+BYTE  *dest;                                   /* a buffer for the result  */
+BYTE  *src;                                    /* component plane          */
+long   pixels;                                 /* amount of values         */
+int    size;                                   /* a size of component      */
+  {
+  long i;                                      /* value number             */
+  int  k;                                      /* byte number              */
+
+  if (size == 1)
+    {
+    memcpy(dest, src, pixels);
+    return;
+    }
+  for (k = 0; k < size; k++, dest += pixels)
+    for (i = 0; i < pixels; i++)
+      dest[i] = src[i * size + k];
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         unshuffle
+ * PURPOSE      joins byte planes into values of component plane.
+ * ARGUMENTS    dest         a buffer for component plane
+ *              src          byte planes
+ *              pixels       amount of values
+ *              size         a size of component (in bytes)
+ * RETURNS      None
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static VOID  unshuffle(dest, src, pixels, size)
+BYTE  *dest;                                   /* a buffer for the result  */
+BYTE  *src;                                    /* byte planes              */
+long   pixels;                                 /* amount of values         */
+int    size;                                   /* a size of component      */
+  {
+  long i;                                      /* value number             */
+  int  k;                                      /* byte number              */
+
+  if (size == 1)
+    {
+    memcpy(dest, src, pixels);
+    return;
+    }
+  for (k = 0; k < size; k++, src += pixels)
+    for (i = 0; i < pixels; i++)
+      dest[i * size + k] = src[i];
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         put_length
+ * PURPOSE      stores 8-byte length in big-endian order.
+ * ARGUMENTS    buffer       a pointer to 8 bytes area
+ *              value        a value to store
+ * RETURNS      None
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static VOID  put_length(buffer, value)
+BYTE  *buffer;                                 /* a pointer to 8 bytes     */
+INT64  value;                                  /* a value to store         */
+  {
+  int n;                                       /* an iteration counter     */
+
+  for (n = 7; n >= 0; n--)
+    {
+    buffer[n] = (BYTE)(value & 0xFF);
+    value >>= 8;
+    }
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         get_length
+ * PURPOSE      retrieves 8-byte length stored in big-endian order.
+ * ARGUMENTS    buffer       a pointer to 8 bytes area
+ * RETURNS      the value.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static INT64  get_length(buffer)
+BYTE  *buffer;                                 /* a pointer to 8 bytes     */
+  {
+  INT64 value;                                 /* retrieved value          */
+  int   n;                                     /* an iteration counter     */
+
+  value = 0;
+  for (n = 0; n < 8; n++)
+    value = (value << 8) | buffer[n];
+  return value;
+  }
+
+#endif
+
+/*--------------------------- END OF MODULE -------------------------------*/
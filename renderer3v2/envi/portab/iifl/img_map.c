@@ -0,0 +1,334 @@
+/*
+ * MODULE NAME  IMG_MAP.C
+ * PURPOSE      random access to image data of IIF file mapped into memory.
+ *
+ * CODING                                             2026.10.18
+ * LAST UPDATED
+ *
+ * NOTE         The whole file is mapped read-only; the pages of the image
+ *              area are loaded by the system only when they are touched, so
+ *              reading a small region of a large file does not read the rest
+ *              of it. The lines buffer of the file is not used at all.
+ */
+
+/* CONDITIONAL COMPILATION SWITCHES */
+
+#define TEST  0  /* testing   switch */
+
+#ifdef TIPE
+#undef TIPE
+#endif
+
+#if (OS_MARK == 'I')
+#include <windows.h>
+#include <io.h>
+#endif
+
+#include "integra.h"
+
+#if (OS_MARK != 'I')
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+/* COMPANY INCLUDES */
+
+#include "iifl.h"
+
+/* PROGRAM INCLUDES */
+
+#include "iifl_own.h"
+
+/* CONSTANTS */
+
+/* MACROS    */
+
+/* STATICS   */
+
+/* INTERFACE FUNCTIONS PROTOTYPES :
+
+int   iif_map(IIF*);
+int   iif_unmap(IIF*);
+VPTR  iif_map_line(IIF*, int, int);
+*/
+
+/* LOCAL FUNCTIONS PROTOTYPES */
+
+#ifndef NO_PROTOTYPES
+
+static   int  map_file(IIFL*, INT64);
+
+#else
+
+static   int  map_file();
+
+#endif
+
+/*************************** CODE ******************************/
+
+/*==================== PUBLIC FUNCTIONS =============================*/
+
+/* --------------------------------------------------------------------------
+ * NAME         iif_map
+ * PURPOSE      maps image file opened for reading into memory; after the
+ *              call iif_read_line() takes data directly from the mapping
+ *              and iif_map_line() may be used.
+ * ARGUMENTS    iflp         a pointer to IIF file opened for reading
+ * RETURNS      an error code; if the mapping failed, the file is still
+ *              accessible through the lines buffer.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  iif_map(iflp)
+IIF  *iflp;                                    /* a pointer to IIF file    */
+  {
+  INT64  map_size;                   /* size of file area to be mapped     */
+  int    err;                                             /* an error code */
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if (fl_check_iifstr_ptr(ifp) != IIF_OK)
+    {
+    IIF_errno = IIFERR_BAD_PTR;
+    return IIFERR_BAD_PTR;
+    }
+
+  if (ifp->attrib != 'r')
+    {
+    ifp->error = IIFERR_BAD_MODE;
+    return IIFERR_BAD_MODE;
+    }
+
+  if (ifp->initialized != 1)
+    {
+    ifp->error = IIFERR_NOT_INIT;
+    return IIFERR_NOT_INIT;
+    }
+
+  if (ifp->format != IIF_FORMAT_IIFF)
+    {
+    ifp->error = IIFERR_BAD_FORMAT;
+    return IIFERR_BAD_FORMAT;
+    }
+
+  if (ifp->map_base != NULL)
+    return IIF_OK;                                   /* already mapped */
+
+  map_size = ifp->image_area_offs +
+             (INT64)fl_get_comp_offset(ifp, (int)ifp->cmps_number) *
+             ifp->yres;
+
+  if ((err = map_file(ifp, map_size)) != IIF_OK)
+    {
+    ifp->error = err;
+    return err;
+    }
+
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         iif_unmap
+ * PURPOSE      releases the mapping set by iif_map(); the following reads
+ *              go through the lines buffer again.
+ * ARGUMENTS    iflp         a pointer to IIF file
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  iif_unmap(iflp)
+IIF  *iflp;                                    /* a pointer to IIF file    */
+  {
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if (fl_check_iifstr_ptr(ifp) != IIF_OK)
+    {
+    IIF_errno = IIFERR_BAD_PTR;
+    return IIFERR_BAD_PTR;
+    }
+
+  fl_unmap(ifp);
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         iif_map_line
+ * PURPOSE      returns a pointer to data of one component of image line in
+ *              the mapped file; no data are copied.
+ * ARGUMENTS    iflp         a pointer to mapped IIF file
+ *              y            line number
+ *              cmp          an order number of component in the file (as in
+ *                           the string returned by iif_get_components)
+ * RETURNS      a pointer to 'xres' values of the component; they must not
+ *              be modified and are valid until the file is unmapped or
+ *              closed. NULL is returned if the file is not mapped
+ *              (IIFERR_NOT_MAPPED) or if the values stored in the file need
+ *              byte swapping or floating point conversion (IIFWARN_CONVERT);
+ *              iif_read_line() should be used in the latter case.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+VPTR  iif_map_line(iflp, y, cmp)
+IIF  *iflp;                                    /* a pointer to IIF file    */
+int   y;                                       /* line number              */
+int   cmp;                                     /* component order number   */
+  {
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if (fl_check_iifstr_ptr(ifp) != IIF_OK)
+    {
+    IIF_errno = IIFERR_BAD_PTR;
+    return NULL;
+    }
+
+  if (ifp->map_base == NULL)
+    {
+    ifp->error = IIFERR_NOT_MAPPED;
+    return NULL;
+    }
+
+  if (y < 0 || y > ifp->yres - 1)
+    {
+    ifp->error = IIFERR_BAD_ORG;
+    return NULL;
+    }
+
+  if (cmp < 0 || cmp > (int)ifp->cmps_number - 1)
+    {
+    ifp->error = IIFERR_BAD_PARMS;
+    return NULL;
+    }
+
+  switch (ifp->types[cmp])
+    {
+    case 'a':
+    case 'b': break;
+    case 'd':
+    case 'l':
+    case 's': if (fl_swap_needed(ifp) == TRUE)
+                {
+                ifp->error = IIFWARN_CONVERT;
+                return NULL;
+                }
+         break;
+    case 'f': if (fl_swap_needed(ifp) == TRUE ||
+                  fl_get_float_ver(ifp) != IIF_os_fp_format)
+                {
+                ifp->error = IIFWARN_CONVERT;
+                return NULL;
+                }
+         break;
+    default : ifp->error = IIFWARN_CONVERT;
+         return NULL;
+    }
+
+  return (VPTR)(fl_map_line(ifp, y) + fl_get_comp_offset(ifp, cmp));
+  }
+
+/*==================== INTERFACE FUNCTIONS =============================*/
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_map_line
+ * PURPOSE      returns address of image line in the mapped file.
+ * ARGUMENTS    ifp          a pointer to mapped IIF file
+ *              y            line number
+ * RETURNS      a pointer to the first byte of the line.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+BYTE  *fl_map_line(ifp, y)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+int    y;                                      /* line number              */
+  {
+  return ifp->map_base + ifp->image_area_offs +
+         (INT64)fl_get_comp_offset(ifp, (int)ifp->cmps_number) * y;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_unmap
+ * PURPOSE      releases the mapping of the file (if any).
+ * ARGUMENTS    ifp          a pointer to IIF file
+ * RETURNS      None
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+VOID  fl_unmap(ifp)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+  {
+  if (ifp->map_base == NULL)
+    return;
+#if (OS_MARK == 'I')
+  UnmapViewOfFile(ifp->map_base);
+  CloseHandle((HANDLE)ifp->map_handle);
+#else
+  munmap((void *)ifp->map_base, (size_t)ifp->map_size);
+#endif
+  ifp->map_base = NULL;
+  ifp->map_handle = NULL;
+  ifp->map_size = 0;
+  }
+
+/*========================= LOCAL FUNCTIONS ==============================*/
+
+/* --------------------------------------------------------------------------
+ * NAME         map_file
+ * PURPOSE      maps beginning of the file into memory for reading.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              size         amount of bytes to map
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static int  map_file(ifp, size)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+INT64  size;                                   /* amount of bytes to map   */
+  {
+#if (OS_MARK == 'I')
+  HANDLE         file;                         /* system file handle       */
+  HANDLE         mapping;                      /* file mapping object      */
+  LARGE_INTEGER  file_size;                    /* actual size of the file  */
+  VPTR           base;                         /* address of the mapping   */
+
+  file = (HANDLE)_get_osfhandle(_fileno(ifp->file_handle));
+  if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &file_size))
+    return IIFERR_BAD_DISK;
+  if (file_size.QuadPart < size)
+    return IIFERR_EOF;
+  if ((SIZE_T)size != size)
+    return IIFERR_NO_MEM;          /* does not fit 32-bit address space */
+
+  mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mapping == NULL)
+    return IIFERR_BAD_DISK;
+  if ((base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, (SIZE_T)size)) ==
+      NULL)
+    {
+    CloseHandle(mapping);
+    return IIFERR_NO_MEM;
+    }
+  ifp->map_handle = (VPTR)mapping;
+#else
+  int          file;                           /* system file descriptor   */
+  struct stat  st;                             /* file status              */
+  VPTR         base;                           /* address of the mapping   */
+
+  file = fileno(ifp->file_handle);
+  if (fstat(file, &st) != 0)
+    return IIFERR_BAD_DISK;
+  if ((INT64)st.st_size < size)
+    return IIFERR_EOF;
+  if ((INT64)(size_t)size != size)
+    return IIFERR_NO_MEM;          /* does not fit 32-bit address space */
+
+  base = (VPTR)mmap(NULL, (size_t)size, PROT_READ, MAP_SHARED, file, 0);
+  if (base == (VPTR)MAP_FAILED)
+    return IIFERR_NO_MEM;
+  ifp->map_handle = NULL;
+#endif
+
+  ifp->map_base = (BYTE *)base;
+  ifp->map_size = size;
+  return IIF_OK;
+  }
+
+/*--------------------------- END OF MODULE -------------------------------*/
@@ -0,0 +1,1013 @@
+/*
+ * MODULE NAME  IMG_TILE.C
+ * PURPOSE      access to image data of IIF files stored by tiles
+ *              (IIF_FORMAT_TILE).
+ *
+ * CODING                                             2026.10.18
+ * LAST UPDATED
+ *
+ * NOTE         The file has the same header and variables areas as
+ *              IIF_FORMAT_IIFF one. The image area starts with the tile
+ *              index followed by the tiles. The index holds for every tile
+ *              (left to right, top to bottom) its offset in the file and
+ *              the length of stored data, both as 8-byte big-endian
+ *              values; the offset of unwritten tile is 0. One more entry
+ *              keeps the end of the tiles area. Every tile has the place of
+ *              full size tile_w x tile_h pixels (edge tiles too); inside the
+ *              tile components follow in the file order, each one as
+ *              tile_h rows of tile_w values.
+ *
+ *              Tiles of compressed files (see img_comp.c) have no fixed
+ *              places: every written tile is appended to the end of the
+ *              tiles area, and the index keeps its actual length.
+ *
+ *              Tiles are written and read by positional i/o, which does not
+ *              touch the file position and the lines buffer, so different
+ *              threads may call iif_write_tile() / iif_read_tile() for the
+ *              same file at the same time (for different tiles, when
+ *              writing). Reading by lines decompresses the tiles of one row
+ *              by several threads.
+ */
+
+/* CONDITIONAL COMPILATION SWITCHES */
+
+#define TEST  0  /* testing   switch */
+
+#ifdef TIPE
+#undef TIPE
+#endif
+
+#if (OS_MARK == 'I')
+#include <windows.h>
+#include <io.h>
+#endif
+
+#include "integra.h"
+
+#if (OS_MARK != 'I')
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#endif
+
+/* COMPANY INCLUDES */
+
+#include "iifl.h"
+
+/* PROGRAM INCLUDES */
+
+#include "iifl_own.h"
+
+/* CONSTANTS */
+
+#define  TILE_SIZE_LIMIT    4096   /* maximal width or height of tile      */
+#define  MAX_ROW_THREADS    16     /* maximal amount of threads reading row */
+
+/* TYPES     */
+
+typedef struct                     /* part of tile row read by one thread  */
+  {
+  IIFL  *ifp;                      /* a pointer to IIF file                */
+  int    first;                    /* first line in the lines buffer       */
+  int    number;                   /* amount of lines in the lines buffer  */
+  int    ty;                       /* row of tiles                         */
+  int    tx;                       /* first column of tiles                */
+  int    step;                     /* distance between the columns         */
+  int    err;                      /* an error code                        */
+  }ROW_PART;
+
+/* MACROS    */
+
+/* STATICS   */
+
+/* INTERFACE FUNCTIONS PROTOTYPES :
+
+int   iif_set_tile_size(IIF*, int, int);
+int   iif_get_tile_size(IIF*, int*, int*);
+int   iif_write_tile(IIF*, VPTR, int, int);
+int   iif_read_tile(IIF*, VPTR, int, int);
+*/
+
+/* LOCAL FUNCTIONS PROTOTYPES */
+
+#ifndef NO_PROTOTYPES
+
+static   int   check_tile(IIFL*, VPTR, int, int);
+static   int   read_tile(IIFL*, BYTE*, int);
+static   int   read_row(IIFL*, int, int, int);
+static   VOID  read_row_part(ROW_PART*);
+#if (OS_MARK == 'I')
+static   DWORD WINAPI row_thread(LPVOID);
+#else
+static   void *row_thread(void*);
+#endif
+static   VOID  copy_tile_lines(IIFL*, BYTE*, int, int, int, int);
+static   int   threads_amount(VOID);
+static   INT64 reserve_space(IIFL*, long);
+static   int   get_comp_num(IIFL*, int);
+static   long  plane_offset(IIFL*, int);
+static   VOID  put_int64(BYTE*, INT64);
+static   INT64 get_int64(BYTE*);
+
+#else
+
+static   int   check_tile();
+static   int   read_tile();
+static   int   read_row();
+static   VOID  read_row_part();
+#if (OS_MARK == 'I')
+static   DWORD WINAPI row_thread();
+#else
+static   void *row_thread();
+#endif
+static   VOID  copy_tile_lines();
+static   int   threads_amount();
+static   INT64 reserve_space();
+static   int   get_comp_num();
+static   long  plane_offset();
+static   VOID  put_int64();
+static   INT64 get_int64();
+
+#endif
+
+/*************************** CODE ******************************/
+
+/*==================== PUBLIC FUNCTIONS =============================*/
+
+/* --------------------------------------------------------------------------
+ * NAME         iif_set_tile_size
+ * PURPOSE      sets size of tiles for new IIF_FORMAT_TILE file; should be
+ *              called before iif_init_file().
+ * ARGUMENTS    iflp         a pointer to IIF file opened for writing
+ *              w            width of tile in pixels
+ *              h            height of tile in pixels
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  iif_set_tile_size(iflp, w, h)
+IIF  *iflp;                                    /* a pointer to IIF file    */
+int   w;                                       /* width of tile            */
+int   h;                                       /* height of tile           */
+  {
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if (fl_check_iifstr_ptr(ifp) != IIF_OK)
+    {
+    IIF_errno = IIFERR_BAD_PTR;
+    return IIFERR_BAD_PTR;
+    }
+
+  if (ifp->attrib != 'w' || ifp->initialized == 1)
+    {
+    ifp->error = IIFERR_BAD_MODE;
+    return IIFERR_BAD_MODE;
+    }
+
+  if (w <= 0 || h <= 0 || w > TILE_SIZE_LIMIT || h > TILE_SIZE_LIMIT)
+    {
+    ifp->error = IIFERR_BAD_PARMS;
+    return IIFERR_BAD_PARMS;
+    }
+
+  ifp->tile_w = w;
+  ifp->tile_h = h;
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         iif_get_tile_size
+ * PURPOSE      retrieves size of tiles of IIF_FORMAT_TILE file.
+ * ARGUMENTS    iflp         a pointer to IIF file
+ *              w            a pointer to tile width
+ *              h            a pointer to tile height
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  iif_get_tile_size(iflp, w, h)
+IIF  *iflp;                                    /* a pointer to IIF file    */
+int  *w;                                       /* a pointer to tile width  */
+int  *h;                                       /* a pointer to tile height */
+  {
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if (fl_check_iifstr_ptr(ifp) != IIF_OK)
+    {
+    IIF_errno = IIFERR_BAD_PTR;
+    return IIFERR_BAD_PTR;
+    }
+
+  if (w == NULL || h == NULL)
+    {
+    ifp->error = IIFERR_BAD_PARMS;
+    return IIFERR_BAD_PARMS;
+    }
+
+  if (ifp->format != IIF_FORMAT_TILE)
+    {
+    ifp->error = IIFERR_BAD_FORMAT;
+    return IIFERR_BAD_FORMAT;
+    }
+
+  *w = ifp->tile_w;
+  *h = ifp->tile_h;
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         iif_write_tile
+ * PURPOSE      writes one tile to IIF_FORMAT_TILE file.
+ * ARGUMENTS    iflp         a pointer to IIF file
+ *              table        a pointer to table with buffer addresses with
+ *                           data, one buffer of tile_w * tile_h values for
+ *                           every defined component (see iif_def_components);
+ *                           values of 'h' and 'e' components are floats
+ *              tx           column of tile (x / tile_w)
+ *              ty           row of tile (y / tile_h)
+ * RETURNS      an error code.
+ * NOTE         Components not defined by iif_def_components() are written
+ *              as zeros. Pixels of edge tiles outside the image are stored
+ *              as well, but never read. In compressed file the space of
+ *              the tile written once more is not reused.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  iif_write_tile(iflp, table, tx, ty)
+IIF  *iflp;          /* a pointer to opened IIF file                       */
+VPTR  table;         /* a pointer to table with buffer addresses with data */
+int   tx;            /* column of tile                                     */
+int   ty;            /* row of tile                                        */
+  {
+  BYTE  *tile;                    /* tile data in file format              */
+  BYTE  *dest;                    /* beginning of component plane in tile  */
+  BYTE  *packed;                  /* compressed tile data                  */
+  BOOL   swap_bytes;              /* flag; TRUE if byte swapping is needed */
+  INT64  offs;                    /* offset of tile in the file            */
+  long   len;                     /* size of stored tile data              */
+  int    pixels;                  /* amount of pixels in tile              */
+  int    num;                     /* component order number in the file    */
+  int    size;                    /* a size of component (in bytes)        */
+  int    n;                       /* an iteration counter                  */
+  int    err;                                             /* an error code */
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if ((err = check_tile(ifp, table, tx, ty)) != IIF_OK)
+    return err;
+
+  if (ifp->attrib == 'r')
+    {
+    ifp->error = IIFERR_BAD_MODE;
+    return IIFERR_BAD_MODE;
+    }
+
+  if ((tile = (BYTE *)calloc(1, ifp->tile_bytes)) == NULL)
+    {
+    ifp->error = IIFERR_NO_MEM;
+    return IIFERR_NO_MEM;
+    }
+
+  swap_bytes = fl_swap_needed(ifp);
+  pixels = ifp->tile_w * ifp->tile_h;
+  for (n = 0; n < (int)ifp->def_cmps_amount; n++)
+    {
+    num = get_comp_num(ifp, n);
+    size = ifp->lcmps[num];
+    dest = tile + plane_offset(ifp, num);
+    if (ifp->types[num] == 'h' || ifp->types[num] == 'e')
+      {
+      fl_narrow_values(dest, *((BYTE**)table + ifp->def_cmps_position[n]),
+                       pixels, ifp->types[num], swap_bytes);
+      continue;
+      }
+    memcpy(dest, *((BYTE**)table + ifp->def_cmps_position[n]),
+           (size_t)pixels * size);
+    if (swap_bytes == TRUE && size > 1)
+      fl_swap_area(dest, pixels, size);
+    }
+
+  n = ty * ifp->tiles_x + tx;
+  if (ifp->compress == IIF_COMPRESS_NONE)
+    {
+    len = ifp->tile_bytes;
+    offs = ifp->image_area_offs + fl_tile_index_size(ifp) +
+           (INT64)ifp->tile_bytes * n;
+    err = fl_file_io(ifp, tile, len, offs, 1);
+    }
+  else if ((packed = (BYTE *)malloc(fl_comp_bound(ifp))) == NULL)
+    err = IIFERR_NO_MEM;
+  else
+    {
+    if ((err = fl_comp_pack(ifp, tile, packed, &len)) == IIF_OK)
+      {
+      offs = reserve_space(ifp, len);
+      err = fl_file_io(ifp, packed, len, offs, 1);
+      }
+    free(packed);
+    }
+  free(tile);
+  if (err != IIF_OK)
+    {
+    ifp->error = err;
+    return err;
+    }
+
+  ifp->tile_index[2 * n + 1] = len;
+  ifp->tile_index[2 * n] = offs;
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         iif_read_tile
+ * PURPOSE      reads one tile of IIF_FORMAT_TILE file.
+ * ARGUMENTS    iflp         a pointer to IIF file
+ *              table        a pointer to table with buffer addresses for
+ *                           data, one buffer of tile_w * tile_h values for
+ *                           every defined component (see iif_def_components);
+ *                           values of 'h' and 'e' components are floats
+ *              tx           column of tile (x / tile_w)
+ *              ty           row of tile (y / tile_h)
+ * RETURNS      an error code. Tile which was not written is read as zeros.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  iif_read_tile(iflp, table, tx, ty)
+IIF  *iflp;          /* a pointer to opened IIF file                       */
+VPTR  table;         /* a pointer to table with buffer addresses for data  */
+int   tx;            /* column of tile                                     */
+int   ty;            /* row of tile                                        */
+  {
+  BYTE  *tile;                    /* tile data in file format              */
+  BYTE  *dest;                    /* user's buffer of the component        */
+  BOOL   swap_bytes;              /* flag; TRUE if byte swapping is needed */
+  int    pixels;                  /* amount of pixels in tile              */
+  int    num;                     /* component order number in the file    */
+  int    size;                    /* a size of component (in bytes)        */
+  int    n;                       /* an iteration counter                  */
+  int    err;                                             /* an error code */
+  IIFL  *ifp;                               /* a pointer to IIFL structure */
+
+  ifp = (IIFL *)iflp;
+
+  if ((err = check_tile(ifp, table, tx, ty)) != IIF_OK)
+    return err;
+
+  if (ifp->attrib == 'w')
+    {
+    ifp->error = IIFERR_BAD_MODE;
+    return IIFERR_BAD_MODE;
+    }
+
+  if ((tile = (BYTE *)malloc(ifp->tile_bytes)) == NULL)
+    {
+    ifp->error = IIFERR_NO_MEM;
+    return IIFERR_NO_MEM;
+    }
+
+  if ((err = read_tile(ifp, tile, ty * ifp->tiles_x + tx)) != IIF_OK)
+    {
+    free(tile);
+    ifp->error = err;
+    return err;
+    }
+
+  swap_bytes = fl_swap_needed(ifp);
+  pixels = ifp->tile_w * ifp->tile_h;
+  for (n = 0; n < (int)ifp->def_cmps_amount; n++)
+    {
+    num = get_comp_num(ifp, n);
+    size = ifp->lcmps[num];
+    dest = *((BYTE**)table + ifp->def_cmps_position[n]);
+    if (ifp->types[num] == 'h' || ifp->types[num] == 'e')
+      {
+      fl_widen_values(dest, tile + plane_offset(ifp, num), pixels,
+                      ifp->types[num], swap_bytes);
+      continue;
+      }
+    memcpy(dest, tile + plane_offset(ifp, num), (size_t)pixels * size);
+    if (swap_bytes == TRUE && size > 1)
+      fl_swap_area(dest, pixels, size);
+    }
+
+  free(tile);
+  return IIF_OK;
+  }
+
+/*==================== INTERFACE FUNCTIONS =============================*/
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_tile_init
+ * PURPOSE      calculates tiles layout of IIF_FORMAT_TILE file and
+ *              allocates the tile index; for new files all tiles are
+ *              marked as not written.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  fl_tile_init(ifp)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+  {
+  int  tiles;                                  /* amount of tiles          */
+
+  if (ifp->tile_w <= 0 || ifp->tile_h <= 0)
+    return IIFERR_BAD_FILE;
+
+  ifp->tiles_x = (ifp->xres + ifp->tile_w - 1) / ifp->tile_w;
+  ifp->tiles_y = (ifp->yres + ifp->tile_h - 1) / ifp->tile_h;
+  ifp->tile_bytes = plane_offset(ifp, (int)ifp->cmps_number);
+  tiles = ifp->tiles_x * ifp->tiles_y;
+
+  if (ifp->tile_index != NULL)
+    free(ifp->tile_index);
+  if ((ifp->tile_index = (INT64 *)calloc(2 * (tiles + 1), sizeof(INT64))) ==
+      NULL)
+    return IIFERR_NO_MEM;
+
+  ifp->tile_index[2 * tiles] = ifp->image_area_offs +
+                               fl_tile_index_size(ifp);
+  if (ifp->compress == IIF_COMPRESS_NONE)
+    ifp->tile_index[2 * tiles] += (INT64)ifp->tile_bytes * tiles;
+
+  fflush(ifp->file_handle);      /* header must precede positional i/o */
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_tile_index_size
+ * PURPOSE      returns size of the tile index in the file.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ * RETURNS      size of the index in bytes.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+long  fl_tile_index_size(ifp)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+  {
+  return (long)(ifp->tiles_x * ifp->tiles_y + 1) * TILE_INDEX_ENTRY;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_tile_read_index
+ * PURPOSE      reads the tile index from the file.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  fl_tile_read_index(ifp)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+  {
+  BYTE  *buff;                                 /* index in file format     */
+  long   len;                                  /* size of the index        */
+  int    n;                                    /* an iteration counter     */
+  int    err;                                  /* an error code            */
+
+  if ((err = fl_tile_init(ifp)) != IIF_OK)
+    return err;
+
+  len = fl_tile_index_size(ifp);
+  if ((buff = (BYTE *)malloc(len)) == NULL)
+    return IIFERR_NO_MEM;
+
+  if ((err = fl_file_io(ifp, buff, len, (INT64)ifp->image_area_offs, 0)) !=
+      IIF_OK)
+    {
+    free(buff);
+    return err;
+    }
+
+  for (n = 0; n < 2 * (ifp->tiles_x * ifp->tiles_y + 1); n++)
+    ifp->tile_index[n] = get_int64(buff + 8 * n);
+
+  free(buff);
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_tile_write_index
+ * PURPOSE      writes the tile index to the file.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  fl_tile_write_index(ifp)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+  {
+  BYTE  *buff;                                 /* index in file format     */
+  long   len;                                  /* size of the index        */
+  int    n;                                    /* an iteration counter     */
+  int    err;                                  /* an error code            */
+
+  len = fl_tile_index_size(ifp);
+  if ((buff = (BYTE *)malloc(len)) == NULL)
+    return IIFERR_NO_MEM;
+
+  for (n = 0; n < 2 * (ifp->tiles_x * ifp->tiles_y + 1); n++)
+    put_int64(buff + 8 * n, ifp->tile_index[n]);
+
+  fflush(ifp->file_handle);
+  err = fl_file_io(ifp, buff, len, (INT64)ifp->image_area_offs, 1);
+  free(buff);
+  return err;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_tile_read_lines
+ * PURPOSE      reads 'number' lines of IIF_FORMAT_TILE file to the lines
+ *              buffer, beginning from line 'first'; data are kept in the
+ *              file format, as for IIF_FORMAT_IIFF files.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              first        first line that should be placed in buffer
+ *              number       amount of lines to read
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  fl_tile_read_lines(ifp, first, number)
+IIFL  *ifp;                  /* a pointer to IIF  file.                    */
+int   first;                 /* first line that should be placed in buffer */
+int   number;                /* amount of lines to read.                   */
+  {
+  int  ty;                                     /* tile row                 */
+  int  err;                                    /* an error code            */
+
+  for (ty = first / ifp->tile_h;
+       ty <= (first + number - 1) / ifp->tile_h; ty++)
+    if ((err = read_row(ifp, first, number, ty)) != IIF_OK)
+      return err;
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_file_io
+ * PURPOSE      reads or writes data at given position of the file.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              buffer       a buffer with data
+ *              len          amount of bytes
+ *              offs         position in the file
+ *              dir          0 - read, 1 - write
+ * RETURNS      an error code.
+ * NOTE         On Windows ReadFile/WriteFile with offset move the pointer
+ *              of the (synchronous) file handle, therefore the stream is
+ *              flushed before the i/o and positioned after the data by
+ *              os_fseek, so later fread/fwrite do not work with a stale
+ *              stream buffer. pread/pwrite do not move the file pointer.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+int  fl_file_io(ifp, buffer, len, offs, dir)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+BYTE  *buffer;                                 /* a buffer with data       */
+long   len;                                    /* amount of bytes          */
+INT64  offs;                                   /* position in the file     */
+int    dir;                                    /* 0 - read, 1 - write      */
+  {
+#if (OS_MARK == 'I')
+  HANDLE      file;                            /* system file handle       */
+  OVERLAPPED  ov;                              /* position of i/o          */
+  DWORD       done;                            /* amount of bytes done     */
+  BOOL        ok;                              /* result of i/o            */
+
+  fflush(ifp->file_handle);      /* buffered data go to their position */
+  file = (HANDLE)_get_osfhandle(_fileno(ifp->file_handle));
+  memset(&ov, 0, sizeof(ov));
+  ov.Offset = (DWORD)(offs & 0xFFFFFFFF);
+  ov.OffsetHigh = (DWORD)(offs >> 32);
+  if (dir == 1)
+    ok = WriteFile(file, buffer, (DWORD)len, &done, &ov);
+  else
+    ok = ReadFile(file, buffer, (DWORD)len, &done, &ov);
+  if (!ok)
+    return (dir == 1) ? IIFERR_DISK_FULL : IIFERR_BAD_DISK;
+  if (done != (DWORD)len)
+    return (dir == 1) ? IIFERR_DISK_FULL : IIFERR_EOF;
+  if (os_fseek(ifp->file_handle, offs + len, SEEK_SET) != 0)
+    return IIFERR_BAD_DISK;      /* the file pointer was moved by i/o */
+#else
+  int      file;                               /* system file descriptor   */
+  ssize_t  done;                               /* amount of bytes done     */
+
+  file = fileno(ifp->file_handle);
+  while (len > 0)
+    {
+    if (dir == 1)
+      done = pwrite(file, buffer, (size_t)len, (off_t)offs);
+    else
+      done = pread(file, buffer, (size_t)len, (off_t)offs);
+    if (done < 0 && errno == EINTR)
+      continue;
+    if (done < 0)
+      return (dir == 1) ? IIFERR_DISK_FULL : IIFERR_BAD_DISK;
+    if (done == 0)
+      return (dir == 1) ? IIFERR_DISK_FULL : IIFERR_EOF;
+    buffer += done;
+    offs += done;
+    len -= (long)done;
+    }
+#endif
+  return IIF_OK;
+  }
+
+/*========================= LOCAL FUNCTIONS ==============================*/
+
+/* --------------------------------------------------------------------------
+ * NAME         check_tile
+ * PURPOSE      checks parameters of tile access.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              table        a pointer to table with buffer addresses
+ *              tx           column of tile
+ *              ty           row of tile
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static int  check_tile(ifp, table, tx, ty)
+IIFL  *ifp;          /* a pointer to IIF file                              */
+VPTR   table;        /* a pointer to table with buffer addresses           */
+int    tx;           /* column of tile                                     */
+int    ty;           /* row of tile                                        */
+  {
+  if (fl_check_iifstr_ptr(ifp) != IIF_OK)
+    {
+    IIF_errno = IIFERR_BAD_PTR;
+    return IIFERR_BAD_PTR;
+    }
+
+  if (ifp->initialized != 1)
+    {
+    ifp->error = IIFERR_NOT_INIT;
+    return IIFERR_NOT_INIT;
+    }
+
+  if (ifp->format != IIF_FORMAT_TILE)
+    {
+    ifp->error = IIFERR_BAD_FORMAT;
+    return IIFERR_BAD_FORMAT;
+    }
+
+  if (table == NULL)
+    {
+    ifp->error = IIFERR_BAD_PARMS;
+    return IIFERR_BAD_PARMS;
+    }
+
+  if (tx < 0 || tx >= ifp->tiles_x || ty < 0 || ty >= ifp->tiles_y)
+    {
+    ifp->error = IIFERR_BAD_ORG;
+    return IIFERR_BAD_ORG;
+    }
+
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         read_tile
+ * PURPOSE      reads data of one tile in the file format.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              tile         a buffer of tile_bytes size for the data
+ *              n            tile number in the index
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static int  read_tile(ifp, tile, n)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+BYTE  *tile;                                   /* a buffer for data        */
+int    n;                                      /* tile number              */
+  {
+  BYTE  *packed;                               /* compressed tile data     */
+  long   len;                                  /* size of stored data      */
+  int    err;                                  /* an error code            */
+
+  if (ifp->tile_index[2 * n] == 0)             /* tile was not written     */
+    {
+    memset(tile, 0, ifp->tile_bytes);
+    return IIF_OK;
+    }
+
+  if (ifp->compress == IIF_COMPRESS_NONE)
+    {
+    if (ifp->tile_index[2 * n + 1] != ifp->tile_bytes)
+      return IIFERR_BAD_FILE;
+    return fl_file_io(ifp, tile, ifp->tile_bytes, ifp->tile_index[2 * n], 0);
+    }
+
+  if (ifp->tile_index[2 * n + 1] <= 0 ||
+      ifp->tile_index[2 * n + 1] > fl_comp_bound(ifp))
+    return IIFERR_BAD_FILE;
+  len = (long)ifp->tile_index[2 * n + 1];
+  if ((packed = (BYTE *)malloc(len)) == NULL)
+    return IIFERR_NO_MEM;
+  if ((err = fl_file_io(ifp, packed, len, ifp->tile_index[2 * n], 0)) ==
+      IIF_OK)
+    err = fl_comp_unpack(ifp, packed, len, tile);
+  free(packed);
+  return err;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         read_row
+ * PURPOSE      places lines of one row of tiles to the lines buffer; tiles
+ *              of compressed file are read by several threads.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              first        first line in the lines buffer
+ *              number       amount of lines in the lines buffer
+ *              ty           row of tiles
+ * RETURNS      an error code.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static int  read_row(ifp, first, number, ty)
+IIFL  *ifp;                  /* a pointer to IIF  file                     */
+int    first;                /* first line in the lines buffer             */
+int    number;               /* amount of lines in the lines buffer        */
+int    ty;                   /* row of tiles                               */
+  {
+  ROW_PART  parts[MAX_ROW_THREADS];            /* parts of the row         */
+#if (OS_MARK == 'I')
+  HANDLE     threads[MAX_ROW_THREADS];         /* threads reading parts    */
+#else
+  pthread_t  threads[MAX_ROW_THREADS];         /* threads reading parts    */
+#endif
+  int        started;                          /* amount of started threads*/
+  int        amount;                           /* amount of parts          */
+  int        n;                                /* part number              */
+
+  amount = 1;
+  if (ifp->compress != IIF_COMPRESS_NONE)
+    amount = threads_amount();
+  if (amount > ifp->tiles_x)
+    amount = ifp->tiles_x;
+
+  for (n = 0; n < amount; n++)
+    {
+    parts[n].ifp = ifp;
+    parts[n].first = first;
+    parts[n].number = number;
+    parts[n].ty = ty;
+    parts[n].tx = n;
+    parts[n].step = amount;
+    parts[n].err = IIF_OK;
+    }
+
+  /* the first part is read by the calling thread; if a thread cannot be
+     started, its part is read by the calling thread as well */
+  for (started = 1; started < amount; started++)
+    {
+#if (OS_MARK == 'I')
+    if ((threads[started] = CreateThread(NULL, 0, row_thread,
+                                         &parts[started], 0, NULL)) == NULL)
+      break;
+#else
+    if (pthread_create(&threads[started], NULL, row_thread,
+                       &parts[started]) != 0)
+      break;
+#endif
+    }
+
+  for (n = started; n < amount; n++)
+    read_row_part(&parts[n]);
+  read_row_part(&parts[0]);
+
+  for (n = 1; n < started; n++)
+    {
+#if (OS_MARK == 'I')
+    WaitForSingleObject(threads[n], INFINITE);
+    CloseHandle(threads[n]);
+#else
+    pthread_join(threads[n], NULL);
+#endif
+    }
+
+  for (n = 0; n < amount; n++)
+    if (parts[n].err != IIF_OK)
+      return parts[n].err;
+  return IIF_OK;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         read_row_part
+ * PURPOSE      reads tiles of the row from columns tx, tx + step, ... and
+ *              places their lines to the lines buffer.
+ * ARGUMENTS    part         a pointer to description of the part
+ * RETURNS      None; an error code is placed into the description.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static VOID  read_row_part(part)
+ROW_PART  *part;                               /* part of the row          */
+  {
+  BYTE  *tile;                    /* tile data in file format              */
+  IIFL  *ifp;                     /* a pointer to IIF file                 */
+  int    tx;                      /* tile column                           */
+
+  ifp = part->ifp;
+  if ((tile = (BYTE *)malloc(ifp->tile_bytes)) == NULL)
+    {
+    part->err = IIFERR_NO_MEM;
+    return;
+    }
+
+  for (tx = part->tx; tx < ifp->tiles_x; tx += part->step)
+    {
+    if ((part->err = read_tile(ifp, tile, part->ty * ifp->tiles_x + tx)) !=
+        IIF_OK)
+      break;
+    copy_tile_lines(ifp, tile, part->first, part->number, tx, part->ty);
+    }
+
+  free(tile);
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         row_thread
+ * PURPOSE      entry point of the thread reading part of tile row.
+ * ARGUMENTS    part         a pointer to description of the part
+ * RETURNS      0
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+#if (OS_MARK == 'I')
+static DWORD WINAPI  row_thread(part)
+LPVOID  part;                                  /* part of the row          */
+#else
+static void  *row_thread(part)
+void  *part;                                   /* part of the row          */
+#endif
+  {
+  read_row_part((ROW_PART *)part);
+  return 0;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         copy_tile_lines
+ * PURPOSE      copies lines of the tile which fall into the lines buffer.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              tile         tile data in file format
+ *              first        first line in the lines buffer
+ *              number       amount of lines in the lines buffer
+ *              tx           column of tile
+ *              ty           row of tile
+ * RETURNS      None
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static VOID  copy_tile_lines(ifp, tile, first, number, tx, ty)
+IIFL  *ifp;                  /* a pointer to IIF  file                     */
+BYTE  *tile;                 /* tile data in file format                   */
+int    first;                /* first line in the lines buffer             */
+int    number;               /* amount of lines in the lines buffer        */
+int    tx;                   /* column of tile                             */
+int    ty;                   /* row of tile                                */
+  {
+  BYTE  *line;                    /* beginning of line in lines buffer     */
+  unsigned long bytes_per_line;   /* size of one line in bytes             */
+  int    x0, y0;                  /* origin of tile in the image           */
+  int    w;                       /* amount of tile pixels inside image    */
+  int    y, y1;                   /* image line numbers                    */
+  int    n;                       /* component order number                */
+  int    size;                    /* a size of component (in bytes)        */
+
+  bytes_per_line = (unsigned long)(ifp->buffer_size / ifp->num_of_lines);
+  x0 = tx * ifp->tile_w;
+  y0 = ty * ifp->tile_h;
+  w = (x0 + ifp->tile_w <= ifp->xres) ? ifp->tile_w : ifp->xres - x0;
+  y1 = (y0 + ifp->tile_h < first + number) ? y0 + ifp->tile_h :
+                                             first + number;
+
+  for (y = (y0 > first) ? y0 : first; y < y1; y++)
+    {
+    line = (BYTE *)(ifp->buffer) + bytes_per_line * (y - first);
+    for (n = 0; n < (int)ifp->cmps_number; n++)
+      {
+      size = ifp->lcmps[n];
+      memcpy(line + fl_get_comp_offset(ifp, n) + (long)x0 * size,
+             tile + plane_offset(ifp, n) +
+             (long)(y - y0) * ifp->tile_w * size,
+             (size_t)w * size);
+      }
+    }
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         threads_amount
+ * PURPOSE      returns amount of threads used for decompression.
+ * ARGUMENTS    None
+ * RETURNS      amount of processors, but not more than MAX_ROW_THREADS.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static int  threads_amount()
+  {
+  long  amount;                                /* amount of processors     */
+#if (OS_MARK == 'I')
+  SYSTEM_INFO  info;                           /* system information       */
+
+  GetSystemInfo(&info);
+  amount = (long)info.dwNumberOfProcessors;
+#else
+  amount = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  if (amount < 1)
+    return 1;
+  return (amount > MAX_ROW_THREADS) ? MAX_ROW_THREADS : (int)amount;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         reserve_space
+ * PURPOSE      allocates place for compressed tile at the end of the tiles
+ *              area; may be called by several threads at the same time.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              len          size of the tile data
+ * RETURNS      offset of the place in the file.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static INT64  reserve_space(ifp, len)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+long   len;                                    /* size of the tile data    */
+  {
+  INT64 *end;                                  /* end of the tiles area    */
+
+  end = ifp->tile_index + 2 * ifp->tiles_x * ifp->tiles_y;
+#if (OS_MARK == 'I')
+  return (INT64)InterlockedExchangeAdd64((LONGLONG volatile *)end,
+                                         (LONGLONG)len);
+#else
+  return __sync_fetch_and_add(end, (INT64)len);
+#endif
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         get_comp_num
+ * PURPOSE      returns order number in the file of defined component.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              n            an order number of component defined by
+ *                           iif_def_components()
+ * RETURNS      an order number of the component in the file.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static int  get_comp_num(ifp, n)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+int    n;                                      /* defined component number */
+  {
+  int num;                                     /* component order number   */
+
+  for (num = 0; num < (int)ifp->cmps_number - 1; num++)
+    if (fl_get_comp_offset(ifp, num) == ifp->def_cmps_offsets[n])
+      break;
+  return num;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         plane_offset
+ * PURPOSE      returns offset in a tile to the values of component 'num'.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ *              num          an order number of component in the file
+ * RETURNS      offset from the beginning of tile data to the component.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static long  plane_offset(ifp, num)
+IIFL  *ifp;                                    /* a pointer to IIF file    */
+int    num;                                    /* component order number   */
+  {
+  long offs;                                   /* offset in the tile       */
+  int  n;                                      /* component order number   */
+
+  offs = 0;
+  for (n = 0; n < num; n++)
+    offs += (long)ifp->lcmps[n] * ifp->tile_w * ifp->tile_h;
+  return offs;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         put_int64
+ * PURPOSE      stores 8-byte value in big-endian order.
+ * ARGUMENTS    buffer       a pointer to 8 bytes area
+ *              value        a value to store
+ * RETURNS      None
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static VOID  put_int64(buffer, value)
+BYTE  *buffer;                                 /* a pointer to 8 bytes     */
+INT64  value;                                  /* a value to store         */
+  {
+  int n;                                       /* an iteration counter     */
+
+  for (n = 7; n >= 0; n--)
+    {
+    buffer[n] = (BYTE)(value & 0xFF);
+    value >>= 8;
+    }
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         get_int64
+ * PURPOSE      retrieves 8-byte value stored in big-endian order.
+ * ARGUMENTS    buffer       a pointer to 8 bytes area
+ * RETURNS      the value.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static INT64  get_int64(buffer)
+BYTE  *buffer;                                 /* a pointer to 8 bytes     */
+  {
+  INT64 value;                                 /* retrieved value          */
+  int   n;                                     /* an iteration counter     */
+
+  value = 0;
+  for (n = 0; n < 8; n++)
+    value = (value << 8) | buffer[n];
+  return value;
+  }
+
+/*--------------------------- END OF MODULE -------------------------------*/
@@ -32,6 +32,8 @@ static char *sccsid =
 
 /* CONSTANTS */
 
+#define  VAR_HASH_SIZE   16     /* initial amount of buckets of vars index */
+
 /* MACROS    */
  
 /* STATICS   */
@@ -52,10 +54,14 @@ BYTE   *iif_get_data(IIF*, char*, unsigned short int*);
 #ifndef NO_PROTOTYPES
 
 static int    put_var(IIFL*, char*, char*, int, unsigned int, int, BOOL*);
+static unsigned int hash_name(char*);
+static VOID   grow_hash(IIFL*);
 
 #else
 
 static int    put_var();
+static unsigned int hash_name();
+static VOID   grow_hash();
 static VLIST *find_var_name();
 
 #endif
@@ -174,7 +180,7 @@ char *name;                                  /* a pointer to string   with */
     }
 
   if ((tmp_ptr = find_var_name(ifp->syst_var, name)) == NULL &&
-      (tmp_ptr = find_var_name(ifp->first_var, name)) == NULL)
+      (tmp_ptr = fl_find_var(ifp, name)) == NULL)
     {
     ifp->error = IIFERR_NOT_A_VAR;
     return NULL;
@@ -446,7 +452,7 @@ unsigned short int *len; /* a pointer to variable to set to data area size */
     return  NULL;
     }
 
-  if ((tmp_ptr = find_var_name(ifp->first_var, name)) == NULL)
+  if ((tmp_ptr = fl_find_var(ifp, name)) == NULL)
     {
     ifp->error = IIFERR_NOT_A_VAR;
     return NULL;
@@ -485,12 +491,91 @@ char *name;                         /* a pointer  to string  with    */
        strcmp(IIFVAR_TYPES, name)     == 0 ||
        strcmp(IIFVAR_NEW_VER, name)   == 0 ||
        strcmp(IIFVAR_NEW_XRES, name)  == 0 ||
-       strcmp(IIFVAR_NEW_YRES, name)  == 0)
+       strcmp(IIFVAR_NEW_YRES, name)  == 0 ||
+       strcmp(IIFVAR_TILE_SIZE, name) == 0 ||
+       strcmp(IIFVAR_COMPRESS, name)  == 0)
      return TRUE;
    else
      return FALSE;
    }
 
+/* --------------------------------------------------------------------------
+ * NAME         fl_add_var
+ * PURPOSE      appends user-defined variable to the end of variables list
+ *              and puts it into the index of names.
+ * ARGUMENTS    ifp          a pointer to opened IIF file
+ *              var          a pointer to new element with the name set
+ * RETURNS      None
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+VOID  fl_add_var(ifp, var)
+IIFL   *ifp;                        /* a pointer to IIF structure          */
+VLIST  *var;                        /* a pointer to new element            */
+  {
+  unsigned int bucket;              /* index bucket of the name            */
+
+  var->next = NULL;
+  if (ifp->first_var == NULL)
+    ifp->first_var = var;
+  else
+    ifp->last_var->next = var;
+  ifp->last_var = var;
+  ifp->vars_amount++;
+
+  if (ifp->vars_amount > ifp->hash_size)
+    grow_hash(ifp);          /* rebuilds the index with the new element */
+  else
+    {
+    bucket = hash_name(var->name) & (ifp->hash_size - 1);
+    var->hash_next = ifp->var_hash[bucket];
+    ifp->var_hash[bucket] = var;
+    }
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_find_var
+ * PURPOSE      searches user-defined variable by name.
+ * ARGUMENTS    ifp          a pointer to opened IIF file
+ *              name         a pointer to buffer with variabe name
+ * RETURNS      a pointer to element of variables list or NULL.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+VLIST  *fl_find_var(ifp, name)
+IIFL  *ifp;                         /* a pointer to IIF structure          */
+char  *name;                        /* a pointer  to string  with          */
+                                    /* variable name                       */
+  {
+  VLIST *var;                       /* an element of the bucket            */
+
+  if (ifp->var_hash == NULL)        /* no memory for the index             */
+    return find_var_name(ifp->first_var, name);
+
+  var = ifp->var_hash[hash_name(name) & (ifp->hash_size - 1)];
+  while (var != NULL)
+    {
+    if (strcmp(var->name, name) == 0)
+      return var;
+    var = var->hash_next;
+    }
+  return NULL;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         fl_free_var_hash
+ * PURPOSE      frees the index of variables names.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ * RETURNS      None
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+VOID  fl_free_var_hash(ifp)
+IIFL  *ifp;                         /* a pointer to IIF structure          */
+  {
+  if (ifp->var_hash != NULL)
+    free(ifp->var_hash);
+  ifp->var_hash = NULL;
+  ifp->hash_size = 0;
+  }
+
 
 /*==================== LOCAL FUNCTIONS ==============================*/
 
@@ -519,12 +604,12 @@ BOOL   *overwritten;           /* a pointer to a flag; TRUE                */
                                /* if an existing variable value was        */
                                /* overwritten                              */
   {
-  VLIST *tmp_ptr, *list;
+  VLIST *tmp_ptr;
   char *new_value, *new_name;
 
   new_value = NULL;
   new_name = NULL;
-  if ((tmp_ptr = find_var_name(ifp->first_var, name)) == NULL)
+  if ((tmp_ptr = fl_find_var(ifp, name)) == NULL)
     {
     *overwritten = FALSE;
     if((tmp_ptr = (VLIST *)malloc(sizeof(VLIST))) == NULL)
@@ -552,19 +637,9 @@ BOOL   *overwritten;           /* a pointer to a flag; TRUE                */
 
   if (*overwritten == FALSE)
     {
-    if (ifp->first_var == NULL)
-      list = ifp->first_var = tmp_ptr;
-    else  /* seek to the end of the list */
-      {
-      list = ifp->first_var;
-      while (list->next != NULL)
-        list = list->next;
-      list->next = tmp_ptr;
-      }
-
     strcpy(new_name, name);
     tmp_ptr->name = new_name;
-    tmp_ptr->next = NULL;
+    fl_add_var(ifp, tmp_ptr);
     }
   else
     free(tmp_ptr->value);
@@ -604,4 +679,67 @@ char *name;                         /* a pointer  to string  with          */
   return NULL;
   }
 
+/* --------------------------------------------------------------------------
+ * NAME         hash_name
+ * PURPOSE      calculates hash value of variable name (FNV-1a).
+ * ARGUMENTS    name         a pointer to buffer with variabe name
+ * RETURNS      the hash value.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static unsigned int hash_name(name)
+char *name;                         /* a pointer  to string  with          */
+                                    /* variable name                       */
+  {
+  unsigned int  hash;               /* the hash value                      */
+
+  hash = 2166136261U;
+  while (*name != '\0')
+    {
+    hash ^= (BYTE)*name++;
+    hash *= 16777619U;
+    }
+  return hash;
+  }
+
+/* --------------------------------------------------------------------------
+ * NAME         grow_hash
+ * PURPOSE      allocates twice bigger index of variables names and puts all
+ *              variables of the list into it; the old index is kept if
+ *              there is no memory for the new one.
+ * ARGUMENTS    ifp          a pointer to IIF file
+ * RETURNS      None
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+static VOID grow_hash(ifp)
+IIFL  *ifp;                         /* a pointer to IIF structure          */
+  {
+  VLIST        **hash;              /* new index                           */
+  VLIST         *var;               /* an element of the list              */
+  unsigned int   size;              /* amount of buckets of new index      */
+  unsigned int   bucket;            /* index bucket of the name            */
+
+  size = (ifp->hash_size == 0) ? VAR_HASH_SIZE : 2 * ifp->hash_size;
+  if ((hash = (VLIST **)calloc(size, sizeof(VLIST *))) == NULL)
+    {
+    if (ifp->var_hash == NULL)
+      return;                   /* fl_find_var() searches the list then */
+    var = ifp->last_var;        /* the old index gets longer chains     */
+    bucket = hash_name(var->name) & (ifp->hash_size - 1);
+    var->hash_next = ifp->var_hash[bucket];
+    ifp->var_hash[bucket] = var;
+    return;
+    }
+
+  for (var = ifp->first_var; var != NULL; var = var->next)
+    {
+    bucket = hash_name(var->name) & (size - 1);
+    var->hash_next = hash[bucket];
+    hash[bucket] = var;
+    }
+
+  fl_free_var_hash(ifp);
+  ifp->var_hash = hash;
+  ifp->hash_size = size;
+  }
+
 /*--------------------------- END OF MODULE -------------------------------*/
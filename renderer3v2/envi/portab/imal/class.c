@@ -134,6 +134,17 @@ static int class_table_size = sizeof(default_class_table) / sizeof(CLASS_DSC);
 
 /* Pointer to the class descriptor table and table size */
 
+/*
+Class table and lists are accessed under IMAL lock (see lock.c):
+the table can be moved by mem_class_create().
+*/
+
+
+/* STATIC PROTOTYPES */
+
+static int class_create(IN char *);
+static int class_close(IN int);
+
 /* Disable "cast truncates constant value" warning */
 #pragma warning(disable : 4310)
 
@@ -165,6 +176,159 @@ static int class_table_size = sizeof(default_class_table) / sizeof(CLASS_DSC);
  --------------------------------------------------------------------------*/
 
 int mem_class_create(class_name)
+IN char *class_name;
+  {
+  int class_id;        /* Identifier of the new class */
+
+  imal_lock();
+  class_id = class_create(class_name);
+  imal_unlock();
+  return class_id;
+  } /* end of mem_class_create function */
+
+
+/* --------------------------------------------------------------------------
+ * NAME         mem_class_close
+ * PURPOSE      Release class descriptor.
+ * ARGUMENTS    IN int class_id - Class identifier.
+ * RETURNS      Error code:
+ *              MEM_OK,
+ *              MEM_ERR_CLASS_NOT_CREATED,
+ *              MEM_ERR_CLASS_NOT_RELEASED.
+ *              MEM_ERR_CLASS_PREDEFINED.
+ * EXTERNS      None
+ * NOTE         Other threads should not use the class meanwhile.
+ --------------------------------------------------------------------------*/
+
+int mem_class_close(class_id)
+IN int class_id;
+  {
+  int err;      /* IMAL error code */
+
+  imal_lock();
+  err = class_close(class_id);
+  imal_unlock();
+  return err;
+  } /* end of mem_class_close function */
+
+
+/* --------------------------------------------------------------------------
+ * NAME         mem_query_class
+ * PURPOSE      Returns name of the class.
+ * ARGUMENTS    IN int class_id - Class identifier.
+ * RETURNS      Name or NULL if class_id is not a class descriptor.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+
+
+char *mem_query_class(class_id)
+IN int class_id;
+  {
+  char *name;   /* Name of the class */
+
+  imal_lock();
+  name = (imal_class_id_to_ptr(class_id) == NULL ?
+          NULL : class_table[class_id].name);
+  imal_unlock();
+  return name;
+  } /* end of mem_duery_class function */
+
+
+                     /* Interface functions */
+
+
+/* --------------------------------------------------------------------------
+ * NAME         imal_class_id_to_ptr
+ * PURPOSE      Check class descriptor of identifier class_id and
+ *              return its info address.
+ * ARGUMENTS    IN int class_id - Class identifier.
+ * RETURNS      Class descriptor info pointer or NULL
+ *              (if  class_id is not class identifier or
+ *              class descriptor have been corrupted).
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+
+CLASS_INFO *imal_class_id_to_ptr(class_id)
+IN int class_id;
+  {
+  CLASS_DSC *pclass;   /* Class descriptor pointer */
+
+  if (class_id < 0 || class_id >= class_table_size)
+    {
+    return NULL;        /* No such class */
+    }
+  pclass = class_table + class_id;
+  return pclass->tag == (short)IMAL_TAG_CLASS ? &(pclass->info) : NULL;
+  /*
+     tag is not IMAL_TAG_CLASS means that class descriptor is
+     free or corrupted.
+  */
+  } /* end of imal_class_id_to_ptr function */
+
+
+/* --------------------------------------------------------------------------
+ * NAME         imal_class_check_id
+ * PURPOSE      Check class descriptor of identifier class_id.
+ * ARGUMENTS    IN int class_id - Class identifier.
+ * RETURNS      MEM_OK
+ *              MEM_ERR_CLASS_NOT_CREATED
+ *              (class_id is not class identifier)
+ *              MEM_ERR_FATAL
+ *              (class descriptor have been corrupted)
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+
+int imal_class_check_id(class_id)
+IN int class_id;
+  {
+  if (class_id < 0 || class_id >= class_table_size ||
+      class_table[class_id].tag == IMAL_TAG_CLASS_FREE)
+    {
+    return MEM_ERR_CLASS_NOT_CREATED;
+    }
+  if (class_table[class_id].tag == IMAL_TAG_CLASS)
+    {
+    return MEM_OK;
+    }
+  return MEM_ERR_FATAL;
+  } /* end of imal_class_check_id function */
+
+
+/* --------------------------------------------------------------------------
+ * NAME         imal_class_next
+ * PURPOSE      Give first/next used class identifier.
+ * ARGUMENTS    IN int class_id - Class identifier or MEM_NOT_CLASS.
+ * RETURNS      First descriptor if class_id is  MEM_NOT_CLASS.
+ *              Next descriptor if class_id is not MEM_NOT_CLASS.
+ *              MEM_NOT_CLASS if there are no more descriptors.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+
+int imal_class_next(class_id)
+IN int class_id;
+  {
+  if (class_id == MEM_NOT_CLASS)
+    return class_used_list;
+  if (imal_class_id_to_ptr(class_id) == NULL)
+    return MEM_NOT_CLASS;       /* class_id is not class dsc. */
+  return class_table[class_id].next;
+  } /* end of imal_class_next function */
+
+
+
+                    /* Auxiliary functions */
+
+
+/* --------------------------------------------------------------------------
+ * NAME         class_create
+ * PURPOSE      Create a new class (see mem_class_create); called with
+ *              IMAL lock kept.
+ * ARGUMENTS    IN char *class_name - Name of class.
+ * RETURNS      Class identifier or MEM_NOT_CLASS.
+ * EXTERNS      None
+ --------------------------------------------------------------------------*/
+
+static int class_create(class_name)
 IN char *class_name;
   {
   int i;               /* Loop variable                   */
@@ -235,6 +399,9 @@ IN char *class_name;
   class_table[i].info.max_block_size = 0;
   class_table[i].info.block_csize = 0;
   class_table[i].info.max_block_csize = 0;
+  class_table[i].info.pool_block_num = 0;
+  class_table[i].info.pool_block_size = 0;
+  class_table[i].info.pool_block_csize = 0;
 
   /* Remove descriptor from free list
      and insert it to the used list  */
@@ -244,25 +411,23 @@ IN char *class_name;
 
   imal_err(MEM_OK);
   return i;
-  } /* end of mem_class_create function */
+  } /* end of class_create function */
 
 
 /* --------------------------------------------------------------------------
- * NAME         mem_class_close
- * PURPOSE      Release class descriptor.
+ * NAME         class_close
+ * PURPOSE      Release class descriptor (see mem_class_close); called
+ *              with IMAL lock kept.
  * ARGUMENTS    IN int class_id - Class identifier.
- * RETURNS      Error code:
- *              MEM_OK,
- *              MEM_ERR_CLASS_NOT_CREATED,
- *              MEM_ERR_CLASS_NOT_RELEASED.
- *              MEM_ERR_CLASS_PREDEFINED.
+ * RETURNS      Error code (see mem_class_close).
  * EXTERNS      None
  --------------------------------------------------------------------------*/
 
-int mem_class_close(class_id)
+static int class_close(class_id)
 IN int class_id;
   {
   int *pnext;   /* Pointer to the 'next' field of class descriptors */
+  SIZE_T blk_num, dummy;
 
   /* Predefined class cannot be released */
   if (PREDEFINED_CLASS(class_id))
@@ -276,11 +441,18 @@ IN int class_id;
     }   /* class_id is not class descriptor index */
 
   /* Check that there are no allocated blocks of this class */
-  if (class_table[class_id].info.block != NULL)
+  /* (blocks taken from pools are not in the block list)    */
+  if (class_table[class_id].info.block != NULL ||
+      mem_class_size(class_id, MEM_INFO_CURRENT,
+                     &blk_num, &dummy, &dummy) != MEM_OK ||
+      blk_num != 0)
     {
     return MEM_ERR_CLASS_NOT_RELEASED;
     }
 
+  /* Remove the class from thread caches */
+  imal_pool_forget_class(class_id);
+
   /* Remove descriptor from used list and insert it to the free list */
   for (pnext = &class_used_list;
        *pnext != class_id;
@@ -312,109 +484,7 @@ IN int class_id;
     }
 
   return MEM_OK;
-  } /* end of mem_class_close function */
-
-
-/* --------------------------------------------------------------------------
- * NAME         mem_query_class
- * PURPOSE      Returns name of the class.
- * ARGUMENTS    IN int class_id - Class identifier.
- * RETURNS      Name or NULL if class_id is not a class descriptor.
- * EXTERNS      None
- --------------------------------------------------------------------------*/
-
-
-char *mem_query_class(class_id)
-IN int class_id;
-  {
-  if (imal_class_id_to_ptr(class_id) == NULL)
-    {
-    return NULL;
-    }   /* class_id is not class descriptor index */
-
-  return class_table[class_id].name;
-  } /* end of mem_duery_class function */
-
-
-                     /* Interface functions */
-
-
-/* --------------------------------------------------------------------------
- * NAME         imal_class_id_to_ptr
- * PURPOSE      Check class descriptor of identifier class_id and
- *              return its info address.
- * ARGUMENTS    IN int class_id - Class identifier.
- * RETURNS      Class descriptor info pointer or NULL
- *              (if  class_id is not class identifier or
- *              class descriptor have been corrupted).
- * EXTERNS      None
- --------------------------------------------------------------------------*/
-
-CLASS_INFO *imal_class_id_to_ptr(class_id)
-IN int class_id;
-  {
-  CLASS_DSC *pclass;   /* Class descriptor pointer */
-
-  if (class_id < 0 || class_id >= class_table_size)
-    {
-    return NULL;        /* No such class */
-    }
-  pclass = class_table + class_id;
-  return pclass->tag == (short)IMAL_TAG_CLASS ? &(pclass->info) : NULL;
-  /*
-     tag is not IMAL_TAG_CLASS means that class descriptor is
-     free or corrupted.
-  */
-  } /* end of imal_class_id_to_ptr function */
-
-
-/* --------------------------------------------------------------------------
- * NAME         imal_class_check_id
- * PURPOSE      Check class descriptor of identifier class_id.
- * ARGUMENTS    IN int class_id - Class identifier.
- * RETURNS      MEM_OK
- *              MEM_ERR_CLASS_NOT_CREATED
- *              (class_id is not class identifier)
- *              MEM_ERR_FATAL
- *              (class descriptor have been corrupted)
- * EXTERNS      None
- --------------------------------------------------------------------------*/
-
-int imal_class_check_id(class_id)
-IN int class_id;
-  {
-  if (class_id < 0 || class_id >= class_table_size ||
-      class_table[class_id].tag == IMAL_TAG_CLASS_FREE)
-    {
-    return MEM_ERR_CLASS_NOT_CREATED;
-    }
-  if (class_table[class_id].tag == IMAL_TAG_CLASS)
-    {
-    return MEM_OK;
-    }
-  return MEM_ERR_FATAL;
-  } /* end of imal_class_check_id function */
-
-
-/* --------------------------------------------------------------------------
- * NAME         imal_class_next
- * PURPOSE      Give first/next used class identifier.
- * ARGUMENTS    IN int class_id - Class identifier or MEM_NOT_CLASS.
- * RETURNS      First descriptor if class_id is  MEM_NOT_CLASS.
- *              Next descriptor if class_id is not MEM_NOT_CLASS.
- *              MEM_NOT_CLASS if there are no more descriptors.
- * EXTERNS      None
- --------------------------------------------------------------------------*/
-
-int imal_class_next(class_id)
-IN int class_id;
-  {
-  if (class_id == MEM_NOT_CLASS)
-    return class_used_list;
-  if (imal_class_id_to_ptr(class_id) == NULL)
-    return MEM_NOT_CLASS;       /* class_id is not class dsc. */
-  return class_table[class_id].next;
-  } /* end of imal_class_next function */
+  } /* end of class_close function */
 
 
 /*** End of file CLASS.C ***/
@@ -6,6 +6,9 @@
  *              functions; IMAL basic internal data structures.
  *              Module imal.c uses functions of locked.c, class.c
  *              and mode.c modules.
+ *              Library functions keep IMAL lock (see lock.c) while
+ *              they use internal data, only blocks of FAST mode are
+ *              taken and released without the lock (see pool.c).
  *
  * SPEC         V. L. Volevich                        1993.01.12
  * DESIGN       V. L. Volevich                        1993.06.03
@@ -45,6 +48,21 @@ static char *sccsid =
 #define MODE_SEMIDEBUG \
    (imal_mode_modify_fl == TRUE)
 
+/* Can block be taken from pool ? */
+#define MODE_FAST(class_id, blk_size) \
+   (imal_mode_fast_fl == TRUE && imal_init_fl == TRUE && \
+    (blk_size) > 0 && (blk_size) <= IMAL_POOL_MAX_SIZE && \
+    (class_id) != MEM_CLASS_NO_CHECK)
+
+/* Is block taken from pool ? */
+#define POOLED_BLOCK(ptr) \
+   (IMAL_BLOCK_EQUAL_PREFIX(ptr, IMAL_TAG_POOLED))
+
+/* Is statistic value a greater than b ? Values are modulo SIZE_T: */
+/* statistic of thread caches is merged at different time.         */
+#define STAT_GREATER(a, b) \
+   ((SIZE_T)((a) - (b) - 1) < (((SIZE_T)~(SIZE_T)0) >> 1))
+
 /* CONSTANTS */
 
 #define MAX_IMAL_NAME_LEN 100    /* Maximum number of symbols in  */
@@ -116,6 +134,7 @@ static BOOL imal_init_fl = FALSE;
 static BOOL imal_mode_debug_fl = FALSE;
 static BOOL imal_mode_trace_fl = FALSE;
 static BOOL imal_mode_modify_fl = FALSE;
+static BOOL imal_mode_fast_fl = FALSE;
 
   /* IMAL mode flags. Set by imal_mode_set() from mode.c */
 
@@ -138,7 +157,19 @@ static SIZE_T imal_blocks_number = 0;
 
   /* Current number of allocated blocks. */
 
-static BOOL imal_tag_check_fl = TRUE;
+static SIZE_T pool_blocks_number = 0;
+static SIZE_T pool_blocks_size = 0;
+static SIZE_T pool_csize = 0;
+
+  /*
+     Current number and sizes of blocks taken from pools in FAST
+     mode. Such blocks are not inserted to the block list. Blocks
+     of thread caches are counted here (and in pool_block_* fields
+     of class descriptors) when the statistic of the cache is
+     merged, the rest is got by imal_pool_stat().
+  */
+
+static IMAL_THREAD BOOL imal_tag_check_fl = TRUE;
 
   /*
     This flag manage the prefix/postfix  tag  checking  in IMAL query
@@ -150,16 +181,18 @@ static BOOL imal_tag_check_fl = TRUE;
     mem_print_class)  to  give  full  info  about  corrupted  blocks.
     Usually this flag is TRUE.  IMAL  functions can set it to  FALSE,
     call query functions and then set it to TRUE again.
+    The flag is kept per thread.
   */
 
 
-static VPTR imal_damage_ptr = NULL;
-static SIZE_T imal_damage_offset = 0;
+static IMAL_THREAD VPTR imal_damage_ptr = NULL;
+static IMAL_THREAD SIZE_T imal_damage_offset = 0;
 
   /*
      Pointer to corrupted block or NULL. Corrupted data offset.
      These variable can be set  by  functions  mem_check_block,
      imal_check_block_ptr. Access via imal_get_damage_info().
+     They are kept per thread.
   */
 
 static char trace_file_name[MAX_PATHNAME_LENGTH + 1] = "memtrace.out";
@@ -183,6 +216,21 @@ static VOID trace_out(IN int, IN char *, IN char *,
                             IN SIZE_T, IN SIZE_T,
                             IN char *, IN int,
                             IN VPTR, IN VPTR, IN int);
+static int close_imal(void);
+static VPTR alloc_block(IN int, IN char *, IN SIZE_T, IN char *, IN int);
+static VPTR calloc_block(IN int, IN char *, IN SIZE_T, IN SIZE_T,
+                         IN char *, IN int);
+static int free_block(IN VPTR, IN char *, IN int);
+static VPTR realloc_block(IN VPTR, IN SIZE_T, IN char *, IN int);
+static int check_block(IN VPTR);
+static int print_list(INOUT FILE *);
+static int print_class(INOUT FILE *, IN int);
+static int block_next(INOUT VPTR *, IN int);
+static VOID total_info(IN int, OUT SIZE_T *, OUT SIZE_T *, OUT SIZE_T *);
+static VOID class_info(IN CLASS_INFO *, IN int, IN int,
+                       OUT SIZE_T *, OUT SIZE_T *, OUT SIZE_T *);
+static int fast_free(IN VPTR, IN char *, IN int);
+static VPTR fast_realloc(IN VPTR, IN SIZE_T, IN char *, IN int);
 
 /* Disable "cast truncates constant value" warning */
 #pragma warning(disable : 4310)
@@ -231,8 +279,10 @@ IN char *trace_file_name_par;
   {
   int len;
 
+  imal_lock();
   if (imal_init_fl == TRUE)     /* IMAL is still initialized */
     {
+    imal_unlock();
     imal_err(MEM_ERR_INIT);
     return MEM_ERR_INIT;
     }
@@ -243,6 +293,10 @@ IN char *trace_file_name_par;
   while (imal_blocks_number > 0 &&
          mem_free(block_head.next) == MEM_OK);
   imal_blocks_number = 0;
+  imal_pool_release();
+  pool_blocks_number = 0;
+  pool_blocks_size = 0;
+  pool_csize = 0;
 
   /* Init error processing, mode stack,    */
   /* parse IMAL_CFG  environment variable. */
@@ -254,6 +308,7 @@ IN char *trace_file_name_par;
     strncpy(trace_file_name, trace_file_name_par, len);
     trace_file_name[len - 1] = '\0';
     }
+  imal_unlock();
 
   imal_err(MEM_OK);
   return MEM_OK;
@@ -273,6 +328,28 @@ IN char *trace_file_name_par;
  ---------------------------------------------------------------------*/
 
 int mem_close()
+  {
+  int err;             /* IMAL error code */
+
+  imal_lock();
+  err = close_imal();
+  imal_unlock();
+  return err;
+  } /* end of mem_close function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         close_imal
+ * PURPOSE      Terminate IMAL (see mem_close); called with IMAL lock
+ *              kept.
+ * ARGUMENTS    None
+ * RETURNS      IMAL error code (see mem_close).
+ * EXTERNS      None
+ * NOTE         Other threads should not use IMAL meanwhile: blocks
+ *              of all pools are returned to the system.
+ ---------------------------------------------------------------------*/
+
+static int close_imal()
   {
   int class_id;
   int last_class_id;
@@ -299,7 +376,7 @@ int mem_close()
     return MEM_ERR_BUFFER_DAMAGE;
 
   /* Check that all blocks are released */
-  if (block_head.next != &block_head ||
+  if (mem_empty() != MEM_OK ||
       mem_class_size(MEM_CLASS_NO_CHECK, MEM_INFO_CURRENT,
                      &blk_num, &dummy, &dummy) != MEM_OK ||
       blk_num != 0)
@@ -307,6 +384,9 @@ int mem_close()
 
   /* Everything O.K. - close IMAL */
 
+  /* Return memory of pools */
+  imal_pool_release();
+
   /* Close class descriptors */
   last_class_id = MEM_NOT_CLASS;
   while ((class_id = imal_class_next(last_class_id)) != MEM_NOT_CLASS)
@@ -320,7 +400,7 @@ int mem_close()
   imal_init_fl = FALSE;
 
   return MEM_OK;
-  } /* end of mem_close function */
+  } /* end of close_imal function */
 
 
 /* --------------------------------------------------------------------
@@ -336,7 +416,10 @@ int mem_close()
  *              IMAL error code will be set.
  *
  * EXTERNS      None
- * NOTE         None
+ * NOTE         In FAST mode small blocks are taken from pools:
+ *              the name is not stored and the block is not
+ *              inserted to the block list. IMAL lock is not
+ *              taken this case.
  ---------------------------------------------------------------------*/
 
 VPTR mem_alloc_fun(class_id, blk_name, blk_size, filename, fileline)
@@ -344,6 +427,42 @@ IN int  class_id;
 IN char *blk_name;
 IN SIZE_T blk_size;
 IN char *filename;
+IN int fileline;
+  {
+  VPTR p;              /* Allocated block pointer        */
+
+  /* FAST mode: take small block from pool of the thread */
+  if (MODE_FAST(class_id, blk_size) && blk_name != NULL &&
+      (p = imal_pool_alloc(class_id, blk_size)) != NULL)
+    {
+    imal_err(MEM_OK);
+    return p;
+    }
+
+  imal_lock();
+  p = alloc_block(class_id, blk_name, blk_size, filename, fileline);
+  imal_unlock();
+  return p;
+  } /* end of mem_alloc_fun function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         alloc_block
+ * PURPOSE      Allocate an ordinary block or a block of NO_CHECK
+ *              class (see mem_alloc_fun); called with IMAL lock
+ *              kept.
+ * ARGUMENTS    See mem_alloc_fun.
+ * RETURNS      Pointer to allocated block or NULL on failure.
+ *              IMAL error code will be set.
+ * EXTERNS      None
+ * NOTE         None
+ ---------------------------------------------------------------------*/
+
+static VPTR alloc_block(class_id, blk_name, blk_size, filename, fileline)
+IN int  class_id;
+IN char *blk_name;
+IN SIZE_T blk_size;
+IN char *filename;
 IN int fileline;
   {
   VPTR p;              /* Allocated block pointer        */
@@ -524,7 +643,7 @@ IN int fileline;
     }
   imal_err(err);
   return p;
-  } /* end of mem_alloc_fun function */
+  } /* end of alloc_block function */
 
 
 /* --------------------------------------------------------------------
@@ -542,7 +661,8 @@ IN int fileline;
  *              IMAL error code will be set.
  *
  * EXTERNS      None
- * NOTE         None
+ * NOTE         In FAST mode small blocks are taken from pools
+ *              (see mem_alloc_fun).
  ---------------------------------------------------------------------*/
 
 VPTR mem_calloc_fun(class_id, blk_name, item_size, item_num,
@@ -552,6 +672,49 @@ IN char *blk_name;
 IN SIZE_T item_size;
 IN SIZE_T item_num;
 IN char *filename;
+IN int fileline;
+  {
+  VPTR p;              /* Allocated block pointer        */
+  SIZE_T blk_size;     /* Size of block                  */
+
+  blk_size = item_size * item_num;
+
+  /* FAST mode: take small block from pool of the thread */
+  if (MODE_FAST(class_id, blk_size) && blk_name != NULL &&
+      (p = imal_pool_alloc(class_id, blk_size)) != NULL)
+    {
+    memset(p, 0, blk_size);
+    imal_err(MEM_OK);
+    return p;
+    }
+
+  imal_lock();
+  p = calloc_block(class_id, blk_name, item_size, item_num,
+                   filename, fileline);
+  imal_unlock();
+  return p;
+  } /* end of mem_calloc_fun function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         calloc_block
+ * PURPOSE      Allocate an ordinary block or a block of NO_CHECK
+ *              class and clear it (see mem_calloc_fun); called with
+ *              IMAL lock kept.
+ * ARGUMENTS    See mem_calloc_fun.
+ * RETURNS      Pointer to allocated block or NULL on failure.
+ *              IMAL error code will be set.
+ * EXTERNS      None
+ * NOTE         None
+ ---------------------------------------------------------------------*/
+
+static VPTR calloc_block(class_id, blk_name, item_size, item_num,
+                         filename, fileline)
+IN int  class_id;
+IN char *blk_name;
+IN SIZE_T item_size;
+IN SIZE_T item_num;
+IN char *filename;
 IN int fileline;
   {
   VPTR p;              /* Allocated block pointer        */
@@ -562,6 +725,7 @@ IN int fileline;
   SIZE_T blk_size;     /* Size of block                  */
   int err;             /* IMAL error code                */
 
+  blk_size = item_size * item_num;
   err = MEM_OK;   /* Set default error code (O.K.) */
 
   /* Check that IMAL is initialized */
@@ -572,7 +736,6 @@ IN int fileline;
     }
 
   /* Check block's size */
-  blk_size = item_size * item_num;
   if (blk_size == 0)
     imal_err(err = MEM_ERR_BAD_SIZE);
 
@@ -732,7 +895,7 @@ IN int fileline;
     }
   imal_err(err);
   return p;
-  } /* end of mem_calloc_fun function */
+  } /* end of calloc_block function */
 
 
 /* --------------------------------------------------------------------
@@ -750,7 +913,8 @@ IN int fileline;
  *
  * EXTERNS      None
  *              imal_mode_modify_fl.
- * NOTE         None
+ * NOTE         Block taken from pool in FAST mode is returned
+ *              without IMAL lock (see fast_free).
  ---------------------------------------------------------------------*/
 
 int mem_free_fun(ptr, filename, fileline)
@@ -758,12 +922,7 @@ IN VPTR ptr;
 IN char *filename;
 IN int fileline;
   {
-  CLASS_INFO *pclass;  /* Block's class descriptor pointer         */
-  int err;             /* IMAL error code                          */
-  int debug_err;       /* IMAL error code: result of debug checking*/
-  char *p;             /* Pointer used for user's data modification*/
-  int class_id;        /* Block's class identifier                 */
-  char *name;          /* Block's name                             */
+  int err;             /* IMAL error code */
 
   /* Check that IMAL is initialized */
   if (imal_init_fl == FALSE)
@@ -771,6 +930,39 @@ IN int fileline;
     return MEM_ERR_NOT_INIT;
     }
 
+  /* Block taken from pool in FAST mode */
+  if (ptr != NULL && IMAL_ALIGNED(ptr) && POOLED_BLOCK(ptr))
+    return fast_free(ptr, filename, fileline);
+
+  imal_lock();
+  err = free_block(ptr, filename, fileline);
+  imal_unlock();
+  return err;
+  } /* end of mem_free_fun function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         free_block
+ * PURPOSE      Release an ordinary block or a block of NO_CHECK
+ *              class (see mem_free_fun); called with IMAL lock kept.
+ * ARGUMENTS    See mem_free_fun.
+ * RETURNS      IMAL error code (see mem_free_fun).
+ * EXTERNS      None
+ * NOTE         None
+ ---------------------------------------------------------------------*/
+
+static int free_block(ptr, filename, fileline)
+IN VPTR ptr;
+IN char *filename;
+IN int fileline;
+  {
+  CLASS_INFO *pclass;  /* Block's class descriptor pointer         */
+  int err;             /* IMAL error code                          */
+  int debug_err;       /* IMAL error code: result of debug checking*/
+  char *p;             /* Pointer used for user's data modification*/
+  int class_id;        /* Block's class identifier                 */
+  char *name;          /* Block's name                             */
+
   /* Check released block, put result to the err */
 
   if (ptr == NULL)
@@ -907,7 +1099,7 @@ IN int fileline;
 
   free(IMAL_BLOCK_BEGIN(ptr));
   return debug_err;
-  } /* end of mem_free_fun function */
+  } /* end of free_block function */
 
 
 /* --------------------------------------------------------------------
@@ -921,6 +1113,33 @@ IN int fileline;
  * RETURNS      Block pointer or NULL. IMAL error code will be set.
  * EXTERNS      None
  * NOTE         Function cannot be used for blocks of NO_CHECK class.
+ *              Block taken from pool is resized in place while it
+ *              fits the slot (see fast_realloc).
+ ---------------------------------------------------------------------*/
+
+VPTR mem_realloc_fun(ptr, new_size, file, line)
+IN VPTR ptr;
+IN SIZE_T new_size;
+IN char *file;
+IN int line;
+  {
+  VPTR new_ptr;        /* Resized block */
+
+  imal_lock();
+  new_ptr = realloc_block(ptr, new_size, file, line);
+  imal_unlock();
+  return new_ptr;
+  } /* end of mem_realloc_fun function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         realloc_block
+ * PURPOSE      Resize block (see mem_realloc_fun); called with IMAL
+ *              lock kept.
+ * ARGUMENTS    See mem_realloc_fun.
+ * RETURNS      Block pointer or NULL. IMAL error code will be set.
+ * EXTERNS      None
+ * NOTE         None
  ---------------------------------------------------------------------*/
 
 #define TRACE_OUT(a, b, c, d, e, f, g, h, i, j)\
@@ -930,7 +1149,7 @@ IN int fileline;
 		}
 
 
-VPTR mem_realloc_fun(ptr, new_size, file, line)
+static VPTR realloc_block(ptr, new_size, file, line)
 IN VPTR ptr;
 IN SIZE_T new_size;
 IN char *file;
@@ -985,6 +1204,10 @@ IN int line;
     imal_err(imal_debug(file, line));
     }
 
+  /* block taken from pool in FAST mode */
+  if (mem_block(ptr) == MEM_OK && POOLED_BLOCK(ptr))
+    return fast_realloc(ptr, new_size, file, line);
+
   /* get block info */
   class_id = MEM_NOT_CLASS;
   name = mem_query_block(ptr, &class_id);
@@ -1127,7 +1350,7 @@ IN int line;
   		size, new_size, file, line, ptr, new_ptr, mem_error())
 
   return new_ptr;
-  }
+  } /* end of realloc_block function */
 
 
 #undef TRACE_OUT
@@ -1153,6 +1376,28 @@ IN int line;
  ---------------------------------------------------------------------*/
 
 int mem_check_block(passed_ptr)
+IN VPTR passed_ptr;
+  {
+  int err;             /* IMAL error code */
+
+  imal_lock();
+  err = check_block(passed_ptr);
+  imal_unlock();
+  return err;
+  } /* end of mem_check_block function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         check_block
+ * PURPOSE      Check allocated block / all blocks (see
+ *              mem_check_block); called with IMAL lock kept.
+ * ARGUMENTS    IN VPTR ptr - Allocated block pointer or NULL.
+ * RETURNS      IMAL error code (see mem_check_block).
+ * EXTERNS      None
+ * NOTE         None
+ ---------------------------------------------------------------------*/
+
+static int check_block(passed_ptr)
 IN VPTR passed_ptr;
   {
   VPTR ptr;            /* Pointer to the checked blocks      */
@@ -1203,6 +1448,12 @@ IN VPTR passed_ptr;
         {
         return MEM_ERR_RELEASED;
         }
+      /* Check is block taken from pool (it has no list pointers) */
+      if (single_fl && POOLED_BLOCK(ptr))
+        {
+        return imal_class_id_to_ptr(IMAL_POOL_CLASS_ID(ptr)) != NULL ?
+               MEM_OK : MEM_ERR_FATAL;
+        }
       checking_result |= CHECK_BAD_PREFIX;
       }
     else /* Prefix OK. Check block's postfix */
@@ -1280,7 +1531,7 @@ IN VPTR passed_ptr;
   if (block_cnt != imal_blocks_number)
     return MEM_ERR_FATAL;      /* Wrong number of blocks in list */
   return MEM_OK;
-  } /* end of mem_check_block function */
+  } /* end of check_block function */
 
 /* --------------------------------------------------------------------
  * NAME         mem_block
@@ -1312,7 +1563,8 @@ IN VPTR ptr;   /* Some pointer */
     return MEM_ERR_NOT_FOUND;
   if (imal_tag_check_fl == TRUE)
     {
-    if (!IMAL_BLOCK_EQUAL_PREFIX(ptr, IMAL_TAG_PREFIX))
+    if (!IMAL_BLOCK_EQUAL_PREFIX(ptr, IMAL_TAG_PREFIX) &&
+        !POOLED_BLOCK(ptr))
       {
       return IMAL_BLOCK_EQUAL_PREFIX(ptr, IMAL_TAG_NO_CHECK) ?
              MEM_WARN_CLASS_NO_CHECK : MEM_ERR_NOT_FOUND;
@@ -1333,7 +1585,16 @@ IN VPTR ptr;   /* Some pointer */
 
 int mem_empty()
   {
-  return (block_head.next == &block_head) ? MEM_OK : MEM_ERR_NOT_EMPTY;
+  SIZE_T pool_num;     /* Number of blocks taken from pools */
+  SIZE_T dummy;
+  int err;             /* IMAL error code                   */
+
+  imal_lock();
+  total_info(MEM_INFO_CURRENT, &pool_num, &dummy, &dummy);
+  err = (block_head.next == &block_head && pool_num == 0) ?
+        MEM_OK : MEM_ERR_NOT_EMPTY;
+  imal_unlock();
+  return err;
   } /* end of mem_empty function */
 
 
@@ -1355,6 +1616,30 @@ int mem_empty()
  ---------------------------------------------------------------------*/
 
 int mem_print_list(stream)
+INOUT FILE *stream;          /* Opened stream */
+  {
+  int err;            /* IMAL error code */
+
+  imal_lock();
+  err = print_list(stream);
+  imal_unlock();
+  return err;
+  } /* end of mem_print_list function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         print_list
+ * PURPOSE      Print map of allocated memory (see mem_print_list);
+ *              called with IMAL lock kept.
+ * ARGUMENTS    INOUT FILE *stream - Opened stream
+ * RETURNS      MEM_OK / MEM_ERR_IO / MEM_ERR_NULL_PTR
+ * EXTERNS      None
+ * NOTE         Blocks taken from pools are counted only, the
+ *              counter and statistic are exact when other threads
+ *              do not allocate/release blocks.
+ ---------------------------------------------------------------------*/
+
+static int print_list(stream)
 INOUT FILE *stream;          /* Opened stream */
   {
   VPTR pblock;        /* Current block                                */
@@ -1366,6 +1651,9 @@ INOUT FILE *stream;          /* Opened stream */
   SIZE_T size;        /* Size of the current block                    */
   SIZE_T csize;       /* Size of the current block's control part     */
   SIZE_T no_check_num; /* number of blocks of NO_CHECK class   */
+  SIZE_T pool_num;    /* Number of blocks taken from pools            */
+  SIZE_T cur_size, cur_csize; /* Current total sizes                  */
+  SIZE_T max_size, max_csize; /* Maximum total sizes                  */
   char *err_sign;     /* Error message prefix                         */
   char *err_list;     /* Error message about block's list damage      */
   char *err_unknown;  /* Used instead names of damaged blocks/classes */
@@ -1377,13 +1665,19 @@ INOUT FILE *stream;          /* Opened stream */
   err_list = "Allocated block's list corrupted: ";
   err_unknown = "UNKNOWN";
   no_check_num = imal_class_id_to_ptr(MEM_CLASS_NO_CHECK)->block_num;
+  total_info(MEM_INFO_CURRENT, &pool_num, &cur_size, &cur_csize);
+  total_info(MEM_INFO_MAX, &pool_num, &max_size, &max_csize);
   if (fprintf(stream,
         "IMAL: There are %Id ordinary allocated blocks now\n",
         imal_blocks_number) <= 0 ||
       (no_check_num > 0 &&
        fprintf(stream,
          "      There are %Id allocated blocks of NO_CHECK class now\n",
-         no_check_num) <= 0))
+         no_check_num) <= 0) ||
+      (pool_num > 0 &&
+       fprintf(stream,
+         "      There are %Id blocks allocated in FAST mode now\n",
+         pool_num) <= 0))
     {
     imal_err(MEM_ERR_IO);
     return MEM_ERR_IO;
@@ -1486,16 +1780,16 @@ INOUT FILE *stream;          /* Opened stream */
 
   if (fprintf(stream,
       "  Current: Total size: %Id  Control structures: %Id\n",
-      total_blocks_size, total_csize) <= 0 ||
+      cur_size, cur_csize) <= 0 ||
       fprintf(stream,
       "  Maximum: Total size: %Id  Control structures: %Id\n",
-      max_blocks_size, max_csize) <= 0)
+      max_size, max_csize) <= 0)
     {
     imal_err(MEM_ERR_IO);
     return MEM_ERR_IO;
     }
   return MEM_OK;
-  } /* end of mem_print_list function */
+  } /* end of print_list function */
 
 /* --------------------------------------------------------------------
  * NAME         mem_print_class
@@ -1520,6 +1814,30 @@ INOUT FILE *stream;          /* Opened stream */
 
 int mem_print_class(stream, class_id)
 INOUT FILE *stream;    /* Opened stream */
+IN int class_id;       /* Class ident or MEM_NOT_CLASS */
+  {
+  int err;             /* IMAL error code */
+
+  imal_lock();
+  err = print_class(stream, class_id);
+  imal_unlock();
+  return err;
+  } /* end of mem_print_class function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         print_class
+ * PURPOSE      Print class information (see mem_print_class);
+ *              called with IMAL lock kept.
+ * ARGUMENTS    INOUT FILE *stream - Opened stream
+ *              IN int class_id - Class ident or MEM_NOT_CLASS
+ * RETURNS      MEM_OK / MEM_ERR_IO / MEM_ERR_NULL_PTR
+ * EXTERNS      None
+ * NOTE         None
+ ---------------------------------------------------------------------*/
+
+static int print_class(stream, class_id)
+INOUT FILE *stream;    /* Opened stream */
 IN int class_id;       /* Class ident or MEM_NOT_CLASS */
   {
   int err;             /* IMAL error code                      */
@@ -1550,7 +1868,7 @@ IN int class_id;       /* Class ident or MEM_NOT_CLASS */
     while ((cur_class_id = imal_class_next(cur_class_id)) !=
             MEM_NOT_CLASS)
       {
-      output_err = mem_print_class(stream, cur_class_id);
+      output_err = print_class(stream, cur_class_id);
       if (err == MEM_OK)
         err = mem_error();
       if (output_err != MEM_OK)
@@ -1600,7 +1918,7 @@ IN int class_id;       /* Class ident or MEM_NOT_CLASS */
     return MEM_ERR_IO;
     }
   return MEM_OK;
-  } /* end of mem_print_class function */
+  } /* end of print_class function */
 
 
 /* --------------------------------------------------------------------
@@ -1641,6 +1959,7 @@ OUT SIZE_T *cblk_size;  /* Return: control block size */
   time of the program".
 */
   {
+  SIZE_T dummy;
 
   if (blk_size == NULL || cblk_size == NULL)
     return MEM_ERR_NULL_PTR;
@@ -1657,6 +1976,12 @@ OUT SIZE_T *cblk_size;  /* Return: control block size */
         *cblk_size = 0;
         return MEM_ERR_NOT_FOUND;
         }
+      if (POOLED_BLOCK(ptr))
+        {
+        *blk_size = IMAL_POOL_USER_LEN(ptr);
+        *cblk_size = IMAL_POOL_CONTROL_SIZE(ptr);
+        return MEM_OK;
+        }
       *blk_size = IMAL_BLOCK_USER_LEN(ptr);
       *cblk_size = IMAL_BLOCK_CONTROL_SIZE(ptr);
       return MEM_OK;
@@ -1664,8 +1989,7 @@ OUT SIZE_T *cblk_size;  /* Return: control block size */
 
     /* CASE  Total size of the all allocated blocks */
 
-    *blk_size = total_blocks_size;
-    *cblk_size = total_csize;
+    total_info(MEM_INFO_CURRENT, &dummy, blk_size, cblk_size);
     return MEM_OK;
     } /* end of IF MODE_CURRENT */
 
@@ -1673,8 +1997,7 @@ OUT SIZE_T *cblk_size;  /* Return: control block size */
 
   if (mode == MEM_INFO_MAX)
     {
-    *blk_size = max_blocks_size;
-    *cblk_size = max_csize;
+    total_info(MEM_INFO_MAX, &dummy, blk_size, cblk_size);
     return MEM_OK;
     }
 
@@ -1714,6 +2037,7 @@ OUT SIZE_T *cblk_size;  /* total control part size*/
 */
   {
   CLASS_INFO *pclass;  /* Class descriptor pointer */
+  int err;             /* IMAL error code */
 
   if (blk_num == NULL || blk_size == NULL || cblk_size == NULL)
     return MEM_ERR_NULL_PTR;
@@ -1721,31 +2045,20 @@ OUT SIZE_T *cblk_size;  /* total control part size*/
   *blk_num = 0;
   *blk_size = 0;
   *cblk_size = 0;
-  if ((pclass = imal_class_id_to_ptr(class_id)) == NULL)
-    return imal_class_check_id(class_id);
-
-  /* CASE Get info about current blocks */
-
-  if (mode == MEM_INFO_CURRENT)
-    {
-    *blk_num = pclass->block_num;
-    *blk_size = pclass->block_size;
-    *cblk_size = pclass->block_csize;
-    return MEM_OK;
-    }
+  if (mode != MEM_INFO_CURRENT && mode != MEM_INFO_MAX)
+    return MEM_ERR_MODE_BAD;            /* Wrong mode parameter */
 
-  /* CASE Get info about maximum memory occupied by the class */
-
-  if (mode == MEM_INFO_MAX)
+  imal_lock();
+  if ((pclass = imal_class_id_to_ptr(class_id)) == NULL)
     {
-    *blk_num = pclass->max_block_num;
-    *blk_size = pclass->max_block_size;
-    *cblk_size = pclass->max_block_csize;
-    return MEM_OK;
+    err = imal_class_check_id(class_id);
+    imal_unlock();
+    return err;
     }
 
-  /* Wrong mode parameter */
-  return MEM_ERR_MODE_BAD;
+  class_info(pclass, class_id, mode, blk_num, blk_size, cblk_size);
+  imal_unlock();
+  return MEM_OK;
   } /* end of mem_class_size function */
 
 
@@ -1759,6 +2072,7 @@ OUT SIZE_T *cblk_size;  /* total control part size*/
  * EXTERNS      None
  * NOTE         For the class MEM_CLASS_NO_CHECK result will be
  *              NULL; *p_class_id will be MEM_CLASS_NO_CHECK.
+ *              Name of block allocated in FAST mode is "NO_NAME".
  *              if  flag  imal_tag_check_fl  is   set   to  FALSE
  *              function   does   not   check   allocated   block
  *              prefix/postfix.
@@ -1773,6 +2087,12 @@ OUT int *p_class_id;    /* class identifier */
   switch (mem_block(ptr))       /* Result of ptr checking */
     {
     case MEM_OK:
+      if (POOLED_BLOCK(ptr))    /* Block from pool has no name */
+        {
+        if (p_class_id != NULL)
+          *p_class_id = IMAL_POOL_CLASS_ID(ptr);
+        return "NO_NAME";
+        }
       if (p_class_id != NULL)
         *p_class_id = IMAL_BLOCK_CLASS_ID(ptr);
       name = IMAL_BLOCK_NAME(ptr);
@@ -1813,9 +2133,36 @@ OUT int *p_class_id;    /* class identifier */
  *              Function   does   not   check   allocated   block
  *              prefix/postfix  if  flag   imal_tag_check_fl   is
  *              FALSE.
+ *              Blocks allocated in FAST mode are not walked.
  ---------------------------------------------------------------------*/
 
 int mem_block_next(pptr, class_id)
+INOUT VPTR *pptr;  /* pointer to variable which contained */
+                   /* allocated block pointer or NULL     */
+IN int class_id;   /* class identifier or MEM_NOT_CLASS   */
+  {
+  int err;             /* IMAL error code */
+
+  imal_lock();
+  err = block_next(pptr, class_id);
+  imal_unlock();
+  return err;
+  } /* end of mem_block_next function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         block_next
+ * PURPOSE      Get address of the first/next allocated block (see
+ *              mem_block_next); called with IMAL lock kept.
+ * ARGUMENTS    INOUT VPTR *pptr - Pointer to variable which contained
+ *                                 allocated block pointer or NULL.
+ *              IN int class_id - Class identifier or MEM_NOT_CLASS.
+ * RETURNS      IMAL error code (see mem_block_next).
+ * EXTERNS      None
+ * NOTE         None
+ ---------------------------------------------------------------------*/
+
+static int block_next(pptr, class_id)
 INOUT VPTR *pptr;  /* pointer to variable which contained */
                    /* allocated block pointer or NULL     */
 IN int class_id;   /* class identifier or MEM_NOT_CLASS   */
@@ -1831,6 +2178,11 @@ IN int class_id;   /* class identifier or MEM_NOT_CLASS   */
       *pptr = NULL;
       return mem_check_block(ptr);     /* Find what is wrong with ptr */
       }
+    if (POOLED_BLOCK(ptr))      /* Block from pool is not in the list */
+      {
+      *pptr = NULL;
+      return MEM_ERR_NOT_FOUND;
+      }
     }
   /* ptr is the current block pointer or NULL */
 
@@ -1871,7 +2223,7 @@ IN int class_id;   /* class identifier or MEM_NOT_CLASS   */
     } /* End of else (class_id is identifier) */
 
   return MEM_OK;
-  } /* end of mem_block_next function */
+  } /* end of block_next function */
 
 
                         /* Interface functions */
@@ -1882,19 +2234,26 @@ IN int class_id;   /* class identifier or MEM_NOT_CLASS   */
  * ARGUMENTS    IN int debug_mode  - Debug mode value
  *              IN int trace_mode  - Warning mode value
  *              IN int modify_mode - Modify mode value
+ *              IN int fast_mode   - Fast mode value
  * RETURNS      None
  * EXTERNS      None
- * NOTE         None
+ * NOTE         FAST mode is turned off while any of debug, trace
+ *              or modify modes is set.
  ---------------------------------------------------------------------*/
 
-VOID imal_mode_set(debug_mode, trace_mode, modify_mode)
+VOID imal_mode_set(debug_mode, trace_mode, modify_mode, fast_mode)
 IN int debug_mode;   /* Debug mode value    */
 IN int trace_mode;   /* Warning mode value  */
 IN int modify_mode;  /* Modify mode value   */
+IN int fast_mode;    /* Fast mode value     */
   {
   imal_mode_debug_fl = (BOOL)(debug_mode == (int)TRUE ? TRUE : FALSE);
   imal_mode_trace_fl = (BOOL)(trace_mode == (int)TRUE ? TRUE : FALSE);
   imal_mode_modify_fl = (BOOL)(modify_mode == (int)TRUE ? TRUE : FALSE);
+  imal_mode_fast_fl = (BOOL)(fast_mode == (int)TRUE &&
+                             imal_mode_debug_fl == FALSE &&
+                             imal_mode_trace_fl == FALSE &&
+                             imal_mode_modify_fl == FALSE ? TRUE : FALSE);
   } /* end of imal_mode_set function */
 
 
@@ -1917,6 +2276,64 @@ IN SIZE_T dcsize;
   } /* end of imal_add_csize function */
 
 
+/* --------------------------------------------------------------------
+ * NAME         imal_add_pool_stat
+ * PURPOSE      Merge statistic of class kept in thread cache (blocks
+ *              taken from pools) into class descriptor and total
+ *              statistic.
+ * ARGUMENTS    IN int class_id    - Class identifier.
+ *              IN SIZE_T dnum     - Change of blocks number
+ *              IN SIZE_T dsize    - Change of blocks size
+ *              IN SIZE_T dcsize   - Change of control parts size
+ * RETURNS      None
+ * EXTERNS      None
+ * NOTE         Changes are modulo SIZE_T. IMAL lock should be kept.
+ *              The changes should be removed from the cache before
+ *              the call.
+ ---------------------------------------------------------------------*/
+
+VOID imal_add_pool_stat(class_id, dnum, dsize, dcsize)
+IN int class_id;
+IN SIZE_T dnum;
+IN SIZE_T dsize;
+IN SIZE_T dcsize;
+  {
+  CLASS_INFO *pclass;  /* Class descriptor */
+  SIZE_T num, size, csize; /* Merged statistic */
+
+  if ((pclass = imal_class_id_to_ptr(class_id)) == NULL)
+    return;
+
+  /* Correct statistic variables */
+  pool_blocks_number += dnum;
+  pool_blocks_size += dsize;
+  pool_csize += dcsize;
+  pclass->pool_block_num += dnum;
+  pclass->pool_block_size += dsize;
+  pclass->pool_block_csize += dcsize;
+
+  /* Correct maximum values. Caches of other threads are not */
+  /* read (they are changed meanwhile), therefore merged     */
+  /* values can be "negative": block taken by one thread can */
+  /* be released by another one.                             */
+  size = total_blocks_size + pool_blocks_size;
+  csize = total_csize + pool_csize;
+  if (STAT_GREATER(size, max_blocks_size))
+    max_blocks_size = size;
+  if (STAT_GREATER(csize, max_csize))
+    max_csize = csize;
+  num = pclass->block_num + pclass->pool_block_num;
+  size = pclass->block_size + pclass->pool_block_size;
+  csize = pclass->block_csize + pclass->pool_block_csize;
+  if (STAT_GREATER(num, pclass->max_block_num))
+    pclass->max_block_num = num;
+  if (STAT_GREATER(size, pclass->max_block_size))
+    pclass->max_block_size = size;
+  if (STAT_GREATER(csize, pclass->max_block_csize))
+    pclass->max_block_csize = csize;
+  } /* end of imal_add_pool_stat function */
+
+
 /* --------------------------------------------------------------------
  * NAME         imal_get_damage_info
  * PURPOSE      Get info about damaged block which has been set by
@@ -1970,6 +2387,243 @@ OUT int *class_id;
                        /* Auxiliary functions */
 
 
+/* --------------------------------------------------------------------
+ * NAME         total_info
+ * PURPOSE      Get total statistic including blocks of thread caches.
+ * ARGUMENTS    IN int mode - MEM_INFO_CURRENT or MEM_INFO_MAX
+ *              OUT SIZE_T *pool_num - Number of blocks taken from
+ *                                     pools (current).
+ *              OUT SIZE_T *blk_size  - Total blocks size
+ *              OUT SIZE_T *cblk_size - Total control parts size
+ * RETURNS      None
+ * EXTERNS      None
+ * NOTE         Maximum of blocks taken from pools is updated when
+ *              statistic of cache is merged or current statistic is
+ *              queried, therefore it is approximate. Current values
+ *              are exact when other threads do not allocate/release
+ *              blocks.
+ ---------------------------------------------------------------------*/
+
+static VOID total_info(mode, pool_num, blk_size, cblk_size)
+IN int mode;
+OUT SIZE_T *pool_num;
+OUT SIZE_T *blk_size;
+OUT SIZE_T *cblk_size;
+  {
+  SIZE_T dnum, dsize, dcsize; /* Statistic kept in thread caches */
+
+  imal_lock();
+  imal_pool_stat(MEM_NOT_CLASS, &dnum, &dsize, &dcsize);
+  *pool_num = pool_blocks_number + dnum;
+  *blk_size = total_blocks_size + pool_blocks_size + dsize;
+  *cblk_size = total_csize + pool_csize + dcsize;
+
+  /* Maximum can not be less than the reported current value */
+  if (STAT_GREATER(*blk_size, max_blocks_size))
+    max_blocks_size = *blk_size;
+  if (STAT_GREATER(*cblk_size, max_csize))
+    max_csize = *cblk_size;
+  if (mode == MEM_INFO_MAX)
+    {
+    *blk_size = max_blocks_size;
+    *cblk_size = max_csize;
+    }
+  imal_unlock();
+  } /* end of total_info function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         class_info
+ * PURPOSE      Get class statistic including blocks of thread caches.
+ * ARGUMENTS    IN CLASS_INFO *pclass - Class descriptor
+ *              IN int class_id       - Class identifier
+ *              IN int mode - MEM_INFO_CURRENT or MEM_INFO_MAX
+ *              OUT SIZE_T *blk_num   - Blocks number
+ *              OUT SIZE_T *blk_size  - Blocks size
+ *              OUT SIZE_T *cblk_size - Control parts size
+ * RETURNS      None
+ * EXTERNS      None
+ * NOTE         IMAL lock should be kept. See also total_info.
+ ---------------------------------------------------------------------*/
+
+static VOID class_info(pclass, class_id, mode, blk_num, blk_size, cblk_size)
+IN CLASS_INFO *pclass;
+IN int class_id;
+IN int mode;
+OUT SIZE_T *blk_num;
+OUT SIZE_T *blk_size;
+OUT SIZE_T *cblk_size;
+  {
+  SIZE_T dnum, dsize, dcsize; /* Statistic kept in thread caches */
+
+  imal_pool_stat(class_id, &dnum, &dsize, &dcsize);
+  *blk_num = pclass->block_num + pclass->pool_block_num + dnum;
+  *blk_size = pclass->block_size + pclass->pool_block_size + dsize;
+  *cblk_size = pclass->block_csize + pclass->pool_block_csize + dcsize;
+
+  /* Maximum can not be less than the reported current value */
+  if (STAT_GREATER(*blk_num, pclass->max_block_num))
+    pclass->max_block_num = *blk_num;
+  if (STAT_GREATER(*blk_size, pclass->max_block_size))
+    pclass->max_block_size = *blk_size;
+  if (STAT_GREATER(*cblk_size, pclass->max_block_csize))
+    pclass->max_block_csize = *cblk_size;
+  if (mode == MEM_INFO_MAX)
+    {
+    *blk_num = pclass->max_block_num;
+    *blk_size = pclass->max_block_size;
+    *cblk_size = pclass->max_block_csize;
+    }
+  } /* end of class_info function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         fast_free
+ * PURPOSE      Return block to its pool.
+ * ARGUMENTS    IN VPTR ptr - Block taken by imal_pool_alloc().
+ *              IN char *filename;          - Source file name
+ *              IN int fileline;            - Source line
+ * RETURNS      IMAL error code (see mem_free_fun).
+ * EXTERNS      None
+ * NOTE         Block can be released when FAST mode is turned off,
+ *              therefore debug/trace/modify modes are considered.
+ *              IMAL lock is taken only in these modes (or if the
+ *              block is wrong).
+ ---------------------------------------------------------------------*/
+
+static int fast_free(ptr, filename, fileline)
+IN VPTR ptr;
+IN char *filename;
+IN int fileline;
+  {
+  int debug_err;       /* IMAL error code: result of debug checking*/
+  SIZE_T size;         /* Size of user's part of block             */
+  char *p;             /* Pointer used for user's data modification*/
+
+  /* FAST mode: nothing to check or trace */
+  if (imal_mode_fast_fl == TRUE && imal_pool_free(ptr) == SUCCESS)
+    return MEM_OK;
+
+  imal_lock();
+  if (imal_class_id_to_ptr(IMAL_POOL_CLASS_ID(ptr)) == NULL)
+    {
+    if (imal_mode_trace_fl == TRUE)
+      {
+      trace_out('F', "NO_NAME", NULL, 0, 0, filename, fileline,
+                ptr, NULL, MEM_ERR_FATAL);
+      }
+    imal_error_proc(MEM_ERR_FATAL, "mem_free", filename, fileline, NULL, 0);
+    /* !!! Program can be stopped in imal_error_proc() */
+    imal_unlock();
+    return MEM_ERR_FATAL;
+    }
+
+  /* Make debug checking if necessary */
+  debug_err = MEM_OK;
+  if (imal_mode_debug_fl == TRUE)
+    {
+    debug_err = imal_debug(filename, fileline);
+    /* !!! Program can be stopped in imal_debug() */
+    }
+
+  /* Trace successful FREE operation */
+  size = IMAL_POOL_USER_LEN(ptr);
+  if (imal_mode_trace_fl == TRUE)
+    {
+    trace_out('F', "NO_NAME", mem_query_class(IMAL_POOL_CLASS_ID(ptr)),
+              size, 1, filename, fileline, ptr, NULL, MEM_OK);
+    }
+
+  /* Modify user's data (to avoid further block usage) */
+  if (imal_mode_modify_fl == TRUE)
+    {
+    for (p = ((char*)ptr) + size; --p >= (char*)ptr; *p = (char)~(*p));
+    }
+
+  /* Return block and correct statistic */
+  imal_pool_free(ptr);
+  imal_unlock();
+  return debug_err;
+  } /* end of fast_free function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         fast_realloc
+ * PURPOSE      Resize block taken from pool.
+ * ARGUMENTS    IN VPTR ptr - Block taken by imal_pool_alloc().
+ *              IN SIZE_T new_size - Size of a new block.
+ *              IN char *file - Source file name.
+ *              IN int line   - Source line.
+ * RETURNS      Block pointer or NULL. IMAL error code will be set.
+ * EXTERNS      None
+ * NOTE         Block stays in its slot while the new size fits the
+ *              slot; otherwise a new block is allocated by
+ *              mem_alloc_fun() (it can be an ordinary block).
+ *              IMAL lock should be kept.
+ ---------------------------------------------------------------------*/
+
+static VPTR fast_realloc(ptr, new_size, file, line)
+IN VPTR ptr;
+IN SIZE_T new_size;
+IN char *file;
+IN int line;
+  {
+  int class_id;        /* Block's class identifier        */
+  VPTR new_ptr;        /* Resized block                   */
+  SIZE_T size;         /* Current size of user's part     */
+  BOOL save_trace;     /* Trace mode flag                 */
+
+  class_id = IMAL_POOL_CLASS_ID(ptr);
+  size = IMAL_POOL_USER_LEN(ptr);
+  if (imal_class_id_to_ptr(class_id) == NULL)
+    {
+    imal_err(MEM_ERR_FATAL);
+    if (imal_mode_trace_fl == TRUE)
+      {
+      trace_out('R', "NO_NAME", NULL, size, new_size, file, line,
+                ptr, NULL, MEM_ERR_FATAL);
+      }
+    return NULL;
+    }
+
+  save_trace = imal_mode_trace_fl;
+  imal_mode_trace_fl = FALSE;
+
+  if (new_size == 0)            /* free() functionality */
+    {
+    imal_err(mem_free_fun(ptr, file, line));
+    new_ptr = NULL;
+    }
+  else if (new_size <= imal_pool_capacity(ptr))
+    {
+    /* Resize block in its slot */
+    imal_pool_resize(ptr, new_size);
+    new_ptr = ptr;
+    }
+  else
+    {
+    /* Move block to the greater one */
+    new_ptr = mem_alloc_fun(class_id, imal_default_name(file, line),
+                            new_size, file, line);
+    if (new_ptr != NULL)
+      {
+      memcpy(new_ptr, ptr, size);
+      mem_free_fun(ptr, file, line);
+      imal_err(MEM_OK);
+      }
+    }
+
+  imal_mode_trace_fl = save_trace;
+
+  if (imal_mode_trace_fl == TRUE)
+    {
+    trace_out('R', "NO_NAME", mem_query_class(class_id),
+              size, new_size, file, line, ptr, new_ptr, mem_error());
+    }
+  return new_ptr;
+  } /* end of fast_realloc function */
+
+
 /* --------------------------------------------------------------------
  * NAME         trace_out
  * PURPOSE      Print trace info about mem_alloc/mem_calloc/mem_free
@@ -15,6 +15,15 @@
 #define _IMAL_LOC_H_
 
 
+/*------------------- THREAD LOCAL STORAGE --------------------*/
+
+#if (OS_MARK == 'I')
+#define  IMAL_THREAD  __declspec(thread)
+#else
+#define  IMAL_THREAD  __thread
+#endif
+
+
 /*--------------------- TYPE DEFINITIONS ----------------------*/
 
                        /* Module imal */
@@ -33,6 +42,14 @@ typedef struct block_control_info  /* allocated block control part */
   SIZE_T block_size;         /* size of user's block */
   } BLOCK_CONTROL_INFO;
 
+typedef struct pool_control_info   /* control part of pooled block */
+  {
+  int class_id;                /* ident. of block's class descriptor */
+  int pool;                    /* index of pool (see pool.c) */
+  SIZE_T block_size;           /* size of user's block */
+  VPTR owner;                  /* cache which owns the slot */
+  } POOL_CONTROL_INFO;
+
 
                        /* Module class */
 
@@ -49,6 +66,10 @@ typedef struct class_info     /* Information about class */
   SIZE_T block_csize;         /* Size of blocks control parts   */
   SIZE_T max_block_csize;     /* Maximum memory occupied by c.parts*/
                               /* during run time of the program.   */
+  SIZE_T pool_block_num;      /* Number, size and control parts  */
+  SIZE_T pool_block_size;     /* size of blocks taken from pools */
+  SIZE_T pool_block_csize;    /* (merged from thread caches,     */
+                              /* modulo SIZE_T).                 */
   } CLASS_INFO;
 
 
@@ -78,6 +99,9 @@ ALIGN is defined into int_env.h.
 #define IMAL_TAG_RELEASED   0x6becadf1L
           /* Released block tag */
 
+#define IMAL_TAG_POOLED     0x5e47c3d2L
+          /* Prefix of block taken from pool in FAST mode */
+
 #define IMAL_TAG_LOCKED     ((short) 0xb71c)   /* 0xfda9b71cL */
           /* Locked buffer reference tag */
 
@@ -250,6 +274,43 @@ Blocks of  default  class  MEM_CLASS_NO_CHECK has more simple form:
   ((VPTR) (((char*)(ptr)) + IMAL_TAG_SIZE))
 
 
+                /* Pooled block macros */
+
+/*
+Blocks allocated in FAST mode are taken from pools of slots of the
+same size (see pool.c). Such block has no name and is not inserted
+into the list of allocated blocks:
+
+  POOL INFO - struct POOL_CONTROL_INFO, aligned.
+  POOLED tag - max(ALIGN,2) bytes, value is IMAL_TAG_POOLED.
+  USER'S DATA BLOCK - aligned, up to the capacity of pool.
+*/
+
+#define IMAL_POOL_MAX_SIZE  512  /* Maximum size of pooled block */
+
+#define POOL_CONTROL_INFO_SIZE \
+  (((sizeof(POOL_CONTROL_INFO) + ALIGN - 1) / ALIGN) * ALIGN)
+
+/* Pool info structure (user_block) */
+#define IMAL_POOL_INFO(uptr)                \
+  ((POOL_CONTROL_INFO *) (((char*)(uptr)) - \
+    (IMAL_TAG_SIZE + POOL_CONTROL_INFO_SIZE)))
+
+#define IMAL_POOL_CLASS_ID(uptr) (IMAL_POOL_INFO(uptr)->class_id)
+#define IMAL_POOL_INDEX(uptr)    (IMAL_POOL_INFO(uptr)->pool)
+#define IMAL_POOL_USER_LEN(uptr) (IMAL_POOL_INFO(uptr)->block_size)
+#define IMAL_POOL_OWNER(uptr)    (IMAL_POOL_INFO(uptr)->owner)
+
+/* Give user's part address by slot address */
+#define IMAL_POOL_SYS_TO_USER(ptr) \
+  ((VPTR) (((char*)(ptr)) + (POOL_CONTROL_INFO_SIZE + IMAL_TAG_SIZE)))
+
+/* Control part size (includes unused tail of the slot) */
+#define IMAL_POOL_CONTROL_SIZE(uptr) \
+  (POOL_CONTROL_INFO_SIZE + IMAL_TAG_SIZE + \
+   imal_pool_capacity(uptr) - IMAL_POOL_USER_LEN(uptr))
+
+
 /*------------------------ PROTOTYPES -------------------------*/
 
                         /* Module mode */
@@ -263,9 +324,10 @@ extern int imal_print_damaged_block(INOUT FILE *, IN VPTR, IN SIZE_T);
                         /* Module imal */
 
 extern VOID imal_get_damage_info(OUT VPTR*, OUT SIZE_T*);
-extern VOID imal_mode_set(IN int, IN int, IN int);
+extern VOID imal_mode_set(IN int, IN int, IN int, IN int);
 extern VOID imal_get_corrupted_info(IN VPTR, OUT char**, OUT SIZE_T*, OUT int *);
 extern VOID imal_add_csize(IN SIZE_T);
+extern VOID imal_add_pool_stat(IN int, IN SIZE_T, IN SIZE_T, IN SIZE_T);
 
                         /* Module rtl */
 
@@ -275,6 +337,21 @@ extern VOID imal_mode_rtl_set(IN int, IN int);
 
 extern VOID imal_get_locked_damage_info(OUT VPTR*);
 
+                        /* Module pool */
+
+extern VPTR imal_pool_alloc(IN int, IN SIZE_T);
+extern int imal_pool_free(IN VPTR);
+extern int imal_pool_resize(IN VPTR, IN SIZE_T);
+extern SIZE_T imal_pool_capacity(IN VPTR);
+extern VOID imal_pool_stat(IN int, OUT SIZE_T*, OUT SIZE_T*, OUT SIZE_T*);
+extern VOID imal_pool_forget_class(IN int);
+extern VOID imal_pool_release(void);
+
+                        /* Module lock */
+
+extern VOID imal_lock(void);
+extern VOID imal_unlock(void);
+
                         /* Module class */
 
 extern CLASS_INFO *imal_class_id_to_ptr(IN int);
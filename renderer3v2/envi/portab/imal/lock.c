@@ -0,0 +1,156 @@
+/*
+ * MODULE NAME  LOCK.C
+ * PURPOSE      Lock of IMAL internal data structures (block list,
+ *              class descriptors, locked buffer list, pools). All
+ *              IMAL library functions which use these structures
+ *              keep the lock, so IMAL may be called from several
+ *              threads.
+ *
+ * CODING                                             2026.10.18
+ *
+ * LAST UPDATED
+ *
+ * NOTE         The lock is recursive: IMAL functions call each other.
+ */
+
+#ifdef TIPE
+#undef TIPE
+#endif
+
+#if (OS_MARK == 'I')
+#include <windows.h>
+#endif
+
+/* COMPANY INCLUDES */
+
+#define IMAL_NO_C_RTL_MACRO  /* Turn off macros for C RTL functions */
+
+#include "integra.h"
+
+#if (OS_MARK != 'I')
+#include <pthread.h>
+#endif
+
+#include "imal.h"
+
+
+/* PROJECT INCLUDE: */
+
+#include "imal_loc.h"
+
+
+/****************************** DATA **********************************/
+
+#if (OS_MARK == 'I')
+
+static INIT_ONCE imal_lock_once = INIT_ONCE_STATIC_INIT;
+static CRITICAL_SECTION imal_lock_section;
+
+#else
+
+static pthread_once_t imal_lock_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t imal_lock_mutex;
+
+#endif
+
+/*
+The lock is created by the first imal_lock() call and is never
+destroyed: IMAL can be initialized again after mem_close().
+*/
+
+
+/* STATIC PROTOTYPES */
+
+#if (OS_MARK == 'I')
+static BOOL CALLBACK lock_create PROT((PINIT_ONCE, PVOID, PVOID *));
+#else
+static VOID lock_create PROT((void));
+#endif
+
+/****************************** CODE **********************************/
+
+
+                     /* Interface functions */
+
+
+/* --------------------------------------------------------------------
+ * NAME         imal_lock
+ * PURPOSE      Lock IMAL internal data; wait while other thread
+ *              keeps them.
+ * ARGUMENTS    None
+ * RETURNS      None
+ * EXTERNS      None
+ * NOTE         Every call should be paired with imal_unlock().
+ ---------------------------------------------------------------------*/
+
+VOID imal_lock()
+  {
+#if (OS_MARK == 'I')
+  InitOnceExecuteOnce(&imal_lock_once, lock_create, NULL, NULL);
+  EnterCriticalSection(&imal_lock_section);
+#else
+  pthread_once(&imal_lock_once, lock_create);
+  pthread_mutex_lock(&imal_lock_mutex);
+#endif
+  } /* end of imal_lock function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         imal_unlock
+ * PURPOSE      Unlock IMAL internal data.
+ * ARGUMENTS    None
+ * RETURNS      None
+ * EXTERNS      None
+ * NOTE         None
+ ---------------------------------------------------------------------*/
+
+VOID imal_unlock()
+  {
+#if (OS_MARK == 'I')
+  LeaveCriticalSection(&imal_lock_section);
+#else
+  pthread_mutex_unlock(&imal_lock_mutex);
+#endif
+  } /* end of imal_unlock function */
+
+
+                       /* Auxiliary functions */
+
+
+/* --------------------------------------------------------------------
+ * NAME         lock_create
+ * PURPOSE      Create the recursive lock (called once).
+ * ARGUMENTS    None (Windows: arguments of InitOnceExecuteOnce
+ *              callback, not used)
+ * RETURNS      None (Windows: TRUE)
+ * EXTERNS      None
+ * NOTE         None
+ ---------------------------------------------------------------------*/
+
+#if (OS_MARK == 'I')
+
+static BOOL CALLBACK lock_create(once, param, context)
+PINIT_ONCE once;
+PVOID param;
+PVOID *context;
+  {
+  InitializeCriticalSection(&imal_lock_section);
+  return TRUE;
+  } /* end of lock_create function */
+
+#else
+
+static VOID lock_create()
+  {
+  pthread_mutexattr_t attr;   /* Attributes of the mutex */
+
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&imal_lock_mutex, &attr);
+  pthread_mutexattr_destroy(&attr);
+  } /* end of lock_create function */
+
+#endif
+
+
+/*** End of file LOCK.C ***/
@@ -68,12 +68,18 @@ static LOCKED_BUF_REF *locked_buf_head = NULL;
 
 /* Header of the one way list of references to locked buffers. */
 
-static int check_errno;
-static VPTR check_damage_ptr;
+static IMAL_THREAD int check_errno;
+static IMAL_THREAD VPTR check_damage_ptr;
 
-/* Result of the locked buffer list checking */
+/* Result of the locked buffer list checking (kept per thread) */
+
+/*
+Locked buffer list is accessed under IMAL lock (see lock.c).
+*/
 
 
+static int static_release(IN VPTR);
+static int check_locked(IN VPTR);
 static LOCKED_BUF_REF **imal_check_locked_ptr(IN VPTR);
 static long check_sum(IN VPTR, IN SIZE_T);
 
@@ -118,15 +124,17 @@ IN SIZE_T length;
     /* Not enough memory for the internal data */
     return MEM_ERR_NOT_MEMORY;
     }
-  imal_add_csize(sizeof(LOCKED_BUF_REF));
 
   /* Initialize locked reference block and insert it to the list */
   locked_ref->tag = IMAL_TAG_LOCKED;
-  locked_ref->next = locked_buf_head;
   locked_ref->buf = buf;
   locked_ref->length = length;
   locked_ref->check_sum = check_sum(buf, length);
+  imal_lock();
+  imal_add_csize(sizeof(LOCKED_BUF_REF));
+  locked_ref->next = locked_buf_head;
   locked_buf_head = locked_ref;
+  imal_unlock();
   return MEM_OK;
   } /* end of mem_static_lock function */
 
@@ -152,6 +160,28 @@ IN SIZE_T length;
  ---------------------------------------------------------------------*/
 
 int  mem_static_release(buf)
+IN VPTR buf;
+  {
+  int err;                     /* Checking result    */
+
+  imal_lock();
+  err = static_release(buf);
+  imal_unlock();
+  return err;
+  } /* end of mem_static_release function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         static_release
+ * PURPOSE      Check and unlock locked buffer / all buffers (see
+ *              mem_static_release); called with IMAL lock kept.
+ * ARGUMENTS    IN VPTR buf - Pointer to the locked buffer or NULL.
+ * RETURNS      IMAL error code (see mem_static_release).
+ * EXTERNS      None
+ * NOTE         None
+ ---------------------------------------------------------------------*/
+
+static int static_release(buf)
 IN VPTR buf;
   {
   LOCKED_BUF_REF *p, **pp;     /* Auxiliary pointers */
@@ -179,7 +209,7 @@ IN VPTR buf;
   /* CASE 'release all buffers' */
 
   /* Check buffers */
-  err = mem_check_locked(NULL);
+  err = check_locked(NULL);
   if (err != MEM_OK && err != MEM_ERR_BUFFER_DAMAGE)
     {
     return err;   /* Locked reference list is corrupted */
@@ -195,7 +225,7 @@ IN VPTR buf;
     } /* end while */
 
   return err;
-  } /* end of mem_static_release function */
+  } /* end of static_release function */
 
 
 /* --------------------------------------------------------------------
@@ -217,6 +247,28 @@ IN VPTR buf;
  ---------------------------------------------------------------------*/
 
 int  mem_check_locked(buf)
+IN VPTR buf;
+  {
+  int err;             /* Checking result               */
+
+  imal_lock();
+  err = check_locked(buf);
+  imal_unlock();
+  return err;
+  } /* end of mem_check_locked function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         check_locked
+ * PURPOSE      Check locked buffer / all buffers (see
+ *              mem_check_locked); called with IMAL lock kept.
+ * ARGUMENTS    IN VPTR buf - Pointer to the locked buffer or NULL.
+ * RETURNS      IMAL error code (see mem_check_locked).
+ * EXTERNS      None
+ * NOTE         None
+ ---------------------------------------------------------------------*/
+
+static int check_locked(buf)
 IN VPTR buf;
   {
   LOCKED_BUF_REF **pp; /* Pointer to the next reference */
@@ -259,7 +311,7 @@ IN VPTR buf;
     } /* end for */
 
   return err;
-  } /* end of mem_check_locked function */
+  } /* end of check_locked function */
 
 
                         /* Interface functions */
@@ -110,12 +110,12 @@ static ERROR_NAME err_tab[] =
   };
 
 
-static int mem_errno = MEM_ERR_NOT_INIT;
+static IMAL_THREAD int mem_errno = MEM_ERR_NOT_INIT;
 
 /*
 Result of the  last IMAL function  call. List of  IMAL  functions
 which set this variable  is  into mem_error() function codes (see
-below).
+below). It is kept per thread.
 */
 
 
@@ -135,6 +135,7 @@ Current   mode    level.   If   mode_stack_ind   is   less   than
 MODE_STACK_SIZE    then    current    mode   value   stored    in
 mode_stack[mode_stack_ind]   else    current   mode   value    is
 mode_stack[0].
+Mode stack is common for all threads, it is changed under IMAL lock.
 */
 
 static int continue_blk_fl = FALSE;
@@ -159,6 +160,7 @@ static BOOL imal_mode_trace_fl = FALSE;
 static BOOL imal_mode_warning_fl = FALSE;
 static BOOL imal_mode_continue_fl = FALSE;
 static BOOL imal_mode_modify_fl = FALSE;
+static BOOL imal_mode_fast_fl = FALSE;
 
 /* IMAL mode flags for mode.c (copies in imal.c and rtl.c are kept) */
 
@@ -169,6 +171,7 @@ static MODE_FLAG_REF envi_mode_tab[] =
     { "warning",  &imal_mode_warning_fl },
     { "continue", &imal_mode_continue_fl },
     { "modify",   &imal_mode_modify_fl },
+    { "fast",     &imal_mode_fast_fl },
     { NULL, NULL }  /* Terminator */
   };
 
@@ -245,6 +248,9 @@ IN int err;
 int mem_mode_open(mode)
 IN int mode;
   {
+  int err;     /* IMAL error code */
+
+  imal_lock();
   mode_stack_ind++;
   if (mode_stack_ind < MODE_STACK_SIZE)
     {
@@ -253,11 +259,15 @@ IN int mode;
   if (set_mode(mode) == FAILURE)   /* mode is uncorrect */
     {
     mem_mode_close();
-    return MEM_ERR_MODE_BAD;
+    err = MEM_ERR_MODE_BAD;
     }
-
-  return  mode_stack_ind < MODE_STACK_SIZE ?
+  else
+    {
+    err = mode_stack_ind < MODE_STACK_SIZE ?
           MEM_OK : MEM_WARN_MODE_OVER;
+    }
+  imal_unlock();
+  return err;
   } /* end of mem_mode_open function */
 
 /* --------------------------------------------------------------------
@@ -271,19 +281,29 @@ IN int mode;
 
 int mem_mode_close()
   {
+  int err;     /* IMAL error code */
+
+  imal_lock();
   if (mode_stack_ind == 0)
-    return MEM_WARN_MODE_OVER;
-  mode_stack_ind--;
-  if (mode_stack_ind < MODE_STACK_SIZE)
     {
-    set_mode(mode_stack[mode_stack_ind]);
-    return MEM_OK;
+    err = MEM_WARN_MODE_OVER;
     }
   else
     {
-    set_mode(mode_stack[0]);
-    return MEM_WARN_MODE_OVER;
+    mode_stack_ind--;
+    if (mode_stack_ind < MODE_STACK_SIZE)
+      {
+      set_mode(mode_stack[mode_stack_ind]);
+      err = MEM_OK;
+      }
+    else
+      {
+      set_mode(mode_stack[0]);
+      err = MEM_WARN_MODE_OVER;
+      }
     }
+  imal_unlock();
+  return err;
   } /* end of mem_mode_close function */
 
 /* --------------------------------------------------------------------
@@ -310,6 +330,8 @@ int mem_mode_current()
     mode |= MEM_MODE_CONTINUE;
   if (imal_mode_modify_fl == TRUE)
     mode |= MEM_MODE_MODIFY;
+  if (imal_mode_fast_fl == TRUE)
+    mode |= MEM_MODE_FAST;
   return mode;
   } /* end of mem_mode_current function */
 
@@ -751,6 +773,7 @@ IN SIZE_T offset;
  *              FAILURE - Wrong mode value.
  * EXTERNS      None
  * NOTE         Mode flags can be modified only by this function !!!
+ *              Flags are changed under IMAL lock.
  ---------------------------------------------------------------------*/
 
 static int set_mode(mode_value)
@@ -765,21 +788,26 @@ IN int mode_value;       /* IMAL mode */
                 MEM_MODE_TRACE |
                 MEM_MODE_WARNING |
                 MEM_MODE_CONTINUE |
-                MEM_MODE_MODIFY)))
+                MEM_MODE_MODIFY |
+                MEM_MODE_FAST)))
     return FAILURE;
 
+  imal_lock();
   imal_mode_debug_fl = (BOOL)((mode & MEM_MODE_DEBUG) ? TRUE : FALSE);
   imal_mode_trace_fl = (BOOL)((mode & MEM_MODE_TRACE) ? TRUE : FALSE);
   imal_mode_warning_fl = (BOOL)((mode & MEM_MODE_WARNING) ? TRUE : FALSE);
   imal_mode_continue_fl = (BOOL)((mode & MEM_MODE_CONTINUE) ? TRUE : FALSE);
   imal_mode_modify_fl = (BOOL)((mode & MEM_MODE_MODIFY) ? TRUE : FALSE);
+  imal_mode_fast_fl = (BOOL)((mode & MEM_MODE_FAST) ? TRUE : FALSE);
 
   imal_mode_set(imal_mode_debug_fl,
                 imal_mode_trace_fl,
-                imal_mode_modify_fl);
+                imal_mode_modify_fl,
+                imal_mode_fast_fl);
 
   imal_mode_rtl_set(imal_mode_debug_fl,
                     imal_mode_warning_fl);
+  imal_unlock();
 
   return SUCCESS;
   } /* end of set_mode function */
@@ -0,0 +1,740 @@
+/*
+ * MODULE NAME  POOL.C
+ * PURPOSE      Size class pools of small blocks used by IMAL in FAST
+ *              mode. Every thread takes blocks from its own cache
+ *              without the IMAL lock; blocks released by other
+ *              threads are returned to the owner cache in batches.
+ *              Memory statistic of the thread is kept in its cache
+ *              and merged into class descriptors when the thread
+ *              takes IMAL lock.
+ *
+ * CODING                                             2026.10.18
+ *
+ * LAST UPDATED
+ *
+ * NOTE         Cache of thread is not released when the thread ends;
+ *              free slots kept by it are reused after mem_close()
+ *              only. It is intended for long living worker threads.
+ */
+
+/* COMPANY INCLUDES */
+
+#define IMAL_NO_C_RTL_MACRO  /* Turn off macros for C RTL functions */
+
+#include "integra.h"
+#include "imal.h"
+
+
+/* PROJECT INCLUDE: */
+
+#include "imal_loc.h"
+
+
+/* CONSTANTS */
+
+#define POOL_NUMBER     16      /* Number of pools (size classes)    */
+
+#define POOL_SLAB_SIZE  16384   /* Size of memory taken for a pool   */
+                                /* by one malloc() call.             */
+
+#define POOL_BATCH_SIZE 32      /* Number of blocks released by      */
+                                /* thread which are passed to the    */
+                                /* owner cache at once.              */
+
+#define POOL_STAT_NUMBER 8      /* Number of classes which statistic */
+                                /* is kept in the cache.             */
+
+
+/* TYPEDEFS */
+
+typedef struct pool_slab        /* Memory taken by malloc() for pool */
+  {
+  struct pool_slab *next;       /* Next slab or NULL                 */
+  } POOL_SLAB;
+
+typedef struct pool_stat        /* Not merged statistic of class     */
+  {
+  int class_id;                 /* Class ident. or MEM_NOT_CLASS     */
+  SIZE_T block_num;             /* Changes of class statistic since  */
+  SIZE_T block_size;            /* the last merging (modulo SIZE_T,  */
+  SIZE_T block_csize;           /* i.e. may be "negative").          */
+  } POOL_STAT;
+
+typedef struct pool_cache       /* Pools of one thread               */
+  {
+  VPTR free[POOL_NUMBER];       /* Free slots of pools               */
+  VPTR remote;                  /* Slots released by other threads;  */
+                                /* access under IMAL lock only.      */
+  struct pool_cache *batch_owner; /* Owner of slots in batch         */
+  VPTR batch;                   /* Slots released by this thread     */
+  VPTR batch_tail;              /* which belong to batch_owner.      */
+  int batch_num;
+  POOL_STAT stat[POOL_STAT_NUMBER]; /* Not merged statistic          */
+  struct pool_cache *next;      /* Next cache or NULL                */
+  } POOL_CACHE;
+
+
+/* MACROS */
+
+#define POOL_SLAB_HEAD_SIZE \
+  (((sizeof(POOL_SLAB) + ALIGN - 1) / ALIGN) * ALIGN)
+
+/* Size of the slot of pool (control part + user's part) */
+#define POOL_SLOT_SIZE(pool) \
+  (POOL_CONTROL_INFO_SIZE + IMAL_TAG_SIZE + pool_capacity[pool])
+
+/* Link of free slots list (user's part of slot) */
+#define POOL_LINK(ptr)  (*(VPTR *)(ptr))
+
+/*-------------------------------------------------------------/
+                   Internal data structures.
+
+Every pool serves  the  blocks  which  user's  parts  are  not
+greater than pool capacity. Memory of pool is  taken by slabs of
+POOL_SLAB_SIZE bytes  which  are  cut  into  slots of  the  same
+size. Every thread has its own cache with free slot lists of all
+pools; the link is kept in user's part of the slot. Slab belongs
+to the cache which has taken it, this cache is written  to  the
+control part of all its slots (owner).
+
+Slot released by the owner thread is inserted to its free  list.
+Slot released by another thread is inserted to  the batch of this
+thread; the batch is moved to the remote list of the owner cache
+when it is full or when slot of other owner  is  released.  Owner
+takes remote list when its own free list is empty.
+
+Slabs and caches are never returned to the  system  until
+imal_pool_release() call; they are linked into lists for it.
+
+   +-----+    +---------------------------------+
+   |slab |--->|next|slot1 |slot2 |slot3 |slot4 |---> ... ---> NULL
+   |list |    +---------------------------------+
+   +-----+                 ^      |      ^
+                           +------+      |
+   +-----+    +-------+                  |
+   |cache|--->|free   |---->---->--------+
+   |list |    |remote |---> slots released by other threads
+   +-----+    |batch  |---> slots of other cache released here
+              |next   |---> ... ---> NULL
+              +-------+
+/-------------------------------------------------------------*/
+
+/****************************** DATA **********************************/
+
+static SIZE_T pool_capacity[POOL_NUMBER] =
+  {
+   16,  32,  48,  64,  80,  96, 112, 128,
+  160, 192, 224, 256, 320, 384, 448, 512
+  };
+
+/*
+Capacities of pools (sizes of user's parts of slots). They are
+multiple of 16, therefore all slots of slab keep the alignment.
+The last one is IMAL_POOL_MAX_SIZE.
+*/
+
+static POOL_SLAB *slab_list = NULL;
+static POOL_CACHE *cache_list = NULL;
+
+/* Lists of all slabs and caches; access under IMAL lock only */
+
+static long cache_generation = 1;
+static IMAL_THREAD POOL_CACHE *thread_cache = NULL;
+static IMAL_THREAD long thread_generation = 0;
+
+/*
+Cache of the current thread. It is valid while thread_generation
+is equal to cache_generation, which is changed when all caches are
+released by imal_pool_release().
+*/
+
+
+/* STATIC PROTOTYPES */
+
+static POOL_CACHE *pool_cache PROT((void));
+static POOL_STAT *pool_stat PROT((INOUT POOL_CACHE *, IN int));
+static int pool_by_size PROT((IN SIZE_T));
+static int pool_refill PROT((INOUT POOL_CACHE *, IN int));
+static int pool_grow PROT((INOUT POOL_CACHE *, IN int));
+static VOID pool_pass_batch PROT((INOUT POOL_CACHE *));
+static int pool_free_direct PROT((IN VPTR));
+static VOID pool_flush PROT((INOUT POOL_CACHE *));
+static VOID pool_merge PROT((INOUT POOL_STAT *));
+
+/****************************** CODE **********************************/
+
+
+                     /* Interface functions */
+
+
+/* --------------------------------------------------------------------
+ * NAME         imal_pool_alloc
+ * PURPOSE      Take a block from the pool of the current thread.
+ * ARGUMENTS    IN int class_id - Block class identifier.
+ *              IN SIZE_T size  - Size of user's part (1 ..
+ *                                IMAL_POOL_MAX_SIZE).
+ * RETURNS      Pointer to user's part of block or NULL if there
+ *              is not enough memory or class_id is wrong.
+ * EXTERNS      None
+ * NOTE         IMAL lock is not necessary.
+ ---------------------------------------------------------------------*/
+
+VPTR imal_pool_alloc(class_id, size)
+IN int class_id;
+IN SIZE_T size;
+  {
+  POOL_CACHE *cache;   /* Cache of the thread       */
+  POOL_STAT *stat;     /* Statistic of class        */
+  int pool;            /* Index of pool             */
+  VPTR ptr;            /* Allocated block           */
+
+  if ((cache = pool_cache()) == NULL ||
+      (stat = pool_stat(cache, class_id)) == NULL)
+    return NULL;
+
+  pool = pool_by_size(size);
+  if (cache->free[pool] == NULL && pool_refill(cache, pool) == FAILURE)
+    return NULL;
+
+  /* Remove the first slot from free list */
+  ptr = cache->free[pool];
+  cache->free[pool] = POOL_LINK(ptr);
+
+  IMAL_POOL_CLASS_ID(ptr) = class_id;
+  IMAL_POOL_USER_LEN(ptr) = size;
+  IMAL_BLOCK_SET_PREFIX(ptr, IMAL_TAG_POOLED);
+
+  stat->block_num++;
+  stat->block_size += size;
+  stat->block_csize += IMAL_POOL_CONTROL_SIZE(ptr);
+  return ptr;
+  } /* end of imal_pool_alloc function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         imal_pool_free
+ * PURPOSE      Return block to its pool.
+ * ARGUMENTS    IN VPTR ptr - Block taken by imal_pool_alloc().
+ * RETURNS      SUCCESS or FAILURE (class of block is wrong).
+ * EXTERNS      None
+ * NOTE         IMAL lock is not necessary.
+ *              Prefix is set to IMAL_TAG_RELEASED, so the second
+ *              release of the block is detected by mem_free().
+ ---------------------------------------------------------------------*/
+
+int imal_pool_free(ptr)
+IN VPTR ptr;
+  {
+  POOL_CACHE *cache;   /* Cache of the thread       */
+  POOL_CACHE *owner;   /* Cache which owns the slot */
+  POOL_STAT *stat;     /* Statistic of class        */
+  int pool;            /* Index of pool             */
+
+  if ((cache = pool_cache()) == NULL)
+    return pool_free_direct(ptr);
+  if ((stat = pool_stat(cache, IMAL_POOL_CLASS_ID(ptr))) == NULL)
+    return FAILURE;
+
+  stat->block_num--;
+  stat->block_size -= IMAL_POOL_USER_LEN(ptr);
+  stat->block_csize -= IMAL_POOL_CONTROL_SIZE(ptr);
+  IMAL_BLOCK_SET_PREFIX(ptr, IMAL_TAG_RELEASED);
+
+  owner = (POOL_CACHE *)IMAL_POOL_OWNER(ptr);
+  if (owner == cache)
+    {
+    /* Insert slot to own free list */
+    pool = IMAL_POOL_INDEX(ptr);
+    POOL_LINK(ptr) = cache->free[pool];
+    cache->free[pool] = ptr;
+    return SUCCESS;
+    }
+
+  /* Insert slot to the batch of its owner */
+  if (cache->batch != NULL && cache->batch_owner != owner)
+    pool_pass_batch(cache);
+  if (cache->batch == NULL)
+    {
+    cache->batch_owner = owner;
+    cache->batch_tail = ptr;
+    }
+  POOL_LINK(ptr) = cache->batch;
+  cache->batch = ptr;
+  if (++(cache->batch_num) >= POOL_BATCH_SIZE)
+    pool_pass_batch(cache);
+  return SUCCESS;
+  } /* end of imal_pool_free function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         imal_pool_resize
+ * PURPOSE      Change size of block in its slot.
+ * ARGUMENTS    IN VPTR ptr         - Block taken by imal_pool_alloc().
+ *              IN SIZE_T new_size  - New size of user's part (not
+ *                                    greater than slot capacity).
+ * RETURNS      SUCCESS or FAILURE (class of block is wrong).
+ * EXTERNS      None
+ * NOTE         IMAL lock is not necessary.
+ ---------------------------------------------------------------------*/
+
+int imal_pool_resize(ptr, new_size)
+IN VPTR ptr;
+IN SIZE_T new_size;
+  {
+  POOL_CACHE *cache;   /* Cache of the thread       */
+  POOL_STAT *stat;     /* Statistic of class        */
+  POOL_STAT direct;    /* Statistic without cache   */
+
+  if ((cache = pool_cache()) == NULL)
+    {
+    /* Merge the change at once */
+    direct.class_id = IMAL_POOL_CLASS_ID(ptr);
+    direct.block_num = 0;
+    direct.block_size = 0;
+    direct.block_csize = 0;
+    stat = &direct;
+    }
+  else if ((stat = pool_stat(cache, IMAL_POOL_CLASS_ID(ptr))) == NULL)
+    return FAILURE;
+
+  stat->block_size -= IMAL_POOL_USER_LEN(ptr);
+  stat->block_csize -= IMAL_POOL_CONTROL_SIZE(ptr);
+  IMAL_POOL_USER_LEN(ptr) = new_size;
+  stat->block_size += new_size;
+  stat->block_csize += IMAL_POOL_CONTROL_SIZE(ptr);
+  if (stat == &direct)
+    {
+    imal_lock();
+    pool_merge(stat);
+    imal_unlock();
+    }
+  return SUCCESS;
+  } /* end of imal_pool_resize function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         imal_pool_capacity
+ * PURPOSE      Get capacity of pool slot occupied by the block.
+ * ARGUMENTS    IN VPTR ptr - Block taken by imal_pool_alloc().
+ * RETURNS      Maximum size of user's part of the block.
+ * EXTERNS      None
+ ---------------------------------------------------------------------*/
+
+SIZE_T imal_pool_capacity(ptr)
+IN VPTR ptr;
+  {
+  return pool_capacity[IMAL_POOL_INDEX(ptr)];
+  } /* end of imal_pool_capacity function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         imal_pool_stat
+ * PURPOSE      Get statistic which is not merged yet into class
+ *              descriptors.
+ * ARGUMENTS    IN int class_id     - Class identifier or
+ *                                    MEM_NOT_CLASS (all classes).
+ *              OUT SIZE_T *blk_num   - Change of blocks number
+ *              OUT SIZE_T *blk_size  - Change of blocks size
+ *              OUT SIZE_T *cblk_size - Change of control parts size
+ * RETURNS      None
+ * EXTERNS      None
+ * NOTE         Changes are modulo SIZE_T, they should be added to
+ *              the values of class descriptor.
+ *              IMAL lock should be kept. The result is exact if
+ *              other threads do not allocate/release blocks.
+ ---------------------------------------------------------------------*/
+
+VOID imal_pool_stat(class_id, blk_num, blk_size, cblk_size)
+IN int class_id;
+OUT SIZE_T *blk_num;
+OUT SIZE_T *blk_size;
+OUT SIZE_T *cblk_size;
+  {
+  POOL_CACHE *cache;   /* Current cache   */
+  POOL_STAT *stat;     /* Class statistic */
+
+  *blk_num = 0;
+  *blk_size = 0;
+  *cblk_size = 0;
+  for (cache = cache_list; cache != NULL; cache = cache->next)
+    {
+    for (stat = cache->stat; stat < cache->stat + POOL_STAT_NUMBER; stat++)
+      {
+      if (stat->class_id == MEM_NOT_CLASS ||
+          (class_id != MEM_NOT_CLASS && stat->class_id != class_id))
+        continue;
+      *blk_num += stat->block_num;
+      *blk_size += stat->block_size;
+      *cblk_size += stat->block_csize;
+      }
+    }
+  } /* end of imal_pool_stat function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         imal_pool_forget_class
+ * PURPOSE      Merge statistic of the class kept in all caches and
+ *              remove the class from caches.
+ * ARGUMENTS    IN int class_id - Class identifier.
+ * RETURNS      None
+ * EXTERNS      None
+ * NOTE         Called by mem_class_close() with IMAL lock kept.
+ *              Other threads should not use the class meanwhile.
+ ---------------------------------------------------------------------*/
+
+VOID imal_pool_forget_class(class_id)
+IN int class_id;
+  {
+  POOL_CACHE *cache;   /* Current cache   */
+  POOL_STAT *stat;     /* Class statistic */
+
+  for (cache = cache_list; cache != NULL; cache = cache->next)
+    {
+    for (stat = cache->stat; stat < cache->stat + POOL_STAT_NUMBER; stat++)
+      {
+      if (stat->class_id == class_id)
+        {
+        pool_merge(stat);
+        stat->class_id = MEM_NOT_CLASS;
+        }
+      }
+    }
+  } /* end of imal_pool_forget_class function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         imal_pool_release
+ * PURPOSE      Return memory of all pools and caches to the system.
+ * ARGUMENTS    None
+ * RETURNS      None
+ * EXTERNS      None
+ * NOTE         All blocks taken from the pools become invalid.
+ *              IMAL lock should be kept; other threads should not
+ *              use IMAL meanwhile.
+ ---------------------------------------------------------------------*/
+
+VOID imal_pool_release()
+  {
+  POOL_SLAB *slab;     /* Released slab  */
+  POOL_CACHE *cache;   /* Released cache */
+
+  while ((slab = slab_list) != NULL)
+    {
+    slab_list = slab->next;
+    free(slab);
+    }
+  while ((cache = cache_list) != NULL)
+    {
+    cache_list = cache->next;
+    free(cache);
+    }
+  cache_generation++;           /* Invalidate caches of all threads */
+  } /* end of imal_pool_release function */
+
+
+                       /* Auxiliary functions */
+
+
+/* --------------------------------------------------------------------
+ * NAME         pool_cache
+ * PURPOSE      Get cache of the current thread; create it if the
+ *              thread has no cache yet.
+ * ARGUMENTS    None
+ * RETURNS      Cache or NULL (not enough memory).
+ * EXTERNS      None
+ ---------------------------------------------------------------------*/
+
+static POOL_CACHE *pool_cache()
+  {
+  POOL_CACHE *cache;   /* New cache      */
+  int i;               /* Loop variable  */
+
+  if (thread_cache != NULL && thread_generation == cache_generation)
+    return thread_cache;
+
+  if ((cache = (POOL_CACHE *)malloc(sizeof(POOL_CACHE))) == NULL)
+    return NULL;
+  memset(cache, 0, sizeof(POOL_CACHE));
+  for (i = 0; i < POOL_STAT_NUMBER; i++)
+    cache->stat[i].class_id = MEM_NOT_CLASS;
+
+  imal_lock();
+  cache->next = cache_list;
+  cache_list = cache;
+  thread_generation = cache_generation;
+  imal_unlock();
+
+  thread_cache = cache;
+  return cache;
+  } /* end of pool_cache function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         pool_stat
+ * PURPOSE      Find statistic of class in the cache; add the class
+ *              to the cache if it is not there.
+ * ARGUMENTS    INOUT POOL_CACHE *cache - Cache of the current thread
+ *              IN int class_id         - Class identifier
+ * RETURNS      Statistic of class or NULL (class_id is wrong).
+ * EXTERNS      None
+ * NOTE         If there is no place for a new class all statistic
+ *              of the cache is merged into class descriptors.
+ ---------------------------------------------------------------------*/
+
+static POOL_STAT *pool_stat(cache, class_id)
+INOUT POOL_CACHE *cache;
+IN int class_id;
+  {
+  POOL_STAT *stat;     /* Class statistic      */
+  POOL_STAT *empty;    /* Unused statistic     */
+
+  empty = NULL;
+  for (stat = cache->stat; stat < cache->stat + POOL_STAT_NUMBER; stat++)
+    {
+    if (stat->class_id == class_id)
+      return stat;
+    if (stat->class_id == MEM_NOT_CLASS && empty == NULL)
+      empty = stat;
+    }
+
+  /* Class is checked under lock: descriptors can be moved */
+  imal_lock();
+  if (imal_class_id_to_ptr(class_id) == NULL)
+    {
+    imal_unlock();
+    return NULL;
+    }
+  if (empty == NULL)
+    {
+    pool_flush(cache);
+    for (stat = cache->stat; stat < cache->stat + POOL_STAT_NUMBER; stat++)
+      stat->class_id = MEM_NOT_CLASS;
+    empty = cache->stat;
+    }
+  empty->class_id = class_id;
+  imal_unlock();
+  return empty;
+  } /* end of pool_stat function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         pool_by_size
+ * PURPOSE      Find the smallest pool which can serve the block.
+ * ARGUMENTS    IN SIZE_T size - Size of user's part (1 ..
+ *                               IMAL_POOL_MAX_SIZE).
+ * RETURNS      Index of pool.
+ * EXTERNS      None
+ * NOTE         Capacities grow by 16 up to 128, by 32 up to 256
+ *              and by 64 up to 512 (see pool_capacity[]).
+ ---------------------------------------------------------------------*/
+
+static int pool_by_size(size)
+IN SIZE_T size;
+  {
+  if (size <= 128)
+    return (int)((size - 1) >> 4);
+  if (size <= 256)
+    return 8 + (int)((size - 129) >> 5);
+  return 12 + (int)((size - 257) >> 6);
+  } /* end of pool_by_size function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         pool_refill
+ * PURPOSE      Fill empty free list of the pool: take slots released
+ *              by other threads or a new slab.
+ * ARGUMENTS    INOUT POOL_CACHE *cache - Cache of the current thread
+ *              IN int pool             - Index of pool.
+ * RETURNS      SUCCESS or FAILURE (not enough memory).
+ * EXTERNS      None
+ ---------------------------------------------------------------------*/
+
+static int pool_refill(cache, pool)
+INOUT POOL_CACHE *cache;
+IN int pool;
+  {
+  VPTR ptr;            /* Slot released by other thread */
+  VPTR next;           /* Next slot in remote list      */
+  int result;          /* SUCCESS or FAILURE            */
+
+  imal_lock();
+  pool_flush(cache);
+
+  /* Pass own batch to its owner, it may wait for slots also */
+  if (cache->batch != NULL)
+    pool_pass_batch(cache);
+
+  /* Distribute remote slots into free lists */
+  for (ptr = cache->remote; ptr != NULL; ptr = next)
+    {
+    next = POOL_LINK(ptr);
+    POOL_LINK(ptr) = cache->free[IMAL_POOL_INDEX(ptr)];
+    cache->free[IMAL_POOL_INDEX(ptr)] = ptr;
+    }
+  cache->remote = NULL;
+
+  result = SUCCESS;
+  if (cache->free[pool] == NULL)
+    result = pool_grow(cache, pool);
+
+  imal_unlock();
+  return result;
+  } /* end of pool_refill function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         pool_grow
+ * PURPOSE      Take a new slab for the pool and cut it into free
+ *              slots.
+ * ARGUMENTS    INOUT POOL_CACHE *cache - Cache which takes the slab.
+ *              IN int pool             - Index of pool.
+ * RETURNS      SUCCESS or FAILURE (not enough memory).
+ * EXTERNS      None
+ * NOTE         IMAL lock should be kept.
+ ---------------------------------------------------------------------*/
+
+static int pool_grow(cache, pool)
+INOUT POOL_CACHE *cache;
+IN int pool;
+  {
+  POOL_SLAB *slab;     /* New slab                    */
+  char *slot;          /* Beginning of the slot       */
+  SIZE_T slot_size;    /* Size of the slot            */
+  SIZE_T slot_num;     /* Number of slots in the slab */
+  VPTR ptr;            /* User's part of the slot     */
+
+  if ((slab = malloc(POOL_SLAB_SIZE)) == NULL)
+    return FAILURE;
+  slab->next = slab_list;
+  slab_list = slab;
+
+  /* Insert slots to free list in order of addresses */
+  slot_size = POOL_SLOT_SIZE(pool);
+  slot_num = (POOL_SLAB_SIZE - POOL_SLAB_HEAD_SIZE) / slot_size;
+  slot = ((char *)slab) + POOL_SLAB_HEAD_SIZE + slot_num * slot_size;
+  while (slot_num-- > 0)
+    {
+    slot -= slot_size;
+    ptr = IMAL_POOL_SYS_TO_USER(slot);
+    IMAL_POOL_OWNER(ptr) = (VPTR)cache;
+    IMAL_POOL_INDEX(ptr) = pool;
+    IMAL_BLOCK_SET_PREFIX(ptr, IMAL_TAG_RELEASED);
+    POOL_LINK(ptr) = cache->free[pool];
+    cache->free[pool] = ptr;
+    }
+  return SUCCESS;
+  } /* end of pool_grow function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         pool_pass_batch
+ * PURPOSE      Move batch of released slots to the remote list of
+ *              their owner.
+ * ARGUMENTS    INOUT POOL_CACHE *cache - Cache of the current thread
+ *                                        (batch is not empty).
+ * RETURNS      None
+ * EXTERNS      None
+ ---------------------------------------------------------------------*/
+
+static VOID pool_pass_batch(cache)
+INOUT POOL_CACHE *cache;
+  {
+  POOL_CACHE *owner;   /* Owner of slots in batch */
+
+  owner = cache->batch_owner;
+  imal_lock();
+  POOL_LINK(cache->batch_tail) = owner->remote;
+  owner->remote = cache->batch;
+  pool_flush(cache);
+  imal_unlock();
+
+  cache->batch = NULL;
+  cache->batch_tail = NULL;
+  cache->batch_owner = NULL;
+  cache->batch_num = 0;
+  } /* end of pool_pass_batch function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         pool_free_direct
+ * PURPOSE      Return block to the remote list of its owner and
+ *              correct class statistic at once (the current thread
+ *              has no cache).
+ * ARGUMENTS    IN VPTR ptr - Block taken by imal_pool_alloc().
+ * RETURNS      SUCCESS or FAILURE (class of block is wrong).
+ * EXTERNS      None
+ ---------------------------------------------------------------------*/
+
+static int pool_free_direct(ptr)
+IN VPTR ptr;
+  {
+  POOL_CACHE *owner;   /* Cache which owns the slot */
+
+  imal_lock();
+  if (imal_class_id_to_ptr(IMAL_POOL_CLASS_ID(ptr)) == NULL)
+    {
+    imal_unlock();
+    return FAILURE;
+    }
+  imal_add_pool_stat(IMAL_POOL_CLASS_ID(ptr), (SIZE_T)0 - 1,
+                     (SIZE_T)0 - IMAL_POOL_USER_LEN(ptr),
+                     (SIZE_T)0 - IMAL_POOL_CONTROL_SIZE(ptr));
+  IMAL_BLOCK_SET_PREFIX(ptr, IMAL_TAG_RELEASED);
+
+  owner = (POOL_CACHE *)IMAL_POOL_OWNER(ptr);
+  POOL_LINK(ptr) = owner->remote;
+  owner->remote = ptr;
+  imal_unlock();
+  return SUCCESS;
+  } /* end of pool_free_direct function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         pool_flush
+ * PURPOSE      Merge all class statistic of the cache into class
+ *              descriptors.
+ * ARGUMENTS    INOUT POOL_CACHE *cache - Cache of the current thread.
+ * RETURNS      None
+ * EXTERNS      None
+ * NOTE         IMAL lock should be kept. Maximum values of class
+ *              descriptors are updated by merging only.
+ ---------------------------------------------------------------------*/
+
+static VOID pool_flush(cache)
+INOUT POOL_CACHE *cache;
+  {
+  POOL_STAT *stat;     /* Class statistic */
+
+  for (stat = cache->stat; stat < cache->stat + POOL_STAT_NUMBER; stat++)
+    pool_merge(stat);
+  } /* end of pool_flush function */
+
+
+/* --------------------------------------------------------------------
+ * NAME         pool_merge
+ * PURPOSE      Merge class statistic of the cache into class
+ *              descriptor.
+ * ARGUMENTS    INOUT POOL_STAT *stat - Statistic of class.
+ * RETURNS      None
+ * EXTERNS      None
+ * NOTE         IMAL lock should be kept. The item stays bound to
+ *              the class.
+ ---------------------------------------------------------------------*/
+
+static VOID pool_merge(stat)
+INOUT POOL_STAT *stat;
+  {
+  POOL_STAT merged;    /* Merged statistic */
+
+  if (stat->class_id == MEM_NOT_CLASS)
+    return;
+  merged = *stat;
+  stat->block_num = 0;
+  stat->block_size = 0;
+  stat->block_csize = 0;
+  imal_add_pool_stat(merged.class_id, merged.block_num,
+                     merged.block_size, merged.block_csize);
+  } /* end of pool_merge function */
+
+
+/*** End of file POOL.C ***/
@@ -42,13 +42,20 @@
 /* MACROS */
 
 #define MEM_BLOCK(ptr) \
-  (IMAL_ALIGNED(ptr) && IMAL_BLOCK_EQUAL_PREFIX(ptr, IMAL_TAG_PREFIX))
+  (IMAL_ALIGNED(ptr) && \
+   (IMAL_BLOCK_EQUAL_PREFIX(ptr, IMAL_TAG_PREFIX) || \
+    IMAL_BLOCK_EQUAL_PREFIX(ptr, IMAL_TAG_POOLED)))
+
+/* Size of user's part of the block passed MEM_BLOCK() check */
+#define MEM_BLOCK_LEN(ptr) \
+  (IMAL_BLOCK_EQUAL_PREFIX(ptr, IMAL_TAG_POOLED) ? \
+   IMAL_POOL_USER_LEN(ptr) : IMAL_BLOCK_USER_LEN(ptr))
 
 /****************************** DATA *************************************/
 
-static char imal_default_name_buf[MAX_DEFAULT_NAME_LEN];
+static IMAL_THREAD char imal_default_name_buf[MAX_DEFAULT_NAME_LEN];
 
-/* Buffer used for preparing names in malloc/free macros */
+/* Buffer used for preparing names in malloc/free macros (per thread) */
 
 
 static BOOL imal_mode_debug_fl = FALSE;
@@ -124,7 +131,7 @@ IN int line;
       return strcpy(dest, source);
 
       } /* end if */
-    dest_size = IMAL_BLOCK_USER_LEN((VPTR)dest);
+    dest_size = MEM_BLOCK_LEN((VPTR)dest);
     } /* end if (dest_size == sizeof(VPTR)) */
 
   /* ASSERT: Size of dest is established and placed to the dest_size */
@@ -206,7 +213,7 @@ IN int line;
       return strcat(dest, source);
 
       } /* end if */
-    dest_size = IMAL_BLOCK_USER_LEN((VPTR)dest);
+    dest_size = MEM_BLOCK_LEN((VPTR)dest);
     } /* end if (dest_size == sizeof(VPTR)) */
 
   /* ASSERT: Size of dest is established and placed to the dest_size */
@@ -288,7 +295,7 @@ IN int line;
       return strncpy(dest, source, len);
 
       } /* end if */
-    dest_size = IMAL_BLOCK_USER_LEN((VPTR)dest);
+    dest_size = MEM_BLOCK_LEN((VPTR)dest);
     } /* end if (dest_size == sizeof(VPTR)) */
 
   /* ASSERT: Size of dest is established and placed to the dest_size */
@@ -369,7 +376,7 @@ IN int line;
       return strncat(dest, source, len);
 
       } /* end if */
-    dest_size = IMAL_BLOCK_USER_LEN((VPTR)dest);
+    dest_size = MEM_BLOCK_LEN((VPTR)dest);
     } /* end if (dest_size == sizeof(VPTR)) */
 
   /* ASSERT: Size of dest is established and placed to the dest_size */
@@ -453,7 +460,7 @@ IN int line;
       return memcpy(dest, source, len);
 
       } /* end if */
-    dest_size = IMAL_BLOCK_USER_LEN((VPTR)dest);
+    dest_size = MEM_BLOCK_LEN((VPTR)dest);
     } /* end if (dest_size == sizeof(VPTR)) */
 
   /* ASSERT: Size of dest is established and placed to the dest_size */
@@ -534,7 +541,7 @@ IN int line;
       return memset(dest, sym, len);
 
       } /* end if */
-    dest_size = IMAL_BLOCK_USER_LEN((VPTR)dest);
+    dest_size = MEM_BLOCK_LEN((VPTR)dest);
     } /* end if (dest_size == sizeof(VPTR)) */
 
   /* ASSERT: Size of dest is established and placed to the dest_size */
@@ -624,7 +631,7 @@ IN int line;
       return fread(dest, item_size, item_num, stream);
 
       } /* end if */
-    dest_size = IMAL_BLOCK_USER_LEN((VPTR)dest);
+    dest_size = MEM_BLOCK_LEN((VPTR)dest);
     } /* end if (dest_size == sizeof(VPTR)) */
 
   /* ASSERT: Size of dest is established and placed to the dest_size */
@@ -713,7 +720,7 @@ IN int line;
       return fgets(dest, len, stream);
 
       } /* end if */
-    dest_size = (int)IMAL_BLOCK_USER_LEN((VPTR)dest);
+    dest_size = (int)MEM_BLOCK_LEN((VPTR)dest);
     } /* end if (dest_size == sizeof(VPTR)) */
 
   /* ASSERT: Size of dest is established and placed to the dest_size */
@@ -790,7 +797,7 @@ IN int line;
       return gets_s(dest, 4096);
 
       } /* end if */
-    dest_size = IMAL_BLOCK_USER_LEN((VPTR)dest);
+    dest_size = MEM_BLOCK_LEN((VPTR)dest);
     } /* end if (dest_size == sizeof(VPTR)) */
 
   /* ASSERT: Size of dest is established and placed to the dest_size */
@@ -16,13 +16,15 @@ START_C_DECLS
 // #include "iosl.h"
 #include "icol.h"
 #include "imal.h"
-#include "iifl.h"`
+#include "iifl.h"
 #include "itoliifl.h"
 // #include "itolscan.h"
 // #include "suffix.h"
 END_C_DECLS
 
 #define C_NUMB_IIF_COMP 5
+// Number of lines written to NIT file by one call
+#define C_NIT_BAND_LINES 64
 
 //////////////////////////////////////////////////////////////////////////////
 /// Write NIT file of observer from luminance matrix of RGB components
@@ -37,7 +39,7 @@ OKAY WriteNITFile(const PathStr &nitfile,
   double white[XY], red[XY], green[XY], blue[XY];
   Str buf, buf1, buf2, layers, format, type;
   int i, j, k;
-  float *pf, **table;
+  float *pf;
   IIF *iif_file;
   INT64 rays;
 
@@ -177,65 +179,58 @@ OKAY WriteNITFile(const PathStr &nitfile,
       }
     }
 
-  /* Set data pointers */
-  table = new float *[C_NUMB_IIF_COMP];
-  if (table == NULL)
-    {
-    printf("\nMemory allocation error - LUX file");
-    iif_close(iif_file);
-    delete[] table;
-    return FAILURE;
-    }
-  table[R] = new float[coldata.NColumns() * C_NUMB_IIF_COMP];
-
-  if (table[R] == NULL)
+  /* Interleaved band of lines, values of pixel follow each other */
+  int band = Min(C_NIT_BAND_LINES, coldata.NRows());
+  SIZE_T size = (SIZE_T)band * coldata.NColumns() * C_NUMB_IIF_COMP;
+  float *image = new float[size];
+  if (image == NULL)
     {
     iif_close(iif_file);
     printf("\nMemory allocation error - NIT file");
     return FAILURE;
     }
-  table[G] = table[R] + G * coldata.NColumns();
-  table[B] = table[R] + B * coldata.NColumns();
-  table[B + 1] = table[R] + (B + 1) * coldata.NColumns();
-  table[B + 2] = table[R] + (B + 2) * coldata.NColumns();
 
-  /* Print image */
-  for (j = 0; j < coldata.NRows(); j++)
+  INT64 offsets[C_NUMB_IIF_COMP];
+  for (k = 0; k < C_NUMB_IIF_COMP; k++)
+    offsets[k] = k * (INT64)sizeof(float);
+
+  /* Print image band by band */
+  for (int y = 0; y < coldata.NRows(); y += band)
     {
-    for (k = 0; k < RGB; k++)
-      {
-      pf = table[k];
+    int h = Min(band, coldata.NRows() - y);
+    pf = image;
+    for (j = y; j < y + h; j++)
       for (i = 0; i < coldata.NColumns(); i++)
         {
-        if (negvalue > 0)
-          *pf++ = (float)Abs(coldata(j, i)[k]);
-        else if (negvalue == 0 && coldata(j, i)[k] < 0)
+        for (k = 0; k < RGB; k++)
+          {
+          if (negvalue > 0)
+            *pf++ = (float)Abs(coldata(j, i)[k]);
+          else if (negvalue == 0 && coldata(j, i)[k] < 0)
+            *pf++ = (float)0;
+          else
+            *pf++ = (float)(coldata(j, i)[k]);
+          }
+        for (; k < C_NUMB_IIF_COMP; k++)
           *pf++ = (float)0;
-        else
-          *pf++ = (float)(coldata(j, i)[k]);
         }
-      }
-    for (; k < C_NUMB_IIF_COMP; k++)
-      {
-      pf = table[k];
-      for (i = 0; i < coldata.NColumns(); i++)
-        *pf++ = (float)0;
-      }
 
-    if (iif_write_line(iif_file, (void *)table, j, -1, 0) != IIF_OK)
+    if (iif_write_image(iif_file, (void *)image, 0, y, coldata.NColumns(),
+                        h, offsets,
+                        C_NUMB_IIF_COMP * (INT64)sizeof(float),
+                        C_NUMB_IIF_COMP * (INT64)sizeof(float) *
+                        coldata.NColumns()) != IIF_OK)
       {
       printf("\nIt is impossible to write observer file - %s",
              nitfile.XData());
       iif_close(iif_file);
-      delete[] table[R];
-      delete[] table;
+      delete[] image;
       return FAILURE;
       }
     }
 
   // Close iif_file 
-  delete[] table[R];
-  delete[] table;
+  delete[] image;
   iif_close(iif_file);
   return SUCCESS;
   } // End of WriteNITFile()
@@ -0,0 +1,157 @@
+/// @internal
+/// @file
+///
+/// @brief Definition of MemoryArena class.
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+#include <stdlib.h>
+#include <integra.hpp>
+
+#include "arena.hpp"
+#include "memclass.hpp"
+
+INTEGRA_NAMESPACE_START
+
+/**
+@class MemoryArena base/arena.hpp
+
+Monotonic (bump) allocator of temporary memory.
+
+The arena takes large chunks from the heap and gives the blocks out of
+them by the increment of a pointer; the blocks are not released one by
+one: Reset() releases all of them at once by resetting the pointer to the
+beginning of the first chunk. The chunks are kept, so a loop over the
+frames or the tiles, which resets the arena on each iteration, does not
+touch the heap after the first iteration.
+
+Arrays (TArray and its descendants) and matrices (TMatrix) constructed
+with an arena take their memory from it:
+
+@code
+   MemoryArena &arena = MemoryArena::Frame();
+   for (int tile = 0; tile < n_tiles; tile++)
+     {
+       {
+       TArray<Hit> hits(&arena);
+       TMatrix<float> weights(&arena);
+       ...
+       }  // destroyed before the reset
+     arena.Reset();
+     }
+@endcode
+
+The memory taken from the heap is reported to the MemoryClass given to
+the constructor ("MemoryArena" by default), so the statistics show the
+memory of each arena; the arrays in the arena are not counted in their
+own memory classes to avoid the double counting, but they are traced as
+usual. UsedSize() is the size of the blocks since the last reset.
+
+The arena is not thread-safe: each thread should use its own one.
+Frame() returns the arena of the calling thread, which is created on the
+first call and released at the end of the thread.
+
+A growing array, which is the last block of the arena, is expanded in
+place by Extend(); otherwise the array is moved to a new block and the
+old block is unused until the reset.
+
+@sa TArray, TMatrix, MemoryClass, @ref base_mainpage
+**/
+
+/////////////////////////////////////////////////////////////////////////////
+/// Constructor.
+///
+/// No memory is taken until the first allocation.
+/// @param[in] class_name - Name of the memory class for the statistics,
+/// "MemoryArena" if NULL.
+/// @param[in] chunk_size - Size of the memory chunk, in bytes; larger
+/// blocks take the chunks of their own size.
+MemoryArena::MemoryArena(const char *class_name, SIZE_T chunk_size)
+  {
+  m_class = MemoryClass::GetClass(class_name != NULL ? class_name : "MemoryArena");
+  m_chunk_size = Max(chunk_size, (SIZE_T)sizeof(Chunk) + DEF_ALIGN);
+  m_first = NULL;
+  m_used_before = 0;
+  m_reserved = 0;
+  SetChunk(NULL);
+  }  // MemoryArena()
+
+/////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+///
+/// All memory is released; the blocks must not be used after it.
+MemoryArena::~MemoryArena()
+  {
+  Release();
+  }  // ~MemoryArena()
+
+/////////////////////////////////////////////////////////////////////////////
+/// Release all blocks and the memory.
+///
+/// The chunks are returned to the heap. The blocks allocated from the arena
+/// become invalid as after Reset().
+void MemoryArena::Release()
+  {
+  while (m_first != NULL)
+    {
+    Chunk *next = m_first->next;
+    m_class->Del(m_first->size);
+    free(m_first);
+    m_first = next;
+    }
+  m_used_before = 0;
+  m_reserved = 0;
+  SetChunk(NULL);
+  }  // Release()
+
+/////////////////////////////////////////////////////////////////////////////
+/// Allocate a block in the next chunk.
+///
+/// The next chunk of the list is used if the block fits into it (the chunks
+/// kept by Reset()); otherwise a new chunk is taken from the heap and
+/// inserted after the current one.
+/// @param[in] size - Size of the block, in bytes.
+/// @param[in] align - Alignment of the block, a power of 2.
+/// @return A pointer to the block or NULL (memory allocation failure).
+void *MemoryArena::AllocSlow(SIZE_T size, SIZE_T align)
+  {
+  if (size > MAX_SIZE_T - sizeof(Chunk) - align)
+    return NULL;
+  SIZE_T need = sizeof(Chunk) + size + align;
+  Chunk *next = (m_cur != NULL) ? m_cur->next : m_first;
+  if (next == NULL || next->size < need)
+    {
+    SIZE_T chunk_size = Max(need, m_chunk_size);
+    Chunk *chunk = (Chunk *)malloc(chunk_size);
+    if (chunk == NULL)
+      return NULL;
+    chunk->size = chunk_size;
+    chunk->next = next;
+    if (m_cur != NULL)
+      m_cur->next = chunk;
+    else
+      m_first = chunk;
+    m_reserved += chunk_size;
+    m_class->Add(chunk_size);
+    next = chunk;
+    }
+  if (m_cur != NULL)
+    m_used_before += (SIZE_T)(m_ptr - (char *)(m_cur + 1));
+  SetChunk(next);
+  return Alloc(size, align);
+  }  // AllocSlow()
+
+/////////////////////////////////////////////////////////////////////////////
+/// Get the arena of the calling thread.
+///
+/// The arena is created on the first call in the thread and released at
+/// the end of the thread. The caller is responsible for Reset() (e.g. at
+/// the end of the frame or of the tile).
+/// @return The frame arena of the thread.
+MemoryArena &MemoryArena::Frame()
+  {
+  static thread_local MemoryArena frame_arena("FrameArena");
+  return frame_arena;
+  }  // Frame()
+
+INTEGRA_NAMESPACE_END
@@ -0,0 +1,231 @@
+/// @file
+///
+/// @brief Declaration of MemoryArena class.
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+#ifndef _ELXX_ARENA_HPP_
+#define _ELXX_ARENA_HPP_
+
+#include "export.h"
+#include "base.hpp"
+
+INTEGRA_NAMESPACE_START
+
+class MemoryClass;
+
+/// Monotonic (bump) allocator of temporary memory.
+class MemoryArena
+  {
+  public:
+    /// @name Constants
+    //@{
+    enum
+      {
+      /// Default size of the memory chunk, in bytes.
+      DEF_CHUNK_SIZE = 1 << 20,
+      /// Default alignment of the blocks, in bytes.
+      DEF_ALIGN = 2 * sizeof(void *)
+      };
+    //@}
+
+  public:
+    /// @name Constructors, destructor
+    //@{
+    /// Constructor.
+    INTAPI_BASE explicit MemoryArena(const char *class_name = NULL,
+                                     SIZE_T chunk_size = DEF_CHUNK_SIZE);
+    /// Destructor.
+    INTAPI_BASE ~MemoryArena();
+    //@}
+
+  public:
+    /// @name Allocation
+    //@{
+    /// Allocate a block.
+    inline void *Alloc(SIZE_T size, SIZE_T align = DEF_ALIGN);
+    /// Release a block.
+    inline void Free(void *p, SIZE_T size);
+    /// Change the size of the last allocated block in place.
+    inline bool Extend(void *p, SIZE_T old_size, SIZE_T new_size);
+    /// Release all blocks, the memory is kept for the next use.
+    inline void Reset();
+    /// Release all blocks and the memory.
+    INTAPI_BASE void Release();
+    //@}
+
+  public:
+    /// @name Statistics
+    //@{
+    /// Get the size of the allocated blocks.
+    inline SIZE_T UsedSize() const;
+    /// Get the size of the memory taken from the heap.
+    inline SIZE_T ReservedSize() const;
+    /// Get the memory class the arena reports to.
+    inline MemoryClass *GetMemoryClass() const;
+    //@}
+
+  public:
+    /// @name Frame arena
+    //@{
+    /// Get the arena of the calling thread.
+    INTAPI_BASE static MemoryArena &Frame();
+    //@}
+
+  private:
+    /// Copy constructor (forbidden).
+    MemoryArena(const MemoryArena &);
+    /// Assignment operator (forbidden).
+    MemoryArena &operator =(const MemoryArena &);
+
+  private:
+    /// Header of the memory chunk, the blocks follow it.
+    struct Chunk
+      {
+      /// Next chunk in the list.
+      Chunk *next;
+      /// Size of the chunk including the header, in bytes.
+      SIZE_T size;
+      };
+
+  private:
+    /// Allocate a block in the next chunk.
+    INTAPI_BASE void *AllocSlow(SIZE_T size, SIZE_T align);
+    /// Make the chunk current.
+    inline void SetChunk(Chunk *chunk);
+
+  private:
+    /// @name Members
+    //@{
+    /// Memory class the reserved memory is reported to.
+    MemoryClass *m_class;
+    /// Default size of the chunk.
+    SIZE_T m_chunk_size;
+    /// List of the chunks.
+    Chunk *m_first;
+    /// Current chunk.
+    Chunk *m_cur;
+    /// First free byte of the current chunk.
+    char *m_ptr;
+    /// End of the current chunk.
+    char *m_end;
+    /// Size of the blocks in the chunks before the current one.
+    SIZE_T m_used_before;
+    /// Size of the chunks taken from the heap.
+    SIZE_T m_reserved;
+    //@}
+  };  // class MemoryArena
+
+//////////////////////////////////////////////////////////////////////////////
+// Inline methods of MemoryArena
+
+//////////////////////////////////////////////////////////////////////////////
+/// Allocate a block.
+///
+/// The block is taken from the current chunk by the increment of the
+/// pointer; a new chunk is taken from the heap if the current one is full.
+/// @param[in] size - Size of the block, in bytes.
+/// @param[in] align - Alignment of the block, a power of 2.
+/// @return A pointer to the block or NULL (memory allocation failure).
+void *MemoryArena::Alloc(SIZE_T size, SIZE_T align)
+  {
+  Assert(align > 0 && (align & (align - 1)) == 0);
+  char *p = (char *)(((SIZE_T)m_ptr + align - 1) & ~(align - 1));
+  if (m_ptr != NULL && p <= m_end && size <= (SIZE_T)(m_end - p))
+    {
+    m_ptr = p + size;
+    return p;
+    }
+  return AllocSlow(size, align);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Release a block.
+///
+/// The memory of the block is reused only after Reset(), so the method does
+/// nothing; it is the pair of Alloc() for the code working with the heap
+/// and arena memory alike.
+/// @param[in] p - A pointer returned by Alloc() or NULL.
+/// @param[in] size - Size of the block.
+void MemoryArena::Free(void *p, SIZE_T size)
+  {
+  (void)p;
+  (void)size;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Change the size of the last allocated block in place.
+///
+/// Growing arrays use it to avoid the copy, if nothing else was allocated
+/// after the array.
+/// @param[in] p - A pointer returned by Alloc().
+/// @param[in] old_size - Current size of the block.
+/// @param[in] new_size - New size of the block.
+/// @return @b true if the block is the last one and the new size fits into
+/// the chunk; @b false otherwise (the block is not changed).
+bool MemoryArena::Extend(void *p, SIZE_T old_size, SIZE_T new_size)
+  {
+  if (p == NULL || (char *)p + old_size != m_ptr ||
+      new_size > (SIZE_T)(m_end - (char *)p))
+    return false;
+  m_ptr = (char *)p + new_size;
+  return true;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Release all blocks, the memory is kept for the next use.
+///
+/// All blocks allocated from the arena become invalid: arrays and matrices
+/// constructed with the arena must be destroyed (or emptied) before.
+/// The chunks are kept, so the next allocations of the same size do not
+/// touch the heap.
+void MemoryArena::Reset()
+  {
+  SetChunk(m_first);
+  m_used_before = 0;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the size of the allocated blocks.
+/// @return Size of the blocks since the last Reset(), in bytes, including
+/// the alignment gaps and the unused tails of the full chunks.
+SIZE_T MemoryArena::UsedSize() const
+  {
+  if (m_cur == NULL)
+    return 0;
+  return m_used_before + (SIZE_T)(m_ptr - (char *)(m_cur + 1));
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the size of the memory taken from the heap.
+/// @return Size of all chunks, in bytes.
+SIZE_T MemoryArena::ReservedSize() const
+  {
+  return m_reserved;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the memory class the arena reports to.
+/// @return Memory class with the size of the chunks of the arena.
+MemoryClass *MemoryArena::GetMemoryClass() const
+  {
+  return m_class;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Make the chunk current.
+/// @param[in] chunk - A chunk of the list or NULL.
+void MemoryArena::SetChunk(Chunk *chunk)
+  {
+  m_cur = chunk;
+  if (chunk == NULL)
+    {
+    m_ptr = m_end = NULL;
+    return;
+    }
+  m_ptr = (char *)(chunk + 1);
+  m_end = (char *)chunk + chunk->size;
+  }
+
+INTEGRA_NAMESPACE_END
+#endif
@@ -18,6 +18,10 @@ elements of the TArray is variable.
 
 @param[in] T - Type of the elements which will be stored in the array.
 The type must provide a default constructor and a copy constructor.
+@param[in] I - Type of the indices, lengths and sizes, int by default.
+Arrays of more than 2^31 elements use INT64 (TArray64, GArray64,
+MArray64 are the shortcuts); the interface is the same, permutations of
+MArray are TArray<I, I>. Serialized length is 32 bit for both.
 
 @note The constructor of type T (default or explicit one) is called to create
 array elements.  Elements are destroyed by calling the destructor
@@ -26,6 +30,23 @@ of type T if any.
 The user may not rely on addresses of array elements as they
 can be reallocated in memory by certain TArray's methods.
 
+The area is raw memory aligned for T, the elements are constructed
+in place. On reallocation the used elements are relocated, not copied:
+trivially copyable elements are moved by realloc() / memcpy(), other
+elements are move-constructed (e.g. nested arrays and strings just pass
+their buffers). Add(T &&) and Emplace() put a new element without a
+temporary copy:
+
+@code
+   TArray<Str> names;
+   names.Emplace("first");         // Str(const char *) in place
+   names.Add(Str(buf, len));       // moved, not copied
+@endcode
+
+Temporary arrays may take their memory from a MemoryArena instead of the
+heap (see TArray(MemoryArena *, I)); such an array is released together
+with the other blocks of the arena by MemoryArena::Reset().
+
 The current implementation of the TArray object keeps a pointer to
 dynamic area where all the elements are kept in order. The
 length of the array (the current number of elements in the
@@ -49,7 +70,10 @@ To serialize an array, use the following code:
 
 This serializes the array @b arr as a chunk with the name "MyArray"
 via the Serializer @b inout. Empty arrays are treated as defaults
-and are not written to serialization media.
+and are not written to serialization media. The number of elements is
+written as 32 bit unsigned value for int indices and as INT64 value for
+64 bit indices (TArray64), so the arrays of these types are not
+interchangeable in serialization media.
 
 Example:
 
@@ -11,6 +11,11 @@
 #ifndef _KLBC_ARRAYS_HPP_
 #define _KLBC_ARRAYS_HPP_
 
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "arena.hpp"
 #include "base.hpp"
 #include "iarray.hpp"
 #include "serializer.hpp"
@@ -19,7 +24,10 @@
 INTEGRA_NAMESPACE_START
 
 /// Dynamic array of elements of an arbitrary type.
-template <class T>
+///
+/// @a I is the type of the indices and lengths: int by default (declared
+/// in str.hpp), INT64 for arrays of more than 2^31 elements (TArray64).
+template <class T, class I>
 class TArray : public IArray
   {
   public:
@@ -37,11 +45,15 @@ class TArray : public IArray
     /// @name Constructors, destructor
     //@{
     /// Default constructor.
-    explicit TArray(int the_block_size = DEF_BLOCK_SIZE);
+    explicit TArray(I the_block_size = DEF_BLOCK_SIZE);
+    /// Constructor of the array in the arena.
+    explicit TArray(MemoryArena *the_arena, I the_block_size = DEF_BLOCK_SIZE);
     /// Constructor from the given values.
-    inline TArray(const T *val, int length, int the_block_size = DEF_BLOCK_SIZE);
+    inline TArray(const T *val, I length, I the_block_size = DEF_BLOCK_SIZE);
     /// Copy constructor.
-    TArray(const TArray<T> &sour);
+    TArray(const TArray<T, I> &sour);
+    /// Move constructor.
+    inline TArray(TArray<T, I> &&sour);
     /// Destructor.
     inline virtual ~TArray();
     //@}
@@ -50,9 +62,9 @@ class TArray : public IArray
     /// @name Access to elements
     //@{
     /// Get a reference to an array element.
-    inline T &operator [](int pos);
+    inline T &operator [](I pos);
     /// Get a const reference to an array element.
-    inline const T &operator [](int pos) const;
+    inline const T &operator [](I pos) const;
     /// Get a pointer to the array for reading.
     inline const T *Data() const;
     /// Get a pointer to the array for reading and writing.
@@ -63,13 +75,13 @@ class TArray : public IArray
     /// @name Length and sizes
     //@{
     /// Get the number of used elements.
-    inline int Length() const;
+    inline I Length() const;
     /// Get the size occupied by the array.
-    inline int Size() const;
+    inline I Size() const;
     /// Get block size of the array.
-    inline int BlockSize() const;
+    inline I BlockSize() const;
     /// Set a new block size.
-    inline void SetBlockSize(int blsize);
+    inline void SetBlockSize(I blsize);
     //@}
 
   public:
@@ -77,64 +89,71 @@ class TArray : public IArray
     //@{
     /// Add a new element to the end of the array.
     OKAY Add(const T &elem);
+    /// Move a new element to the end of the array.
+    OKAY Add(T &&elem);
+    /// Construct a new element at the end of the array.
+    template <class... Args>
+    OKAY Emplace(Args &&... args);
     /// Add a new elements to the end of the array.
-    OKAY Append(const T *pelem, int len = 1);
+    OKAY Append(const T *pelem, I len = 1);
     /// Insert a new elements to the specified position.
-    OKAY Insert(const T *pelem, int pos, int len = 1);
+    OKAY Insert(const T *pelem, I pos, I len = 1);
     /// Put a new element to the specified position.
-    OKAY Put(const T &elem, int pos);
+    OKAY Put(const T &elem, I pos);
     //@}
 
   public:
     /// @name Removal of elements
     //@{
     /// Exclude a number of elements starting from the specified position.
-    void Exclude(int pos, int len = 1);
+    void Exclude(I pos, I len = 1);
     /// Exclude one element at the specified position.
-    void Remove(int pos);
+    void Remove(I pos);
     //@}
 
   public:
     /// @name Size and length change
     //@{
     /// Decrease the length of the array.
-    inline void Truncate(int new_count = 0);
+    inline void Truncate(I new_count = 0);
     /// Change the size of the array.
-    OKAY Resize(int new_size = 0);
+    OKAY Resize(I new_size = 0);
     /// Change (expand) length of the array.
-    OKAY Allocate(int new_len);
+    OKAY Allocate(I new_len);
     /// Change length of the array.
-    OKAY SetLength(int new_len);
+    OKAY SetLength(I new_len);
     /// Change (expand) length of the array.
-    OKAY Grow(int new_len);
+    OKAY Grow(I new_len);
     //@}
 
   public:
     /// @name Swap arrays
     //@{
     /// Fast swap of arrays.
-    static void SwapArrays(TArray<T> &a, TArray<T> &b);
+    static void SwapArrays(TArray<T, I> &a, TArray<T, I> &b);
     //@}
 
   public:
     /// @name Copying, assignment
     //@{
     /// Copy the array.
-    OKAY Copy(const TArray<T> &sour);
+    OKAY Copy(const TArray<T, I> &sour);
     /// Permute the array.
-    OKAY Permute(const int *perm);
+    OKAY Permute(const I *perm);
     /// Assignment operator.
-    TArray<T> &operator =(const TArray<T> &sour);
+    TArray<T, I> &operator =(const TArray<T, I> &sour);
+    /// Move assignment operator.
+    TArray<T, I> &operator =(TArray<T, I> &&sour);
     /// Set array size to Length(sour) and copy only used array part.
-    OKAY SetArray(const TArray<T> &sour);
+    OKAY SetArray(const TArray<T, I> &sour);
     /// Set all elements to the same value.
-    TArray<T> &operator =(const T &val);
+    TArray<T, I> &operator =(const T &val);
     /// Set all elements to the same value.
     void Set(const T &val);
     /// Set some elements to the same value.
-    void Set(const T &val, int pos, int n);
+    void Set(const T &val, I pos, I n);
     /// Append an array to 'this' array.
-    inline TArray<T> &Append(const TArray<T> &sour);
+    inline TArray<T, I> &Append(const TArray<T, I> &sour);
     //@}
 
   public:
@@ -150,7 +169,25 @@ class TArray : public IArray
     /// @name Private methods
     //@{
     /// Expand the size of the array.
-    OKAY Expand(int needed_size);
+    OKAY Expand(I needed_size);
+    /// Allocate raw storage for the elements.
+    T *AllocData(I n);
+    /// Release raw storage of the elements.
+    void FreeData(T *p, I n);
+    /// Default-construct elements in raw storage.
+    static void ConstructData(T *p, I n);
+    /// Destroy elements, storage is not released.
+    static void DestroyData(T *p, I n);
+    //@}
+
+  private:
+    /// @name Private constants
+    //@{
+    enum
+      {
+      /// Alignment guaranteed by malloc()
+      MALLOC_ALIGN = 2 * sizeof(void *)
+      };
     //@}
 
   protected:
@@ -159,19 +196,23 @@ class TArray : public IArray
     /// Pointer to the array of the elements.
     T *data;
     /// Number of elements in the array.
-    int count;
+    I count;
     //@}
 
   private:
     /// @name Private members
     //@{
     /// Size occupied by array (size of allocated area), in elements.
-    int size;
+    I size;
     /// Number of elements in the memory block.
-    int block_size;
+    I block_size;
     //@}
   };  // class TArray
 
+/// Dynamic array with 64 bit indices.
+template <class T>
+using TArray64 = TArray<T, INT64>;
+
 
 //////////////////////////////////////////////////////////////////////////////
 // Methods of the class TArray
@@ -183,14 +224,34 @@ class TArray : public IArray
 /// size and length are set to zero, block size is set to the parameter.
 /// @param[in] the_block_size - Size of the memory block, in elements;
 /// must be > 0, the debug version asserts it.
-template <class T>
-TArray<T>::TArray(int the_block_size)
+template <class T, class I>
+TArray<T, I>::TArray(I the_block_size)
+  {
+  Assert(the_block_size > 0);
+  size = 0;
+  count = 0;
+  block_size = the_block_size;
+  data = NULL;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Constructor of the array in the arena.
+///
+/// The elements are allocated in the arena instead of the heap; the array
+/// must be destroyed (or emptied) before the arena is reset. Copies of the
+/// array are allocated in the heap.
+/// @param[in] the_arena - Arena for the elements, NULL for the heap.
+/// @param[in] the_block_size - Size of the memory block, in elements;
+/// must be > 0, the debug version asserts it.
+template <class T, class I>
+TArray<T, I>::TArray(MemoryArena *the_arena, I the_block_size)
   {
   Assert(the_block_size > 0);
   size = 0;
   count = 0;
   block_size = the_block_size;
   data = NULL;
+  arena = the_arena;
   }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -200,8 +261,8 @@ TArray<T>::TArray(int the_block_size)
 /// @param[in] the_block_size  Size of the memory block, in elements;
 /// @note Is array succesfully constructed or not - can be controlled
 /// via the Length() of the array, which is 0, if data allocation failed.
-template <class T>
-TArray<T>::TArray(const T *val, int length, int the_block_size)
+template <class T, class I>
+TArray<T, I>::TArray(const T *val, I length, I the_block_size)
   {
   Assert(the_block_size > 0);
   size = 0;
@@ -215,15 +276,15 @@ TArray<T>::TArray(const T *val, int length, int the_block_size)
 
   // Copy data
   count = length;
-  for (int i = 0; i < count; i++)
+  for (I i = 0; i < count; i++)
     data[i] = val[i];
   }
 
 //////////////////////////////////////////////////////////////////////////////
 /// Copy constructor.
 /// @param[in] sour - A source object of the class.
-template <class T>
-TArray<T>::TArray(const TArray<T> &sour)
+template <class T, class I>
+TArray<T, I>::TArray(const TArray<T, I> &sour)
   {
   size = 0;
   count = 0;
@@ -232,16 +293,35 @@ TArray<T>::TArray(const TArray<T> &sour)
   (void)this->Copy(sour);
   }
 
+//////////////////////////////////////////////////////////////////////////////
+/// Move constructor.
+///
+/// The elements are taken from the source array without copying,
+/// the source array becomes empty.
+/// @param[in, out] sour - A source object of the class.
+template <class T, class I>
+TArray<T, I>::TArray(TArray<T, I> &&sour)
+  {
+  size = 0;
+  count = 0;
+  data = NULL;
+  block_size = sour.block_size;
+  SwapArrays(*this, sour);
+  }
+
 //////////////////////////////////////////////////////////////////////////////
 /// Destructor.
 ///
 /// The method releases all memory occupied by the array.
-template <class T>
-TArray<T>::~TArray()
+template <class T, class I>
+TArray<T, I>::~TArray()
   {
-  delete[] data;
   if (data != NULL)
+    {
     DelMemStat(size * sizeof(T), data, "TArray");
+    DestroyData(data, size);
+    FreeData(data, size);
+    }
   }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -252,8 +332,8 @@ TArray<T>::~TArray()
 /// @param[in] pos - An index of the element;
 /// must be >= 0 and less than the length of the array, debug version asserts it.
 /// @return A reference to the element.
-template <class T>
-T &TArray<T>::operator [](int pos)
+template <class T, class I>
+T &TArray<T, I>::operator [](I pos)
   {
   Assert(pos >= 0 && pos < count);
   return data[pos];
@@ -267,8 +347,8 @@ T &TArray<T>::operator [](int pos)
 /// @param[in] pos - An index of the element;
 /// must be >= 0 and less than the length of the array, debug version asserts it.
 /// @return A const reference to the element.
-template <class T>
-const T &TArray<T>::operator [](int pos) const
+template <class T, class I>
+const T &TArray<T, I>::operator [](I pos) const
   {
   Assert(pos >= 0 && pos < count);
   return data[pos];
@@ -277,8 +357,8 @@ const T &TArray<T>::operator [](int pos) const
 //////////////////////////////////////////////////////////////////////////////
 /// Get a pointer to the array for reading.
 /// @return A const pointer to the array data.
-template <class T>
-const T *TArray<T>::Data() const
+template <class T, class I>
+const T *TArray<T, I>::Data() const
   {
   return data;
   }
@@ -286,8 +366,8 @@ const T *TArray<T>::Data() const
 //////////////////////////////////////////////////////////////////////////////
 /// Get a pointer to the array for reading and writing.
 /// @return A pointer to the array data.
-template <class T>
-T *TArray<T>::Data()
+template <class T, class I>
+T *TArray<T, I>::Data()
   {
   return data;
   }
@@ -295,8 +375,8 @@ T *TArray<T>::Data()
 //////////////////////////////////////////////////////////////////////////////
 /// Get the number of used elements.
 /// @return The length of the array.
-template <class T>
-int TArray<T>::Length() const
+template <class T, class I>
+I TArray<T, I>::Length() const
   {
   return count;
   }
@@ -304,8 +384,8 @@ int TArray<T>::Length() const
 //////////////////////////////////////////////////////////////////////////////
 /// Get the size occupied by the array.
 /// @return The size occupied by the array, in elements.
-template <class T>
-int TArray<T>::Size() const
+template <class T, class I>
+I TArray<T, I>::Size() const
   {
   return size;
   }
@@ -313,8 +393,8 @@ int TArray<T>::Size() const
 //////////////////////////////////////////////////////////////////////////////
 /// Get the block size of the array.
 /// @return The block size of the array, in elements.
-template <class T>
-int TArray<T>::BlockSize() const
+template <class T, class I>
+I TArray<T, I>::BlockSize() const
   {
   return block_size;
   }
@@ -323,8 +403,8 @@ int TArray<T>::BlockSize() const
 /// Set a new block size.
 /// @param[in] blsize - A new block size of the array, in elements;
 /// must be > 0, debug version asserts it.
-template <class T>
-void TArray<T>::SetBlockSize(int blsize)
+template <class T, class I>
+void TArray<T, I>::SetBlockSize(I blsize)
   {
   Assert(blsize > 0);
   block_size = blsize;
@@ -334,8 +414,8 @@ void TArray<T>::SetBlockSize(int blsize)
 /// Add a new element to the end of the array.
 /// @param[in] elem - A reference to the new element.
 /// @return SUCCESS / FAILURE (memory allocation failure).
-template <class T>
-OKAY TArray<T>::Add(const T &elem)
+template <class T, class I>
+OKAY TArray<T, I>::Add(const T &elem)
   {
   if (this->Expand(count + 1) != SUCCESS)
     return FAILURE;
@@ -345,6 +425,46 @@ OKAY TArray<T>::Add(const T &elem)
   return SUCCESS;
   }
 
+//////////////////////////////////////////////////////////////////////////////
+/// Move a new element to the end of the array.
+///
+/// The element is move-assigned, i.e. its resources are taken without
+/// copying.
+/// @param[in, out] elem - An rvalue reference to the new element.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, class I>
+OKAY TArray<T, I>::Add(T &&elem)
+  {
+  if (this->Expand(count + 1) != SUCCESS)
+    return FAILURE;
+  data[count++] = std::move(elem);
+  Assert(count <= size);
+
+  return SUCCESS;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Construct a new element at the end of the array.
+///
+/// The element is constructed in place by the constructor of T with the
+/// given arguments (the default element in the slot is destroyed first).
+/// @param[in] args - Arguments of the constructor of T.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, class I>
+template <class... Args>
+OKAY TArray<T, I>::Emplace(Args &&... args)
+  {
+  if (this->Expand(count + 1) != SUCCESS)
+    return FAILURE;
+  T *p = data + count;
+  p->~T();
+  ::new ((void *)p) T(std::forward<Args>(args)...);
+  count++;
+  Assert(count <= size);
+
+  return SUCCESS;
+  }
+
 //////////////////////////////////////////////////////////////////////////////
 /// Add new elements to the end of the array.
 ///
@@ -354,15 +474,15 @@ OKAY TArray<T>::Add(const T &elem)
 /// @param[in] len - The length of the array of new elements;
 /// must be >= 0, debug version asserts it.
 /// @return SUCCESS / FAILURE (memory allocation failure).
-template <class T>
-OKAY TArray<T>::Append(const T *elem, int len)
+template <class T, class I>
+OKAY TArray<T, I>::Append(const T *elem, I len)
   {
   Assert(len >= 0);  
 
   if (this->Expand(count + len) != SUCCESS)
     return FAILURE;
 
-  for (int i = 0; i < len; i++)
+  for (I i = 0; i < len; i++)
     data[count++] = elem[i];
 
   Assert(count <= size);
@@ -382,22 +502,22 @@ OKAY TArray<T>::Append(const T *elem, int len)
 /// @param[in] len - The length of the array of new elements;
 /// must be >= 0, debug version asserts it.
 /// @return SUCCESS / FAILURE (memory allocation failure).
-template <class T>
-OKAY TArray<T>::Insert(const T *elem, int pos, int len)
+template <class T, class I>
+OKAY TArray<T, I>::Insert(const T *elem, I pos, I len)
   {
   Assert(len >= 0 && pos >= 0);
 
   // Allocation new memory, if needed
-  int new_len = (pos > count) ? (pos + len) : (count + len);
+  I new_len = (pos > count) ? (pos + len) : (count + len);
   if (this->Expand(new_len) != SUCCESS)
     return FAILURE;
 
   // Shift elements to end of the new array
-  int i;
+  I i;
   for (i = count; i > pos; )
     {
     i--;
-    data[i + len] = data[i];
+    data[i + len] = std::move(data[i]);
     }
 
   // Insert of the new elements
@@ -419,8 +539,8 @@ OKAY TArray<T>::Insert(const T *elem, int pos, int len)
 /// @param[in] pos - A position for the insertion;
 /// must be >= 0, debug version asserts it.
 /// @return SUCCESS / FAILURE (memory allocation failure).
-template <class T>
-OKAY TArray<T>::Put(const T &elem, int pos)
+template <class T, class I>
+OKAY TArray<T, I>::Put(const T &elem, I pos)
   {
   Assert(pos >= 0);
 
@@ -449,15 +569,15 @@ OKAY TArray<T>::Put(const T &elem, int pos)
 /// to the end of the array are copied to the position @a pos; the length
 /// of the array is changed; the order of the rest elements is
 /// not changed.
-template <class T>
-void TArray<T>::Exclude(int pos, int len)
+template <class T, class I>
+void TArray<T, I>::Exclude(I pos, I len)
   {
   Assert(len >= 0 && pos >= 0 && pos < count);
 
   if (pos + len < count)     // In this case shift elements
     {
-    for (int i = pos; i + len < count; i++)
-      data[i] = data[len + i];
+    for (I i = pos; i + len < count; i++)
+      data[i] = std::move(data[len + i]);
 
     count -= len;
     }
@@ -477,14 +597,14 @@ void TArray<T>::Exclude(int pos, int len)
 /// The size of the array is not changed.
 /// @param[in] pos - A position of the element to be removed;
 /// must be >= 0 and less than length of array, debug version asserts it.
-template <class T>
-void TArray<T>::Remove(int pos)
+template <class T, class I>
+void TArray<T, I>::Remove(I pos)
   {
   Assert(pos >= 0 && pos < count);
 
   count--;
   if (pos < count)
-    data[pos] = data[count];
+    data[pos] = std::move(data[count]);
   }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -498,14 +618,14 @@ void TArray<T>::Remove(int pos)
 /// @param[in] new_size - A new size of the array, in elements;
 /// must be >= 0, debug version asserts it.
 /// @return SUCCESS / FAILURE (memory allocation failure).
-template <class T>
-OKAY TArray<T>::Resize(int new_size)
+template <class T, class I>
+OKAY TArray<T, I>::Resize(I new_size)
   {
   if (new_size < 0)
     {
-    // May we run out of 32 bit...
-    return User()->InternalError("TArray: new_size=%d < 0 (32 bit overflow?)",
-      new_size);
+    // May we run out of the index type...
+    return User()->InternalError("TArray: new_size=%lld < 0 (index overflow?)",
+      (long long)new_size);
     }
   Assert(new_size >= 0);
   if (new_size == size)
@@ -514,39 +634,83 @@ OKAY TArray<T>::Resize(int new_size)
   // Process zero case specially
   if (new_size == 0)
     {
-    delete[] data;
     if (data != NULL)
+      {
       DelMemStat(size * sizeof(T), data, "TArray");
+      DestroyData(data, size);
+      FreeData(data, size);
+      }
     data = NULL;
     count = size = 0;
     return SUCCESS;
     }
 
   // Allocate new array
-  if (MAX_SIZE_T / new_size < sizeof(T))
+  if ((UINT64)new_size > MAX_SIZE_T / sizeof(T))
     {
-    // May we run out of 32 bit...
-    return User()->InternalError("TArray: new_size=%d * %d (32 bit overflow?)",
-      new_size, (int)sizeof(T));
+    // May we run out of the address space...
+    return User()->InternalError("TArray: new_size=%lld * %d (size overflow?)",
+      (long long)new_size, (int)sizeof(T));
     }
-  T *new_data = new T[new_size];
-  AddMemStat(new_size * sizeof(T), new_data, "TArray");
-  if (new_data == NULL)
-    return FAILURE;
-  if (data != NULL)
+  T *new_data;
+  if (arena != NULL && data != NULL &&
+      arena->Extend(data, (SIZE_T)size * sizeof(T), (SIZE_T)new_size * sizeof(T)))
+    {
+    // The last block of the arena is changed in place
+    new_data = data;
     DelMemStat(size * sizeof(T), data, "TArray");
+    AddMemStat(new_size * sizeof(T), new_data, "TArray");
+    if (new_size > size)
+      ConstructData(new_data + size, new_size - size);
+    else
+      DestroyData(new_data + new_size, size - new_size);
+    }
+  else if (std::is_trivially_copyable<T>::value && alignof(T) <= MALLOC_ALIGN &&
+           arena == NULL)
+    {
+    // Trivially copyable elements are relocated by realloc()
+    new_data = (T *)realloc((void *)data, (SIZE_T)new_size * sizeof(T));
+    if (new_data == NULL)
+      return FAILURE;
+    if (data != NULL)
+      DelMemStat(size * sizeof(T), data, "TArray");
+    AddMemStat(new_size * sizeof(T), new_data, "TArray");
+    if (new_size > size)
+      ConstructData(new_data + size, new_size - size);
+    }
+  else
+    {
+    new_data = AllocData(new_size);
+    if (new_data == NULL)
+      return FAILURE;
+    AddMemStat(new_size * sizeof(T), new_data, "TArray");
+    // Relocate used elements, construct the rest
+    I n_used = Min(count, new_size);
+    if (std::is_trivially_copyable<T>::value)
+      {
+      if (n_used > 0)
+        memcpy((void *)new_data, (const void *)data, n_used * sizeof(T));
+      }
+    else
+      {
+      for (I i = 0; i < n_used; i++)
+        ::new ((void *)(new_data + i)) T(std::move(data[i]));
+      }
+    ConstructData(new_data + n_used, new_size - n_used);
+    // Delete old area
+    if (data != NULL)
+      {
+      DelMemStat(size * sizeof(T), data, "TArray");
+      DestroyData(data, size);
+      FreeData(data, size);
+      }
+    }
+  data = new_data;
+
   // Update size and length
   size = new_size;
   if (count > size)
     count = size;
-
-  // Copy data
-  for (int i = 0; i < count; i++)
-    new_data[i] = data[i];
-
-  // Delete old area
-  delete[] data;
-  data = new_data;
   return SUCCESS;
   }  // Resize()
 
@@ -558,8 +722,8 @@ OKAY TArray<T>::Resize(int new_size)
 /// Memory is not reallocated.
 /// @param[in] new_count - A new length;
 /// must be >= 0 and no more than the length of array, debug version asserts it.
-template <class T>
-void TArray<T>::Truncate(int new_count)
+template <class T, class I>
+void TArray<T, I>::Truncate(I new_count)
   {
   Assert(new_count >= 0 && new_count <= count);
   count = new_count;
@@ -574,8 +738,8 @@ void TArray<T>::Truncate(int new_count)
 /// @param[in] new_len - A new length;
 /// must be >= 0, debug version asserts it.
 /// @return SUCCESS / FAILURE (memory allocation failure).
-template <class T>
-OKAY TArray<T>::Allocate(int new_len)
+template <class T, class I>
+OKAY TArray<T, I>::Allocate(I new_len)
   {
   Assert(new_len >= 0);
   if (new_len < 0)
@@ -605,8 +769,8 @@ OKAY TArray<T>::Allocate(int new_len)
 /// @param[in] new_len - A new length;
 /// must be >= 0, debug version asserts it.
 /// @return SUCCESS / FAILURE (memory allocation failure).
-template <class T>
-OKAY TArray<T>::SetLength(int new_len)
+template <class T, class I>
+OKAY TArray<T, I>::SetLength(I new_len)
   {
   Assert(new_len >= 0);
   // Realloc memory
@@ -624,8 +788,8 @@ OKAY TArray<T>::SetLength(int new_len)
 /// @param[in] new_len - A new length;
 /// must be >= 0, debug version asserts it.
 /// @return SUCCESS / FAILURE (memory allocation failure).
-template <class T>
-OKAY TArray<T>::Grow(int new_len)
+template <class T, class I>
+OKAY TArray<T, I>::Grow(I new_len)
   {
   Assert(new_len >= 0);
   if (new_len < 0)
@@ -648,13 +812,14 @@ OKAY TArray<T>::Grow(int new_len)
 /// actual transposing of the elements.
 /// @param[in, out] a - The first array to be swapped.
 /// @param[in, out] b - The second array to be swapped.
-template <class T>
-void TArray<T>::SwapArrays(TArray<T> &a, TArray<T> &b)
+template <class T, class I>
+void TArray<T, I>::SwapArrays(TArray<T, I> &a, TArray<T, I> &b)
   {
   Swap(a.data, b.data);
   Swap(a.size, b.size);
   Swap(a.count, b.count);
   Swap(a.block_size, b.block_size);
+  Swap(a.arena, b.arena);
   }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -663,8 +828,8 @@ void TArray<T>::SwapArrays(TArray<T> &a, TArray<T> &b)
 /// Memory under the new array is reallocated.
 /// @param[in] sour - A source array.
 /// @return SUCCESS / FAILURE (memory allocation failure).
-template <class T>
-OKAY TArray<T>::Copy(const TArray<T> &sour)
+template <class T, class I>
+OKAY TArray<T, I>::Copy(const TArray<T, I> &sour)
   {
   // Reallocate memory
   if (this->Resize(sour.size) != SUCCESS)
@@ -672,7 +837,7 @@ OKAY TArray<T>::Copy(const TArray<T> &sour)
 
   // Copy data
   count = sour.count;
-  for (int i = 0; i < count; i++)
+  for (I i = 0; i < count; i++)
     data[i] = sour[i];
 
   return SUCCESS;
@@ -684,21 +849,35 @@ OKAY TArray<T>::Copy(const TArray<T> &sour)
 /// Memory under the new array is reallocated.
 /// @param[in] sour - A source array.
 /// @return A reference to this array.
-template <class T>
-TArray<T> &TArray<T>::operator =(const TArray<T> &sour)
+template <class T, class I>
+TArray<T, I> &TArray<T, I>::operator =(const TArray<T, I> &sour)
   {
   (void)(this->Copy(sour));
   return(*this);
   }
 
+//////////////////////////////////////////////////////////////////////////////
+/// The move assignment operator.
+/// The elements are taken from the source array without copying,
+/// the source array gets the old elements of this array.
+/// @param[in, out] sour - A source array.
+/// @return A reference to this array.
+template <class T, class I>
+TArray<T, I> &TArray<T, I>::operator =(TArray<T, I> &&sour)
+  {
+  if (this != &sour)
+    SwapArrays(*this, sour);
+  return(*this);
+  }
+
 //////////////////////////////////////////////////////////////////////////////
 /// Set all elements to the same value.
 ///
 /// The method sets all array elements to the same value.
 /// @param[in] val - A source value.
 /// @return A reference to this array.
-template <class T>
-TArray<T> &TArray<T>::operator =(const T &val)
+template <class T, class I>
+TArray<T, I> &TArray<T, I>::operator =(const T &val)
   {
   Set(val);
   return(*this);
@@ -709,10 +888,10 @@ TArray<T> &TArray<T>::operator =(const T &val)
 ///
 /// The method sets all array elements to the same value.
 /// @param[in] val - A source value.
-template <class T>
-void TArray<T>::Set(const T &val)
+template <class T, class I>
+void TArray<T, I>::Set(const T &val)
   {
-  for (int i = 0; i < count; i++)
+  for (I i = 0; i < count; i++)
     data[i] = val;
   }
 
@@ -725,10 +904,10 @@ void TArray<T>::Set(const T &val)
 /// must be >= 0 and less than length of array, debug version asserts it.
 /// @param[in] n - The number of elements to set, pos + n
 /// must be >= 0 and less than the length of array, debug version asserts it.
-template <class T>
-void TArray<T>::Set(const T &val, int pos, int n)
+template <class T, class I>
+void TArray<T, I>::Set(const T &val, I pos, I n)
   {
-  for (int i = 0; i < n; i++)
+  for (I i = 0; i < n; i++)
     data[pos + i] = val;
   }
 
@@ -739,8 +918,8 @@ void TArray<T>::Set(const T &val, int pos, int n)
 /// (i.e. if the requested size is greater than the current one).
 /// @param[in] needed_size - The needed size of the memory for the array.
 /// @return SUCCESS / FAILURE (if memory was not allocated).
-template <class T>
-OKAY TArray<T>::Expand(int needed_size)
+template <class T, class I>
+OKAY TArray<T, I>::Expand(I needed_size)
   {
   if (needed_size < 0)
     return User()->InternalError("TArray::Expand(): 32 bit overflow?", needed_size);
@@ -757,7 +936,7 @@ OKAY TArray<T>::Expand(int needed_size)
   // Realloc memory
   return this->Resize(block_size);
 #if 0
-  int new_size = block_size;
+  I new_size = block_size;
   if (needed_size > block_size)
     {
     const int large_blk_size = MAX_INT / 8;
@@ -778,14 +957,87 @@ OKAY TArray<T>::Expand(int needed_size)
 #endif  
   }
 
+//////////////////////////////////////////////////////////////////////////////
+/// Allocate raw storage for the elements.
+///
+/// Memory is aligned for T; elements are not constructed. The storage is
+/// taken from the arena of the array, if any.
+/// @param[in] n - The number of elements, > 0.
+/// @return A pointer to the storage or NULL (memory allocation failure).
+template <class T, class I>
+T *TArray<T, I>::AllocData(I n)
+  {
+  SIZE_T bytes = (SIZE_T)n * sizeof(T);
+  if (arena != NULL)
+    return (T *)arena->Alloc(bytes, Max((SIZE_T)alignof(T), (SIZE_T)MALLOC_ALIGN));
+  if (alignof(T) <= MALLOC_ALIGN)
+    return (T *)malloc(bytes);
+  // Over-aligned type: the block pointer is kept just before the data
+  char *block = (char *)malloc(bytes + alignof(T) + sizeof(void *));
+  if (block == NULL)
+    return NULL;
+  SIZE_T addr = ((SIZE_T)block + sizeof(void *) + alignof(T) - 1) &
+                ~(SIZE_T)(alignof(T) - 1);
+  ((void **)addr)[-1] = block;
+  return (T *)addr;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Release raw storage of the elements.
+/// @param[in] p - A pointer returned by AllocData() or NULL.
+/// @param[in] n - The number of elements given to AllocData().
+template <class T, class I>
+void TArray<T, I>::FreeData(T *p, I n)
+  {
+  if (p == NULL)
+    return;
+  if (arena != NULL)
+    {
+    arena->Free(p, (SIZE_T)n * sizeof(T));
+    return;
+    }
+  if (alignof(T) <= MALLOC_ALIGN)
+    free((void *)p);
+  else
+    free(((void **)p)[-1]);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Default-construct elements in raw storage.
+///
+/// Default initialization as of new T[], i.e. built-in types are not set.
+/// @param[in] p - A pointer to the first element.
+/// @param[in] n - The number of elements, >= 0.
+template <class T, class I>
+void TArray<T, I>::ConstructData(T *p, I n)
+  {
+  if (std::is_trivially_default_constructible<T>::value)
+    return;
+  for (I i = 0; i < n; i++)
+    ::new ((void *)(p + i)) T;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Destroy elements, storage is not released.
+/// @param[in] p - A pointer to the first element.
+/// @param[in] n - The number of elements, >= 0.
+template <class T, class I>
+void TArray<T, I>::DestroyData(T *p, I n)
+  {
+  if (std::is_trivially_destructible<T>::value)
+    return;
+  for (I i = 0; i < n; i++)
+    p[i].~T();
+  }
+
 //////////////////////////////////////////////////////////////////////////////
 /// Permute the array.
 ///
 /// The method permutes the array according to the provided order.
 /// @param[in] perm - A permutation array of the same length as this array;
 /// @return SUCCESS / FAILURE (memory allocation failure).
-template <class T>
-OKAY TArray<T>::Permute(const int *perm)
+template <class T, class I>
+OKAY TArray<T, I>::Permute(const I *perm)
   {
   if (count <= 1)
     {
@@ -793,25 +1045,25 @@ OKAY TArray<T>::Permute(const int *perm)
     }
 
   // Allocate new array
-  T *new_data = new T[count];
-  AddMemStat(count * sizeof(T), new_data, "TArray");
+  T *new_data = AllocData(count);
   if (new_data == NULL)
     return FAILURE;
+  AddMemStat(count * sizeof(T), new_data, "TArray");
   Assert(data != NULL);
-  DelMemStat(size * sizeof(T), data, "TArray");
-
-  // Update size
-  size = count;
-
-  // Copy data with permutation
-  for (int i = 0; i < count; i++)
-    new_data[i] = data[perm[i]];
 
+  // Move data with permutation
+  for (I i = 0; i < count; i++)
+    ::new ((void *)(new_data + i)) T(std::move(data[perm[i]]));
 
   // Delete old area
-  delete[] data;
+  DelMemStat(size * sizeof(T), data, "TArray");
+  DestroyData(data, size);
+  FreeData(data, size);
   data = new_data;
 
+  // Update size
+  size = count;
+
   return SUCCESS;
   }  // Permute()
 
@@ -819,8 +1071,8 @@ OKAY TArray<T>::Permute(const int *perm)
 /// Append an array to this array.
 /// @param[in] sour - A source array to append.
 /// @return A reference to this array.
-template <class T>
-TArray<T> &TArray<T>::Append(const TArray<T> &sour)
+template <class T, class I>
+TArray<T, I> &TArray<T, I>::Append(const TArray<T, I> &sour)
   {
   Append(sour.Data(), sour.Length());
   return *this;
@@ -832,8 +1084,8 @@ TArray<T> &TArray<T>::Append(const TArray<T> &sour)
 /// See @ref base_tarray_serialization for details.
 /// @param[in, out] inout - A serializer.
 /// @param[in] tag - A chunk name.
-template <class T>
-void TArray<T>::BegChunk(Serializer &inout, const char *tag)
+template <class T, class I>
+void TArray<T, I>::BegChunk(Serializer &inout, const char *tag)
   {
   // Open a chunk
   inout.BegChunk(tag);
@@ -842,8 +1094,25 @@ void TArray<T>::BegChunk(Serializer &inout, const char *tag)
     {
     // Reading...
     Resize();                        // Free memory for sure
-    unsigned total = 0;
-    inout.Value(total);              // Read number of elements
+    I total = 0;
+    if (sizeof(I) > sizeof(unsigned))
+      {
+      // 64 bit indices: 64 bit number of elements
+      INT64 total64 = 0;
+      inout.Value(total64);
+      if (total64 < 0)
+        {
+        inout.SetAllocError();       // Corrupted number of elements
+        return;
+        }
+      total = (I)total64;
+      }
+    else
+      {
+      unsigned total32 = 0;
+      inout.Value(total32);          // Read number of elements
+      total = (I)total32;
+      }
     if (Allocate(total) != SUCCESS)  // Allocate memory for the elements
       inout.SetAllocError();
     }
@@ -851,7 +1120,16 @@ void TArray<T>::BegChunk(Serializer &inout, const char *tag)
     {
     // Writing...
     // Write non-zero number of elements
-    inout.Value((unsigned &)count);
+    if (sizeof(I) > sizeof(unsigned))
+      {
+      INT64 total64 = (INT64)count;
+      inout.Value(total64);
+      }
+    else
+      {
+      unsigned total32 = (unsigned)count;
+      inout.Value(total32);
+      }
     }
   }  // BegChunk()
 
@@ -860,8 +1138,8 @@ void TArray<T>::BegChunk(Serializer &inout, const char *tag)
 ///
 /// See @ref base_tarray_serialization for details.
 /// @param[in, out] inout - A serializer.
-template <class T>
-void TArray<T>::EndChunk(Serializer &inout)
+template <class T, class I>
+void TArray<T, I>::EndChunk(Serializer &inout)
   {
   inout.EndChunk();     // Close the chunk
   }
@@ -870,8 +1148,8 @@ void TArray<T>::EndChunk(Serializer &inout)
 /// Set array size to Length(sour) and copy only used array part.
 /// @param[in] sour - Input array.
 /// @return SUCCESS / FAILURE (memory allocation failure).
-template <class T>
-OKAY TArray<T>::SetArray(const TArray<T> &sour)
+template <class T, class I>
+OKAY TArray<T, I>::SetArray(const TArray<T, I> &sour)
   {
   // Reallocate memory
   if (Resize(sour.count) != SUCCESS)
@@ -880,7 +1158,7 @@ OKAY TArray<T>::SetArray(const TArray<T> &sour)
   size = sour.count;
   count = size;
   // Copy data
-  for (int i = 0; i < count; i++)
+  for (I i = 0; i < count; i++)
     data[i] = sour[i];
   return SUCCESS;
   }
@@ -23,5 +23,15 @@ Type must provide copy constructor and "operator ==()".
 @param[in] VALUE Type of the elements to be used as values.
 Type must provide copy constructor.
 
+Pairs are kept in the array in the order of addition, so GetKey(i) and
+GetValue(i) enumerate them as before. Dictionaries of more than a few
+pairs with hashed keys (integers, enumerations, pointers, Str and UStr,
+see DictHashTraits) keep also a hash index: open addressing table of
+(hash, index of the pair) slots with Robin Hood linear probing. Search,
+Put(), Enter() and Remove() are O(1) on average; Exclude() keeps the order
+of pairs and rebuilds the index, i.e. it is O(n) as before. Other key
+types are searched by the linear scan; specialize DictHashTraits for
+them to get the index.
+
 @sa @ref base_mainpage
 **/
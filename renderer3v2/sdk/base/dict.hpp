@@ -11,10 +11,83 @@
 #ifndef _KLBC_DICT_HPP_
 #define _KLBC_DICT_HPP_
 
+#include <type_traits>
+
 #include "arrays.hpp"
 
 INTEGRA_NAMESPACE_START
 
+/// @brief Hash function of the keys of TDict.
+///
+/// Keys without hash function are searched by the linear scan.
+/// Specialize the template for own key types: HASHED = 1 and Hash()
+/// consistent with "operator ==()" of the key.
+template <class KEY, class ENABLE = void>
+struct DictHashTraits
+  {
+  /// The key type has no hash function.
+  enum { HASHED = 0 };
+  /// Dummy hash.
+  static unsigned Hash(const KEY &) { return 0; }
+  };
+
+/// Hash of 64 bit integer (finalizer of MurmurHash3).
+inline unsigned DictHashInt(UINT64 v)
+  {
+  v ^= v >> 33;
+  v *= 0xff51afd7ed558ccdULL;
+  v ^= v >> 33;
+  v *= 0xc4ceb9fe1a85ec53ULL;
+  v ^= v >> 33;
+  return (unsigned)v;
+  }
+
+/// Hash of integer and enumeration keys.
+template <class KEY>
+struct DictHashTraits<KEY, typename std::enable_if<
+  std::is_integral<KEY>::value || std::is_enum<KEY>::value>::type>
+  {
+  /// The key type has hash function.
+  enum { HASHED = 1 };
+  /// Hash of the key.
+  static unsigned Hash(const KEY &key) { return DictHashInt((UINT64)key); }
+  };
+
+/// Hash of pointer keys (handles).
+template <class KEY>
+struct DictHashTraits<KEY, typename std::enable_if<
+  std::is_pointer<KEY>::value>::type>
+  {
+  /// The key type has hash function.
+  enum { HASHED = 1 };
+  /// Hash of the key.
+  static unsigned Hash(const KEY &key) { return DictHashInt((UINT64)(SIZE_T)key); }
+  };
+
+/// @brief Hash of string keys (FNV-1a of the chars).
+///
+/// PathStr is not hashed: its comparison is case insensitive on Windows
+/// (multibyte aware), so it is searched by the linear scan.
+template <class KEY>
+struct DictHashTraits<KEY, typename std::enable_if<
+  std::is_base_of<Str, KEY>::value && !std::is_base_of<PathStr, KEY>::value>::type>
+  {
+  /// The key type has hash function.
+  enum { HASHED = 1 };
+  /// Hash of the key; NULL and empty strings have the same hash.
+  static unsigned Hash(const KEY &key)
+    {
+    unsigned h = 2166136261U;
+    const char *p = key.Data();
+    if (p != NULL)
+      {
+      for ( ; *p != '\0'; p++)
+        h = (h ^ (unsigned char)*p) * 16777619U;
+      }
+    return h;
+    }
+  };
+
 /// Dynamic dictionary of elements of an arbitrary type.
 template <class KEY, class VALUE>
 class TDict
@@ -113,6 +186,53 @@ class TDict
     /// Array of pairs.
     TArray<TDictElem> m_contents;
     //@}
+
+  protected:
+    /// @name Hash index
+    //@{
+    /// Slot of the hash index.
+    struct TDictSlot
+      {
+      /// Hash of the key.
+      unsigned m_hash;
+      /// Index of the pair in m_contents, -1 for the empty slot.
+      int m_ind;
+      };
+    /// @brief Hash index of the pairs: open addressing with Robin Hood
+    /// linear probing, the size is a power of 2.
+    ///
+    /// Empty if the dictionary is short or keys are not hashed.
+    TArray<TDictSlot> m_slots;
+    //@}
+
+  private:
+    /// @name Hash index maintenance
+    //@{
+    /// Constants of the hash index.
+    enum
+      {
+      /// Minimal length of the dictionary to be indexed.
+      HASH_MIN_LENGTH = 8,
+      /// Minimal size of the index.
+      HASH_MIN_SIZE = 16
+      };
+    /// Hash of the key.
+    inline static unsigned HashKey(const KEY &key);
+    /// Index of the pair with the specified key.
+    int Lookup(const KEY &key) const;
+    /// Slot of the pair with the specified key.
+    int FindSlot(const KEY &key, unsigned hash) const;
+    /// Slot of the pair with the specified index.
+    int SlotOf(int ind) const;
+    /// Put a pair to the index.
+    void InsertSlot(unsigned hash, int ind);
+    /// Remove a slot from the index.
+    void EraseSlot(int slot);
+    /// Add the last pair to the index.
+    void IndexLast();
+    /// Rebuild the index of all pairs.
+    void Reindex();
+    //@}
   };  // class TDict
 
 
@@ -138,7 +258,7 @@ TDict<KEY, VALUE>::TDict(int block_size) :
 /// @param[in] sour - A source object of the class.
 template <class KEY, class VALUE>
 TDict<KEY, VALUE>::TDict(const TDict<KEY, VALUE> &sour) :
-  m_contents(sour.m_contents)
+  m_contents(sour.m_contents), m_slots(sour.m_slots)
   {
   }
 
@@ -163,21 +283,16 @@ TDict<KEY, VALUE>::~TDict()
 template <class KEY, class VALUE>
 VALUE &TDict<KEY, VALUE>::operator [] (const KEY &key)
   {
-  int i;         // counter for the loop
-  int arr_count; // number elements in the array
-
-  arr_count = m_contents.Length();
-  // Loop all elements for the search key
-  for (i = 0; i < arr_count; i++)
-    {
-    if (m_contents[i].m_key == key) // Key was found
-      return (m_contents[i].m_value);
-    }
+  int i = Lookup(key);
+  if (i >= 0) // Key was found
+    return (m_contents[i].m_value);
 
   // Key was not found
+  int arr_count = m_contents.Length();
   TDictElem elem;
   elem.m_key = key;
-  m_contents.Put(elem, arr_count);
+  if (m_contents.Put(elem, arr_count) == SUCCESS)
+    IndexLast();
   return (m_contents[arr_count].m_value);
   }  // operator []()
 
@@ -192,16 +307,9 @@ template <class KEY, class VALUE>
 const VALUE &TDict<KEY, VALUE>::operator [] (const KEY &key) const
   {
   static VALUE res;
-  int i;         // counter for the loop
-  int arr_count; // number elements in the array
-
-  arr_count = m_contents.Length();
-  // Loop all elements for the search key
-  for (i = 0; i < arr_count; i++)
-    {
-    if (m_contents[i].m_key == key) // Key was found
-      return (m_contents[i].m_value);
-    }
+  int i = Lookup(key);
+  if (i >= 0) // Key was found
+    return (m_contents[i].m_value);
 
   // Key was not found - return garbage (meaning that this code is also garbage, once there is no any sign, that key is found) 
   return res;
@@ -217,13 +325,9 @@ const VALUE &TDict<KEY, VALUE>::operator [] (const KEY &key) const
 template <class KEY, class VALUE>
 VALUE *TDict<KEY, VALUE>::FindValue(const KEY &key)
   {
-  int arr_count = m_contents.Length();
-  // Loop all elements for the search key
-  for (int i = 0; i < arr_count; i++)
-    {
-    if (m_contents[i].m_key == key) // Key was found
-      return (&m_contents[i].m_value);
-    }
+  int i = Lookup(key);
+  if (i >= 0) // Key was found
+    return (&m_contents[i].m_value);
 
   // Key was not found - return NULL. 
   return NULL;
@@ -238,13 +342,9 @@ VALUE *TDict<KEY, VALUE>::FindValue(const KEY &key)
 template <class KEY, class VALUE>
 const VALUE *TDict<KEY, VALUE>::FindValue(const KEY &key) const
   {
-  int arr_count = m_contents.Length();
-  // Loop all elements for the search key
-  for (int i = 0; i < arr_count; i++)
-    {
-    if (m_contents[i].m_key == key) // Key was found
-      return (&m_contents[i].m_value);
-    }
+  int i = Lookup(key);
+  if (i >= 0) // Key was found
+    return (&m_contents[i].m_value);
 
   // Key was not found - return NULL. 
   return NULL;
@@ -262,11 +362,15 @@ const KEY &TDict<KEY, VALUE>::GetKey(int i) const
 
 //////////////////////////////////////////////////////////////////////////////
 /// Direct access to the key with the specified index.
+///
+/// The key may be changed via the reference, so the hash index is
+/// dropped: the search is linear until the next addition of a pair.
 /// @param[in] i - An index of a pair.
 /// @return A key with the specified index.
 template <class KEY, class VALUE>
 KEY &TDict<KEY, VALUE>::Key(int i)
   {
+  m_slots.Truncate(0);
   return m_contents[i].m_key;
   }
 
@@ -341,7 +445,10 @@ OKAY TDict<KEY, VALUE>::Put(const KEY &new_key, const VALUE &new_value)
   elem.m_key = new_key;
   elem.m_value = new_value;
 
-  return (m_contents.Add(elem));
+  if (m_contents.Add(elem) != SUCCESS)
+    return FAILURE;
+  IndexLast();
+  return SUCCESS;
   }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -359,23 +466,21 @@ OKAY TDict<KEY, VALUE>::Enter(const KEY &key,
                               const VALUE &new_value)
   {
   TDictElem elem; // current element of the array
-  int arr_count;  // number elements in the array
 
-  arr_count = m_contents.Length();
-  // Loop all elements for the search key
-  for (int i = 0; i < arr_count; i++)
+  int i = Lookup(key);
+  if (i >= 0) // Key was found
     {
-    if (m_contents[i].m_key == key) // Key was found
-      {
-      m_contents[i].m_value = new_value;
-      return SUCCESS;
-      }
-    }  // for (i = 0; i < arr_count; i++)
+    m_contents[i].m_value = new_value;
+    return SUCCESS;
+    }
 
   // Key was not found then add pair (key, new_value)
   elem.m_key = key;
   elem.m_value = new_value;
-  return m_contents.Add(elem);
+  if (m_contents.Add(elem) != SUCCESS)
+    return FAILURE;
+  IndexLast();
+  return SUCCESS;
   }  // Enter()
 
 //////////////////////////////////////////////////////////////////////////////
@@ -389,17 +494,9 @@ OKAY TDict<KEY, VALUE>::Enter(const KEY &key,
 template <class KEY, class VALUE>
 void TDict<KEY, VALUE>::Exclude(const KEY &key)
   {
-  int length; // length of the dictionary array
-
-  length = m_contents.Length();
-  for (int i = 0; i < length; i++)
-    {
-    if (m_contents[i].m_key == key)
-      {
-      m_contents.Exclude(i);
-      return;
-      }
-    }
+  int i = Lookup(key);
+  if (i >= 0)
+    Exclude(i);
   }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -409,11 +506,13 @@ void TDict<KEY, VALUE>::Exclude(const KEY &key)
 /// The order of the rest pairs is not changed because
 /// the method shifts the remaining pairs keeping their order intact.
 /// The size occupied by the dictionary is not changed.
+/// Indices of the following pairs are changed, so the hash index is rebuilt.
 /// @param[in] ind - An index of the pair to be removed.
 template <class KEY, class VALUE>
 void TDict<KEY, VALUE>::Exclude(int ind)
   {
   m_contents.Exclude(ind);
+  Reindex();
   }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -428,17 +527,24 @@ void TDict<KEY, VALUE>::Exclude(int ind)
 template <class KEY, class VALUE>
 void TDict<KEY, VALUE>::Remove(const KEY &key)
   {
-  int length; // length of the dictionary array
-
-  length = m_contents.Length();
-  for (int i = 0; i < length; i++)
+  if (m_slots.Length() == 0)
     {
-    if (m_contents[i].m_key == key)
-      {
+    int i = Lookup(key);
+    if (i >= 0)
       m_contents.Remove(i);
-      return;
-      }
+    return;
     }
+
+  int slot = FindSlot(key, HashKey(key));
+  if (slot < 0)
+    return;
+  int i = m_slots[slot].m_ind;
+  EraseSlot(slot);
+  // The last pair is moved to the position of the removed one
+  int last = m_contents.Length() - 1;
+  if (i != last)
+    m_slots[SlotOf(last)].m_ind = i;
+  m_contents.Remove(i);
   }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -450,6 +556,7 @@ template <class KEY, class VALUE>
 void TDict<KEY, VALUE>::RemoveElements()
   {
   m_contents.Allocate(0);
+  m_slots.Truncate(0);
   }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -460,6 +567,7 @@ template <class KEY, class VALUE>
 void TDict<KEY, VALUE>::RemoveAll()
   {
   m_contents.Resize();
+  m_slots.Resize();
   }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -473,22 +581,13 @@ template <class KEY, class VALUE>
 bool TDict<KEY, VALUE>::Find(
     const KEY &key, VALUE *search_value) const
   {
-  int i;         // counter for the loop
-  int arr_count; // number elements in the array
-
-  arr_count = m_contents.Length();
-  // Loop all elements for the search key
-  for (i = 0; i < arr_count; i++)
-    {
-    if (m_contents[i].m_key == key) // Key was found
-      {
-      if (search_value != NULL)
-        *search_value = m_contents[i].m_value;
-      return true;
-      }
-    }  // for (i = 0; i < arr_count; i++)
+  int i = Lookup(key);
+  if (i < 0)
+    return false; // Key was not found
 
-  return false; // Key was not found
+  if (search_value != NULL)
+    *search_value = m_contents[i].m_value;
+  return true;
   }  // Find()
 
 //////////////////////////////////////////////////////////////////////////////
@@ -510,6 +609,190 @@ OKAY TDict<KEY, VALUE>::Accommodate(int new_len)
   return m_contents.Allocate(count);
   }
 
+//////////////////////////////////////////////////////////////////////////////
+/// Hash of the key.
+/// @param[in] key - A key.
+/// @return Hash of the key by DictHashTraits.
+template <class KEY, class VALUE>
+unsigned TDict<KEY, VALUE>::HashKey(const KEY &key)
+  {
+  return DictHashTraits<KEY>::Hash(key);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Index of the pair with the specified key.
+///
+/// The hash index is used if it is built, otherwise all pairs are scanned.
+/// @param[in] key - A key for the search.
+/// @return The index of the pair or -1 if the key was not found.
+template <class KEY, class VALUE>
+int TDict<KEY, VALUE>::Lookup(const KEY &key) const
+  {
+  if (m_slots.Length() > 0)
+    {
+    int slot = FindSlot(key, HashKey(key));
+    return slot < 0 ? -1 : m_slots[slot].m_ind;
+    }
+
+  int arr_count = m_contents.Length();
+  // Loop all elements for the search key
+  for (int i = 0; i < arr_count; i++)
+    {
+    if (m_contents[i].m_key == key) // Key was found
+      return i;
+    }
+  return -1;
+  }  // Lookup()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Slot of the pair with the specified key.
+///
+/// Probing stops at the empty slot or at the slot, which is closer to its
+/// home than the key would be (Robin Hood invariant).
+/// @param[in] key - A key for the search.
+/// @param[in] hash - Hash of the key.
+/// @return The slot of the index or -1 if the key was not found.
+template <class KEY, class VALUE>
+int TDict<KEY, VALUE>::FindSlot(const KEY &key, unsigned hash) const
+  {
+  Assert(m_slots.Length() > 0);
+  int mask = m_slots.Length() - 1;
+  const TDictSlot *slots = m_slots.Data();
+  int pos = (int)(hash & mask);
+  for (int dist = 0; ; dist++)
+    {
+    const TDictSlot &s = slots[pos];
+    if (s.m_ind < 0)
+      return -1;
+    if (((pos - (int)(s.m_hash & mask)) & mask) < dist)
+      return -1;
+    if (s.m_hash == hash && m_contents[s.m_ind].m_key == key)
+      return pos;
+    pos = (pos + 1) & mask;
+    }
+  }  // FindSlot()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Slot of the pair with the specified index.
+/// @param[in] ind - An index of the pair, the pair must be in the index.
+/// @return The slot of the index.
+template <class KEY, class VALUE>
+int TDict<KEY, VALUE>::SlotOf(int ind) const
+  {
+  int mask = m_slots.Length() - 1;
+  int pos = (int)(HashKey(m_contents[ind].m_key) & mask);
+  while (m_slots[pos].m_ind != ind)
+    {
+    Assert(m_slots[pos].m_ind >= 0);
+    pos = (pos + 1) & mask;
+    }
+  return pos;
+  }  // SlotOf()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Put a pair to the index.
+///
+/// Robin Hood insertion: the probed entry, which is closer to its home
+/// than the inserted one, gives its slot away and is inserted further.
+/// There must be an empty slot in the index.
+/// @param[in] hash - Hash of the key of the pair.
+/// @param[in] ind - An index of the pair.
+template <class KEY, class VALUE>
+void TDict<KEY, VALUE>::InsertSlot(unsigned hash, int ind)
+  {
+  int mask = m_slots.Length() - 1;
+  TDictSlot *slots = m_slots.Data();
+  TDictSlot cur;
+  cur.m_hash = hash;
+  cur.m_ind = ind;
+  int pos = (int)(hash & mask);
+  for (int dist = 0; ; dist++)
+    {
+    TDictSlot &s = slots[pos];
+    if (s.m_ind < 0)
+      {
+      s = cur;
+      return;
+      }
+    int s_dist = (pos - (int)(s.m_hash & mask)) & mask;
+    if (s_dist < dist)
+      {
+      Swap(s, cur);
+      dist = s_dist;
+      }
+    pos = (pos + 1) & mask;
+    }
+  }  // InsertSlot()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Remove a slot from the index.
+///
+/// Backward shift deletion: the following entries are moved one slot back
+/// up to the empty slot or the entry in its home slot, no tombstones.
+/// @param[in] slot - The slot to be emptied.
+template <class KEY, class VALUE>
+void TDict<KEY, VALUE>::EraseSlot(int slot)
+  {
+  int mask = m_slots.Length() - 1;
+  TDictSlot *slots = m_slots.Data();
+  int pos = slot;
+  for ( ; ; )
+    {
+    int next = (pos + 1) & mask;
+    const TDictSlot &s = slots[next];
+    if (s.m_ind < 0 || (int)(s.m_hash & mask) == next)
+      break;
+    slots[pos] = s;
+    pos = next;
+    }
+  slots[pos].m_ind = -1;
+  }  // EraseSlot()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Add the last pair to the index.
+///
+/// The index is built when the dictionary becomes long enough and is
+/// doubled when it is filled by 3/4.
+template <class KEY, class VALUE>
+void TDict<KEY, VALUE>::IndexLast()
+  {
+  int last = m_contents.Length() - 1;
+  if (m_slots.Length() == 0 || (last + 1) * 4 > m_slots.Length() * 3)
+    {
+    Reindex();
+    return;
+    }
+  InsertSlot(HashKey(m_contents[last].m_key), last);
+  }  // IndexLast()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Rebuild the index of all pairs.
+///
+/// The index is not built for the short dictionaries and the keys without
+/// hash function; if memory is not allocated, the search is linear.
+template <class KEY, class VALUE>
+void TDict<KEY, VALUE>::Reindex()
+  {
+  int length = m_contents.Length();
+  if (!DictHashTraits<KEY>::HASHED || length < HASH_MIN_LENGTH)
+    {
+    m_slots.Truncate(0);
+    return;
+    }
+  int size = HASH_MIN_SIZE;
+  while (size * 3 < length * 4)
+    size += size;
+  if (m_slots.SetLength(size) != SUCCESS)
+    {
+    m_slots.Truncate(0);
+    return;
+    }
+  for (int i = 0; i < size; i++)
+    m_slots[i].m_ind = -1;
+  for (int i = 0; i < length; i++)
+    InsertSlot(HashKey(m_contents[i].m_key), i);
+  }  // Reindex()
+
 //////////////////////////////////////////////////////////////////////////////
 // Methods of the struct TDictElem
 
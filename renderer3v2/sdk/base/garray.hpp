@@ -16,36 +16,51 @@ INTEGRA_NAMESPACE_START
 
 /// @brief Dynamic array of elements of an arbitrary type, which may
 /// be compared for equality.
-template <class T>
-class GArray : public TArray<T>
+template <class T, class I = int>
+class GArray : public TArray<T, I>
   {
   public:
     /// @name Constructors
     //@{
     /// Default constructor.
-    explicit GArray(int the_block_size = TArray<T>::DEF_BLOCK_SIZE);
+    explicit GArray(I the_block_size = TArray<T, I>::DEF_BLOCK_SIZE);
     /// Constructor from the given values.
-    inline GArray(const T *val, int length,
-                  int the_block_size = TArray<T>::DEF_BLOCK_SIZE);
+    inline GArray(const T *val, I length,
+                  I the_block_size = TArray<T, I>::DEF_BLOCK_SIZE);
     /// Copy constructor.
-    GArray(const GArray<T> &sour);
+    GArray(const GArray<T, I> &sour);
+    /// Move constructor.
+    inline GArray(GArray<T, I> &&sour);
+    //@}
+
+  public:
+    /// @name Assignment
+    //@{
+    /// Assignment operator.
+    inline GArray<T, I> &operator =(const GArray<T, I> &sour);
+    /// Move assignment operator.
+    inline GArray<T, I> &operator =(GArray<T, I> &&sour);
     //@}
 
   public:
     /// @name Comparison
     //@{
     /// Comparison of arrays.
-    bool operator ==(const GArray<T> &src) const;
+    bool operator ==(const GArray<T, I> &src) const;
     //@}
 
   public:
     /// @name Search
     //@{
     /// Find an element.
-    bool Find(const T &elem, int *pos = NULL) const;
+    bool Find(const T &elem, I *pos = NULL) const;
     //@}
   };  // class GArray
 
+/// Dynamic array with 64 bit indices, which may be compared for equality.
+template <class T>
+using GArray64 = GArray<T, INT64>;
+
 //////////////////////////////////////////////////////////////////////////////
 // Methods of the class GArray
 
@@ -57,8 +72,8 @@ class GArray : public TArray<T>
 /// parameter.
 /// @param[in] the_block_size - A size of the memory block, in elements;
 /// must be > 0, debug version asserts it.
-template <class T>
-GArray<T>::GArray(int the_block_size) : TArray<T>(the_block_size)
+template <class T, class I>
+GArray<T, I>::GArray(I the_block_size) : TArray<T, I>(the_block_size)
   {
   }
 
@@ -69,18 +84,48 @@ GArray<T>::GArray(int the_block_size) : TArray<T>(the_block_size)
 /// @param[in] the_block_size  Size of the memory block, in elements;
 /// @note Is array succesfully constructed or not - can be controlled
 /// via the Length() of the array, which is 0, if data allocation failed.
-template <class T>
-GArray<T>::GArray(const T *val, int length, int the_block_size)
-  : TArray<T>(val, length, the_block_size)
+template <class T, class I>
+GArray<T, I>::GArray(const T *val, I length, I the_block_size)
+  : TArray<T, I>(val, length, the_block_size)
   {
   }
 
 //////////////////////////////////////////////////////////////////////////////
 /// Copy constructor.
 /// @param[in] sour - A source object of the class.
-template <class T>
-GArray<T>::GArray(const GArray<T> &sour) : TArray<T>(sour)
+template <class T, class I>
+GArray<T, I>::GArray(const GArray<T, I> &sour) : TArray<T, I>(sour)
+  {
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Move constructor.
+/// @param[in, out] sour - A source object of the class, becomes empty.
+template <class T, class I>
+GArray<T, I>::GArray(GArray<T, I> &&sour) : TArray<T, I>(std::move(sour))
+  {
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Assignment operator.
+/// @param[in] sour - A source array.
+/// @return A reference to this array.
+template <class T, class I>
+GArray<T, I> &GArray<T, I>::operator =(const GArray<T, I> &sour)
   {
+  TArray<T, I>::operator =(sour);
+  return *this;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Move assignment operator.
+/// @param[in, out] sour - A source array.
+/// @return A reference to this array.
+template <class T, class I>
+GArray<T, I> &GArray<T, I>::operator =(GArray<T, I> &&sour)
+  {
+  TArray<T, I>::operator =(std::move(sour));
+  return *this;
   }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -90,12 +135,12 @@ GArray<T>::GArray(const GArray<T> &sour) : TArray<T>(sour)
 /// @param[in] src An array to compare with.
 /// @return @b true, if all the elements are correspondently equal;
 /// @b false otherwise.
-template <class T>
-bool GArray<T>::operator ==(const GArray<T> &src) const
+template <class T, class I>
+bool GArray<T, I>::operator ==(const GArray<T, I> &src) const
   {
   if (this->count != src.count)
     return false;
-  for (int i = 0; i < this->count; i++)
+  for (I i = 0; i < this->count; i++)
     if (!(this->data[i] == src.data[i]))
       return false;
   return true;
@@ -111,11 +156,11 @@ bool GArray<T>::operator ==(const GArray<T> &src) const
 /// @return @b YES, if the element was found, or @b NO otherwise.
 ///  @note If @b YES, and @b pos is not NULL, *pos is set to the
 /// (zero-based) position of the found element.
-template <class T>
-bool GArray<T>::Find(const T &elem, int *pos) const
+template <class T, class I>
+bool GArray<T, I>::Find(const T &elem, I *pos) const
   {
-  int len = this->Length();
-  for (int i = 0; i < len; i++)
+  I len = this->Length();
+  for (I i = 0; i < len; i++)
     {
     if (elem == this->operator[](i))
       {
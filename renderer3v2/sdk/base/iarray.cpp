@@ -31,6 +31,7 @@ usage statistics. All array classes must be inherited from it.
 IArray::IArray()
   {
   mem_class = MemoryClass::GetClass(NULL);
+  arena = NULL;
   }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -66,7 +67,8 @@ void IArray::AddMemStat(SIZE_T size, void *p, const char *str)
   if (mem_class == NULL)
     mem_class = MemoryClass::GetClass(NULL);
 
-  if (size != 0 && p != NULL)
+  // Blocks in an arena are counted in the class of the arena
+  if (size != 0 && p != NULL && arena == NULL)
     mem_class->Add(size);
 
   if (mem_class->ToTrace(size))
@@ -90,7 +92,8 @@ void IArray::DelMemStat(SIZE_T size, void *p, const char *str)
   if (mem_class == NULL)
     mem_class = MemoryClass::GetClass(NULL);
 
-  if (size != 0 && p != NULL)
+  // Blocks in an arena are counted in the class of the arena
+  if (size != 0 && p != NULL && arena == NULL)
     mem_class->Del(size);
 
   if (mem_class->ToTrace(size))
@@ -15,6 +15,7 @@
 
 INTEGRA_NAMESPACE_START
 
+class MemoryArena;
 class MemoryClass;
 
 /// Base class for all arrays.
@@ -25,6 +26,8 @@ class IArray
     INTAPI_BASE void SetName(const char *class_name, const char *array_name);
     /// Destructor.
     INTAPI_BASE virtual ~IArray();
+    /// Get the arena the array is allocated in.
+    inline MemoryArena *GetArena() const;
   protected:
     /// Constructor.
     INTAPI_BASE IArray();
@@ -37,7 +40,18 @@ class IArray
     MemoryClass *mem_class;
     /// Array name.
     Str name;
+    /// Arena the elements are allocated in, NULL for the heap.
+    MemoryArena *arena;
   };  // class IArray
 
+/////////////////////////////////////////////////////////////////////////////
+/// Get the arena the array is allocated in.
+/// @return Arena given to the constructor of the array or NULL (the
+/// elements are in the heap).
+MemoryArena *IArray::GetArena() const
+  {
+  return arena;
+  }
+
 INTEGRA_NAMESPACE_END
 #endif
@@ -23,6 +23,24 @@ Moreover this class provides sorting arrays with arbitrary elements (without
 '==' and '<' operators). In this case the special functions less() may be used
 instead of comparison operators.
 
+Large arrays may be sorted faster:
+- RadixSort() - LSD radix sort of integer and floating point elements,
+  RadixSortByKey() sorts arbitrary elements by such keys (e.g. Morton codes)
+  given by a function or functor. Both are stable, O(n) and single-threaded;
+  temporary memory is of the array size.
+- ParSort (base/par_sort.hpp) sorts by a group of threads: the parallel
+  radix sort ParSort::RadixSort() and the sample sort ParSort::Sort() of
+  the elements with '<' operator.
+
+@code
+   MArray<float> depth;
+   ...
+   if (depth.RadixSort() != SUCCESS)
+     return FAILURE;
+   MArray<Hit>::RadixSortByKey(hits.Data(), hits.Length(),
+     [](const Hit &h) { return h.morton; });
+@endcode
+
 @note MArray class adds no own member variables.
 
 @param T - Base element type, must provide proper "==" and "<" operators
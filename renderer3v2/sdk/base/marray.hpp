@@ -12,57 +12,122 @@
 #ifndef _KLBC_MARRAY_HPP_
 #define _KLBC_MARRAY_HPP_
 
+#include <string.h>
+#include <type_traits>
+
 #include <base/garray.hpp>
 
 INTEGRA_NAMESPACE_START
 
+/// @brief Keys of the radix sort.
+///
+/// Bits() maps the key to the unsigned integer of the same size keeping
+/// the order. Defined for integer and floating point types.
+template <class K, class ENABLE = void>
+struct RadixKeyTraits;
+
+/// Integer keys of the radix sort: the sign bit is flipped.
+template <class K>
+struct RadixKeyTraits<K, typename std::enable_if<
+  std::is_integral<K>::value && !std::is_same<K, bool>::value>::type>
+  {
+  /// Unsigned integer of the same size.
+  typedef typename std::make_unsigned<K>::type UINT;
+  /// Order preserving unsigned image of the key.
+  static UINT Bits(K k)
+    {
+    return (UINT)((UINT)k ^ (std::is_signed<K>::value ?
+      (UINT)((UINT)1 << (8 * sizeof(K) - 1)) : (UINT)0));
+    }
+  };
+
+/// @brief Float keys of the radix sort.
+///
+/// The sign bit of the positive numbers is set, negative numbers are
+/// inverted, so -0 precedes +0 and NaNs are at the ends.
+template <>
+struct RadixKeyTraits<float>
+  {
+  /// Unsigned integer of the same size.
+  typedef unsigned UINT;
+  /// Order preserving unsigned image of the key.
+  static UINT Bits(float k)
+    {
+    UINT u;
+    memcpy(&u, &k, sizeof(u));
+    return (u & 0x80000000U) ? ~u : (u | 0x80000000U);
+    }
+  };
+
+/// Double keys of the radix sort, see RadixKeyTraits<float>.
+template <>
+struct RadixKeyTraits<double>
+  {
+  /// Unsigned integer of the same size.
+  typedef UINT64 UINT;
+  /// Order preserving unsigned image of the key.
+  static UINT Bits(double k)
+    {
+    UINT u;
+    memcpy(&u, &k, sizeof(u));
+    return (u & 0x8000000000000000ULL) ? ~u : (u | 0x8000000000000000ULL);
+    }
+  };
+
 /// Dynamic array of elements of an arbitrary type,
 /// for which '==' and '<' operations are applicable.
 /// MArray class provides array sort and fast binary search.
-template <class T>
-class MArray : public GArray<T>
+template <class T, class I = int>
+class MArray : public GArray<T, I>
   {
   public:
     /// @name Constructors
     //@{
     /// Initialization by default.
-    explicit MArray(int the_block_size = 10);
+    explicit MArray(I the_block_size = 10);
     /// Constructor from the given values.
-    inline MArray(const T *val, int length,
-                  int the_block_size = TArray<T>::DEF_BLOCK_SIZE);
+    inline MArray(const T *val, I length,
+                  I the_block_size = TArray<T, I>::DEF_BLOCK_SIZE);
     /// Copy constructor
-    inline MArray(const MArray<T> &sour);
+    inline MArray(const MArray<T, I> &sour);
+    /// Move constructor
+    inline MArray(MArray<T, I> &&sour);
     //@}
 
+    /// Assignment operator.
+    inline MArray<T, I> &operator =(const MArray<T, I> &sour);
+    /// Move assignment operator.
+    inline MArray<T, I> &operator =(MArray<T, I> &&sour);
+
     /// Comparison operator.
-    bool operator == (const MArray<T> &another) const;
+    bool operator == (const MArray<T, I> &another) const;
     /// Comparison operator.
-    inline bool operator != (const MArray<T> &another) const;
+    inline bool operator != (const MArray<T, I> &another) const;
     /// Scale elements value to the given factor.
     inline MArray &operator *=(const double &c);
     /// Add elements of the given array to elements of 'this' array.
-    inline MArray<T> &operator += (const TArray<T> &sour);
+    inline MArray<T, I> &operator += (const TArray<T, I> &sour);
 
     /// @name Sorting of external array in the ascending order
     //@{
     /// Sorts array of the elements of T type.
-    static void QSort(T *data, int count);
+    static void QSort(T *data, I count);
 
     /// Sorts array of the elements of T type by the comparison function.
-    static void QSort(T *data, int count, bool (*less)(const T &a, const T &b));
+    static void QSort(T *data, I count, bool (*less)(const T &a, const T &b));
 
     /// Defines ascending order of the elements in array.
-    static void QSort(const T *data, int count, TArray<int> &perm);
+    static void QSort(const T *data, I count, TArray<I, I> &perm);
 
     /// @brief Sorts elements in the ascending order.
     /// Preserves relative order of the equivalent elements.
-    static void StableSort(T *data, int count);
+    static void StableSort(T *data, I count);
     /// @brief Defines ascending order of the elements in array preserving
     /// relative order of equivalent elements.
-    static void StableSort(const T *data, int count, TArray<int> &perm);
+    static void StableSort(const T *data, I count, TArray<I, I> &perm);
     /// @brief Sorts array of the elements of T type by the comparison
     /// function, preserving relative order of equivalent elements.
-    static void StableSortLessEqual(T *data, int count);
+    static void StableSortLessEqual(T *data, I count);
     //@}
 
     /// @name Sorting of internal array in the ascending order
@@ -71,31 +136,50 @@ class MArray : public GArray<T>
     inline void QSort();
 
     /// Defines ascending order of the elements in this array
-    inline void QSort(TArray<int> &perm) const;
+    inline void QSort(TArray<I, I> &perm) const;
 
     /// Sorts first @a len elements of this array in the ascending order
-    inline void QSort(int len);
+    inline void QSort(I len);
 
     /// Sorts all elements of this array by the comparison function
     inline void QSort(bool (*less)(const T &a, const T &b));
 
     /// Sorts first @a len elements of this array by the comparison function
-    inline void QSort(int len, bool (*less)(const T &a, const T &b));
+    inline void QSort(I len, bool (*less)(const T &a, const T &b));
 
     /// @brief Sorts all elements of this array in the ascending order.
     /// Preserves relative order of the equivalent elements.
     inline void StableSort();
     //@}
 
+    /// @name Radix sorting in the ascending order, stable
+    //@{
+    /// Sorts array of integer or floating point elements.
+    static OKAY RadixSort(T *data, I count);
+    /// Defines ascending order of integer or floating point elements.
+    static OKAY RadixSort(const T *data, I count, TArray<I, I> &perm);
+    /// Sorts array of the elements by their integer or floating point keys.
+    template <class KEY_FUNC>
+    static OKAY RadixSortByKey(T *data, I count, KEY_FUNC key);
+    /// Defines ascending order of the elements by their keys.
+    template <class KEY_FUNC>
+    static OKAY RadixSortByKey(const T *data, I count, TArray<I, I> &perm,
+                               KEY_FUNC key);
+    /// Sorts all elements of this array.
+    inline OKAY RadixSort();
+    /// Defines ascending order of the elements in this array.
+    inline OKAY RadixSort(TArray<I, I> &perm) const;
+    //@}
+
     /// @name Search in the ascending array
     /// Be carefull, read complete description - actually it returns position
     /// of the next element after the last element equal to the searched!
     //@{
     /// Finds position of value @a x in an ascending array.
-    inline int BinarySearch(const T &x) const;
+    inline I BinarySearch(const T &x) const;
 
     /// Finds position of value @a x in an ascending external array.
-    inline static int BinarySearch(const T &x, const T *data, int n);
+    inline static I BinarySearch(const T &x, const T *data, I n);
     //@}
 
     /// @name Search in descending array
@@ -103,7 +187,7 @@ class MArray : public GArray<T>
     /// appropriate function @a less().
     //@{
     /// Finds position of value @a x in a descending this array
-    inline int BinarySearchRev(const T &x) const;
+    inline I BinarySearchRev(const T &x) const;
     //@}
 
     /// @name Search in descending external array
@@ -111,7 +195,7 @@ class MArray : public GArray<T>
     /// appropriate function @a less().
     //@{
     /// Finds position of value @a x in a descending array.
-    inline static int BinarySearchRev(const T &x, const T *data, int n);
+    inline static I BinarySearchRev(const T &x, const T *data, I n);
     //@}
 
     /// Find maximal value in the array.
@@ -119,16 +203,27 @@ class MArray : public GArray<T>
     /// Find minimal value in the array.
     inline T MinValue() const;
     /// Find index of element with maximal value.
-    inline int MaxValueIndex() const;
+    inline I MaxValueIndex() const;
     /// Calculate a sum of values in the array.
     inline T Sum() const;
 
     /// Create new array, resized with linear interpolation.
-    inline OKAY ResizeLinear(int n, MArray<T> &out) const;
+    inline OKAY ResizeLinear(I n, MArray<T, I> &out) const;
     /// Pack elements of this array - leave only non-equal.
     inline void Pack();
+
+  private:
+    /// Stable radix sort of the unsigned keys with the indices.
+    template <class UINT>
+    static OKAY RadixSortPairs(UINT *keys, I *ind, I count);
+    /// Offsets of the radix sort pass from the digit histogram.
+    static bool RadixOffsets(I *hist, I count);
   };  // class MArray
 
+/// Sortable dynamic array with 64 bit indices.
+template <class T>
+using MArray64 = MArray<T, INT64>;
+
 
 // -----------------------------------------------------------------
 //              Methods of the class MArray
@@ -142,8 +237,8 @@ class MArray : public GArray<T>
 ///
 /// @note Block size must be >0. Debug version asserts this.
 /// @param the_block_size - Size of the block on memory allocation.
-template <class T>
-MArray<T>::MArray(int the_block_size) : GArray<T>(the_block_size)
+template <class T, class I>
+MArray<T, I>::MArray(I the_block_size) : GArray<T, I>(the_block_size)
   {
   }
 
@@ -154,9 +249,9 @@ MArray<T>::MArray(int the_block_size) : GArray<T>(the_block_size)
 /// @param[in] the_block_size  Size of the memory block, in elements;
 /// @note Is array succesfully constructed or not - can be controlled
 /// via the Length() of the array, which is 0, if data allocation failed.
-template <class T>
-MArray<T>::MArray(const T *val, int length, int the_block_size)
-  : GArray<T>(val, length, the_block_size)
+template <class T, class I>
+MArray<T, I>::MArray(const T *val, I length, I the_block_size)
+  : GArray<T, I>(val, length, the_block_size)
   {
   }
 
@@ -164,9 +259,42 @@ MArray<T>::MArray(const T *val, int length, int the_block_size)
 /// Copy constructor.
 ///
 /// @param sour - Source array
-template <class T>
-MArray<T>::MArray(const MArray<T> &sour) : GArray<T>(sour)
+template <class T, class I>
+MArray<T, I>::MArray(const MArray<T, I> &sour) : GArray<T, I>(sour)
+  {
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Move constructor.
+///
+/// @param sour - Source array, becomes empty
+template <class T, class I>
+MArray<T, I>::MArray(MArray<T, I> &&sour) : GArray<T, I>(std::move(sour))
+  {
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Assignment operator.
+///
+/// @param sour - Source array
+/// @return Reference to this array.
+template <class T, class I>
+MArray<T, I> &MArray<T, I>::operator =(const MArray<T, I> &sour)
   {
+  GArray<T, I>::operator =(sour);
+  return *this;
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Move assignment operator.
+///
+/// @param sour - Source array
+/// @return Reference to this array.
+template <class T, class I>
+MArray<T, I> &MArray<T, I>::operator =(MArray<T, I> &&sour)
+  {
+  GArray<T, I>::operator =(std::move(sour));
+  return *this;
   }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -176,13 +304,13 @@ MArray<T>::MArray(const MArray<T> &sour) : GArray<T>(sour)
 ///
 /// @return Result of element by element comparision.
 ///
-template <class T>
-bool MArray<T>::operator == (const MArray<T> &another) const
+template <class T, class I>
+bool MArray<T, I>::operator == (const MArray<T, I> &another) const
   {
-  int len = Length();
+  I len = Length();
   if (another.Length() != len)
     return false;
-  for (int i = 0; i < len; i++)
+  for (I i = 0; i < len; i++)
     {
     if (this->data[i] != another.data[i])
       return false;
@@ -197,8 +325,8 @@ bool MArray<T>::operator == (const MArray<T> &another) const
 ///
 /// @return Result of element by element comparision.
 ///
-template <class T>
-bool MArray<T>::operator != (const MArray<T> &another) const
+template <class T, class I>
+bool MArray<T, I>::operator != (const MArray<T, I> &another) const
   {
   return !(this->operator == (another));
   }
@@ -209,10 +337,10 @@ bool MArray<T>::operator != (const MArray<T> &another) const
 /// @note T type must have 'operator *=" defined.
 /// @param[in] c - A multiplier.
 /// @return A reference to "this" array.
-template <class T>
-MArray<T> &MArray<T>::operator *=(const double &c)
+template <class T, class I>
+MArray<T, I> &MArray<T, I>::operator *=(const double &c)
   {
-  for (int i = 0; i < this->count; i++)
+  for (I i = 0; i < this->count; i++)
     data[i] = (T)(data[i] * c);
   return *this;
   }  // 'operator *=()'
@@ -223,11 +351,11 @@ MArray<T> &MArray<T>::operator *=(const double &c)
 ///       Arrays must have the same length.
 /// @param[in] sour - Added array.
 /// @return A reference to "this" array.
-template <class T>
-MArray<T> &MArray<T>::operator += (const TArray<T> &sour)
+template <class T, class I>
+MArray<T, I> &MArray<T, I>::operator += (const TArray<T, I> &sour)
   {
   Assert(count == sour.count);
-  for (int i = 0; i < this->count; i++)
+  for (I i = 0; i < this->count; i++)
     data[i] += sour.data[i];
   return *this;
   }
@@ -238,19 +366,18 @@ MArray<T> &MArray<T>::operator += (const TArray<T> &sour)
 ///
 /// @param[in, out] data  - Elements to be sorted.
 /// @param[in] count - Number of the elements in the array.
-template <class T>
-void MArray<T>::QSort(T *data, int count)
+template <class T, class I>
+void MArray<T, I>::QSort(T *data, I count)
   {
   // variables used for stack
-  Assert(count <= 2147483647);  // stack size restriction
-  const int QS_STACK_SIZE = 130;  // should be enough for 32
-  int stack[QS_STACK_SIZE];
+  const int QS_STACK_SIZE = 130;  // should be enough for 64 bit count
+  I stack[QS_STACK_SIZE];
   int stck_top = 0; // top of the stack
 
   // Variables used for sorting
-  int i, j, k;
-  int ir = count - 1; // right element
-  int il = 0; // left element
+  I i, j, k;
+  I ir = count - 1; // right element
+  I il = 0; // left element
 
   // Partitioning element
   T a;
@@ -328,7 +455,7 @@ void MArray<T>::QSort(T *data, int count)
         }
       }
     }
-  } // MArray<T>::QSort()
+  } // MArray<T, I>::QSort()
 
 ///////////////////////////////////////////////////////////////////////////////
 /// Defines ascending order of the elements in array.
@@ -342,24 +469,23 @@ void MArray<T>::QSort(T *data, int count)
 /// @param[in] data  - Elements to be sorted.
 /// @param[in] count - Number of the elements in the array.
 /// @param[out] perm - Result of sorting.
-template <class T>
-void MArray<T>::QSort(const T *data, int count, TArray<int> &perm)
+template <class T, class I>
+void MArray<T, I>::QSort(const T *data, I count, TArray<I, I> &perm)
   {
   // variables used for stack
-  Assert(count <= 2147483647);  // stack size restriction
-  const int QS_STACK_SIZE = 130;  // should be enough for 32
-  int stack[QS_STACK_SIZE];
+  const int QS_STACK_SIZE = 130;  // should be enough for 64 bit count
+  I stack[QS_STACK_SIZE];
   int stck_top = 0; // top of the stack
   Assert(count <= perm.Length());
 
   // Variables used for sorting
-  int i, j, k;
-  int ir = count - 1; // right element
-  int il = 0; // left element
+  I i, j, k;
+  I ir = count - 1; // right element
+  I il = 0; // left element
 
   // Partitioning element
   T a;
-  int b;
+  I b;
 
   for ( ; ; )
     {
@@ -436,7 +562,7 @@ void MArray<T>::QSort(const T *data, int count, TArray<int> &perm)
         }
       }
     }
-  } // MArray<T>::QSort()
+  } // MArray<T, I>::QSort()
 
 //////////////////////////////////////////////////////////////////////////////
 /// Sorts elements of T type by the comparison function.
@@ -451,19 +577,18 @@ void MArray<T>::QSort(const T *data, int count, TArray<int> &perm)
 /// @param[in] less  - Pointer to the function. This function compares two
 /// elements @a a and @a b of the T type and returns true if first element less
 /// than second element.
-template <class T>
-void MArray<T>::QSort(T *data, int count, bool (*less)(const T &a, const T&b))
+template <class T, class I>
+void MArray<T, I>::QSort(T *data, I count, bool (*less)(const T &a, const T&b))
   {
   // variables used for stack
-  Assert(count <= 2147483647);  // stack size restriction
-  const int QS_STACK_SIZE = 130;  // should be enough for 32
-  int stack[QS_STACK_SIZE];
+  const int QS_STACK_SIZE = 130;  // should be enough for 64 bit count
+  I stack[QS_STACK_SIZE];
   int stck_top = 0; // top of the stack
 
   // Variables used for sorting
-  int i, j, k;
-  int ir = count - 1; // right element
-  int il = 0; // left element
+  I i, j, k;
+  I ir = count - 1; // right element
+  I il = 0; // left element
 
   // Partitioning element
   T a;
@@ -539,8 +664,8 @@ void MArray<T>::QSort(T *data, int count, bool (*less)(const T &a, const T&b))
 
 ///////////////////////////////////////////////////////////////////////////////
 /// Sorts all elements of this array in the ascending order.
-template <class T>
-void MArray<T>::QSort()
+template <class T, class I>
+void MArray<T, I>::QSort()
   {
   QSort(this->data, this->count);
   }
@@ -549,12 +674,12 @@ void MArray<T>::QSort()
 /// Pack elements of this array - leave only non-equal.
 ///
 /// Remaining elements are sorted in the ascending order.
-template <class T>
-void MArray<T>::Pack()
+template <class T, class I>
+void MArray<T, I>::Pack()
   {
   QSort();
-  int prev = 0;
-  for (int i = 1; i < count; i++)
+  I prev = 0;
+  for (I i = 1; i < count; i++)
     {
     if (data[i] == data[prev])
       continue;
@@ -574,8 +699,8 @@ void MArray<T>::Pack()
 /// is this array, @a n - length of the array.
 ///
 /// @param[out] perm  - Result of sorting.
-template <class T>
-void MArray<T>::QSort(TArray<int> &perm) const
+template <class T, class I>
+void MArray<T, I>::QSort(TArray<I, I> &perm) const
   {
   QSort(this->data, this->count, perm);
   }
@@ -584,8 +709,8 @@ void MArray<T>::QSort(TArray<int> &perm) const
 /// Sorts first @a len elements of this array in the ascending order.
 ///
 /// @param len - Number of the first sorted elements of this array.
-template <class T>
-void MArray<T>::QSort(int len)
+template <class T, class I>
+void MArray<T, I>::QSort(I len)
   {
   QSort(this->data, len);
   }
@@ -601,8 +726,8 @@ void MArray<T>::QSort(int len)
 /// @param[in] less  - Pointer to the function. This function compares two
 /// elements @a a and @a b of the T type and returns true if first element
 /// less than second element.
-template <class T>
-void MArray<T>::QSort(bool (*less)(const T &a, const T &b))
+template <class T, class I>
+void MArray<T, I>::QSort(bool (*less)(const T &a, const T &b))
   {
   QSort(this->data, this->count, less);
   }
@@ -620,8 +745,8 @@ void MArray<T>::QSort(bool (*less)(const T &a, const T &b))
 /// @param[in] less  - Pointer to the function. This function compares two
 /// elements @a a and @a b of the T type and returns true if first element less
 /// than second element.
-template <class T>
-void MArray<T>::QSort(int len, bool (*less)(const T &a, const T &b))
+template <class T, class I>
+void MArray<T, I>::QSort(I len, bool (*less)(const T &a, const T &b))
   {
   QSort(this->data, len, less);
   }
@@ -640,10 +765,10 @@ void MArray<T>::QSort(int len, bool (*less)(const T &a, const T &b))
 /// @param[in] data - Data array.
 /// @param[in] n    - Length of the array.
 /// @return Obtained index.
-template <class T>
-int MArray<T>::BinarySearch(const T &x, const T *data, int n)
+template <class T, class I>
+I MArray<T, I>::BinarySearch(const T &x, const T *data, I n)
   {
-  int mid, low, high;
+  I mid, low, high;
   low = 0;
   high = n - 1;
 //  if (x < data[0])
@@ -674,8 +799,8 @@ int MArray<T>::BinarySearch(const T &x, const T *data, int n)
 ///
 /// @param[in] x - Value whose position in array is to be found.
 /// @return Obtained index.
-template <class T>
-int MArray<T>::BinarySearch(const T &x) const
+template <class T, class I>
+I MArray<T, I>::BinarySearch(const T &x) const
   {
   return BinarySearch(x, this->data, this->count);
   }
@@ -694,10 +819,10 @@ int MArray<T>::BinarySearch(const T &x) const
 /// @param[in] data - Data array.
 /// @param[in] n    - Length of the array.
 /// @return Obtained index.
-template <class T>
-int MArray<T>::BinarySearchRev(const T &x, const T* data, int n)
+template <class T, class I>
+I MArray<T, I>::BinarySearchRev(const T &x, const T* data, I n)
   {
-  int mid, low, high;
+  I mid, low, high;
   low = 0;
   high = n - 1;
 
@@ -729,37 +854,37 @@ int MArray<T>::BinarySearchRev(const T &x, const T* data, int n)
 ///
 /// @param[in] x    - Value whose position in array is to be found.
 /// @return Obtained index.
-template <class T>
-int MArray<T>::BinarySearchRev(const T &x) const
+template <class T, class I>
+I MArray<T, I>::BinarySearchRev(const T &x) const
   {
   return BinarySearchRev(x, this->data, this->count);
   }
 
 //////////////////////////////////////////////////////////////////////////////
 /// Auxiliary class for StableSort - keeps value and it's initial order.
-template <class T>
+template <class T, class I>
 class ValOrd
   {
   public:
     /// Default Constructor.
     inline ValOrd();
     /// Constructor.
-    inline ValOrd(T val, int ord);
+    inline ValOrd(T val, I ord);
     /// Operator ==
-    inline bool operator == (const ValOrd<T> &u) const;
+    inline bool operator == (const ValOrd<T, I> &u) const;
     /// Operator <
-    inline bool operator < (const ValOrd<T> &u) const;
+    inline bool operator < (const ValOrd<T, I> &u) const;
   public:
     /// Value.
     T m_val;
     /// Initial order of value in array.
-    int m_ord;
+    I m_ord;
   };
 
 //////////////////////////////////////////////////////////////////////////////
 /// Default Constructor.
-template <class T>
-ValOrd<T>::ValOrd()
+template <class T, class I>
+ValOrd<T, I>::ValOrd()
   {
   }
 
@@ -768,8 +893,8 @@ ValOrd<T>::ValOrd()
 ///
 /// @param val Value.
 /// @param ord Initial order of value in array.
-template <class T>
-ValOrd<T>::ValOrd(T val, int ord)
+template <class T, class I>
+ValOrd<T, I>::ValOrd(T val, I ord)
   {
   m_val = val;
   m_ord = ord;
@@ -780,8 +905,8 @@ ValOrd<T>::ValOrd(T val, int ord)
 ///
 /// @param u Operand for comparison.
 /// @return Result of comparison.
-template <class T>
-bool ValOrd<T>::operator == (const ValOrd<T> &u) const
+template <class T, class I>
+bool ValOrd<T, I>::operator == (const ValOrd<T, I> &u) const
   {
   return (m_val == u.m_val && m_ord == u.m_ord);
   }
@@ -791,8 +916,8 @@ bool ValOrd<T>::operator == (const ValOrd<T> &u) const
 ///
 /// @param u Operand for comparison.
 /// @return Result of comparison.
-template <class T>
-bool ValOrd<T>::operator < (const ValOrd<T> &u) const
+template <class T, class I>
+bool ValOrd<T, I>::operator < (const ValOrd<T, I> &u) const
   {
   return (m_val == u.m_val ? (m_ord < u.m_ord) : (m_val < u.m_val));
   }
@@ -810,17 +935,17 @@ bool ValOrd<T>::operator < (const ValOrd<T> &u) const
 /// @param[in] data  - Elements to be sorted.
 /// @param[in] count - Number of the elements in the array.
 /// @param[out] perm - Result of sorting.
-template <class T>
-void MArray<T>::StableSort(const T *data, int count, TArray<int> &perm)
+template <class T, class I>
+void MArray<T, I>::StableSort(const T *data, I count, TArray<I, I> &perm)
   {
   // Auxiliary array of elements containing value together with order.
-  MArray<ValOrd<T> > sort_arr;
+  MArray<ValOrd<T, I>, I> sort_arr;
   sort_arr.Allocate(count);
 
-  for (int i = 0; i < count; i++)
-    sort_arr[i] = ValOrd<T>(data[i], i);
+  for (I i = 0; i < count; i++)
+    sort_arr[i] = ValOrd<T, I>(data[i], i);
 
-  MArray<ValOrd<T> >::QSort(sort_arr.Data(), count, perm);
+  MArray<ValOrd<T, I>, I>::QSort(sort_arr.Data(), count, perm);
   }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -829,19 +954,19 @@ void MArray<T>::StableSort(const T *data, int count, TArray<int> &perm)
 ///
 /// @param[in, out] data  - Elements to be sorted.
 /// @param[in] count - Number of the elements in the array.
-template <class T>
-void MArray<T>::StableSort(T *data, int count)
+template <class T, class I>
+void MArray<T, I>::StableSort(T *data, I count)
   {
   // Auxiliary array of elements containing value together with order.
-  MArray<ValOrd<T> > sort_arr;
+  MArray<ValOrd<T, I>, I> sort_arr;
   sort_arr.Allocate(count);
 
-  for (int i = 0; i < count; i++)
-    sort_arr[i] = ValOrd<T>(data[i], i);
+  for (I i = 0; i < count; i++)
+    sort_arr[i] = ValOrd<T, I>(data[i], i);
 
-  MArray<ValOrd<T> >::QSort(sort_arr.Data(), count);
+  MArray<ValOrd<T, I>, I>::QSort(sort_arr.Data(), count);
 
-  for (int i = 0; i < count; i++)
+  for (I i = 0; i < count; i++)
     data[i] = sort_arr[i].m_val;
   }
 
@@ -851,29 +976,29 @@ void MArray<T>::StableSort(T *data, int count)
 /// object:
 /// bool Less(const T &b) const
 /// bool Equal(const T &b) const
-template <class T>
+template <class T, class I>
 class ValOrdLessEqual
   {
   public:
     /// Default Constructor.
     inline ValOrdLessEqual();
     /// Constructor.
-    inline ValOrdLessEqual(T val, int ord);
+    inline ValOrdLessEqual(T val, I ord);
     /// Operator ==
-    inline bool operator == (const ValOrdLessEqual<T> &u) const;
+    inline bool operator == (const ValOrdLessEqual<T, I> &u) const;
     /// Operator <
-    inline bool operator < (const ValOrdLessEqual<T> &u) const;
+    inline bool operator < (const ValOrdLessEqual<T, I> &u) const;
   public:
     /// Value.
     T m_val;
     /// Initial order of value in array.
-    int m_ord;
+    I m_ord;
   };
 
 //////////////////////////////////////////////////////////////////////////////
 /// Default Constructor.
-template <class T>
-ValOrdLessEqual<T>::ValOrdLessEqual()
+template <class T, class I>
+ValOrdLessEqual<T, I>::ValOrdLessEqual()
   {
   }
 
@@ -882,8 +1007,8 @@ ValOrdLessEqual<T>::ValOrdLessEqual()
 ///
 /// @param val Value.
 /// @param ord Initial order of value in array.
-template <class T>
-ValOrdLessEqual<T>::ValOrdLessEqual(T val, int ord)
+template <class T, class I>
+ValOrdLessEqual<T, I>::ValOrdLessEqual(T val, I ord)
 : m_val(val), m_ord(ord)
   {
   }
@@ -893,8 +1018,8 @@ ValOrdLessEqual<T>::ValOrdLessEqual(T val, int ord)
 ///
 /// @param u Operand for comparison.
 /// @return Result of comparison.
-template <class T>
-bool ValOrdLessEqual<T>::operator == (const ValOrdLessEqual<T> &u) const
+template <class T, class I>
+bool ValOrdLessEqual<T, I>::operator == (const ValOrdLessEqual<T, I> &u) const
   {
   return (m_val.Equal(u.m_val) && m_ord == u.m_ord);
   }
@@ -904,8 +1029,8 @@ bool ValOrdLessEqual<T>::operator == (const ValOrdLessEqual<T> &u) const
 ///
 /// @param u Operand for comparison.
 /// @return Result of comparison.
-template <class T>
-bool ValOrdLessEqual<T>::operator < (const ValOrdLessEqual<T> &u) const
+template <class T, class I>
+bool ValOrdLessEqual<T, I>::operator < (const ValOrdLessEqual<T, I> &u) const
   {
   return (m_val.Equal(u.m_val) ? (m_ord < u.m_ord) : (m_val.Less(u.m_val)));
   }
@@ -918,27 +1043,27 @@ bool ValOrdLessEqual<T>::operator < (const ValOrdLessEqual<T> &u) const
 /// bool Equal(const T &b) const
 /// @param[in] data Pointer to array to be sorted.
 /// @param[in] count Number of elements in the array.
-template <class T>
-void MArray<T>::StableSortLessEqual(T *data, int count)
+template <class T, class I>
+void MArray<T, I>::StableSortLessEqual(T *data, I count)
   {
   // Auxiliary array of elements containing value together with order.
-  MArray<ValOrdLessEqual<T> > sort_arr;
+  MArray<ValOrdLessEqual<T, I>, I> sort_arr;
   sort_arr.Allocate(count);
 
-  for (int i = 0; i < count; i++)
-    sort_arr[i] = ValOrdLessEqual<T>(data[i], i);
+  for (I i = 0; i < count; i++)
+    sort_arr[i] = ValOrdLessEqual<T, I>(data[i], i);
 
-  MArray<ValOrdLessEqual<T> >::QSort(sort_arr.Data(), count);
+  MArray<ValOrdLessEqual<T, I>, I>::QSort(sort_arr.Data(), count);
 
-  for (int i = 0; i < count; i++)
+  for (I i = 0; i < count; i++)
     data[i] = sort_arr[i].m_val;
   }
 
 //////////////////////////////////////////////////////////////////////////////
 /// Sorts all elements of this array in the ascending order.
 /// Preserves relative order of the equivalent elements.
-template <class T>
-void MArray<T>::StableSort()
+template <class T, class I>
+void MArray<T, I>::StableSort()
   {
   StableSort(this->data, this->count);
   }
@@ -947,14 +1072,14 @@ void MArray<T>::StableSort()
 /// Find maximal value in the array.
 /// @return Maximal value in the array.
 /// @note If array has 0 length - return value is undefined.
-template <class T>
-T MArray<T>::MaxValue() const
+template <class T, class I>
+T MArray<T, I>::MaxValue() const
   {
   T max_value(0);
   if (this->count < 1)
     return max_value;
   max_value = this->data[0];
-  for (int i = 1; i < this->count; i++)
+  for (I i = 1; i < this->count; i++)
     {
     if (max_value < this->data[i])
       max_value = this->data[i];
@@ -966,14 +1091,14 @@ T MArray<T>::MaxValue() const
 /// Find minimal value in the array.
 /// @return Minimal value in the array.
 /// @note If array has 0 length - return value is undefined.
-template <class T>
-T MArray<T>::MinValue() const
+template <class T, class I>
+T MArray<T, I>::MinValue() const
   {
   T min_value(0);
   if (this->count < 1)
     return min_value;
   min_value = this->data[0];
-  for (int i = 1; i < this->count; i++)
+  for (I i = 1; i < this->count; i++)
     {
     if (this->data[i] < min_value)
       min_value = this->data[i];
@@ -986,8 +1111,8 @@ T MArray<T>::MinValue() const
 /// @return Index of element with maximal value.
 /// @note If array has 0 length - -1 is returned. 
 /// If several elements have maximal value - the first is returned.
-template <class T>
-int MArray<T>::MaxValueIndex() const
+template <class T, class I>
+I MArray<T, I>::MaxValueIndex() const
   {
   T max_value(0);
   ind = 0;
@@ -995,7 +1120,7 @@ int MArray<T>::MaxValueIndex() const
     return -1;
   ind = 0;
   max_value = this->data[0];
-  for (int i = 1; i < this->count; i++)
+  for (I i = 1; i < this->count; i++)
     {
     if (max_value < this->data[i])
       {
@@ -1009,11 +1134,11 @@ int MArray<T>::MaxValueIndex() const
 //////////////////////////////////////////////////////////////////////////////
 /// Calculate a sum of values in the array.
 /// @return A sum of values in the array.
-template <class T>
-T MArray<T>::Sum() const
+template <class T, class I>
+T MArray<T, I>::Sum() const
   {
   T sum(0);
-  for (int i = 0; i < this->count; i++)
+  for (I i = 0; i < this->count; i++)
     sum += this->data[i];
   return sum;
   }
@@ -1024,8 +1149,8 @@ T MArray<T>::Sum() const
 /// @param n New number of the elements.
 /// @param out Created array.
 /// @return SUCCESS if array is created successfully, FAILURE - otherwise.
-template <class T>
-OKAY MArray<T>::ResizeLinear(int n, MArray<T> &out) const
+template <class T, class I>
+OKAY MArray<T, I>::ResizeLinear(I n, MArray<T, I> &out) const
   {
   Assert(n > 0 && count > 0);
   if (n == count)
@@ -1043,21 +1168,249 @@ OKAY MArray<T>::ResizeLinear(int n, MArray<T> &out) const
     return SUCCESS;
     }
 
-  for (int i = 0; i < n; i++)
+  for (I i = 0; i < n; i++)
     {
     double row = double(i) * (count - 1) / double(n - 1);
-    int r = (int)floor(row);
-    int rn = r + 1;
+    I r = (I)floor(row);
+    I rn = r + 1;
     if (rn > count - 1)
       rn = count - 1;
     double u = row - r;
 
     out[i] = (*this)[r]  * (1.0 - u) + (*this)[rn] * u;
-    }  // for (int i = 0; i < n; i++)
+    }  // for (I i = 0; i < n; i++)
+
+  return SUCCESS;
+  }
+
+
+//////////////////////////////////////////////////////////////////////////////
+/// Sorts array of integer or floating point elements.
+///
+/// LSD radix sort by 8 bit digits, the passes over the digits, which are
+/// the same for all elements, are skipped. Preserves relative order of the
+/// equivalent elements. Temporary memory: @a count elements.
+///
+/// @param[in, out] data - Elements to be sorted.
+/// @param[in] count - Number of the elements in the array.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, class I>
+OKAY MArray<T, I>::RadixSort(T *data, I count)
+  {
+  typedef RadixKeyTraits<T> TRAITS;
+  typedef typename TRAITS::UINT UINT;
+  const int N_DIGITS = (int)sizeof(UINT);
+  if (count <= 1)
+    return SUCCESS;
+
+  TArray<T, I> buf;
+  TArray<I, I> hist;
+  if (buf.Allocate(count) != SUCCESS || hist.Allocate(N_DIGITS * 256) != SUCCESS)
+    return FAILURE;
+  // Histograms of all digits by one pass
+  hist.Set(0);
+  I *h = hist.Data();
+  for (I i = 0; i < count; i++)
+    {
+    UINT k = TRAITS::Bits(data[i]);
+    for (int d = 0; d < N_DIGITS; d++)
+      h[d * 256 + (int)((k >> (8 * d)) & 0xFF)]++;
+    }
+
+  T *src = data, *dst = buf.Data();
+  for (int d = 0; d < N_DIGITS; d++)
+    {
+    I *off = h + d * 256;
+    if (!RadixOffsets(off, count))
+      continue;
+    for (I i = 0; i < count; i++)
+      dst[off[(int)((TRAITS::Bits(src[i]) >> (8 * d)) & 0xFF)]++] = src[i];
+    Swap(src, dst);
+    }
+  if (src != data)
+    memcpy(data, src, (SIZE_T)count * sizeof(T));
+  return SUCCESS;
+  }  // RadixSort()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Defines ascending order of integer or floating point elements.
+///
+/// Order of the elements in @a data array is not changed. As for QSort(),
+/// the first @a count entries of @a perm are the indices to be ordered
+/// (usually 0, 1, ... count - 1); on exit data[perm[i]] <= data[perm[i + 1]].
+/// Preserves relative order of the equivalent elements.
+///
+/// @param[in] data  - Elements to be sorted.
+/// @param[in] count - Number of the elements in the array.
+/// @param[in, out] perm - Result of sorting.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, class I>
+OKAY MArray<T, I>::RadixSort(const T *data, I count, TArray<I, I> &perm)
+  {
+  typedef RadixKeyTraits<T> TRAITS;
+  Assert(count <= perm.Length());
+  if (count <= 1)
+    return SUCCESS;
+  TArray<typename TRAITS::UINT, I> keys;
+  if (keys.Allocate(count) != SUCCESS)
+    return FAILURE;
+  for (I i = 0; i < count; i++)
+    keys[i] = TRAITS::Bits(data[perm[i]]);
+  return RadixSortPairs(keys.Data(), perm.Data(), count);
+  }  // RadixSort()
 
+//////////////////////////////////////////////////////////////////////////////
+/// Sorts array of the elements by their integer or floating point keys.
+///
+/// The key of each element is extracted once, then the elements are
+/// moved to their places. Preserves relative order of the equivalent
+/// elements.
+/// @code
+/// // Sort hits by the Morton code
+/// MArray<Hit>::RadixSortByKey(hits.Data(), hits.Length(), HitMorton);
+/// @endcode
+///
+/// @param[in, out] data - Elements to be sorted.
+/// @param[in] count - Number of the elements in the array.
+/// @param[in] key - Function or functor: key(const T &) returns the key.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, class I>
+template <class KEY_FUNC>
+OKAY MArray<T, I>::RadixSortByKey(T *data, I count, KEY_FUNC key)
+  {
+  if (count <= 1)
+    return SUCCESS;
+  TArray<I, I> perm;
+  TArray<T, I> buf;
+  if (perm.Allocate(count) != SUCCESS || buf.Allocate(count) != SUCCESS)
+    return FAILURE;
+  for (I i = 0; i < count; i++)
+    perm[i] = i;
+  if (RadixSortByKey((const T *)data, count, perm, key) != SUCCESS)
+    return FAILURE;
+  for (I i = 0; i < count; i++)
+    buf[i] = std::move(data[perm[i]]);
+  for (I i = 0; i < count; i++)
+    data[i] = std::move(buf[i]);
   return SUCCESS;
+  }  // RadixSortByKey()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Defines ascending order of the elements by their keys.
+///
+/// See RadixSort(const T *, I, TArray<I, I> &) for the meaning of
+/// @a perm. Preserves relative order of the equivalent elements.
+///
+/// @param[in] data  - Elements to be sorted.
+/// @param[in] count - Number of the elements in the array.
+/// @param[in, out] perm - Result of sorting.
+/// @param[in] key - Function or functor: key(const T &) returns the key.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, class I>
+template <class KEY_FUNC>
+OKAY MArray<T, I>::RadixSortByKey(const T *data, I count, TArray<I, I> &perm,
+                                  KEY_FUNC key)
+  {
+  typedef typename std::decay<decltype(key(*data))>::type KEY;
+  typedef RadixKeyTraits<KEY> TRAITS;
+  Assert(count <= perm.Length());
+  if (count <= 1)
+    return SUCCESS;
+  TArray<typename TRAITS::UINT, I> keys;
+  if (keys.Allocate(count) != SUCCESS)
+    return FAILURE;
+  for (I i = 0; i < count; i++)
+    keys[i] = TRAITS::Bits(key(data[perm[i]]));
+  return RadixSortPairs(keys.Data(), perm.Data(), count);
+  }  // RadixSortByKey()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Sorts all elements of this array by the radix sort.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, class I>
+OKAY MArray<T, I>::RadixSort()
+  {
+  return RadixSort(this->data, this->count);
   }
 
+//////////////////////////////////////////////////////////////////////////////
+/// Defines ascending order of the elements in this array by the radix sort.
+/// @param[in, out] perm - Result of sorting, see QSort(TArray<I, I> &).
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, class I>
+OKAY MArray<T, I>::RadixSort(TArray<I, I> &perm) const
+  {
+  return RadixSort(this->data, this->count, perm);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Stable radix sort of the unsigned keys with the indices.
+///
+/// @param[in, out] keys - Keys, the order is undefined on exit.
+/// @param[in, out] ind - Indices, reordered as the keys are sorted.
+/// @param[in] count - Number of the keys.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, class I>
+template <class UINT>
+OKAY MArray<T, I>::RadixSortPairs(UINT *keys, I *ind, I count)
+  {
+  const int N_DIGITS = (int)sizeof(UINT);
+  TArray<UINT, I> keys2;
+  TArray<I, I> ind2, hist;
+  if (keys2.Allocate(count) != SUCCESS || ind2.Allocate(count) != SUCCESS ||
+      hist.Allocate(N_DIGITS * 256) != SUCCESS)
+    return FAILURE;
+  hist.Set(0);
+  I *h = hist.Data();
+  for (I i = 0; i < count; i++)
+    {
+    for (int d = 0; d < N_DIGITS; d++)
+      h[d * 256 + (int)((keys[i] >> (8 * d)) & 0xFF)]++;
+    }
+
+  UINT *src_k = keys, *dst_k = keys2.Data();
+  I *src_i = ind, *dst_i = ind2.Data();
+  for (int d = 0; d < N_DIGITS; d++)
+    {
+    I *off = h + d * 256;
+    if (!RadixOffsets(off, count))
+      continue;
+    for (I i = 0; i < count; i++)
+      {
+      I pos = off[(int)((src_k[i] >> (8 * d)) & 0xFF)]++;
+      dst_k[pos] = src_k[i];
+      dst_i[pos] = src_i[i];
+      }
+    Swap(src_k, dst_k);
+    Swap(src_i, dst_i);
+    }
+  if (src_i != ind)
+    memcpy(ind, src_i, (SIZE_T)count * sizeof(I));
+  return SUCCESS;
+  }  // RadixSortPairs()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Offsets of the radix sort pass from the digit histogram.
+///
+/// @param[in, out] hist - Histogram of 256 digits, replaced by the
+/// exclusive prefix sums (output positions of the digits).
+/// @param[in] count - Number of the elements.
+/// @return false if all elements have the same digit (the pass is not
+/// needed), true otherwise.
+template <class T, class I>
+bool MArray<T, I>::RadixOffsets(I *hist, I count)
+  {
+  I sum = 0;
+  for (int b = 0; b < 256; b++)
+    {
+    I n = hist[b];
+    if (n == count)
+      return false;
+    hist[b] = sum;
+    sum += n;
+    }
+  return true;
+  }  // RadixOffsets()
 
 INTEGRA_NAMESPACE_END
 #endif
@@ -28,6 +28,8 @@ class TMatrix
     inline explicit TMatrix();
     /// Constructor.
     inline explicit TMatrix(int n_r, int n_c);
+    /// Constructor of the matrix in the arena.
+    inline explicit TMatrix(MemoryArena *arena);
     /// Constructor from the given values.
     inline TMatrix(const T *val, int n_r, int n_c);
 
@@ -200,6 +202,18 @@ class TMatrix
     /// Number of columns.
     int m_n_cols;
     //@}
+
+  private:
+    /// Allocate and construct the elements.
+    T *AllocData(SIZE_T n);
+    /// Destroy and release the elements.
+    void FreeData(T *p, SIZE_T n);
+
+  private:
+    /// Arena the elements are allocated in, NULL for the heap.
+    MemoryArena *m_arena;
+    /// Number of the allocated elements.
+    SIZE_T m_n_alloc;
   };  // class TMatrix
 
 //////////////////////////////////////////////////////////////////////////////
@@ -214,6 +228,8 @@ TMatrix<T>::TMatrix()
   {
   m_n_rows = m_n_cols = 0;
   m_data = NULL;
+  m_arena = NULL;
+  m_n_alloc = 0;
   }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -228,9 +244,28 @@ TMatrix<T>::TMatrix(int n_r, int n_c)
   {
   m_n_rows = m_n_cols = 0;
   m_data = NULL;
+  m_arena = NULL;
+  m_n_alloc = 0;
   Allocate(n_r, n_c);
   }
 
+//////////////////////////////////////////////////////////////////////////////
+/// Constructor of the matrix in the arena.
+///
+/// The method creates a matrix of zero dimensions; the elements allocated
+/// later are taken from the arena instead of the heap. The matrix must be
+/// destroyed (or emptied) before the arena is reset. Copies of the matrix
+/// are allocated in the heap.
+/// @param[in] arena - Arena for the elements, NULL for the heap.
+template <class T>
+TMatrix<T>::TMatrix(MemoryArena *arena)
+  {
+  m_n_rows = m_n_cols = 0;
+  m_data = NULL;
+  m_arena = arena;
+  m_n_alloc = 0;
+  }
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Constructor from the given values.
 /// @param[in] val The given data array.
@@ -243,6 +278,8 @@ TMatrix<T>::TMatrix(const T *val, int n_r, int n_c)
   {
   m_n_rows = m_n_cols = 0;
   m_data = NULL;
+  m_arena = NULL;
+  m_n_alloc = 0;
   if (Allocate(n_r, n_c) != SUCCESS)
     return;
   SIZE_T len = (SIZE_T)n_r * (SIZE_T)n_c;
@@ -266,6 +303,8 @@ TMatrix<T>::TMatrix(TMatrix<T> const &m)
   {
   m_n_rows = m_n_cols = 0;
   m_data = NULL;
+  m_arena = NULL;
+  m_n_alloc = 0;
   *this = m;
   }
 
@@ -416,9 +455,9 @@ OKAY TMatrix<T>::Allocate(int n_r, int n_c)
     if ((MAX_SIZE_T / n_r) / n_c < sizeof(T))
       {
       m_n_rows = m_n_cols = 0;
-      if (m_data != NULL)
-        delete m_data;
+      FreeData(m_data, m_n_alloc);
       m_data = NULL;
+      m_n_alloc = 0;
       return FAILURE;
       }
     }
@@ -428,19 +467,20 @@ OKAY TMatrix<T>::Allocate(int n_r, int n_c)
   if (av_n_el != n_el || (n_el > 0 && m_data == NULL))
     {
     // free existing memory
-    if (av_n_el > 0 && m_data != NULL)
-      delete [] m_data;
+    FreeData(m_data, m_n_alloc);
     m_data = NULL;
+    m_n_alloc = 0;
     // and allocate new block
     if (n_el > 0)
       {
       //User()->LogMessage("Allocate Matrix %d * %d * %d", n_r, n_c, sizeof(T)); // Catch allocations
-      m_data = new T[n_el];
+      m_data = AllocData(n_el);
       if (m_data == NULL)
         {
         m_n_rows = m_n_cols = 0;
         return FAILURE;
         }
+      m_n_alloc = n_el;
       }
     }
   m_n_rows = n_r;
@@ -510,9 +550,9 @@ OKAY TMatrix<T>::Resize(int n_r, int n_c)
     if ((MAX_SIZE_T / n_r) / n_c < sizeof(T))
       {
       m_n_rows = m_n_cols = 0;
-      if (m_data != NULL)
-        delete m_data;
+      FreeData(m_data, m_n_alloc);
       m_data = NULL;
+      m_n_alloc = 0;
       return FAILURE;
       }
     }
@@ -524,7 +564,8 @@ OKAY TMatrix<T>::Resize(int n_r, int n_c)
   else // we need to keep old data
     {
     // First create a temporary matrix of desired (new) dimensions
-    TMatrix<T> b(n_r, n_c);
+    TMatrix<T> b(m_arena);
+    b.Allocate(n_r, n_c);
     if (b.m_data == NULL && n_r !=0 && n_c != 0)
       return FAILURE;
 
@@ -630,7 +671,8 @@ OKAY TMatrix<T>::InsertRows(int i0, int n, int m0)
     return FAILURE;
 
   // Create a temporary matrix of desired (new) dimensions
-  TMatrix<T> b(m_n_rows + n, m_n_cols);
+  TMatrix<T> b(m_arena);
+  b.Allocate(m_n_rows + n, m_n_cols);
   if (!b.m_data)
     return FAILURE;
 
@@ -692,7 +734,8 @@ OKAY TMatrix<T>::InsertColumns(int j0, int n, int n0)
     return FAILURE;
 
   // Create a temporary matrix of desired (new) dimensions
-  TMatrix<T> b(m_n_rows, m_n_cols + n);
+  TMatrix<T> b(m_arena);
+  b.Allocate(m_n_rows, m_n_cols + n);
   if (!b.m_data)
     return FAILURE;
 
@@ -827,6 +870,8 @@ void TMatrix<T>::SwapMatrix(TMatrix<T> &m1, TMatrix<T> &m2)
   m2.m_n_rows = nrows_tmp;
   m2.m_n_cols = ncols_tmp;
   m2.m_data = a_tmp;
+  Swap(m1.m_arena, m2.m_arena);
+  Swap(m1.m_n_alloc, m2.m_n_alloc);
   return;
   }
 
@@ -984,14 +1029,15 @@ OKAY TMatrix<T>::RemoveRows(int row, int n)
   // If remove all rows from matrix
   if (size == 0)
     {
-    delete[] m_data;
+    FreeData(m_data, m_n_alloc);
     m_data = NULL;
+    m_n_alloc = 0;
     m_n_rows = new_nrows;
     return SUCCESS;
     }
 
   // Allocate memory under new matrix
-  T *new_data = new T[size];
+  T *new_data = AllocData(size);
   if (new_data == NULL)
     return FAILURE;
 
@@ -1009,8 +1055,9 @@ OKAY TMatrix<T>::RemoveRows(int row, int n)
     for (int c = 0; c < m_n_cols; c++)
       new_data[p++] = m_data[p0++];
 
-  delete[] m_data;
+  FreeData(m_data, m_n_alloc);
   m_data = new_data;
+  m_n_alloc = size;
   m_n_rows = new_nrows;
   return SUCCESS;
   }  // RemoveRows()
@@ -1054,14 +1101,15 @@ OKAY TMatrix<T>::RemoveColumns(int col, int n)
   // If remove all columns from matrix
   if (size == 0)
     {
-    delete[] m_data;
+    FreeData(m_data, m_n_alloc);
     m_data = NULL;
+    m_n_alloc = 0;
     m_n_cols = new_ncols;
     return SUCCESS;
     }
 
   // Allocate memory under new matrix
-  T *new_data = new T[size];
+  T *new_data = AllocData(size);
   if (new_data == NULL)
     return FAILURE;
 
@@ -1082,8 +1130,9 @@ OKAY TMatrix<T>::RemoveColumns(int col, int n)
     p0 += m_n_cols;
     }
 
-  delete[] m_data;
+  FreeData(m_data, m_n_alloc);
   m_data = new_data;
+  m_n_alloc = size;
   m_n_cols = new_ncols;
   return SUCCESS;
   }  // RemoveColumns()
@@ -1601,6 +1650,48 @@ bool TMatrix<T>::IsEmpty() const
   return m_n_rows == 0 || m_n_cols == 0;
   }
 
+//////////////////////////////////////////////////////////////////////////////
+/// Allocate and construct the elements.
+///
+/// The elements are taken from the arena of the matrix, if any, and
+/// initialised by the default constructor of type T.
+/// @param[in] n - The number of elements, > 0.
+/// @return A pointer to the elements or NULL (allocation failure).
+template <class T>
+T *TMatrix<T>::AllocData(SIZE_T n)
+  {
+  if (m_arena == NULL)
+    return new T[n];
+  if (n > MAX_SIZE_T / sizeof(T))
+    return NULL;
+  T *p = (T *)m_arena->Alloc(n * sizeof(T),
+    Max((SIZE_T)alignof(T), (SIZE_T)MemoryArena::DEF_ALIGN));
+  if (p == NULL)
+    return NULL;
+  for (SIZE_T i = 0; i < n; i++)
+    ::new ((void *)(p + i)) T;
+  return p;
+  }  // AllocData()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Destroy and release the elements.
+/// @param[in] p - A pointer returned by AllocData() or NULL.
+/// @param[in] n - The number of elements given to AllocData().
+template <class T>
+void TMatrix<T>::FreeData(T *p, SIZE_T n)
+  {
+  if (p == NULL)
+    return;
+  if (m_arena == NULL)
+    {
+    delete [] p;
+    return;
+    }
+  for (SIZE_T i = 0; i < n; i++)
+    p[i].~T();
+  m_arena->Free(p, n * sizeof(T));
+  }  // FreeData()
+
 INTEGRA_NAMESPACE_END
 
 #endif
@@ -8,6 +8,7 @@
 /// Copyright &copy; INTEGRA, Inc., 2004.
 
 #include <stdlib.h>
+#include <mutex>
 #include <integra.hpp>
 #include "base.hpp"
 #include "envi.hpp"
@@ -25,7 +26,12 @@ static const char *MEM_TRACE_SIZE = "MEMCLASS_TRACE_SIZE";
 MemoryClass::TraceMode MemoryClass::trace_mode = MemoryClass::UNDEFINED;
 File MemoryClass::trace_file;
 SIZE_T MemoryClass::trace_size = 0;
-MemoryClass *MemoryClass::top = NULL;
+std::atomic<MemoryClass *> MemoryClass::top(NULL);
+
+/// Counter of the threads for the assignment of the shards.
+static std::atomic<int> thread_counter(0);
+/// Shard of the thread, -1 if not assigned yet.
+static thread_local int thread_shard = -1;
 
 /**
 @class MemoryClass base/memclass.hpp
@@ -53,6 +59,15 @@ set MEMCLASS_TRACE_SIZE=512
 
 If this variable is not specified, tracing of all sizes is performed.
 
+Add() and Del() may be called from any thread. The sizes are accumulated
+in several counters, each in its own cache line; the threads are
+assigned to the counters in turn, so the threads of a group do not share
+a cache line on each allocation. CurSize() sums the counters. The max size
+is updated by CurSize(), MaxSize() and each time a counter grows by
+another megabyte; so it may miss a short peak by less than a megabyte
+per counter. The classes are created under a lock; GetClass() finds an
+existing class without it.
+
 @sa @ref base_mainpage
 **/
 
@@ -63,7 +78,10 @@ If this variable is not specified, tracing of all sizes is performed.
 /// @param[in] class_name Class name.
 MemoryClass::MemoryClass(const char *class_name)
   {
-  cur_size = max_size = 0;
+  for (int i = 0; i < N_SHARDS; i++)
+    shards[i].size.store(0, std::memory_order_relaxed);
+  max_size.store(0, std::memory_order_relaxed);
+  next = NULL;
   name = class_name;
 
   if (trace_mode == UNDEFINED)
@@ -84,26 +102,76 @@ MemoryClass::MemoryClass(const char *class_name)
     else
       trace_mode = NO_TRACE;
     }
-
-  if (top == NULL)
-    {
-    next = NULL;
-    top = this;
-    }
-  else
-    {
-    next = top->next;
-    top->next = this;
-    }
   }  // MemoryClass()
 
+/////////////////////////////////////////////////////////////////////////////
+/// Add size.
+///
+/// The method adds the specified size to the memory allocation statistics.
+/// @param[in] size - The size of a block.
+void MemoryClass::Add(SIZE_T size)
+  {
+  std::atomic<INT64> &counter = shards[ShardIndex()].size;
+  INT64 old = counter.fetch_add((INT64)size, std::memory_order_relaxed);
+  // Update max size on each megabyte of growth
+  if (((old + (INT64)size) >> SYNC_SHIFT) != (old >> SYNC_SHIFT))
+    UpdateMax();
+  }
+
+/////////////////////////////////////////////////////////////////////////////
+/// Subtract size.
+/// The method subtracts the specified size from the memory statistics.
+/// @param[in] size - the size of a block.
+void MemoryClass::Del(SIZE_T size)
+  {
+  shards[ShardIndex()].size.fetch_sub((INT64)size, std::memory_order_relaxed);
+  }
+
+/////////////////////////////////////////////////////////////////////////////
+/// Get the counter of the calling thread.
+/// @return Index of the shard, the same for all classes.
+int MemoryClass::ShardIndex()
+  {
+  if (thread_shard < 0)
+    thread_shard = thread_counter.fetch_add(1, std::memory_order_relaxed) &
+                   (N_SHARDS - 1);
+  return thread_shard;
+  }
+
+/////////////////////////////////////////////////////////////////////////////
+/// Sum of the counters.
+///
+/// A block may be released by another thread, so a counter may be negative;
+/// the sum read while other threads work may be too.
+/// @return Memory currently occupied by the class, in bytes.
+SIZE_T MemoryClass::Sum() const
+  {
+  INT64 sum = 0;
+  for (int i = 0; i < N_SHARDS; i++)
+    sum += shards[i].size.load(std::memory_order_relaxed);
+  return sum > 0 ? (SIZE_T)sum : 0;
+  }
+
+/////////////////////////////////////////////////////////////////////////////
+/// Update max size by the current one.
+/// @return The current size.
+SIZE_T MemoryClass::UpdateMax()
+  {
+  SIZE_T cur = Sum();
+  SIZE_T peak = max_size.load(std::memory_order_relaxed);
+  while (cur > peak &&
+         !max_size.compare_exchange_weak(peak, cur, std::memory_order_relaxed))
+    ;
+  return cur;
+  }
+
 
 /////////////////////////////////////////////////////////////////////////////
 /// Get the current size.
 /// @return The currently occupied memory size for this class, in bytes.
 SIZE_T MemoryClass::CurSize()
   {
-  return cur_size;
+  return UpdateMax();
   }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -111,7 +179,8 @@ SIZE_T MemoryClass::CurSize()
 /// @return The maximal occupied size for this class, in bytes.
 SIZE_T MemoryClass::MaxSize()
   {
-  return max_size;
+  UpdateMax();
+  return max_size.load(std::memory_order_relaxed);
   }
 
 
@@ -120,7 +189,7 @@ SIZE_T MemoryClass::MaxSize()
 /// @return Pointer to first object in the stack.
 MemoryClass *MemoryClass::FirstClass()
   {
-  return top;
+  return top.load(std::memory_order_acquire);
   }
 
 
@@ -139,6 +208,9 @@ MemoryClass *MemoryClass::NextClass()
 /// If there is no such a class, it is created.
 /// If a move from one class to another was requested,
 /// the statistics will not be moved as there is no such possibility.
+///
+/// The classes are never deleted and are added to the top of the stack,
+/// so the search does not need the lock.
 /// @param[in] class_name A class name.
 /// @return A new memory class
 MemoryClass *MemoryClass::GetClass(const char *class_name)
@@ -146,12 +218,21 @@ MemoryClass *MemoryClass::GetClass(const char *class_name)
   MemoryClass *p;
 
   // Search among existing classes
-  for (p = top; p != NULL; p = p->next)
+  for (p = FirstClass(); p != NULL; p = p->next)
+    if (p->name == class_name)
+      return p;
+
+  // Search again under the lock, the class may be just added
+  static std::mutex lock;
+  std::lock_guard<std::mutex> guard(lock);
+  for (p = FirstClass(); p != NULL; p = p->next)
     if (p->name == class_name)
       return p;
 
   // No class with such name - add one.
   p = new MemoryClass(class_name);
+  p->next = top.load(std::memory_order_relaxed);
+  top.store(p, std::memory_order_release);
   return p;
   }
 
@@ -164,9 +245,9 @@ SIZE_T MemoryClass::AllocatedByClass(const char *class_name)
   {
   MemoryClass *p;
 
-  for (p = top; p != NULL; p = p->next)
+  for (p = FirstClass(); p != NULL; p = p->next)
     if (p->name == class_name)
-      return p->cur_size;
+      return p->CurSize();
 
   // Not found
   return 0;
@@ -181,8 +262,8 @@ SIZE_T MemoryClass::AllocatedByAll()
   SIZE_T size = 0;
   MemoryClass *p;
 
-  for (p = top; p != NULL; p = p->next)
-    size += p->cur_size;
+  for (p = FirstClass(); p != NULL; p = p->next)
+    size += p->CurSize();
 
   return size;
   }
@@ -200,12 +281,13 @@ void MemoryClass::PrintMapForClass(const char *class_name,TArray<Str> &out)
   out.Add("    Cur size    Max size  Class name");
   out.Add("------------------------------------");
 
-  for (p = top; p != NULL; p = p->next)
+  for (p = FirstClass(); p != NULL; p = p->next)
     if (p->name == class_name)
       {
+      SIZE_T cur = p->CurSize();
       s.Printf("%10dMB%10dMB  %s",
-               Envi::Bytes2MBytes(p->cur_size),
-               Envi::Bytes2MBytes(p->max_size),
+               Envi::Bytes2MBytes(cur),
+               Envi::Bytes2MBytes(p->MaxSize()),
                p->name.IsNull() ? "UNNAMED" : p->name.Data());
       out.Add(s);
       break;
@@ -228,11 +310,12 @@ void MemoryClass::PrintMapForAll(TArray<Str> &out)
   out.Add("    Cur size    Max size  Class name");
   out.Add("------------------------------------");
 
-  for (p = top; p != NULL; p = p->next)
+  for (p = FirstClass(); p != NULL; p = p->next)
     {
+    SIZE_T cur = p->CurSize();
     s.Printf("%10dMB%10dMB  %s",
-             Envi::Bytes2MBytes(p->cur_size),
-             Envi::Bytes2MBytes(p->max_size),
+             Envi::Bytes2MBytes(cur),
+             Envi::Bytes2MBytes(p->MaxSize()),
              p->name.IsNull() ? "UNNAMED" : p->name.Data());
     out.Add(s);
     }
@@ -10,6 +10,8 @@
 #ifndef _AT58_MEMORYCLASS_HPP_
 #define _AT58_MEMORYCLASS_HPP_
 
+#include <atomic>
+
 #include "arrays.hpp"
 #include "export.h"
 #include "file.hpp"
@@ -31,9 +33,9 @@ class MemoryClass
     /// @name Memory statistics methods
     //@{
     /// Add size.
-    inline void Add(SIZE_T size);
+    INTAPI_BASE void Add(SIZE_T size);
     /// Subtract size.
-    inline void Del(SIZE_T size);
+    INTAPI_BASE void Del(SIZE_T size);
     //@}
 
   public:
@@ -91,6 +93,39 @@ class MemoryClass
   private:
     /// Constructor.
     MemoryClass(const char *class_name);
+    /// Copy constructor (forbidden).
+    MemoryClass(const MemoryClass &);
+    /// Assignment operator (forbidden).
+    MemoryClass &operator =(const MemoryClass &);
+
+  private:
+    /// Constants
+    enum
+      {
+      /// Number of the counters (a power of 2).
+      N_SHARDS = 16,
+      /// Size of the cache line, in bytes.
+      CACHE_LINE = 64,
+      /// log2 of the growth of a counter, which updates the max size.
+      SYNC_SHIFT = 20
+      };
+
+    /// Counter of the threads sharing it, in its own cache line.
+    struct Shard
+      {
+      /// Allocated minus released size, may be negative.
+      std::atomic<INT64> size;
+      /// Padding up to the cache line.
+      char pad[CACHE_LINE - sizeof(std::atomic<INT64>)];
+      };
+
+  private:
+    /// Get the counter of the calling thread.
+    static int ShardIndex();
+    /// Sum of the counters.
+    SIZE_T Sum() const;
+    /// Update max size by the current one.
+    SIZE_T UpdateMax();
 
   private:
     /// @brief Trace mode enumeration.
@@ -122,17 +157,17 @@ class MemoryClass
     //@{
     /// Class name.
     Str name;
-    /// Memory currently occupied by class.
-    SIZE_T cur_size;
-    /// Max memory ever occupied by class.
-    SIZE_T max_size;
+    /// Memory currently occupied by class, by the groups of threads.
+    Shard shards[N_SHARDS];
+    /// Max memory ever occupied by class (see UpdateMax()).
+    std::atomic<SIZE_T> max_size;
     //@}
 
   private:
     /// @name Representation of all registered memory classes
     //@{
     /// Pointer to top of stack.
-    static MemoryClass *top;
+    static std::atomic<MemoryClass *> top;
     //@}
 
   private:
@@ -156,29 +191,6 @@ const Str &MemoryClass::GetName() const
   return name;
   }
 
-/////////////////////////////////////////////////////////////////////////////
-/// Add size.
-///
-/// The method adds the specified size to the memory allocation statistics.
-/// @param[in] size - The size of a block.
-void MemoryClass::Add(SIZE_T size)
-  {
-  cur_size += size;
-  if (cur_size > max_size)
-    max_size = cur_size;
-  }
-
-
-/////////////////////////////////////////////////////////////////////////////
-/// Subtract size.
-/// The method subtracts the specified size from the memory statistics.
-/// @param[in] size - the size of a block.
-void MemoryClass::Del(SIZE_T size)
-  {
-  cur_size -= size;
-  }
-
-
 /////////////////////////////////////////////////////////////////////////////
 /// Should this block be traced or not.
 /// @param[in] size - A block size.
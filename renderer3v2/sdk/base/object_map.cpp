@@ -13,13 +13,20 @@
 
 Fast map of objects to indices.
 
-The class provides a limited STL-based implementation of a map.
-Public intrface of the class has no STL specifics.
+The class provides a limited implementation of a map of object addresses
+to indices (e.g. numbering of the objects on serialization).
+
+The map is a flat hash table: open addressing with linear probing over
+an array of (address, index) slots, Fibonacci hashing of the address,
+load factor <= 1/2. Addition does not allocate memory except for the
+doubling of the table; search is a few adjacent slots reads. Use Reserve()
+when the number of objects is known to avoid the rehashing.
 
 Usage:
 
 @code
 ObjectMap<Plug> obj_map;
+obj_map.Reserve(n_plugs);
 ...
 Plug *obj1 = ...;
 obj_map.AddObj(obj1, 1);
@@ -30,5 +37,8 @@ int index;
 bool found = obj_map.Find(obj, &index);
 @endcode
 
+Comparison with MapEnvelop (std::map) on one million objects:
+tests/base/test/bench_object_map.cpp.
+
 **/
 
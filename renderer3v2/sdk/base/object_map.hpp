@@ -10,7 +10,7 @@
 #ifndef _ELXX_OBJECT_MAP_HPP_
 #define _ELXX_OBJECT_MAP_HPP_
 
-#include "map_envelop.h"
+#include "arrays.hpp"
 
 INTEGRA_NAMESPACE_START
 
@@ -29,14 +29,49 @@ class ObjectMap
     OKAY AddObj(OBJ_TYPE *object, int index);
     /// Find element in object map.
     bool FindObj(OBJ_TYPE *object, int *p_index = NULL);
+    /// Prepare the map for the given number of objects.
+    OKAY Reserve(int n_objects);
+    /// Number of objects in the map.
+    inline int Length() const;
+    /// Remove all objects, memory is kept.
+    void RemoveAll();
 
   private:
     /// Copy constructor (forbidden).
     ObjectMap(const ObjectMap<OBJ_TYPE> &src);
 
   private:
-    /// STL map envelop.
-    MapEnvelop m_map_env;
+    /// Slot of the hash table.
+    struct Slot
+      {
+      /// Object, NULL for the empty slot.
+      OBJ_TYPE *m_obj;
+      /// Index of the object.
+      int m_ind;
+      };
+
+    /// Constants
+    enum
+      {
+      /// Minimal log2 of the table size.
+      MIN_SHIFT = 4,
+      /// Maximal log2 of the table size.
+      MAX_SHIFT = 30
+      };
+
+  private:
+    /// Home slot of the object.
+    inline int Home(const OBJ_TYPE *object) const;
+    /// Reallocate the table to 2^shift slots and put the objects there.
+    OKAY Rehash(int shift);
+
+  private:
+    /// Hash table: open addressing with linear probing, 2^m_shift slots.
+    TArray<Slot> m_slots;
+    /// log2 of the table size, 0 if the table is not allocated.
+    int m_shift;
+    /// Number of objects in the table.
+    int m_count;
 
   };  // class ObjectMap
 
@@ -46,6 +81,8 @@ class ObjectMap
 template <class OBJ_TYPE>
 ObjectMap<OBJ_TYPE>::ObjectMap()
   {
+  m_shift = 0;
+  m_count = 0;
   }  // ObjectMap()
 
 //////////////////////////////////////////////////////////////////////////////
@@ -59,6 +96,7 @@ ObjectMap<OBJ_TYPE>::~ObjectMap()
 //////////////////////////////////////////////////////////////////////////////
 /// Add element to the map.
 ///
+/// Index of the object already present in the map is replaced.
 /// @param[in] object Object to add (not NULL).
 /// @param[in] index Index of the object.
 /// @return SUCCESS or FAILURE.
@@ -66,7 +104,31 @@ ObjectMap<OBJ_TYPE>::~ObjectMap()
 template <class OBJ_TYPE>
 OKAY ObjectMap<OBJ_TYPE>::AddObj(OBJ_TYPE *object, int index)
   {
-  return m_map_env.AddObj(object, index);
+  Assert(object != NULL);
+  // Keep the load factor <= 1/2
+  if (2 * (m_count + 1) > m_slots.Length())
+    {
+    if (m_shift >= MAX_SHIFT)
+      return User()->ErrorNoMemory();
+    if (Rehash(m_shift > 0 ? m_shift + 1 : (int)MIN_SHIFT) != SUCCESS)
+      return FAILURE;
+    }
+  int mask = m_slots.Length() - 1;
+  Slot *slots = m_slots.Data();
+  int pos = Home(object);
+  while (slots[pos].m_obj != NULL)
+    {
+    if (slots[pos].m_obj == object)
+      {
+      slots[pos].m_ind = index;
+      return SUCCESS;
+      }
+    pos = (pos + 1) & mask;
+    }
+  slots[pos].m_obj = object;
+  slots[pos].m_ind = index;
+  m_count++;
+  return SUCCESS;
   }  // AddObj()
 
 //////////////////////////////////////////////////////////////////////////////
@@ -79,9 +141,114 @@ OKAY ObjectMap<OBJ_TYPE>::AddObj(OBJ_TYPE *object, int index)
 template <class OBJ_TYPE>
 bool ObjectMap<OBJ_TYPE>::FindObj(OBJ_TYPE *object, int *p_index)
   {
-  return m_map_env.FindObj(object, p_index);
+  if (m_count == 0)
+    return false;
+  int mask = m_slots.Length() - 1;
+  const Slot *slots = m_slots.Data();
+  for (int pos = Home(object); slots[pos].m_obj != NULL; pos = (pos + 1) & mask)
+    {
+    if (slots[pos].m_obj == object)
+      {
+      if (p_index != NULL)
+        *p_index = slots[pos].m_ind;
+      return true;
+      }
+    }
+  return false;
   }  // FindObj()
 
+//////////////////////////////////////////////////////////////////////////////
+/// Prepare the map for the given number of objects.
+///
+/// The table is allocated at once, so the following AddObj() calls do
+/// not reallocate it until the map holds more than @a n_objects objects.
+/// @param[in] n_objects Expected number of objects.
+/// @return SUCCESS or FAILURE.
+///
+template <class OBJ_TYPE>
+OKAY ObjectMap<OBJ_TYPE>::Reserve(int n_objects)
+  {
+  Assert(n_objects >= 0);
+  int shift = MIN_SHIFT;
+  while (shift < MAX_SHIFT && (1 << (shift - 1)) < n_objects)
+    shift++;
+  if (shift <= m_shift)
+    return SUCCESS;
+  return Rehash(shift);
+  }  // Reserve()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Number of objects in the map.
+/// @return Number of different objects added.
+///
+template <class OBJ_TYPE>
+int ObjectMap<OBJ_TYPE>::Length() const
+  {
+  return m_count;
+  }  // Length()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Remove all objects, memory is kept.
+///
+template <class OBJ_TYPE>
+void ObjectMap<OBJ_TYPE>::RemoveAll()
+  {
+  for (int i = 0; i < m_slots.Length(); i++)
+    m_slots[i].m_obj = NULL;
+  m_count = 0;
+  }  // RemoveAll()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Home slot of the object.
+///
+/// Fibonacci hashing of the address: the top bits of the product do not
+/// depend on the alignment of the objects.
+/// @param[in] object Object.
+/// @return Index of the slot, where the probing starts.
+///
+template <class OBJ_TYPE>
+int ObjectMap<OBJ_TYPE>::Home(const OBJ_TYPE *object) const
+  {
+  Assert(m_shift > 0);
+  UINT64 h = (UINT64)(SIZE_T)object * 0x9E3779B97F4A7C15ULL;
+  return (int)(h >> (64 - m_shift));
+  }  // Home()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Reallocate the table and put the objects there.
+///
+/// @param[in] shift log2 of the new table size.
+/// @return SUCCESS or FAILURE.
+///
+template <class OBJ_TYPE>
+OKAY ObjectMap<OBJ_TYPE>::Rehash(int shift)
+  {
+  Assert(shift >= MIN_SHIFT && shift <= MAX_SHIFT);
+  TArray<Slot> old_slots;
+  TArray<Slot>::SwapArrays(old_slots, m_slots);
+  if (m_slots.SetLength(1 << shift) != SUCCESS)
+    {
+    TArray<Slot>::SwapArrays(old_slots, m_slots);
+    return User()->ErrorNoMemory((INT64)sizeof(Slot) << shift);
+    }
+  m_shift = shift;
+  for (int i = 0; i < m_slots.Length(); i++)
+    m_slots[i].m_obj = NULL;
+
+  int mask = m_slots.Length() - 1;
+  Slot *slots = m_slots.Data();
+  for (int i = 0; i < old_slots.Length(); i++)
+    {
+    if (old_slots[i].m_obj == NULL)
+      continue;
+    int pos = Home(old_slots[i].m_obj);
+    while (slots[pos].m_obj != NULL)
+      pos = (pos + 1) & mask;
+    slots[pos] = old_slots[i];
+    }
+  return SUCCESS;
+  }  // Rehash()
+
 INTEGRA_NAMESPACE_END
 #endif
 
@@ -0,0 +1,548 @@
+/// @file
+///
+/// @brief Declaration of ParSort template class - sorting by a group
+/// of threads.
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+#ifndef _KLBC_PAR_SORT_HPP_
+#define _KLBC_PAR_SORT_HPP_
+
+#include <string.h>
+#include <utility>
+
+#include <base/marray.hpp>
+#include <base/thread_group.hpp>
+
+INTEGRA_NAMESPACE_START
+
+/// @brief Sorting of the arrays by a group of threads.
+///
+/// Sort() is a sample sort of the elements with '<' operator: the elements
+/// are distributed to the buckets by the splitters chosen from a sample,
+/// then the buckets are sorted by MArray::QSort() in parallel. It is not
+/// stable, except for the variant with the permutation, which orders the
+/// equivalent elements by their indices.
+///
+/// RadixSort() is the LSD radix sort of integer and floating point
+/// elements (see RadixKeyTraits) by 8 bit digits, as
+/// MArray::RadixSort(): the input is split into a chunk per thread,
+/// the threads build the digit histograms of their chunks, the prefix
+/// sums of the histograms over the digits and the chunks give the output
+/// positions of each chunk, and the threads scatter their chunks
+/// independently. It is stable.
+///
+/// Arrays of less than PAR_SORT_MIN elements are sorted by a single
+/// thread. Temporary memory of both sorts is of the array size.
+/// @code
+///   MArray<float> depth;
+///   ...
+///   if (ParSort<float>::RadixSort(depth.Data(), depth.Length()) != SUCCESS)
+///     return FAILURE;
+/// @endcode
+template <class T, class I = int>
+class ParSort
+  {
+  public:
+    /// @name Sample sort of the elements with '<' operator
+    //@{
+    /// Sorts array of the elements by the group of threads.
+    static OKAY Sort(T *data, I count, ThreadGroup &group, int n_threads);
+    /// Sorts array of the elements by a temporary group of threads.
+    static OKAY Sort(T *data, I count, int n_threads = 0);
+    /// Defines ascending order of the elements by a temporary group of threads.
+    static OKAY Sort(const T *data, I count, TArray<I, I> &perm,
+                     int n_threads = 0);
+    //@}
+
+    /// @name Radix sort of integer or floating point elements, stable
+    //@{
+    /// Sorts array of the elements by the group of threads.
+    static OKAY RadixSort(T *data, I count, ThreadGroup &group, int n_threads);
+    /// Sorts array of the elements by a temporary group of threads.
+    static OKAY RadixSort(T *data, I count, int n_threads = 0);
+    //@}
+
+  public:
+    /// Constants of the parallel sort.
+    enum
+      {
+      /// Smaller arrays are sorted by a single thread.
+      PAR_SORT_MIN = 65536,
+      /// Maximal number of the buckets (and chunks of the input).
+      PAR_SORT_MAX_PARTS = 1024,
+      /// Number of the sample elements per bucket.
+      PAR_SORT_OVERSAMPLE = 32
+      };
+
+  private:
+    /// Shared parameters of the sample sort.
+    struct SampleJob
+      {
+      /// Elements to sort.
+      T *data;
+      /// Temporary storage of the elements.
+      T *temp;
+      /// Number of the elements.
+      I count;
+      /// Number of the buckets, equal to the number of the input chunks.
+      int n_parts;
+      /// Boundaries of the buckets, n_parts - 1 ascending values.
+      const T *splitters;
+      /// Counts, then output offsets of the chunk c in the bucket b: [c * n_parts + b].
+      I *offsets;
+      /// Start of the bucket b in the output, n_parts + 1 values.
+      I *bucket_start;
+      /// Stage: 0 - count, 1 - scatter, 2 - sort the buckets, 3 - copy back.
+      int stage;
+      };
+
+    /// Shared parameters of the radix sort.
+    struct RadixJob
+      {
+      /// Source of the pass.
+      const T *src;
+      /// Destination of the pass.
+      T *dst;
+      /// Number of the elements.
+      I count;
+      /// Number of the input chunks.
+      int n_parts;
+      /// Histograms, then output offsets of the digits of the chunk c:
+      /// [(c * sizeof(key) + d) * 256 + digit].
+      I *hist;
+      /// Digit of the pass, -1 - histograms of all digits.
+      int digit;
+      /// Stage: 0 - count, 1 - scatter.
+      int stage;
+      };
+
+  private:
+    /// Job of the sample sort for a thread.
+    static void SampleExec(void *shared_param, void *indiv_param,
+                           unsigned int thread_id);
+    /// Bucket of the element in the sample sort.
+    inline static int SampleBucket(const SampleJob &job, const T &x);
+    /// Stage of the parallel sort over n_parts chunks.
+    static OKAY RunStage(ThreadGroup &group, Thread1DRange &range,
+                         int n_parts, int n_threads, void *job,
+                         ThreadGroup::ExecFuncType exec);
+    /// Job of the radix sort for a thread.
+    static void RadixExec(void *shared_param, void *indiv_param,
+                          unsigned int thread_id);
+  };  // class ParSort
+
+
+// -----------------------------------------------------------------
+//              Methods of the class ParSort
+// -----------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////////
+/// Sorts array of the elements by the group of threads.
+///
+/// Sample sort: the splitters chosen from a regular sample of the elements
+/// define n_parts = 4 * @a n_threads buckets; the threads count the elements
+/// of the input chunks per bucket, copy them to the buckets, sort the
+/// buckets by MArray::QSort() and move them back. Relative order of the
+/// equivalent elements is not preserved. Arrays with many equal elements
+/// are sorted correctly but with worse load balance.
+///
+/// The elements of @a data are changed only by the last stage, so on
+/// failure of the allocation, or on exception in a thread before that
+/// stage (e.g. in '<' or in the copy of T), @a data is left unchanged.
+///
+/// @param[in, out] data - Elements to be sorted.
+/// @param[in] count - Number of the elements in the array.
+/// @param[in] group - Group of threads, not started.
+/// @param[in] n_threads - Number of threads of the group to use, > 0.
+/// @return SUCCESS / FAILURE (memory allocation failure or exception
+/// in a thread).
+template <class T, class I>
+OKAY ParSort<T, I>::Sort(T *data, I count, ThreadGroup &group, int n_threads)
+  {
+  Assert(n_threads > 0);
+  if (count < PAR_SORT_MIN || n_threads <= 1)
+    {
+    MArray<T, I>::QSort(data, count);
+    return SUCCESS;
+    }
+  int n_parts = Min(4 * n_threads, (int)PAR_SORT_MAX_PARTS);
+
+  // Splitters from the sorted regular sample
+  TArray<T, I> sample, splitters;
+  I n_sample = (I)n_parts * PAR_SORT_OVERSAMPLE;
+  if (sample.Allocate(n_sample) != SUCCESS || splitters.Allocate(n_parts - 1) != SUCCESS)
+    return FAILURE;
+  for (I i = 0; i < n_sample; i++)
+    sample[i] = data[(I)((INT64)i * count / n_sample)];
+  MArray<T, I>::QSort(sample.Data(), n_sample);
+  for (int b = 0; b < n_parts - 1; b++)
+    splitters[b] = sample[(I)(b + 1) * PAR_SORT_OVERSAMPLE];
+
+  TArray<T, I> temp;
+  TArray<I, I> offsets, bucket_start;
+  if (temp.Allocate(count) != SUCCESS ||
+      offsets.Allocate((I)n_parts * n_parts) != SUCCESS ||
+      bucket_start.Allocate(n_parts + 1) != SUCCESS)
+    return FAILURE;
+
+  SampleJob job;
+  job.data = data;
+  job.temp = temp.Data();
+  job.count = count;
+  job.n_parts = n_parts;
+  job.splitters = splitters.Data();
+  job.offsets = offsets.Data();
+  job.bucket_start = bucket_start.Data();
+
+  Thread1DRange range(n_threads);
+  for (job.stage = 0; job.stage < 4; job.stage++)
+    {
+    if (RunStage(group, range, n_parts, n_threads, &job, SampleExec) != SUCCESS)
+      return FAILURE;
+    if (job.stage != 0)
+      continue;
+    // Output offsets: buckets in order, chunks in order inside a bucket
+    I pos = 0;
+    for (int b = 0; b < n_parts; b++)
+      {
+      bucket_start[b] = pos;
+      for (int c = 0; c < n_parts; c++)
+        {
+        I n = offsets[(I)c * n_parts + b];
+        offsets[(I)c * n_parts + b] = pos;
+        pos += n;
+        }
+      }
+    bucket_start[n_parts] = pos;
+    Assert(pos == count);
+    }
+  return SUCCESS;
+  }  // Sort()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Sorts array of the elements by a temporary group of threads.
+///
+/// See Sort(T *, I, ThreadGroup &, int); the group is created for the call,
+/// use that method to sort many arrays by the same group.
+///
+/// @param[in, out] data - Elements to be sorted.
+/// @param[in] count - Number of the elements in the array.
+/// @param[in] n_threads - Number of threads, <= 0 - number of logical cores.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, class I>
+OKAY ParSort<T, I>::Sort(T *data, I count, int n_threads)
+  {
+  if (n_threads <= 0)
+    n_threads = NumberOfLogicalCores();
+  if (count < PAR_SORT_MIN || n_threads <= 1)
+    {
+    MArray<T, I>::QSort(data, count);
+    return SUCCESS;
+    }
+  ThreadGroup group(n_threads, "ParSort::Sort");
+  return Sort(data, count, group, n_threads);
+  }  // Sort()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Defines ascending order of the elements by a temporary group of threads.
+///
+/// See MArray::QSort(const T *, I, TArray<I, I> &) for the meaning of
+/// @a perm. Equivalent elements are ordered by their indices, i.e. the
+/// result is the same as of MArray::StableSort(const T *, I, TArray<I, I> &).
+/// On failure @a perm is left unchanged.
+///
+/// @param[in] data  - Elements to be sorted.
+/// @param[in] count - Number of the elements in the array.
+/// @param[in, out] perm - Result of sorting.
+/// @param[in] n_threads - Number of threads, <= 0 - number of logical cores.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, class I>
+OKAY ParSort<T, I>::Sort(const T *data, I count, TArray<I, I> &perm,
+                         int n_threads)
+  {
+  Assert(count <= perm.Length());
+  TArray<ValOrd<T, I>, I> sort_arr;
+  if (sort_arr.Allocate(count) != SUCCESS)
+    return FAILURE;
+  for (I i = 0; i < count; i++)
+    sort_arr[i] = ValOrd<T, I>(data[perm[i]], perm[i]);
+  if (ParSort<ValOrd<T, I>, I>::Sort(sort_arr.Data(), count, n_threads) != SUCCESS)
+    return FAILURE;
+  for (I i = 0; i < count; i++)
+    perm[i] = sort_arr[i].m_ord;
+  return SUCCESS;
+  }  // Sort()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Sorts array of integer or floating point elements by the group of threads.
+///
+/// The histograms of all digits of the chunks are built in one parallel
+/// pass; the passes over the digits, which are the same for all elements,
+/// are skipped. Each other pass rebuilds the histograms of its digit for
+/// the current order of the elements (except the first pass), turns them
+/// into the output offsets and scatters the chunks in parallel. Preserves
+/// relative order of the equivalent elements. The elements are of
+/// arithmetic types, so the threads do not throw; on failure the order of
+/// the elements is undefined.
+///
+/// @param[in, out] data - Elements to be sorted.
+/// @param[in] count - Number of the elements in the array.
+/// @param[in] group - Group of threads, not started.
+/// @param[in] n_threads - Number of threads of the group to use, > 0.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, class I>
+OKAY ParSort<T, I>::RadixSort(T *data, I count, ThreadGroup &group,
+                              int n_threads)
+  {
+  typedef typename RadixKeyTraits<T>::UINT UINT;
+  const int N_DIGITS = (int)sizeof(UINT);
+  Assert(n_threads > 0);
+  if (count < PAR_SORT_MIN || n_threads <= 1)
+    return MArray<T, I>::RadixSort(data, count);
+  int n_parts = Min(n_threads, (int)PAR_SORT_MAX_PARTS);
+
+  TArray<T, I> buf;
+  TArray<I, I> hist;
+  if (buf.Allocate(count) != SUCCESS ||
+      hist.Allocate((I)n_parts * N_DIGITS * 256) != SUCCESS)
+    return FAILURE;
+
+  RadixJob job;
+  job.src = data;
+  job.dst = buf.Data();
+  job.count = count;
+  job.n_parts = n_parts;
+  job.hist = hist.Data();
+
+  // Histograms of all digits of the chunks
+  Thread1DRange range(n_threads);
+  job.digit = -1;
+  job.stage = 0;
+  if (RunStage(group, range, n_parts, n_threads, &job, RadixExec) != SUCCESS)
+    return FAILURE;
+  bool first = true;
+  for (int d = 0; d < N_DIGITS; d++)
+    {
+    // Skip the digit, which is the same for all elements
+    bool skip = false;
+    for (int b = 0; b < 256 && !skip; b++)
+      {
+      I n = 0;
+      for (int c = 0; c < n_parts; c++)
+        n += hist[((I)c * N_DIGITS + d) * 256 + b];
+      skip = (n == count);
+      }
+    if (skip)
+      continue;
+    job.digit = d;
+    if (!first)
+      {
+      // Histograms of the digit for the current order of the elements
+      job.stage = 0;
+      if (RunStage(group, range, n_parts, n_threads, &job, RadixExec) != SUCCESS)
+        return FAILURE;
+      }
+    // Output offsets: digits in order, chunks in order inside a digit
+    I pos = 0;
+    for (int b = 0; b < 256; b++)
+      {
+      for (int c = 0; c < n_parts; c++)
+        {
+        I &h = hist[((I)c * N_DIGITS + d) * 256 + b];
+        I n = h;
+        h = pos;
+        pos += n;
+        }
+      }
+    Assert(pos == count);
+    job.stage = 1;
+    if (RunStage(group, range, n_parts, n_threads, &job, RadixExec) != SUCCESS)
+      return FAILURE;
+    first = false;
+    job.src = job.dst;
+    job.dst = (job.dst == data ? buf.Data() : data);
+    }
+  if (job.src != data)
+    memcpy(data, job.src, (SIZE_T)count * sizeof(T));
+  return SUCCESS;
+  }  // RadixSort()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Sorts array of integer or floating point elements by a temporary group
+/// of threads.
+///
+/// See RadixSort(T *, I, ThreadGroup &, int); the group is created for
+/// the call, use that method to sort many arrays by the same group.
+///
+/// @param[in, out] data - Elements to be sorted.
+/// @param[in] count - Number of the elements in the array.
+/// @param[in] n_threads - Number of threads, <= 0 - number of logical cores.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, class I>
+OKAY ParSort<T, I>::RadixSort(T *data, I count, int n_threads)
+  {
+  if (n_threads <= 0)
+    n_threads = NumberOfLogicalCores();
+  if (count < PAR_SORT_MIN || n_threads <= 1)
+    return MArray<T, I>::RadixSort(data, count);
+  ThreadGroup group(n_threads, "ParSort::RadixSort");
+  return RadixSort(data, count, group, n_threads);
+  }  // RadixSort()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Stage of the parallel sort over n_parts chunks.
+///
+/// The chunks (or buckets) 0, ..., n_parts - 1 of the job are processed by
+/// the threads of the group, the call waits for all of them.
+/// @param[in] group - Group of threads, not started.
+/// @param[in, out] range - Range of the chunks.
+/// @param[in] n_parts - Number of the chunks.
+/// @param[in] n_threads - Number of threads of the group to use.
+/// @param[in, out] job - SampleJob or RadixJob.
+/// @param[in] exec - Job of a thread.
+/// @return SUCCESS / FAILURE (exception in a thread).
+template <class T, class I>
+OKAY ParSort<T, I>::RunStage(ThreadGroup &group, Thread1DRange &range,
+                             int n_parts, int n_threads, void *job,
+                             ThreadGroup::ExecFuncType exec)
+  {
+  range.Set(0, n_parts, 1, n_threads);
+  group.Start(job, exec, &range, n_threads);
+  return group.Gathering() != 0 ? FAILURE : SUCCESS;
+  }  // RunStage()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Job of the sample sort for a thread.
+///
+/// Processes the chunks (stages 0, 1) or the buckets (stages 2, 3) of the
+/// range given to the thread.
+/// @param[in, out] shared_param - SampleJob.
+/// @param[in] indiv_param - Thread1DRange::Range of the parts.
+/// @param[in] thread_id - Index of the thread (not used).
+template <class T, class I>
+void ParSort<T, I>::SampleExec(void *shared_param, void *indiv_param,
+                               unsigned int thread_id)
+  {
+  SampleJob &job = *(SampleJob *)shared_param;
+  const Thread1DRange::Range &range = *(const Thread1DRange::Range *)indiv_param;
+  (void)thread_id;
+  for (int part = range.begin; part < range.end; part++)
+    {
+    I beg = (I)((INT64)job.count * part / job.n_parts);
+    I end = (I)((INT64)job.count * (part + 1) / job.n_parts);
+    I *off = job.offsets + (I)part * job.n_parts;
+    switch (job.stage)
+      {
+      case 0:
+        // Count elements of the chunk per bucket
+        for (int b = 0; b < job.n_parts; b++)
+          off[b] = 0;
+        for (I i = beg; i < end; i++)
+          off[SampleBucket(job, job.data[i])]++;
+        break;
+      case 1:
+        // Copy elements of the chunk to the buckets, the input is kept
+        for (I i = beg; i < end; i++)
+          job.temp[off[SampleBucket(job, job.data[i])]++] = job.data[i];
+        break;
+      case 2:
+        // Sort the bucket
+        beg = job.bucket_start[part];
+        end = job.bucket_start[part + 1];
+        MArray<T, I>::QSort(job.temp + beg, end - beg);
+        break;
+      default:
+        // Move the sorted bucket back
+        beg = job.bucket_start[part];
+        end = job.bucket_start[part + 1];
+        for (I i = beg; i < end; i++)
+          job.data[i] = std::move(job.temp[i]);
+        break;
+      }
+    }
+  }  // SampleExec()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Bucket of the element in the sample sort.
+/// @param[in] job - Parameters of the sort.
+/// @param[in] x - Element.
+/// @return Number of the splitters <= @a x.
+template <class T, class I>
+int ParSort<T, I>::SampleBucket(const SampleJob &job, const T &x)
+  {
+  int low = 0, high = job.n_parts - 2;
+  while (low <= high)
+    {
+    int mid = (low + high) >> 1;
+    if (x < job.splitters[mid])
+      high = mid - 1;
+    else
+      low = mid + 1;
+    }
+  return low;
+  }  // SampleBucket()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Job of the radix sort for a thread.
+///
+/// Builds the histograms (stage 0) or scatters the elements (stage 1) of
+/// the chunks of the range given to the thread. Histograms are counted
+/// locally and stored once to avoid false sharing between the threads.
+/// @param[in, out] shared_param - RadixJob.
+/// @param[in] indiv_param - Thread1DRange::Range of the chunks.
+/// @param[in] thread_id - Index of the thread (not used).
+template <class T, class I>
+void ParSort<T, I>::RadixExec(void *shared_param, void *indiv_param,
+                              unsigned int thread_id)
+  {
+  typedef RadixKeyTraits<T> TRAITS;
+  typedef typename TRAITS::UINT UINT;
+  const int N_DIGITS = (int)sizeof(UINT);
+  RadixJob &job = *(RadixJob *)shared_param;
+  const Thread1DRange::Range &range = *(const Thread1DRange::Range *)indiv_param;
+  (void)thread_id;
+  const T *src = job.src;
+  int shift = 8 * job.digit;
+  for (int part = range.begin; part < range.end; part++)
+    {
+    I beg = (I)((INT64)job.count * part / job.n_parts);
+    I end = (I)((INT64)job.count * (part + 1) / job.n_parts);
+    I *hist = job.hist + (I)part * N_DIGITS * 256;
+    if (job.stage == 0 && job.digit < 0)
+      {
+      // Histograms of all digits
+      I h[N_DIGITS * 256];
+      memset(h, 0, sizeof(h));
+      for (I i = beg; i < end; i++)
+        {
+        UINT k = TRAITS::Bits(src[i]);
+        for (int d = 0; d < N_DIGITS; d++)
+          h[d * 256 + (int)((k >> (8 * d)) & 0xFF)]++;
+        }
+      memcpy(hist, h, sizeof(h));
+      }
+    else if (job.stage == 0)
+      {
+      // Histogram of the digit
+      I h[256];
+      memset(h, 0, sizeof(h));
+      for (I i = beg; i < end; i++)
+        h[(int)((TRAITS::Bits(src[i]) >> shift) & 0xFF)]++;
+      memcpy(hist + job.digit * 256, h, sizeof(h));
+      }
+    else
+      {
+      // Scatter the chunk from its offsets
+      I off[256];
+      memcpy(off, hist + job.digit * 256, sizeof(off));
+      T *dst = job.dst;
+      for (I i = beg; i < end; i++)
+        dst[off[(int)((TRAITS::Bits(src[i]) >> shift) & 0xFF)]++] = src[i];
+      }
+    }
+  }  // RadixExec()
+
+INTEGRA_NAMESPACE_END
+
+#endif
@@ -0,0 +1,40 @@
+/// @internal
+/// @file
+///
+/// @brief Definition of TSmallArray template class.
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+/**
+@class TSmallArray base/small_array.hpp
+
+Dynamic array keeping up to N elements inside the object.
+
+TSmallArray is intended for short-lived scratch arrays, whose typical
+length is known: traversal stacks, hit lists, lobes of a sample. Up to N
+elements are kept in the storage inside the object, so such an array on
+the stack of the function does not touch the heap at all. Longer arrays
+spill to a heap block, which grows twice at a time; Resize() with the
+size not greater than N returns the elements to the inline storage.
+
+@code
+   TSmallArray<Lobe, 8> lobes;
+   for (int i = 0; i < n_layers; i++)
+     if (lobes.Emplace(layer[i], wo) != SUCCESS)
+       return FAILURE;
+@endcode
+
+Unlike TArray, only the used elements are constructed, the removed
+elements are destroyed at once, and the object has no memory statistics
+(the heap blocks are rare and short-lived). The elements are relocated
+by memcpy() if they are trivially copyable, otherwise move-constructed.
+
+@param T - Type of the elements; must be default constructible for
+Allocate(), copy constructible for Add(const T &) and Append().
+@param N - Number of the elements in the inline storage, > 0.
+
+The user may not rely on addresses of array elements as they are moved
+by the spilling to the heap, by Resize() and by the move of the array.
+
+@sa TSmallStack, @ref base_mainpage
+**/
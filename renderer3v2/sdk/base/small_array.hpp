@@ -0,0 +1,590 @@
+/// @file
+///
+/// @brief Declaration of TSmallArray template class.
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+#ifndef _ELXX_SMALL_ARRAY_HPP_
+#define _ELXX_SMALL_ARRAY_HPP_
+
+#include <new>
+#include <string.h>
+#include <type_traits>
+#include <utility>
+
+#include "base.hpp"
+#include "user.hpp"
+
+INTEGRA_NAMESPACE_START
+
+/// Dynamic array keeping up to N elements inside the object.
+template <class T, int N>
+class TSmallArray
+  {
+  static_assert(N > 0, "TSmallArray: N must be positive");
+
+  public:
+    /// @name Constructors, destructor
+    //@{
+    /// Default constructor - empty array in the inline storage.
+    inline TSmallArray();
+    /// Copy constructor.
+    inline TSmallArray(const TSmallArray<T, N> &sour);
+    /// Move constructor.
+    inline TSmallArray(TSmallArray<T, N> &&sour);
+    /// Destructor.
+    inline ~TSmallArray();
+    //@}
+
+  public:
+    /// @name Access to elements
+    //@{
+    /// Get a reference to an array element.
+    inline T &operator [](int pos);
+    /// Get a const reference to an array element.
+    inline const T &operator [](int pos) const;
+    /// Get a pointer to the array for reading.
+    inline const T *Data() const;
+    /// Get a pointer to the array for reading and writing.
+    inline T *Data();
+    /// Get a reference to the last element.
+    inline T &Last();
+    /// Get a const reference to the last element.
+    inline const T &Last() const;
+    //@}
+
+  public:
+    /// @name Length and sizes
+    //@{
+    /// Get the number of used elements.
+    inline int Length() const;
+    /// Get the number of elements the array may hold without reallocation.
+    inline int Size() const;
+    /// Check whether the elements are in the inline storage.
+    inline bool IsInline() const;
+    //@}
+
+  public:
+    /// @name Addition and removal of elements
+    //@{
+    /// Add a new element to the end of the array.
+    inline OKAY Add(const T &elem);
+    /// Move a new element to the end of the array.
+    inline OKAY Add(T &&elem);
+    /// Construct a new element at the end of the array.
+    template <class... Args>
+    inline OKAY Emplace(Args &&... args);
+    /// Add new elements to the end of the array.
+    inline OKAY Append(const T *pelem, int len);
+    /// Exclude one element at the specified position.
+    inline void Remove(int pos);
+    /// Remove the last element.
+    inline void RemoveLast();
+    //@}
+
+  public:
+    /// @name Size and length change
+    //@{
+    /// Decrease the length of the array.
+    inline void Truncate(int new_count = 0);
+    /// Change (expand) length of the array.
+    inline OKAY Allocate(int new_len);
+    /// Change the size of the array.
+    inline OKAY Resize(int new_size = 0);
+    //@}
+
+  public:
+    /// @name Assignment
+    //@{
+    /// Copy the array.
+    inline OKAY Copy(const TSmallArray<T, N> &sour);
+    /// Assignment operator.
+    inline TSmallArray<T, N> &operator =(const TSmallArray<T, N> &sour);
+    /// Move assignment operator.
+    inline TSmallArray<T, N> &operator =(TSmallArray<T, N> &&sour);
+    //@}
+
+  private:
+    /// @name Private methods
+    //@{
+    /// Expand the size of the array for the given number of elements.
+    inline OKAY Expand(INT64 needed);
+    /// Move the elements to the new storage of the given size.
+    inline OKAY Relocate(int new_size);
+    /// Pointer to the inline storage.
+    inline T *Inline();
+    /// Allocate raw storage for the elements.
+    inline static T *AllocData(int n);
+    /// Release raw storage of the elements.
+    inline static void FreeData(T *p);
+    //@}
+
+  private:
+    /// @name Private members
+    //@{
+    /// Elements: the inline storage or the heap block.
+    T *data;
+    /// Number of elements in the array.
+    int count;
+    /// Size of the storage, in elements; N for the inline storage.
+    int size;
+    /// Inline storage of N elements, constructed up to count.
+    alignas(T) unsigned char buf[N * sizeof(T)];
+    //@}
+  };  // class TSmallArray
+
+//////////////////////////////////////////////////////////////////////////////
+// Methods of the class TSmallArray
+
+//////////////////////////////////////////////////////////////////////////////
+/// Default constructor - empty array in the inline storage.
+///
+/// No memory is allocated and no elements are constructed.
+template <class T, int N>
+TSmallArray<T, N>::TSmallArray()
+  {
+  data = Inline();
+  count = 0;
+  size = N;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Copy constructor.
+/// @param[in] sour - A source object of the class.
+template <class T, int N>
+TSmallArray<T, N>::TSmallArray(const TSmallArray<T, N> &sour)
+  {
+  data = Inline();
+  count = 0;
+  size = N;
+  (void)Copy(sour);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Move constructor.
+///
+/// The heap block of the source array is taken without copying; the
+/// inline elements are moved one by one. The source array becomes empty.
+/// @param[in, out] sour - A source object of the class.
+template <class T, int N>
+TSmallArray<T, N>::TSmallArray(TSmallArray<T, N> &&sour)
+  {
+  data = Inline();
+  count = 0;
+  size = N;
+  *this = std::move(sour);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+///
+/// The elements are destroyed, the heap block (if any) is released.
+template <class T, int N>
+TSmallArray<T, N>::~TSmallArray()
+  {
+  Resize();
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get a reference to an array element.
+/// @param[in] pos - Index of an element (0 <= pos < Length(), the debug
+/// version asserts it).
+/// @return A reference to the element.
+template <class T, int N>
+T &TSmallArray<T, N>::operator [](int pos)
+  {
+  Assert(pos >= 0 && pos < count);
+  return data[pos];
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get a const reference to an array element.
+/// @param[in] pos - Index of an element (0 <= pos < Length(), the debug
+/// version asserts it).
+/// @return A const reference to the element.
+template <class T, int N>
+const T &TSmallArray<T, N>::operator [](int pos) const
+  {
+  Assert(pos >= 0 && pos < count);
+  return data[pos];
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get a pointer to the array for reading.
+/// @return A pointer to the first element.
+template <class T, int N>
+const T *TSmallArray<T, N>::Data() const
+  {
+  return data;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get a pointer to the array for reading and writing.
+/// @return A pointer to the first element.
+template <class T, int N>
+T *TSmallArray<T, N>::Data()
+  {
+  return data;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get a reference to the last element.
+/// @note The array must not be empty, debug version asserts it.
+/// @return A reference to the last element.
+template <class T, int N>
+T &TSmallArray<T, N>::Last()
+  {
+  Assert(count > 0);
+  return data[count - 1];
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get a const reference to the last element.
+/// @note The array must not be empty, debug version asserts it.
+/// @return A const reference to the last element.
+template <class T, int N>
+const T &TSmallArray<T, N>::Last() const
+  {
+  Assert(count > 0);
+  return data[count - 1];
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the number of used elements.
+/// @return The length of the array.
+template <class T, int N>
+int TSmallArray<T, N>::Length() const
+  {
+  return count;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the number of elements the array may hold without reallocation.
+/// @return N for the inline storage, size of the heap block otherwise.
+template <class T, int N>
+int TSmallArray<T, N>::Size() const
+  {
+  return size;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Check whether the elements are in the inline storage.
+/// @return @b true if no heap memory is used.
+template <class T, int N>
+bool TSmallArray<T, N>::IsInline() const
+  {
+  return data == (const T *)buf;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Add a new element to the end of the array.
+/// @param[in] elem - A new element; it may be an element of this array.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, int N>
+OKAY TSmallArray<T, N>::Add(const T &elem)
+  {
+  if (count < size)
+    {
+    ::new ((void *)(data + count)) T(elem);
+    count++;
+    return SUCCESS;
+    }
+  // The element may be in the storage being relocated
+  T tmp(elem);
+  return Add(std::move(tmp));
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Move a new element to the end of the array.
+/// @param[in, out] elem - A new element, moved into the array.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, int N>
+OKAY TSmallArray<T, N>::Add(T &&elem)
+  {
+  if (count == size && Expand((INT64)count + 1) != SUCCESS)
+    return FAILURE;
+  ::new ((void *)(data + count)) T(std::move(elem));
+  count++;
+  return SUCCESS;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Construct a new element at the end of the array.
+/// @param[in] args - Arguments of the constructor of T.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, int N>
+template <class... Args>
+OKAY TSmallArray<T, N>::Emplace(Args &&... args)
+  {
+  if (count == size && Expand((INT64)count + 1) != SUCCESS)
+    return FAILURE;
+  ::new ((void *)(data + count)) T(std::forward<Args>(args)...);
+  count++;
+  return SUCCESS;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Add new elements to the end of the array.
+/// @param[in] pelem - A pointer to the elements (not of this array).
+/// @param[in] len - The number of the elements, >= 0.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, int N>
+OKAY TSmallArray<T, N>::Append(const T *pelem, int len)
+  {
+  Assert(len >= 0);
+  if (len > size - count && Expand((INT64)count + len) != SUCCESS)
+    return FAILURE;
+  for (int i = 0; i < len; i++)
+    ::new ((void *)(data + count + i)) T(pelem[i]);
+  count += len;
+  return SUCCESS;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Exclude one element at the specified position.
+///
+/// The last element is moved to the position, i.e. the order of the
+/// elements is not kept (as in TArray::Remove()).
+/// @param[in] pos - Index of the element (0 <= pos < Length(), the debug
+/// version asserts it).
+template <class T, int N>
+void TSmallArray<T, N>::Remove(int pos)
+  {
+  Assert(pos >= 0 && pos < count);
+  count--;
+  if (pos < count)
+    data[pos] = std::move(data[count]);
+  data[count].~T();
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Remove the last element.
+/// @note The array must not be empty, debug version asserts it.
+template <class T, int N>
+void TSmallArray<T, N>::RemoveLast()
+  {
+  Assert(count > 0);
+  count--;
+  data[count].~T();
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Decrease the length of the array.
+///
+/// The removed elements are destroyed. Memory is not reallocated.
+/// @param[in] new_count - A new length; must be >= 0 and no more than the
+/// length of array, debug version asserts it.
+template <class T, int N>
+void TSmallArray<T, N>::Truncate(int new_count)
+  {
+  Assert(new_count >= 0 && new_count <= count);
+  if (!std::is_trivially_destructible<T>::value)
+    {
+    for (int i = new_count; i < count; i++)
+      data[i].~T();
+    }
+  count = new_count;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Change (expand) the length of the array.
+///
+/// The added elements are default-initialized (built-in types are not set).
+/// Shorter length truncates the array.
+/// @param[in] new_len - A new length, >= 0.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, int N>
+OKAY TSmallArray<T, N>::Allocate(int new_len)
+  {
+  Assert(new_len >= 0);
+  if (new_len <= count)
+    {
+    Truncate(new_len);
+    return SUCCESS;
+    }
+  if (new_len > size && Expand(new_len) != SUCCESS)
+    return FAILURE;
+  for (int i = count; i < new_len; i++)
+    ::new ((void *)(data + i)) T;
+  count = new_len;
+  return SUCCESS;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Change the size of the array.
+///
+/// The size not greater than N returns the elements to the inline storage
+/// and releases the heap block. If the new size is less than the array
+/// length, the array is truncated.
+/// @param[in] new_size - A new size, in elements, >= 0.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, int N>
+OKAY TSmallArray<T, N>::Resize(int new_size)
+  {
+  Assert(new_size >= 0);
+  if (new_size < count)
+    Truncate(new_size);
+  if (new_size <= N)
+    return IsInline() ? SUCCESS : Relocate(N);
+  if (new_size == size)
+    return SUCCESS;
+  return Relocate(new_size);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Copy the array.
+/// @param[in] sour - A source array.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, int N>
+OKAY TSmallArray<T, N>::Copy(const TSmallArray<T, N> &sour)
+  {
+  if (this == &sour)
+    return SUCCESS;
+  Truncate();
+  return Append(sour.data, sour.count);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Assignment operator.
+/// @param[in] sour - A source array.
+/// @return A reference to this array.
+template <class T, int N>
+TSmallArray<T, N> &TSmallArray<T, N>::operator =(const TSmallArray<T, N> &sour)
+  {
+  (void)Copy(sour);
+  return *this;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Move assignment operator.
+///
+/// The heap block of the source array is taken without copying; the
+/// inline elements are moved one by one. The source array becomes empty.
+/// @param[in, out] sour - A source array.
+/// @return A reference to this array.
+template <class T, int N>
+TSmallArray<T, N> &TSmallArray<T, N>::operator =(TSmallArray<T, N> &&sour)
+  {
+  if (this == &sour)
+    return *this;
+  Resize();
+  if (sour.IsInline())
+    {
+    for (int i = 0; i < sour.count; i++)
+      ::new ((void *)(data + i)) T(std::move(sour.data[i]));
+    count = sour.count;
+    sour.Truncate();
+    return *this;
+    }
+  data = sour.data;
+  count = sour.count;
+  size = sour.size;
+  sour.data = sour.Inline();
+  sour.count = 0;
+  sour.size = N;
+  return *this;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Expand the size of the array for the given number of elements.
+///
+/// The size is at least doubled (up to MAX_INT), so the addition has
+/// constant amortized cost.
+/// @param[in] needed - The number of elements, > Size().
+/// @return SUCCESS / FAILURE (index overflow or memory allocation failure).
+template <class T, int N>
+OKAY TSmallArray<T, N>::Expand(INT64 needed)
+  {
+  Assert(needed > size);
+  if (needed > MAX_INT)
+    return User()->InternalError("TSmallArray: size=%lld (index overflow?)",
+      (long long)needed);
+  int new_size = size > MAX_INT / 2 ? MAX_INT : 2 * size;
+  return Relocate(Max((int)needed, new_size));
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Move the elements to the new storage of the given size.
+/// @param[in] new_size - A new size, >= Length(); N means the inline storage.
+/// @return SUCCESS / FAILURE (memory allocation failure, the array is not
+/// changed).
+template <class T, int N>
+OKAY TSmallArray<T, N>::Relocate(int new_size)
+  {
+  Assert(new_size >= count);
+  T *new_data = new_size <= N ? Inline() : AllocData(new_size);
+  if (new_data == NULL)
+    return User()->ErrorNoMemory((INT64)new_size * sizeof(T));
+  if (new_data != data)
+    {
+    if (std::is_trivially_copyable<T>::value)
+      {
+      if (count > 0)
+        memcpy((void *)new_data, (const void *)data, count * sizeof(T));
+      }
+    else
+      {
+      for (int i = 0; i < count; i++)
+        {
+        ::new ((void *)(new_data + i)) T(std::move(data[i]));
+        data[i].~T();
+        }
+      }
+    if (!IsInline())
+      FreeData(data);
+    }
+  data = new_data;
+  size = Max(new_size, N);
+  return SUCCESS;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Pointer to the inline storage.
+/// @return A pointer to the first inline element.
+template <class T, int N>
+T *TSmallArray<T, N>::Inline()
+  {
+  return (T *)buf;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Allocate raw storage for the elements.
+///
+/// Memory is aligned for T; elements are not constructed.
+/// @param[in] n - The number of elements, > 0.
+/// @return A pointer to the storage or NULL (memory allocation failure or
+/// size out of the address space).
+template <class T, int N>
+T *TSmallArray<T, N>::AllocData(int n)
+  {
+  if ((UINT64)n > (MAX_SIZE_T - alignof(T) - sizeof(void *)) / sizeof(T))
+    return NULL;
+  SIZE_T bytes = (SIZE_T)n * sizeof(T);
+  if (alignof(T) <= 2 * sizeof(void *))
+    return (T *)malloc(bytes);
+  // Over-aligned type: the block pointer is kept just before the data
+  char *block = (char *)malloc(bytes + alignof(T) + sizeof(void *));
+  if (block == NULL)
+    return NULL;
+  SIZE_T addr = ((SIZE_T)block + sizeof(void *) + alignof(T) - 1) &
+                ~(SIZE_T)(alignof(T) - 1);
+  ((void **)addr)[-1] = block;
+  return (T *)addr;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Release raw storage of the elements.
+/// @param[in] p - A pointer returned by AllocData() or NULL.
+template <class T, int N>
+void TSmallArray<T, N>::FreeData(T *p)
+  {
+  if (p == NULL)
+    return;
+  if (alignof(T) <= 2 * sizeof(void *))
+    free((void *)p);
+  else
+    free(((void **)p)[-1]);
+  }
+
+INTEGRA_NAMESPACE_END
+#endif
@@ -0,0 +1,41 @@
+/// @internal
+/// @file
+///
+/// @brief Definition of SoAArray3 template class.
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+/**
+@class SoAArray3 base/soa_array.hpp
+
+Array of 3D points (vectors) as separate streams of coordinates.
+
+The geometry is usually kept as arrays of TPoint3 / TVect3 structures
+(array of structures, AoS), where x, y, z of a point are adjacent. The
+batch processing of such arrays is hard to vectorize: a SIMD register has
+to gather the same coordinate of several points. SoAArray3 keeps all x
+coordinates, then all y, then all z (structure of arrays, SoA), so the
+same operation is applied to the adjacent elements of a stream.
+
+Each stream is aligned by ALIGN (64) bytes and padded to the multiple of
+LANE elements (16 floats, 8 doubles), i.e. the full SIMD vectors may be
+loaded up to PaddedLength(). The padding is filled by the last element,
+so it does not change the reductions like the bounding box.
+
+The batch operations work on the views - the stream pointers with the
+length - so they may be applied to the streams of other containers too:
+- SoAPointTransform(), SoAVectorTransform() - same as
+  TMatrix43::PointTransformed(), TMatrix43::VectorTransformed();
+- SoABBox() - bounding box of the points.
+
+@code
+   SoAArray3f soa;
+   if (soa.Set(mesh_points) != SUCCESS)  // TArray<Point3f>
+     return FAILURE;
+   SoAPointTransform(tm, soa.GetView(), soa.GetView());
+   BBox3f bbox = soa.BBox();
+   soa.Get(mesh_points);
+@endcode
+
+@param T - Type of the coordinates (float, double).
+*/
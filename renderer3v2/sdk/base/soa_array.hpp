@@ -0,0 +1,717 @@
+/// @file
+///
+/// @brief Declaration of SoAArray3 template class.
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+#ifndef _ELXX_SOA_ARRAY_HPP_
+#define _ELXX_SOA_ARRAY_HPP_
+
+#include <string.h>
+
+#include <math/vect3.hpp>
+#include <math/matrix43.hpp>
+
+#include "arrays.hpp"
+
+INTEGRA_NAMESPACE_START
+
+/// Array of 3D points (vectors) as separate streams of x, y, z coordinates.
+template <class T>
+class SoAArray3
+  {
+  public:
+    /// @name Constants
+    //@{
+    enum
+      {
+      /// Alignment of the streams in bytes (cache line, AVX-512 vector).
+      ALIGN = 64,
+      /// Number of the elements in the aligned block; the streams are padded to it.
+      LANE = ALIGN / sizeof(T)
+      };
+    //@}
+
+    /// Modifiable streams of the array.
+    struct View
+      {
+      /// X coordinates.
+      T *x;
+      /// Y coordinates.
+      T *y;
+      /// Z coordinates.
+      T *z;
+      /// Number of the elements.
+      int count;
+      };
+
+    /// Read-only streams of the array.
+    struct ConstView
+      {
+      /// Default constructor, no initialization.
+      inline ConstView() {}
+      /// Conversion of the modifiable streams.
+      inline ConstView(const View &v) : x(v.x), y(v.y), z(v.z), count(v.count) {}
+      /// X coordinates.
+      const T *x;
+      /// Y coordinates.
+      const T *y;
+      /// Z coordinates.
+      const T *z;
+      /// Number of the elements.
+      int count;
+      };
+
+  public:
+    /// @name Constructors, destructor
+    //@{
+    /// Default constructor - empty array.
+    inline SoAArray3();
+    /// Destructor.
+    inline ~SoAArray3();
+    //@}
+
+    /// @name Size
+    //@{
+    /// Allocate the array of the given length, the values are undefined.
+    inline OKAY Allocate(int count);
+    /// Change the length of the array, the values are kept.
+    inline OKAY SetLength(int count);
+    /// Remove all elements and free the memory.
+    inline void Resize();
+    /// Number of the elements.
+    inline int Length() const;
+    /// Length of the streams, padded to LANE.
+    inline int PaddedLength() const;
+    //@}
+
+    /// @name Streams access
+    //@{
+    /// X coordinates.
+    inline T *X();
+    /// X coordinates.
+    inline const T *X() const;
+    /// Y coordinates.
+    inline T *Y();
+    /// Y coordinates.
+    inline const T *Y() const;
+    /// Z coordinates.
+    inline T *Z();
+    /// Z coordinates.
+    inline const T *Z() const;
+    /// Coordinates of the given axis (0, 1, 2).
+    inline T *Stream(int axis);
+    /// Coordinates of the given axis (0, 1, 2).
+    inline const T *Stream(int axis) const;
+    /// Modifiable streams for the batch operations.
+    inline View GetView();
+    /// Read-only streams for the batch operations.
+    inline ConstView GetView() const;
+    //@}
+
+    /// @name Elements access
+    //@{
+    /// Get the point.
+    inline TPoint3<T> Point(int i) const;
+    /// Get the vector.
+    inline TVect3<T> Vector(int i) const;
+    /// Set the point.
+    inline void SetPoint(int i, const TPoint3<T> &p);
+    /// Set the vector.
+    inline void SetVector(int i, const TVect3<T> &v);
+    /// Fill the padding of the streams by the last element.
+    inline void FillPadding();
+    //@}
+
+    /// @name Conversion from / to arrays of structures
+    //@{
+    /// Set the array from the points.
+    inline OKAY Set(const TPoint3<T> *points, int count);
+    /// Set the array from the points.
+    inline OKAY Set(const TArray<TPoint3<T> > &points);
+    /// Set the array from the vectors.
+    inline OKAY Set(const TVect3<T> *vectors, int count);
+    /// Set the array from the vectors.
+    inline OKAY Set(const TArray<TVect3<T> > &vectors);
+    /// Get the points.
+    inline void Get(TPoint3<T> *points) const;
+    /// Get the points.
+    inline OKAY Get(TArray<TPoint3<T> > &points) const;
+    /// Get the vectors.
+    inline void Get(TVect3<T> *vectors) const;
+    /// Get the vectors.
+    inline OKAY Get(TArray<TVect3<T> > &vectors) const;
+    //@}
+
+    /// @name Batch operations
+    //@{
+    /// Transform the points.
+    inline void PointTransform(const TMatrix43<T> &tm);
+    /// Transform the vectors.
+    inline void VectorTransform(const TMatrix43<T> &tm);
+    /// Bounding box of the points.
+    inline BBox3<T> BBox() const;
+    //@}
+
+  private:
+    /// Aligned block of the stream.
+    struct alignas(ALIGN) Lane
+      {
+      /// Elements of the block.
+      T v[LANE];
+      };
+
+  private:
+    /// Streams x, y, z one after another, m_stride blocks each.
+    TArray<Lane> m_lanes;
+    /// Number of the elements.
+    int m_count;
+    /// Number of the blocks in a stream.
+    int m_stride;
+  };  // class SoAArray3
+
+/// Array of float points as separate streams of x, y, z coordinates.
+typedef SoAArray3<float> SoAArray3f;
+/// Array of double points as separate streams of x, y, z coordinates.
+typedef SoAArray3<double> SoAArray3d;
+
+//////////////////////////////////////////////////////////////////////////////
+/// Transform the points of the streams.
+///
+/// Same as TMatrix43::PointTransformed() for each point; @a src and @a dst
+/// may be the same streams.
+/// @param[in] tm - Transformation matrix.
+/// @param[in] src - Points to transform.
+/// @param[out] dst - Transformed points, at least src.count elements.
+template <class T>
+inline void SoAPointTransform(const TMatrix43<T> &tm,
+                              const typename SoAArray3<T>::ConstView &src,
+                              const typename SoAArray3<T>::View &dst)
+  {
+  Assert(dst.count >= src.count);
+  const T m00 = tm[0][0], m01 = tm[0][1], m02 = tm[0][2];
+  const T m10 = tm[1][0], m11 = tm[1][1], m12 = tm[1][2];
+  const T m20 = tm[2][0], m21 = tm[2][1], m22 = tm[2][2];
+  const T t0 = tm[3][0], t1 = tm[3][1], t2 = tm[3][2];
+  for (int i = 0; i < src.count; i++)
+    {
+    T x = src.x[i], y = src.y[i], z = src.z[i];
+    dst.x[i] = x * m00 + y * m10 + z * m20 + t0;
+    dst.y[i] = x * m01 + y * m11 + z * m21 + t1;
+    dst.z[i] = x * m02 + y * m12 + z * m22 + t2;
+    }
+  }  // SoAPointTransform()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Transform the vectors of the streams.
+///
+/// Same as TMatrix43::VectorTransformed() for each vector (the translation
+/// is ignored); @a src and @a dst may be the same streams.
+/// @param[in] tm - Transformation matrix.
+/// @param[in] src - Vectors to transform.
+/// @param[out] dst - Transformed vectors, at least src.count elements.
+template <class T>
+inline void SoAVectorTransform(const TMatrix43<T> &tm,
+                               const typename SoAArray3<T>::ConstView &src,
+                               const typename SoAArray3<T>::View &dst)
+  {
+  Assert(dst.count >= src.count);
+  const T m00 = tm[0][0], m01 = tm[0][1], m02 = tm[0][2];
+  const T m10 = tm[1][0], m11 = tm[1][1], m12 = tm[1][2];
+  const T m20 = tm[2][0], m21 = tm[2][1], m22 = tm[2][2];
+  for (int i = 0; i < src.count; i++)
+    {
+    T x = src.x[i], y = src.y[i], z = src.z[i];
+    dst.x[i] = x * m00 + y * m10 + z * m20;
+    dst.y[i] = x * m01 + y * m11 + z * m21;
+    dst.z[i] = x * m02 + y * m12 + z * m22;
+    }
+  }  // SoAVectorTransform()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Bounding box of the points of the streams.
+///
+/// Each coordinate is reduced by its own loop into LANE independent
+/// minimums and maximums, so the loop over the full blocks is vectorized
+/// without the reordering of the floating point operations.
+/// @param[in] src - Points.
+/// @param[out] bbox - Bounding box of the points, empty if there are no points.
+template <class T>
+inline void SoABBox(const typename SoAArray3<T>::ConstView &src, BBox3<T> &bbox)
+  {
+  const int W = SoAArray3<T>::LANE;
+  if (src.count <= 0)
+    {
+    bbox.SetEmpty();
+    return;
+    }
+  const T *stream[3] = { src.x, src.y, src.z };
+  int n_full = src.count / W * W;
+  for (int axis = 0; axis < 3; axis++)
+    {
+    const T *s = stream[axis];
+    T lo[W], hi[W];
+    for (int j = 0; j < W; j++)
+      lo[j] = hi[j] = s[0];
+    for (int i = 0; i < n_full; i += W)
+      {
+      for (int j = 0; j < W; j++)
+        {
+        lo[j] = s[i + j] < lo[j] ? s[i + j] : lo[j];
+        hi[j] = hi[j] < s[i + j] ? s[i + j] : hi[j];
+        }
+      }
+    for (int i = n_full; i < src.count; i++)
+      {
+      lo[0] = s[i] < lo[0] ? s[i] : lo[0];
+      hi[0] = hi[0] < s[i] ? s[i] : hi[0];
+      }
+    for (int j = 1; j < W; j++)
+      {
+      lo[0] = lo[j] < lo[0] ? lo[j] : lo[0];
+      hi[0] = hi[0] < hi[j] ? hi[j] : hi[0];
+      }
+    bbox.vmin[axis] = lo[0];
+    bbox.vmax[axis] = hi[0];
+    }
+  }  // SoABBox()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Default constructor - empty array.
+template <class T>
+SoAArray3<T>::SoAArray3()
+  {
+  m_count = 0;
+  m_stride = 0;
+  }  // SoAArray3()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+template <class T>
+SoAArray3<T>::~SoAArray3()
+  {
+  }  // ~SoAArray3()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Allocate the array of the given length, the values are undefined.
+///
+/// The memory is reallocated only if the padded length is changed.
+/// @param[in] count - New number of the elements.
+/// @return SUCCESS / FAILURE (not enough memory).
+template <class T>
+OKAY SoAArray3<T>::Allocate(int count)
+  {
+  Assert(count >= 0);
+  int stride = (count + LANE - 1) / LANE;
+  if (stride != m_stride)
+    {
+    if (m_lanes.Allocate(3 * stride) != SUCCESS)
+      {
+      m_count = m_stride = 0;
+      return FAILURE;
+      }
+    m_stride = stride;
+    }
+  m_count = count;
+  return SUCCESS;
+  }  // Allocate()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Change the length of the array, the values are kept.
+///
+/// The added elements and the padding are set to the last element kept
+/// (to zeroes if the array was empty).
+/// @param[in] count - New number of the elements.
+/// @return SUCCESS / FAILURE (not enough memory, the array is not changed).
+template <class T>
+OKAY SoAArray3<T>::SetLength(int count)
+  {
+  Assert(count >= 0);
+  int stride = (count + LANE - 1) / LANE;
+  int kept = Min(count, m_count);
+  if (stride != m_stride)
+    {
+    TArray<Lane> lanes;
+    if (lanes.Allocate(3 * stride) != SUCCESS)
+      return FAILURE;
+    for (int axis = 0; axis < 3 && kept > 0; axis++)
+      memcpy(lanes[axis * stride].v, Stream(axis), kept * sizeof(T));
+    TArray<Lane>::SwapArrays(lanes, m_lanes);
+    m_stride = stride;
+    }
+  m_count = kept;
+  if (m_count == 0 && count > 0)
+    {
+    m_count = 1;
+    SetVector(0, TVect3<T>((T)0));
+    }
+  int last = m_count - 1;
+  m_count = count;
+  for (int axis = 0; axis < 3 && last >= 0; axis++)
+    {
+    T *s = Stream(axis);
+    for (int i = last + 1; i < count; i++)
+      s[i] = s[last];
+    }
+  FillPadding();
+  return SUCCESS;
+  }  // SetLength()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Remove all elements and free the memory.
+template <class T>
+void SoAArray3<T>::Resize()
+  {
+  m_lanes.Resize();
+  m_count = m_stride = 0;
+  }  // Resize()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Number of the elements.
+/// @return Number of the elements.
+template <class T>
+int SoAArray3<T>::Length() const
+  {
+  return m_count;
+  }  // Length()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Length of the streams, padded to LANE.
+///
+/// The elements of the streams up to this length may be read (e.g. by the
+/// full SIMD vectors); the padding is valid after FillPadding().
+/// @return Padded length of the streams.
+template <class T>
+int SoAArray3<T>::PaddedLength() const
+  {
+  return m_stride * LANE;
+  }  // PaddedLength()
+
+//////////////////////////////////////////////////////////////////////////////
+/// X coordinates.
+/// @return Pointer to the stream, aligned by ALIGN bytes.
+template <class T>
+T *SoAArray3<T>::X()
+  {
+  return Stream(0);
+  }  // X()
+
+//////////////////////////////////////////////////////////////////////////////
+/// X coordinates.
+/// @return Pointer to the stream, aligned by ALIGN bytes.
+template <class T>
+const T *SoAArray3<T>::X() const
+  {
+  return Stream(0);
+  }  // X()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Y coordinates.
+/// @return Pointer to the stream, aligned by ALIGN bytes.
+template <class T>
+T *SoAArray3<T>::Y()
+  {
+  return Stream(1);
+  }  // Y()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Y coordinates.
+/// @return Pointer to the stream, aligned by ALIGN bytes.
+template <class T>
+const T *SoAArray3<T>::Y() const
+  {
+  return Stream(1);
+  }  // Y()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Z coordinates.
+/// @return Pointer to the stream, aligned by ALIGN bytes.
+template <class T>
+T *SoAArray3<T>::Z()
+  {
+  return Stream(2);
+  }  // Z()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Z coordinates.
+/// @return Pointer to the stream, aligned by ALIGN bytes.
+template <class T>
+const T *SoAArray3<T>::Z() const
+  {
+  return Stream(2);
+  }  // Z()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Coordinates of the given axis.
+/// @param[in] axis - Axis: 0 - x, 1 - y, 2 - z.
+/// @return Pointer to the stream, aligned by ALIGN bytes (NULL for the
+/// empty array).
+template <class T>
+T *SoAArray3<T>::Stream(int axis)
+  {
+  Assert(axis >= 0 && axis < 3);
+  return m_stride > 0 ? m_lanes[axis * m_stride].v : NULL;
+  }  // Stream()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Coordinates of the given axis.
+/// @param[in] axis - Axis: 0 - x, 1 - y, 2 - z.
+/// @return Pointer to the stream, aligned by ALIGN bytes (NULL for the
+/// empty array).
+template <class T>
+const T *SoAArray3<T>::Stream(int axis) const
+  {
+  Assert(axis >= 0 && axis < 3);
+  return m_stride > 0 ? m_lanes[axis * m_stride].v : NULL;
+  }  // Stream()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Modifiable streams for the batch operations.
+/// @return Streams and length of the array.
+template <class T>
+typename SoAArray3<T>::View SoAArray3<T>::GetView()
+  {
+  View view;
+  view.x = X();
+  view.y = Y();
+  view.z = Z();
+  view.count = m_count;
+  return view;
+  }  // GetView()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Read-only streams for the batch operations.
+/// @return Streams and length of the array.
+template <class T>
+typename SoAArray3<T>::ConstView SoAArray3<T>::GetView() const
+  {
+  ConstView view;
+  view.x = X();
+  view.y = Y();
+  view.z = Z();
+  view.count = m_count;
+  return view;
+  }  // GetView()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the point.
+/// @param[in] i - Index of the element.
+/// @return Point.
+template <class T>
+TPoint3<T> SoAArray3<T>::Point(int i) const
+  {
+  Assert(i >= 0 && i < m_count);
+  return TPoint3<T>(X()[i], Y()[i], Z()[i]);
+  }  // Point()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the vector.
+/// @param[in] i - Index of the element.
+/// @return Vector.
+template <class T>
+TVect3<T> SoAArray3<T>::Vector(int i) const
+  {
+  Assert(i >= 0 && i < m_count);
+  return TVect3<T>(X()[i], Y()[i], Z()[i]);
+  }  // Vector()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Set the point.
+/// @param[in] i - Index of the element.
+/// @param[in] p - Point.
+template <class T>
+void SoAArray3<T>::SetPoint(int i, const TPoint3<T> &p)
+  {
+  Assert(i >= 0 && i < m_count);
+  X()[i] = p.x;
+  Y()[i] = p.y;
+  Z()[i] = p.z;
+  }  // SetPoint()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Set the vector.
+/// @param[in] i - Index of the element.
+/// @param[in] v - Vector.
+template <class T>
+void SoAArray3<T>::SetVector(int i, const TVect3<T> &v)
+  {
+  Assert(i >= 0 && i < m_count);
+  X()[i] = v.x;
+  Y()[i] = v.y;
+  Z()[i] = v.z;
+  }  // SetVector()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Fill the padding of the streams by the last element.
+///
+/// The padded elements do not change the bounding box and are harmless for
+/// the arithmetics, so the kernels may process the full LANE blocks.
+/// Set() and SetLength() fill the padding; call it after the last element
+/// is changed directly.
+template <class T>
+void SoAArray3<T>::FillPadding()
+  {
+  if (m_count == 0)
+    return;
+  int padded = PaddedLength();
+  for (int axis = 0; axis < 3; axis++)
+    {
+    T *s = Stream(axis);
+    for (int i = m_count; i < padded; i++)
+      s[i] = s[m_count - 1];
+    }
+  }  // FillPadding()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Set the array from the points.
+/// @param[in] points - Points.
+/// @param[in] count - Number of the points.
+/// @return SUCCESS / FAILURE (not enough memory).
+template <class T>
+OKAY SoAArray3<T>::Set(const TPoint3<T> *points, int count)
+  {
+  if (Allocate(count) != SUCCESS)
+    return FAILURE;
+  T *x = X(), *y = Y(), *z = Z();
+  for (int i = 0; i < count; i++)
+    {
+    x[i] = points[i].x;
+    y[i] = points[i].y;
+    z[i] = points[i].z;
+    }
+  FillPadding();
+  return SUCCESS;
+  }  // Set()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Set the array from the points.
+/// @param[in] points - Points.
+/// @return SUCCESS / FAILURE (not enough memory).
+template <class T>
+OKAY SoAArray3<T>::Set(const TArray<TPoint3<T> > &points)
+  {
+  return Set(points.Data(), points.Length());
+  }  // Set()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Set the array from the vectors.
+/// @param[in] vectors - Vectors.
+/// @param[in] count - Number of the vectors.
+/// @return SUCCESS / FAILURE (not enough memory).
+template <class T>
+OKAY SoAArray3<T>::Set(const TVect3<T> *vectors, int count)
+  {
+  if (Allocate(count) != SUCCESS)
+    return FAILURE;
+  T *x = X(), *y = Y(), *z = Z();
+  for (int i = 0; i < count; i++)
+    {
+    x[i] = vectors[i].x;
+    y[i] = vectors[i].y;
+    z[i] = vectors[i].z;
+    }
+  FillPadding();
+  return SUCCESS;
+  }  // Set()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Set the array from the vectors.
+/// @param[in] vectors - Vectors.
+/// @return SUCCESS / FAILURE (not enough memory).
+template <class T>
+OKAY SoAArray3<T>::Set(const TArray<TVect3<T> > &vectors)
+  {
+  return Set(vectors.Data(), vectors.Length());
+  }  // Set()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the points.
+/// @param[out] points - Points, Length() elements.
+template <class T>
+void SoAArray3<T>::Get(TPoint3<T> *points) const
+  {
+  const T *x = X(), *y = Y(), *z = Z();
+  for (int i = 0; i < m_count; i++)
+    {
+    points[i].x = x[i];
+    points[i].y = y[i];
+    points[i].z = z[i];
+    }
+  }  // Get()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the points.
+/// @param[out] points - Points, the array is reallocated to Length().
+/// @return SUCCESS / FAILURE (not enough memory).
+template <class T>
+OKAY SoAArray3<T>::Get(TArray<TPoint3<T> > &points) const
+  {
+  if (points.Allocate(m_count) != SUCCESS)
+    return FAILURE;
+  Get(points.Data());
+  return SUCCESS;
+  }  // Get()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the vectors.
+/// @param[out] vectors - Vectors, Length() elements.
+template <class T>
+void SoAArray3<T>::Get(TVect3<T> *vectors) const
+  {
+  const T *x = X(), *y = Y(), *z = Z();
+  for (int i = 0; i < m_count; i++)
+    {
+    vectors[i].x = x[i];
+    vectors[i].y = y[i];
+    vectors[i].z = z[i];
+    }
+  }  // Get()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the vectors.
+/// @param[out] vectors - Vectors, the array is reallocated to Length().
+/// @return SUCCESS / FAILURE (not enough memory).
+template <class T>
+OKAY SoAArray3<T>::Get(TArray<TVect3<T> > &vectors) const
+  {
+  if (vectors.Allocate(m_count) != SUCCESS)
+    return FAILURE;
+  Get(vectors.Data());
+  return SUCCESS;
+  }  // Get()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Transform the points, see SoAPointTransform().
+/// @param[in] tm - Transformation matrix.
+template <class T>
+void SoAArray3<T>::PointTransform(const TMatrix43<T> &tm)
+  {
+  View view = GetView();
+  SoAPointTransform(tm, view, view);
+  FillPadding();
+  }  // PointTransform()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Transform the vectors, see SoAVectorTransform().
+/// @param[in] tm - Transformation matrix.
+template <class T>
+void SoAArray3<T>::VectorTransform(const TMatrix43<T> &tm)
+  {
+  View view = GetView();
+  SoAVectorTransform(tm, view, view);
+  FillPadding();
+  }  // VectorTransform()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Bounding box of the points, see SoABBox().
+/// @return Bounding box, empty for the empty array.
+template <class T>
+BBox3<T> SoAArray3<T>::BBox() const
+  {
+  BBox3<T> bbox;
+  SoABBox(GetView(), bbox);
+  return bbox;
+  }  // BBox()
+
+INTEGRA_NAMESPACE_END
+#endif
@@ -34,3 +34,30 @@ placeholder elements are added when the stack area is expanded.
 @internal
 The current implementation of TStack object is based on TArray class.
 **/
+
+/**
+@class TSmallStack base/stack.hpp
+
+Stack keeping up to N elements inside the object.
+
+The template class TSmallStack has the interface of TStack, but the
+elements are kept by TSmallArray: up to N elements are stored inside the
+object, so a traversal stack of the typical depth on the stack of the
+function never allocates memory; a deeper stack spills to the heap.
+
+@code
+   TSmallStack<const Node *, 64> todo;
+   todo.Push(root);
+   const Node *node;
+   while (!todo.IsEmpty())
+     {
+     todo.Pop(node);
+     ...
+     }
+@endcode
+
+@param[in] T - The type of elements, which will be stored in the stack.
+@param[in] N - The number of elements kept inside the object.
+
+@sa @ref base_mainpage
+**/
@@ -11,6 +11,7 @@
 #define _KLBC_STACK_HPP_
 
 #include "arrays.hpp"
+#include "small_array.hpp"
 
 INTEGRA_NAMESPACE_START
 
@@ -65,6 +66,52 @@ class TStack
     //@}
   }; // class TStack
 
+/// Stack keeping up to N elements inside the object.
+template <class T, int N>
+class TSmallStack
+  {
+  public:
+    /// @name Constructors, destructor
+    //@{
+    /// Default constructor.
+    inline TSmallStack();
+    /// Destructor.
+    inline ~TSmallStack();
+    //@}
+
+  public:
+    /// @name Access to elements
+    //@{
+    /// Push an element.
+    inline OKAY Push(const T &elem);
+    /// Push an element by moving it.
+    inline OKAY Push(T &&elem);
+    /// Push an empty element.
+    inline OKAY Push();
+    /// Access the top element.
+    inline T &Top();
+    /// Access the top element.
+    inline const T &Top() const;
+    /// Pop the stack.
+    inline OKAY Pop(T &elem);
+    /// Pop the stack.
+    inline OKAY Pop();
+    /// Clear the stack.
+    inline void Clear();
+    /// Check whether the stack is empty.
+    inline bool IsEmpty() const;
+    /// Get the number of elements in the stack.
+    inline int Length() const;
+    //@}
+
+  protected:
+    /// @name Protected members
+    //@{
+    /// The array of elements.
+    TSmallArray<T, N> arr;
+    //@}
+  }; // class TSmallStack
+
 //////////////////////////////////////////////////////////////////////////////
 // Inline methods of TStack class
 
@@ -196,5 +243,132 @@ bool TStack<T>::IsEmpty() const
   return (arr.Length() == 0);
   }
 
+//////////////////////////////////////////////////////////////////////////////
+// Inline methods of TSmallStack class
+
+//////////////////////////////////////////////////////////////////////////////
+/// Default constructor.
+///
+/// No memory is allocated: up to N elements are kept inside the object.
+template <class T, int N>
+TSmallStack<T, N>::TSmallStack()
+  {
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+template <class T, int N>
+TSmallStack<T, N>::~TSmallStack()
+  {
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Push an element.
+/// @param[in] elem - A new element to push into the stack.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, int N>
+OKAY TSmallStack<T, N>::Push(const T &elem)
+  {
+  return arr.Add(elem);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Push an element by moving it.
+/// @param[in, out] elem - A new element to move into the stack.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, int N>
+OKAY TSmallStack<T, N>::Push(T &&elem)
+  {
+  return arr.Add(std::move(elem));
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Push an empty element.
+///
+/// The method pushes an empty element that may be filled later directly on
+/// the stack using the Top() method.
+/// @return SUCCESS / FAILURE (memory allocation failure).
+template <class T, int N>
+OKAY TSmallStack<T, N>::Push()
+  {
+  return arr.Allocate(arr.Length() + 1);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Access the top element.
+/// @note The stack must not be empty, debug version asserts it.
+/// @return A reference to the top element.
+template <class T, int N>
+T &TSmallStack<T, N>::Top()
+  {
+  Assert(!IsEmpty());
+  return arr.Last();
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Access the top element.
+/// @note The stack must not be empty, debug version asserts it.
+/// @return A reference to the top element.
+template <class T, int N>
+const T &TSmallStack<T, N>::Top() const
+  {
+  Assert(!IsEmpty());
+  return arr.Last();
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Pop the stack.
+/// @note The stack must not be empty, debug version asserts it.
+/// @param[out] elem - An element popped from the stack (moved).
+/// @return SUCCESS.
+template <class T, int N>
+OKAY TSmallStack<T, N>::Pop(T &elem)
+  {
+  Assert(!IsEmpty());
+  elem = std::move(arr.Last());
+  arr.RemoveLast();
+  return SUCCESS;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Pop the stack.
+/// @note The stack must not be empty, debug version asserts it.
+/// @return SUCCESS.
+template <class T, int N>
+OKAY TSmallStack<T, N>::Pop()
+  {
+  Assert(!IsEmpty());
+  arr.RemoveLast();
+  return SUCCESS;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Clear the stack.
+///
+/// The method removes all elements from the stack. Memory is not reallocated.
+template <class T, int N>
+void TSmallStack<T, N>::Clear()
+  {
+  arr.Truncate();
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Check whether the stack is empty.
+/// @return @b true if the stack is empty; @b false otherwise.
+template <class T, int N>
+bool TSmallStack<T, N>::IsEmpty() const
+  {
+  return (arr.Length() == 0);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the number of elements in the stack.
+/// @return The number of elements.
+template <class T, int N>
+int TSmallStack<T, N>::Length() const
+  {
+  return arr.Length();
+  }
+
 INTEGRA_NAMESPACE_END
 #endif //  _KLBC_STACK_HPP_
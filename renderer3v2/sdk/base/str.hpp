@@ -27,7 +27,7 @@ INTEGRA_NAMESPACE_START
 
 class Serializer;
 class Time;
-template <class T> class TArray;
+template <class T, class I = int> class TArray;
 
 /// Processing of strings.
 class Str
@@ -56,6 +56,8 @@ class Str
     INTAPI_BASE Str(const char *ch, int n);
     /// Copy constructor.
     INTAPI_BASE Str(const Str &s);
+    /// Move constructor.
+    inline Str(Str &&s);
     /// Destructor.
     INTAPI_BASE ~Str();
     //@}
@@ -87,6 +89,8 @@ class Str
     INTAPI_BASE void operator =(const char *s);
     /// Assignment operator.
     inline void operator =(const Str &s);
+    /// Move assignment operator.
+    inline void operator =(Str &&s);
     /// Assignment operator.
     INTAPI_BASE void Set(const char *ch, int n);
     /// Concatenation and assignment operator.
@@ -646,6 +650,17 @@ Str::Str()
   buf = NULL;
   }
 
+//////////////////////////////////////////////////////////////////////////////
+/// Move constructor.
+///
+/// The buffer is taken from the source string, which becomes NULL.
+/// @param[in, out] s - A source string.
+Str::Str(Str &&s)
+  {
+  buf = s.buf;
+  s.buf = NULL;
+  }
+
 //////////////////////////////////////////////////////////////////////////////
 /// Get reference to character.
 /// @note String may not be NULL, debug version asserts it.
@@ -710,6 +725,21 @@ void Str::operator =(const Str &s)
   *this = s.buf;
   }
 
+//////////////////////////////////////////////////////////////////////////////
+/// Move assignment operator.
+///
+/// The buffer is taken from the source string, which becomes NULL.
+/// @param[in, out] s - A source string.
+void Str::operator =(Str &&s)
+  {
+  if (&s == this)
+    return;
+  if (buf != NULL)
+    free(buf);
+  buf = s.buf;
+  s.buf = NULL;
+  }
+
 //////////////////////////////////////////////////////////////////////////////
 /// Equal.
 ///
@@ -70,33 +70,33 @@ class ThreadGroup
   public:
 
     /// Constructor                                                             
-    ThreadGroup(int num, const char *name = NULL, int numa_node_id = -1);
+    INTAPI_BASE ThreadGroup(int num, const char *name = NULL, int numa_node_id = -1);
     /// Destructor
-    ~ThreadGroup();
+    INTAPI_BASE ~ThreadGroup();
     /// Start thread group anisochronously
-    void Start(void *shared_params, void *next_shared_params, int used_tr_num = 0);
+    INTAPI_BASE void Start(void *shared_params, void *next_shared_params, int used_tr_num = 0);
     /// Start thread group anisochronously
-    void Start(void *shared_params, ExecFuncType exec, NextFuncType next = NULL,
+    INTAPI_BASE void Start(void *shared_params, ExecFuncType exec, NextFuncType next = NULL,
                              int used_tr_num = 0);
     /// Start thread group anisochronously
-    void Start(void *shared_params, void *next_shared_params, 
+    INTAPI_BASE void Start(void *shared_params, void *next_shared_params, 
                              ExecFuncType exec, NextFuncType next = NULL, int used_tr_num = 0);
     /// Start thread group anisochronously
-    void Start(void *shared_params, ExecFuncType exec, Thread1DRange *range,
+    INTAPI_BASE void Start(void *shared_params, ExecFuncType exec, Thread1DRange *range,
                              int used_tr_num = 0);
     /// Start thread group anisochronously
-    void Start(void *shared_params, ExecFuncType exec, Thread2DRange *range,
+    INTAPI_BASE void Start(void *shared_params, ExecFuncType exec, Thread2DRange *range,
                              int used_tr_num = 0);
     /// Stop thread group
-    void Stop();
+    INTAPI_BASE void Stop();
     /// Check - is thread group stopped. 
-    bool IsStopped() const;
+    INTAPI_BASE bool IsStopped() const;
     /// Wait while thread group finished all job for specified time
-    int Gathering(DWORD dwMilliseconds);
+    INTAPI_BASE int Gathering(DWORD dwMilliseconds);
     /// Wait while thread group finished all job
-    int Gathering();
+    INTAPI_BASE int Gathering();
     /// Return exception source text
-    const char *ExceptionSource() const;
+    INTAPI_BASE const char *ExceptionSource() const;
 
   private:
     /// Create threads
@@ -184,15 +184,15 @@ class Thread1DRange
       int t_index;
       };
     /// Constructor
-    Thread1DRange(int threads_num);
+    INTAPI_BASE Thread1DRange(int threads_num);
     /// Destructor
-    ~Thread1DRange();
+    INTAPI_BASE ~Thread1DRange();
     /// Set domain range
-    void Set(int begin, int end, int stp = 0, int used_tr_num = 0, int t_ind = 0);
+    INTAPI_BASE void Set(int begin, int end, int stp = 0, int used_tr_num = 0, int t_ind = 0);
     /// Get completed percentage
-    double GetDone() const;
+    INTAPI_BASE double GetDone() const;
     /// Get next subdomain job
-    bool GetNext(int thread_id);
+    INTAPI_BASE bool GetNext(int thread_id);
 
     /// Domain subdivision
     TArray<Range*> thread_ranges;
@@ -241,17 +241,17 @@ class Thread2DRange
       };
 
     /// Constructor
-    Thread2DRange(int threads_num);
+    INTAPI_BASE Thread2DRange(int threads_num);
     /// Destructor
-    ~Thread2DRange();
+    INTAPI_BASE ~Thread2DRange();
     /// Set domain range
-    void Set(int x_begin, int x_end, 
+    INTAPI_BASE void Set(int x_begin, int x_end, 
                            int y_begin, int y_end, int stepx = 0, int stepy = 0,
                            int used_tr_num = 0, int t_ind = 0);
     /// Get completed percentage
-    double GetDone() const;
+    INTAPI_BASE double GetDone() const;
     /// Get next subdomain job
-    bool GetNext(int thread_id);
+    INTAPI_BASE bool GetNext(int thread_id);
     /// Domain subdivision
     TArray<Range*> thread_ranges;
 
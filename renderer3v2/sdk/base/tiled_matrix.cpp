@@ -0,0 +1,42 @@
+/// @internal
+/// @file
+///
+/// @brief Definition of TTiledMatrix template class.
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+/**
+@class TTiledMatrix base/tiled_matrix.hpp
+
+Two-dimensional matrix stored by square tiles.
+
+TMatrix keeps the rows one after another, so the elements of a column are
+a row apart in memory: a 2D neighbourhood of a large image touches a cache
+line (and often a page) per row. TTiledMatrix keeps the matrix by tiles of
+TILE x TILE elements (8 x 8 by default, LOG_TILE = 3), each tile by rows;
+a neighbourhood of an element is a few tiles. The element access has the
+same interface as TMatrix:
+
+@code
+   TTiledMatrix<float> img(n_rows, n_cols);
+   for (int i = 1; i < n_rows - 1; i++)
+     for (int j = 0; j < n_cols; j++)
+       out(i, j) = (img(i - 1, j) + img(i, j) + img(i + 1, j)) / 3;
+@endcode
+
+The tiles are aligned to the cache line and do not share lines, so the
+threads of a tile-parallel renderer may write their tiles directly
+(Tile() gives the elements of a tile) without false sharing at the tile
+borders. The dimensions are padded to whole tiles.
+
+The rows are streamed by spans of TILE elements: GetRow() and SetRow()
+copy a row to / from a plain array (e.g. a scanline of an image file),
+Row() gives an iterator over the row. CopyFrom() and CopyTo() convert the
+matrix to / from TMatrix. ResizeBilinear() and ScaleToHalf() work as the
+TMatrix methods of the same names and fill the output tile by tile.
+
+@param T - Type of the elements, default constructible.
+@param LOG_TILE - log2 of the tile side, 3..7.
+
+@sa TMatrix, @ref base_mainpage
+**/
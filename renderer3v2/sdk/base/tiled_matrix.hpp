@@ -0,0 +1,557 @@
+/// @file
+///
+/// @brief Declaration of TTiledMatrix template class.
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+#ifndef _ELXX_TILED_MATRIX_HPP_
+#define _ELXX_TILED_MATRIX_HPP_
+
+#include <math.h>
+
+#include <math/vect2.hpp>
+
+#include "arrays.hpp"
+#include "matrix.hpp"
+
+INTEGRA_NAMESPACE_START
+
+/// Two-dimensional matrix stored by square tiles (cache-blocked layout).
+template <class T, int LOG_TILE = 3>
+class TTiledMatrix
+  {
+  public:
+    /// @name Constants
+    //@{
+    enum
+      {
+      /// Size of the tile side, in elements.
+      TILE = 1 << LOG_TILE,
+      /// Mask of the position inside the tile.
+      TILE_MASK = TILE - 1,
+      /// Number of the elements in the tile.
+      TILE_LENGTH = TILE * TILE,
+      /// Alignment of the tiles in bytes (cache line).
+      ALIGN = 64
+      };
+    //@}
+
+    /// Iterator over the elements of a row.
+    class RowIterator
+      {
+      public:
+        /// Default constructor, no initialization.
+        inline RowIterator() {}
+        /// Constructor.
+        inline RowIterator(T *p, int k) : m_p(p), m_k(k) {}
+        /// Access the current element.
+        inline T &operator *() const { return m_p[m_k]; }
+        /// Go to the next element of the row.
+        inline RowIterator &operator ++()
+          {
+          if (++m_k == TILE)
+            {
+            m_k = 0;
+            m_p += TILE_LENGTH;
+            }
+          return *this;
+          }
+      private:
+        /// Beginning of the row in the current tile.
+        T *m_p;
+        /// Position in the tile row.
+        int m_k;
+      };
+
+  public:
+    /// @name Constructors, destructor
+    //@{
+    /// Default constructor.
+    inline TTiledMatrix();
+    /// Constructor.
+    inline TTiledMatrix(int n_r, int n_c);
+    //@}
+
+  public:
+    /// @name Resizing
+    //@{
+    /// Set dimensions and (re)allocate memory, data are not retained.
+    inline OKAY Allocate(int n_r, int n_c);
+    /// Free the memory.
+    inline void Resize();
+    //@}
+
+  public:
+    /// @name Query dimensions
+    //@{
+    /// Get resolution of matrix: x - columns, y - rows.
+    inline Vect2i GetRes() const;
+    /// Get the number of rows.
+    inline int NRows() const;
+    /// Get the number of columns.
+    inline int NColumns() const;
+    /// Check - is the matrix empty - is not allocated.
+    inline bool IsEmpty() const;
+    /// Get the number of tiles: x - tile columns, y - tile rows.
+    inline Vect2i TileRes() const;
+    //@}
+
+  public:
+    /// @name Access data
+    //@{
+    /// Access the specified element.
+    inline T &operator ()(int i, int j);
+    /// Access the specified element.
+    inline const T &operator ()(int i, int j) const;
+    /// Access the specified tile.
+    inline T *Tile(int ti, int tj);
+    /// Access the specified tile.
+    inline const T *Tile(int ti, int tj) const;
+    /// Get an iterator over the row.
+    inline RowIterator Row(int i, int j0 = 0);
+    /// Copy the row to the given array.
+    inline void GetRow(int i, T *dst) const;
+    /// Set the row from the given array.
+    inline void SetRow(int i, const T *src);
+    /// Set all elements to the same value.
+    inline void Set(const T &val);
+    //@}
+
+  public:
+    /// @name Conversion
+    //@{
+    /// Copy the row-major matrix.
+    inline OKAY CopyFrom(const TMatrix<T> &src);
+    /// Copy to the row-major matrix.
+    inline OKAY CopyTo(TMatrix<T> &dst) const;
+    //@}
+
+  public:
+    /// @name Scaling
+    //@{
+    /// Create new matrix, resized with bilinear interpolation.
+    inline OKAY ResizeBilinear(int n_rows, int n_cols, TTiledMatrix &out) const;
+    /// Create new matrix, scaled to half size.
+    inline OKAY ScaleToHalf(TTiledMatrix &out) const;
+    //@}
+
+  private:
+    /// Storage of the tile, in its own cache lines.
+    struct alignas(ALIGN) TileData
+      {
+      /// Elements of the tile by rows.
+      T v[TILE_LENGTH];
+      };
+
+  private:
+    /// Offset of the element from the beginning of the storage.
+    inline SIZE_T Offset(int i, int j) const;
+    /// Pointer to the elements.
+    inline T *Elements();
+    /// Pointer to the elements.
+    inline const T *Elements() const;
+
+  private:
+    /// Tiles by tile rows.
+    TArray<TileData> m_tiles;
+    /// Number of rows.
+    int m_n_rows;
+    /// Number of columns.
+    int m_n_cols;
+    /// Number of the tiles in the tile row.
+    int m_n_tile_cols;
+  };  // class TTiledMatrix
+
+//////////////////////////////////////////////////////////////////////////////
+// Methods of the class TTiledMatrix
+
+//////////////////////////////////////////////////////////////////////////////
+/// Default constructor.
+///
+/// The method creates a matrix of zero dimensions.
+template <class T, int LOG_TILE>
+TTiledMatrix<T, LOG_TILE>::TTiledMatrix()
+  {
+  static_assert(LOG_TILE >= 3 && LOG_TILE <= 7, "TTiledMatrix: bad tile size");
+  static_assert(sizeof(TileData) == TILE_LENGTH * sizeof(T),
+                "TTiledMatrix: tiles are not contiguous");
+  m_n_rows = m_n_cols = 0;
+  m_n_tile_cols = 0;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Constructor.
+///
+/// The method creates a matrix with the specified numbers of rows and columns.
+/// All elements are initialised by the default constructor of type T.
+/// @param[in] n_r - The number of rows.
+/// @param[in] n_c - The number of columns.
+template <class T, int LOG_TILE>
+TTiledMatrix<T, LOG_TILE>::TTiledMatrix(int n_r, int n_c)
+  {
+  static_assert(LOG_TILE >= 3 && LOG_TILE <= 7, "TTiledMatrix: bad tile size");
+  m_n_rows = m_n_cols = 0;
+  m_n_tile_cols = 0;
+  Allocate(n_r, n_c);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Set dimensions and (re)allocate memory, data are not retained.
+///
+/// The dimensions are rounded up to whole tiles; the padding elements are
+/// not accessible by operator ()(), but they are passed by the tile loops.
+/// @param[in] n_r - The new number of rows.
+/// @param[in] n_c - The new number of columns.
+/// @return SUCCESS or FAILURE (allocation failure).
+template <class T, int LOG_TILE>
+OKAY TTiledMatrix<T, LOG_TILE>::Allocate(int n_r, int n_c)
+  {
+  if (n_r < 0 || n_c < 0)
+    {
+    Assert(false);
+    return FAILURE;
+    }
+  int n_tile_rows = (n_r + TILE_MASK) >> LOG_TILE;
+  int n_tile_cols = (n_c + TILE_MASK) >> LOG_TILE;
+  if (n_tile_rows > 0 && MAX_INT / n_tile_rows < n_tile_cols)
+    return User()->ErrorNoMemory((INT64)n_tile_rows * n_tile_cols * sizeof(TileData));
+  if (m_tiles.Allocate(n_tile_rows * n_tile_cols) != SUCCESS)
+    {
+    m_n_rows = m_n_cols = m_n_tile_cols = 0;
+    return FAILURE;
+    }
+  m_n_rows = n_r;
+  m_n_cols = n_c;
+  m_n_tile_cols = n_tile_cols;
+  return SUCCESS;
+  }  // Allocate()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Free the memory.
+///
+/// The matrix becomes empty.
+template <class T, int LOG_TILE>
+void TTiledMatrix<T, LOG_TILE>::Resize()
+  {
+  m_tiles.Resize(0);
+  m_n_rows = m_n_cols = m_n_tile_cols = 0;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get resolution of matrix: x - columns, y - rows.
+/// @return Resolution of the matrix.
+template <class T, int LOG_TILE>
+Vect2i TTiledMatrix<T, LOG_TILE>::GetRes() const
+  {
+  return Vect2i(m_n_cols, m_n_rows);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the number of rows.
+/// @return The number of rows.
+template <class T, int LOG_TILE>
+int TTiledMatrix<T, LOG_TILE>::NRows() const
+  {
+  return m_n_rows;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the number of columns.
+/// @return The number of columns.
+template <class T, int LOG_TILE>
+int TTiledMatrix<T, LOG_TILE>::NColumns() const
+  {
+  return m_n_cols;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Check - is the matrix empty - is not allocated.
+/// @return @b true if the matrix has no elements.
+template <class T, int LOG_TILE>
+bool TTiledMatrix<T, LOG_TILE>::IsEmpty() const
+  {
+  return m_n_rows == 0 || m_n_cols == 0;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get the number of tiles: x - tile columns, y - tile rows.
+/// @return The number of tiles covering the matrix.
+template <class T, int LOG_TILE>
+Vect2i TTiledMatrix<T, LOG_TILE>::TileRes() const
+  {
+  return Vect2i(m_n_tile_cols, (m_n_rows + TILE_MASK) >> LOG_TILE);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Access the specified element.
+/// @param[in] i - A row.
+/// @param[in] j - A column.
+/// @return A reference to the element.
+template <class T, int LOG_TILE>
+T &TTiledMatrix<T, LOG_TILE>::operator ()(int i, int j)
+  {
+  Assert(i >= 0 && i < m_n_rows && j >= 0 && j < m_n_cols);
+  return Elements()[Offset(i, j)];
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Access the specified element.
+/// @param[in] i - A row.
+/// @param[in] j - A column.
+/// @return A const reference to the element.
+template <class T, int LOG_TILE>
+const T &TTiledMatrix<T, LOG_TILE>::operator ()(int i, int j) const
+  {
+  Assert(i >= 0 && i < m_n_rows && j >= 0 && j < m_n_cols);
+  return Elements()[Offset(i, j)];
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Access the specified tile.
+///
+/// The tile keeps TILE x TILE elements by rows; element (i, j) of the matrix
+/// is element (i % TILE, j % TILE) of tile (i / TILE, j / TILE). The tiles
+/// do not share cache lines, so the threads may write different tiles
+/// without false sharing.
+/// @param[in] ti - A tile row.
+/// @param[in] tj - A tile column.
+/// @return A pointer to TILE_LENGTH elements of the tile.
+template <class T, int LOG_TILE>
+T *TTiledMatrix<T, LOG_TILE>::Tile(int ti, int tj)
+  {
+  Assert(tj >= 0 && tj < m_n_tile_cols);
+  return m_tiles[ti * m_n_tile_cols + tj].v;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Access the specified tile.
+/// @param[in] ti - A tile row.
+/// @param[in] tj - A tile column.
+/// @return A pointer to TILE_LENGTH elements of the tile.
+template <class T, int LOG_TILE>
+const T *TTiledMatrix<T, LOG_TILE>::Tile(int ti, int tj) const
+  {
+  Assert(tj >= 0 && tj < m_n_tile_cols);
+  return m_tiles[ti * m_n_tile_cols + tj].v;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Get an iterator over the row.
+///
+/// The iterator passes TILE elements of the row in a tile and jumps to the
+/// next tile; it is not checked against the end of the row.
+/// @param[in] i - A row.
+/// @param[in] j0 - The first column.
+/// @return Iterator pointing to element (i, j0).
+template <class T, int LOG_TILE>
+typename TTiledMatrix<T, LOG_TILE>::RowIterator
+TTiledMatrix<T, LOG_TILE>::Row(int i, int j0)
+  {
+  Assert(i >= 0 && i < m_n_rows && j0 >= 0 && j0 < m_n_cols);
+  return RowIterator(Elements() + Offset(i, j0 & ~TILE_MASK), j0 & TILE_MASK);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Copy the row to the given array.
+///
+/// The row is copied by spans of TILE elements.
+/// @param[in] i - A row.
+/// @param[out] dst - Array of NColumns() elements.
+template <class T, int LOG_TILE>
+void TTiledMatrix<T, LOG_TILE>::GetRow(int i, T *dst) const
+  {
+  Assert(i >= 0 && i < m_n_rows);
+  const T *src = Elements() + Offset(i, 0);
+  for (int j = 0; j < m_n_cols; j += TILE, src += TILE_LENGTH)
+    {
+    int n = Min((int)TILE, m_n_cols - j);
+    for (int k = 0; k < n; k++)
+      dst[j + k] = src[k];
+    }
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Set the row from the given array.
+/// @param[in] i - A row.
+/// @param[in] src - Array of NColumns() elements.
+template <class T, int LOG_TILE>
+void TTiledMatrix<T, LOG_TILE>::SetRow(int i, const T *src)
+  {
+  Assert(i >= 0 && i < m_n_rows);
+  T *dst = Elements() + Offset(i, 0);
+  for (int j = 0; j < m_n_cols; j += TILE, dst += TILE_LENGTH)
+    {
+    int n = Min((int)TILE, m_n_cols - j);
+    for (int k = 0; k < n; k++)
+      dst[k] = src[j + k];
+    }
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Set all elements to the same value.
+/// @param[in] val - A value; the padding elements are set too.
+template <class T, int LOG_TILE>
+void TTiledMatrix<T, LOG_TILE>::Set(const T &val)
+  {
+  T *p = Elements();
+  SIZE_T n = (SIZE_T)m_tiles.Length() * TILE_LENGTH;
+  for (SIZE_T k = 0; k < n; k++)
+    p[k] = val;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Copy the row-major matrix.
+/// @param[in] src - A source matrix.
+/// @return SUCCESS or FAILURE (allocation failure).
+template <class T, int LOG_TILE>
+OKAY TTiledMatrix<T, LOG_TILE>::CopyFrom(const TMatrix<T> &src)
+  {
+  if (Allocate(src.NRows(), src.NColumns()) != SUCCESS)
+    return FAILURE;
+  for (int i = 0; i < m_n_rows; i++)
+    SetRow(i, src.Slice(i));
+  return SUCCESS;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Copy to the row-major matrix.
+/// @param[out] dst - A destination matrix.
+/// @return SUCCESS or FAILURE (allocation failure).
+template <class T, int LOG_TILE>
+OKAY TTiledMatrix<T, LOG_TILE>::CopyTo(TMatrix<T> &dst) const
+  {
+  if (dst.Allocate(m_n_rows, m_n_cols) != SUCCESS)
+    return FAILURE;
+  for (int i = 0; i < m_n_rows; i++)
+    GetRow(i, dst.Slice(i));
+  return SUCCESS;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Create new matrix, resized with bilinear interpolation.
+///
+/// The same interpolation as TMatrix::ResizeBilinear(). The output is filled
+/// tile by tile, so the source is read by compact neighbourhoods too.
+/// @param[in] n_rows - The number of rows of the new matrix, >= 1.
+/// @param[in] n_cols - The number of columns of the new matrix, >= 1.
+/// @param[out] out - A new matrix; must not be this matrix.
+/// @return SUCCESS or FAILURE (allocation failure).
+template <class T, int LOG_TILE>
+OKAY TTiledMatrix<T, LOG_TILE>::ResizeBilinear(int n_rows, int n_cols,
+                                               TTiledMatrix &out) const
+  {
+  Assert(n_rows >= 1 && n_cols >= 1);
+  Assert(&out != this);
+  if (out.Allocate(n_rows, n_cols) != SUCCESS)
+    return FAILURE;
+  double row_scale = n_rows > 1 ? (m_n_rows - 1) / double(n_rows - 1) : 0;
+  double col_scale = n_cols > 1 ? (m_n_cols - 1) / double(n_cols - 1) : 0;
+
+  Vect2i tiles = out.TileRes();
+  for (int ti = 0; ti < tiles.y; ti++)
+    {
+    for (int tj = 0; tj < tiles.x; tj++)
+      {
+      T *dst = out.Tile(ti, tj);
+      int i1 = Min((ti + 1) << LOG_TILE, n_rows);
+      int j1 = Min((tj + 1) << LOG_TILE, n_cols);
+      for (int i = ti << LOG_TILE; i < i1; i++)
+        {
+        double row = double(i) * row_scale;
+        int r = (int)floor(row);
+        int rn = Min(r + 1, m_n_rows - 1);
+        double u = row - r;
+        T *d = dst + ((i & TILE_MASK) << LOG_TILE);
+        for (int j = tj << LOG_TILE; j < j1; j++)
+          {
+          double col = double(j) * col_scale;
+          int c = (int)floor(col);
+          int cn = Min(c + 1, m_n_cols - 1);
+          double t = col - c;
+          d[j & TILE_MASK] = (T)((*this)(r, c)   * ((1.0 - t) * (1.0 - u)) +
+                                 (*this)(r, cn)  * (       t  * (1.0 - u)) +
+                                 (*this)(rn, c)  * ((1.0 - t) *        u)  +
+                                 (*this)(rn, cn) * (       t  *        u));
+          }
+        }
+      }
+    }
+  return SUCCESS;
+  }  // ResizeBilinear()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Create new matrix, scaled to half size.
+///
+/// Each element of the new matrix is the average of 2x2 elements; an odd
+/// last row or column is dropped as in TMatrix::ScaleToHalf(). An output
+/// tile is made of 2x2 source tiles.
+/// @param[out] out - A new matrix; must not be this matrix.
+/// @return SUCCESS or FAILURE (allocation failure).
+template <class T, int LOG_TILE>
+OKAY TTiledMatrix<T, LOG_TILE>::ScaleToHalf(TTiledMatrix &out) const
+  {
+  Assert(&out != this);
+  if (out.Allocate(m_n_rows / 2, m_n_cols / 2) != SUCCESS)
+    return FAILURE;
+
+  Vect2i tiles = out.TileRes();
+  for (int ti = 0; ti < tiles.y; ti++)
+    {
+    for (int tj = 0; tj < tiles.x; tj++)
+      {
+      T *dst = out.Tile(ti, tj);
+      int i1 = Min((ti + 1) << LOG_TILE, out.m_n_rows);
+      int j1 = Min((tj + 1) << LOG_TILE, out.m_n_cols);
+      for (int i = ti << LOG_TILE; i < i1; i++)
+        {
+        T *d = dst + ((i & TILE_MASK) << LOG_TILE);
+        const T *s0 = Elements() + Offset(2 * i, 0);
+        const T *s1 = Elements() + Offset(2 * i + 1, 0);
+        for (int j = tj << LOG_TILE; j < j1; j++)
+          {
+          // Both source columns are in the same source tile
+          SIZE_T k = (SIZE_T)((2 * j) >> LOG_TILE) * TILE_LENGTH +
+                     ((2 * j) & TILE_MASK);
+          d[j & TILE_MASK] = (T)((s0[k] + s0[k + 1] + s1[k] + s1[k + 1]) * 0.25);
+          }
+        }
+      }
+    }
+  return SUCCESS;
+  }  // ScaleToHalf()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Offset of the element from the beginning of the storage.
+/// @param[in] i - A row.
+/// @param[in] j - A column.
+/// @return Index of the element in Elements().
+template <class T, int LOG_TILE>
+SIZE_T TTiledMatrix<T, LOG_TILE>::Offset(int i, int j) const
+  {
+  SIZE_T tile = (SIZE_T)(i >> LOG_TILE) * m_n_tile_cols + (j >> LOG_TILE);
+  return tile * TILE_LENGTH + ((i & TILE_MASK) << LOG_TILE) + (j & TILE_MASK);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Pointer to the elements.
+///
+/// The tiles follow each other without gaps (TILE_LENGTH * sizeof(T) is a
+/// multiple of ALIGN), so the storage is a plain array of the elements.
+/// @return A pointer to the first element of the first tile.
+template <class T, int LOG_TILE>
+T *TTiledMatrix<T, LOG_TILE>::Elements()
+  {
+  return (T *)m_tiles.Data();
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Pointer to the elements.
+/// @return A pointer to the first element of the first tile.
+template <class T, int LOG_TILE>
+const T *TTiledMatrix<T, LOG_TILE>::Elements() const
+  {
+  return (const T *)m_tiles.Data();
+  }
+
+INTEGRA_NAMESPACE_END
+#endif
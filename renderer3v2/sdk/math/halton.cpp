@@ -0,0 +1,345 @@
+/// @internal
+/// @file
+///
+/// @brief Functions of the HaltonSampler class
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+#include <integra.hpp>
+
+#include "philox.hpp"
+#include "halton.hpp"
+
+INTEGRA_NAMESPACE_START
+
+// **********************************************************
+//                  STATIC VARIABLES
+// **********************************************************
+// CONSTANTS
+
+/// Largest exactly representable integer range of double: 2^53
+static const UINT64 HALTON_MAX_RANGE = 9007199254740992ULL;
+/// Largest double below 1
+static const double HALTON_ONE_MINUS_EPS = 1.0 - 1.0 / 9007199254740992.0;
+
+
+/**
+@class HaltonSampler math/halton.hpp
+
+Multidimensional Halton low-discrepancy sequence.
+
+Coordinate @a d of the point @a i is the radical inverse of @a i in base
+of the @a d-th prime number (2, 3, 5, 7, ...), digits of @a i may be
+scrambled by permutations:
+- SCRAMBLE_NONE - plain Halton sequence;
+- SCRAMBLE_FAURE - deterministic Faure permutations, which break the
+  correlation between the dimensions with close large bases;
+- SCRAMBLE_RANDOM - random digit permutations per dimension (random XOR of
+  all bits for base 2), the seed defines the permutations.
+
+The cost of a point is negligible even for hundreds of dimensions:
+- base 2 is the bit reversal of the index;
+- for other bases the sampler keeps the digits of the current index and
+  the integer value of the radical inverse; transition to the next index
+  updates the value by the changed digits only, i.e. 1 + 1/(b - 1) digits
+  per point on average, without division;
+- digit permutations are precomputed by Init(), the same tables are used
+  by the random access method Sample().
+
+Radical inverse takes into account the digits giving the double
+precision, i.e. indices below base^n_digits (at least 2^26 for the largest
+supported base), larger indices are wrapped.
+
+Typical usage - whole block of samples of a pixel:
+@code
+HaltonSampler halton;
+if (halton.Init(n_dims, HaltonSampler::SCRAMBLE_FAURE) != SUCCESS)
+  return FAILURE;
+// n_spp points of n_dims coordinates each
+halton.Block((UINT64)pixel * n_spp, n_spp, samples);
+@endcode
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+/// Check if the number is prime.
+/// @param n - Number to check, > 1.
+/// @return true if @a n is prime.
+static bool HaltonIsPrime(int n)
+  {
+  for (int i = 2; i * i <= n; i++)
+    {
+    if (n % i == 0)
+      return false;
+    }
+  return true;
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Convert scaled radical inverse to [0, 1).
+/// @param value - Radical inverse multiplied by base^n_digits.
+/// @param scale - Inverse of base^n_digits.
+/// @return Radical inverse in [0, 1).
+static inline double HaltonUnit(UINT64 value, double scale)
+  {
+  double v = (double)value * scale;
+  return v < 1 ? v : HALTON_ONE_MINUS_EPS;
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Default constructor - empty sampler.
+///
+/// Init() has to be called before generation.
+HaltonSampler::HaltonSampler()
+  {
+  index = 0;
+  } // END OF HaltonSampler FUNCTION
+
+///////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+HaltonSampler::~HaltonSampler()
+  {
+  } // END OF ~HaltonSampler FUNCTION
+
+///////////////////////////////////////////////////////////////////////////////
+/// Prepare tables for the given number of dimensions.
+///
+/// Method computes digit permutations and weights of all dimensions and sets
+/// the index of the next point to 0.
+/// @param n_dims - Number of dimensions, 1...MAX_DIMS.
+/// @param scr - Scrambling of the digits.
+/// @param seed - Seed of the random permutations (SCRAMBLE_RANDOM only).
+/// @return SUCCESS / FAILURE (memory allocation failure).
+OKAY HaltonSampler::Init(int n_dims, Scrambling scr, unsigned seed)
+  {
+  Assert(n_dims > 0 && n_dims <= MAX_DIMS);
+  if (dims.SetLength(n_dims) != SUCCESS)
+    return FAILURE;
+
+  // Bases and sizes of the tables
+  int base = 1, n_perm = 0, n_digit = 0;
+  for (int d = 0; d < n_dims; d++)
+    {
+    do
+      base++;
+    while (!HaltonIsPrime(base));
+    DimTab &t = dims[d];
+    t.base = base;
+    UINT64 range = 1;
+    t.n_digits = 0;
+    while (range <= HALTON_MAX_RANGE / base)
+      {
+      range *= base;
+      t.n_digits++;
+      }
+    t.scale = 1.0 / (double)range;
+    t.perm = n_perm;
+    t.digit = n_digit;
+    t.mask = 0;
+    n_perm += base;
+    n_digit += t.n_digits;
+    }
+  if (perms.SetLength(n_perm) != SUCCESS ||
+      weights.SetLength(n_digit) != SUCCESS ||
+      digits.SetLength(n_digit) != SUCCESS)
+    return FAILURE;
+
+  // Permutations and weights
+  for (int d = 0; d < n_dims; d++)
+    {
+    DimTab &t = dims[d];
+    unsigned short *perm = &perms[t.perm];
+    UINT64 w = 1;
+    for (int i = t.n_digits - 1; i >= 0; i--)
+      {
+      weights[t.digit + i] = w;
+      w *= t.base;
+      }
+    switch (scr)
+      {
+      case SCRAMBLE_FAURE:
+        FaurePermutation(t.base, perm);
+        break;
+      case SCRAMBLE_RANDOM:
+        {
+        Philox rnd(seed, d);
+        for (int i = 0; i < t.base; i++)
+          perm[i] = (unsigned short)i;
+        for (int i = t.base - 1; i > 0; i--)
+          Swap(perm[i], perm[rnd.IRnd(i + 1)]);
+        t.mask = ((UINT64)rnd.URnd() << 32) | rnd.URnd();
+        break;
+        }
+      default:
+        for (int i = 0; i < t.base; i++)
+          perm[i] = (unsigned short)i;
+        break;
+      }
+    }
+  Start(0);
+  return SUCCESS;
+  } // Init()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Set index of the next point of the sequence.
+///
+/// Digits of the index are computed once, Next() updates them incrementally.
+/// @param idx - Index of the next point.
+void HaltonSampler::Start(UINT64 idx)
+  {
+  index = idx;
+  for (int d = 0; d < dims.Length(); d++)
+    {
+    DimTab &t = dims[d];
+    if (t.base != 2)
+      t.value = Inverse(t, idx, &digits[t.digit]);
+    }
+  } // Start()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Generate next point of the sequence.
+///
+/// Point with the current index is generated, the index is incremented.
+/// @param[out] point - Coordinates of the point, Dims() values in [0, 1).
+void HaltonSampler::Next(double *point)
+  {
+  const unsigned short *prm = perms.Data();
+  const UINT64 *wgt = weights.Data();
+  unsigned short *dig = digits.Data();
+  for (int d = 0; d < dims.Length(); d++)
+    {
+    DimTab &t = dims[d];
+    if (t.base == 2)
+      {
+      point[d] = RadicalInverse2(index, t.mask);
+      continue;
+      }
+    point[d] = HaltonUnit(t.value, t.scale);
+    // Increment the digits of the index, update the value by changed digits
+    // (modular arithmetic, the final value is always in range)
+    const unsigned short *perm = prm + t.perm;
+    const UINT64 *w = wgt + t.digit;
+    unsigned short *di = dig + t.digit;
+    for (int i = 0; i < t.n_digits; i++)
+      {
+      int a = di[i];
+      if (a + 1 < t.base)
+        {
+        t.value += ((UINT64)perm[a + 1] - perm[a]) * w[i];
+        di[i] = (unsigned short)(a + 1);
+        break;
+        }
+      // carry
+      t.value += ((UINT64)perm[0] - perm[a]) * w[i];
+      di[i] = 0;
+      }
+    }
+  index++;
+  } // Next()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Generate block of consecutive points.
+///
+/// Convenient for the samples of a pixel: use @a first = pixel * n_points.
+/// @param[in] first - Index of the first point.
+/// @param[in] n_points - Number of points.
+/// @param[out] out - Coordinates, n_points * Dims() values, point by point.
+void HaltonSampler::Block(UINT64 first, int n_points, double *out)
+  {
+  Assert(n_points >= 0);
+  Start(first);
+  int n_dims = dims.Length();
+  for (int i = 0; i < n_points; i++)
+    Next(out + i * n_dims);
+  } // Block()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Coordinate of the point with given index.
+///
+/// Random access, state of the sequence is not changed.
+/// @param index - Index of the point.
+/// @param dim - Index of the dimension.
+/// @return Coordinate in [0, 1).
+double HaltonSampler::Sample(UINT64 idx, int dim) const
+  {
+  const DimTab &t = dims[dim];
+  if (t.base == 2)
+    return RadicalInverse2(idx, t.mask);
+  return HaltonUnit(Inverse(t, idx, NULL), t.scale);
+  } // Sample()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Scaled radical inverse of the index and its digits.
+/// @param[in] t - Tables of the dimension.
+/// @param[in] idx - Index of the point.
+/// @param[out] dig - Digits of the index (n_digits values), may be NULL.
+/// @return Radical inverse multiplied by base^n_digits.
+UINT64 HaltonSampler::Inverse(const DimTab &t, UINT64 idx, unsigned short *dig) const
+  {
+  const unsigned short *perm = &perms[t.perm];
+  const UINT64 *w = &weights[t.digit];
+  UINT64 value = 0;
+  int i;
+  for (i = 0; i < t.n_digits && idx != 0; i++)
+    {
+    int a = (int)(idx % t.base);
+    idx /= t.base;
+    value += perm[a] * w[i];
+    if (dig != NULL)
+      dig[i] = (unsigned short)a;
+    }
+  if (i < t.n_digits)
+    {
+    // Remaining zero digits: perm[0] * (base^(n_digits - i) - 1) / (base - 1)
+    value += perm[0] * ((w[i] * t.base - 1) / (t.base - 1));
+    if (dig != NULL)
+      {
+      for ( ; i < t.n_digits; i++)
+        dig[i] = 0;
+      }
+    }
+  return value;
+  } // Inverse()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Faure permutation for the given base.
+///
+/// Recursive construction: permutation of even base b is made of the
+/// permutation p of b / 2 as 2p, 2p + 1; permutation of odd base b is made
+/// of the permutation of b - 1 by incrementing values >= (b - 1) / 2 and
+/// inserting (b - 1) / 2 in the middle. Permutation is built in place.
+/// @param[in] base - Base, >= 2.
+/// @param[out] perm - Permutation, @a base values.
+void HaltonSampler::FaurePermutation(int base, unsigned short *perm)
+  {
+  Assert(base >= 2);
+  if (base == 2)
+    {
+    perm[0] = 0;
+    perm[1] = 1;
+    return;
+    }
+  if (base % 2 == 0)
+    {
+    int h = base / 2;
+    FaurePermutation(h, perm);
+    for (int i = h - 1; i >= 0; i--)
+      {
+      perm[i + h] = (unsigned short)(2 * perm[i] + 1);
+      perm[i] = (unsigned short)(2 * perm[i]);
+      }
+    return;
+    }
+  int c = (base - 1) / 2;
+  FaurePermutation(base - 1, perm);
+  for (int i = base - 2; i >= 0; i--)
+    {
+    unsigned short v = perm[i];
+    if (v >= c)
+      v++;
+    perm[i < c ? i : i + 1] = v;
+    }
+  perm[c] = (unsigned short)c;
+  } // FaurePermutation()
+
+INTEGRA_NAMESPACE_END
@@ -0,0 +1,159 @@
+/// @file
+///
+/// @brief Multidimensional Halton low-discrepancy sampler class header file
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+#ifndef _KSML_HALTON_HPP_
+#define _KSML_HALTON_HPP_
+
+#include <base/arrays.hpp>
+
+INTEGRA_NAMESPACE_START
+
+/// Multidimensional Halton sequence with incremental digit updates.
+class HaltonSampler
+  {
+  public:
+    /// Scrambling of the digits
+    enum Scrambling
+      {
+      /// Plain radical inverse
+      SCRAMBLE_NONE = 0,
+      /// Deterministic Faure digit permutations
+      SCRAMBLE_FAURE,
+      /// Random digit permutations (random digit XOR for base 2)
+      SCRAMBLE_RANDOM
+      };
+
+    /// Limits
+    enum
+      {
+      /// Maximal number of dimensions
+      MAX_DIMS = 1024
+      };
+
+  public:
+    /// @name Constructor, destructor
+    //@{
+    /// Default constructor - empty sampler.
+    HaltonSampler();
+    /// Destructor.
+    ~HaltonSampler();
+    //@}
+
+  public:
+    /// @name Initialization
+    //@{
+    /// Prepare tables for the given number of dimensions.
+    OKAY Init(int n_dims, Scrambling scr = SCRAMBLE_NONE, unsigned seed = 0);
+    /// Number of dimensions.
+    inline int Dims() const;
+    /// Base (prime number) of the dimension.
+    inline int Base(int dim) const;
+    //@}
+
+  public:
+    /// @name Generation
+    //@{
+    /// Set index of the next point of the sequence.
+    void Start(UINT64 index);
+    /// Generate next point of the sequence.
+    void Next(double *point);
+    /// Generate block of consecutive points.
+    void Block(UINT64 first, int n_points, double *out);
+    /// Coordinate of the point with given index.
+    double Sample(UINT64 index, int dim) const;
+    /// Radical inverse in base 2 (bit reversal).
+    inline static double RadicalInverse2(UINT64 index, UINT64 mask = 0);
+    /// Reverse bit order of 64 bit word.
+    inline static UINT64 ReverseBits(UINT64 v);
+    //@}
+
+  private:
+    /// Tables of one dimension
+    struct DimTab
+      {
+      /// Base of the radical inverse
+      int base;
+      /// Number of digits taken into account (base^n_digits <= 2^53)
+      int n_digits;
+      /// Offset of the digit permutation in 'perms'
+      int perm;
+      /// Offset of the digit weights in 'weights' and digits in 'digits'
+      int digit;
+      /// Inverse of base^n_digits
+      double scale;
+      /// XOR mask of the bit reversed index for base 2
+      UINT64 mask;
+      /// Radical inverse of the current index multiplied by base^n_digits
+      UINT64 value;
+      };
+
+  private:
+    /// Faure permutation for the given base.
+    static void FaurePermutation(int base, unsigned short *perm);
+    /// Scaled radical inverse of the index and its digits.
+    UINT64 Inverse(const DimTab &t, UINT64 idx, unsigned short *dig) const;
+
+  private:
+    /// Tables of the dimensions
+    TArray<DimTab> dims;
+    /// Digit permutations of all dimensions
+    TArray<unsigned short> perms;
+    /// Weights of the digits: base^(n_digits - 1 - i)
+    TArray<UINT64> weights;
+    /// Digits of the current index, least significant first
+    TArray<unsigned short> digits;
+    /// Current index
+    UINT64 index;
+  }; // class HaltonSampler
+
+
+//////////////////////////////////////////////////////////////////////////////
+/// Number of dimensions.
+/// @return Number of dimensions given to Init().
+int HaltonSampler::Dims() const
+  {
+  return dims.Length();
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Base (prime number) of the dimension.
+/// @param dim - Index of the dimension.
+/// @return Base of the radical inverse of the dimension.
+int HaltonSampler::Base(int dim) const
+  {
+  return dims[dim].base;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Reverse bit order of 64 bit word.
+/// @param v - Word.
+/// @return Word with bit i moved to bit 63 - i.
+UINT64 HaltonSampler::ReverseBits(UINT64 v)
+  {
+  v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+  v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+  v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+  v = ((v >> 8) & 0x00FF00FF00FF00FFULL) | ((v & 0x00FF00FF00FF00FFULL) << 8);
+  v = ((v >> 16) & 0x0000FFFF0000FFFFULL) | ((v & 0x0000FFFF0000FFFFULL) << 16);
+  return (v >> 32) | (v << 32);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Radical inverse in base 2 (bit reversal).
+///
+/// Result is exactly the same as of the digit loop for indices below 2^53.
+/// @param index - Index of the point.
+/// @param mask - XOR mask of the reversed bits (random digit scrambling).
+/// @return Radical inverse in [0, 1).
+double HaltonSampler::RadicalInverse2(UINT64 index, UINT64 mask)
+  {
+  // 2^-53
+  const double INV_2_53 = 1.0 / 9007199254740992.0;
+  return (double)((ReverseBits(index) ^ mask) >> 11) * INV_2_53;
+  }
+
+INTEGRA_NAMESPACE_END
+#endif // _KSML_HALTON_HPP_
@@ -9,6 +9,8 @@
 #ifndef _KLRP_HALTONGEN2D_HPP_
 #define _KLRP_HALTONGEN2D_HPP_
 
+#include "halton.hpp"
+
 INTEGRA_NAMESPACE_START
 
 /**
@@ -88,23 +90,13 @@ void HaltonGen2D::SetLength(int span, int length)
 /// @return Quasi-random 2D vector.
 void HaltonGen2D::GetNext(double &x, double &y)
   {
+  // x random for base 2 is the bit reversal of current index
+  x = HaltonSampler::RadicalInverse2((UINT64)idx);
+  Assert(x >= 0. && x < 1.);
+
   double fraction = 1.;
   double dvalue = 0.;
-  // get current index in the sequence
   int i = idx;
-  do // and generate x random for base 2
-    {
-    dvalue += (fraction /= 2.) * (i % 2);
-    } 
-  while ((i /= 2) != 0);
-
-  Assert(i == 0);
-  Assert(dvalue >= 0. && dvalue < 1.);
-  x = dvalue - (int)dvalue;
-
-  fraction = 1.;
-  dvalue = 0.;
-  i = idx;
   do // and generate y random for base 3
     {
     dvalue += (fraction /= 3.) * (i % 3);
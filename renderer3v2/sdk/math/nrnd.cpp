@@ -56,10 +56,7 @@ int Niederreiter::instances = 0;
 /// @param iseed - seed for initialization of base Rnd class
 Niederreiter::Niederreiter(INT64 sample0, unsigned iseed) : Rnd(iseed)
   {
-  if (cj == NULL)
-    {
-    GenerateCJ();
-    }
+  AddInstance();
 
   sample = sample0;
   dindex = 0;
@@ -69,17 +66,36 @@ Niederreiter::Niederreiter(INT64 sample0, unsigned iseed) : Rnd(iseed)
     }
 
   GenerateDValue();
-  instances++;
   }
 
 ///////////////////////////////////////////////////////////////////////////////
 /// Destructor releases the all allocated buffers
 Niederreiter::~Niederreiter()
+  {
+  DelInstance();
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Generate cj tables for the first instance.
+///
+/// Tables are shared by all instances of Niederreiter and NiederreiterGray.
+void Niederreiter::AddInstance()
+  {
+  if (cj == NULL)
+    {
+    GenerateCJ();
+    }
+  instances++;
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Release cj tables with the last instance.
+void Niederreiter::DelInstance()
   {
   instances--;
   if (instances == 0)
     {
-    for (int i = 0; i < NIEDERREITER_NDMS; i++)
+    for (int i = 0; i < NIEDERREITER_NTABS; i++)
       delete [] cj[i];
     delete [] cj;
     cj = NULL;
@@ -94,8 +110,9 @@ void Niederreiter::GenerateDValue()
     dvalue = Rnd::DRnd();
   else
     {
-    INT64 gray, *cj0 = cj[dindex], irnd;
-    gray = sample ^ cache[dindex][0];
+    INT64 *cj0 = cj[dindex], irnd;
+    // unsigned: all 64 bits of the sample index are valid
+    UINT64 gray = (UINT64)(sample ^ cache[dindex][0]);
     irnd = cache[dindex][1];
     while (gray)
       {
@@ -120,10 +137,10 @@ void Niederreiter::GeneratePolynomials()
   {
   int i, n, p1, p2, l;
   int e_p1, e_p2, e_b;
-  int buffer[NIEDERREITER_NDMS];
+  int buffer[NIEDERREITER_NTABS];
 
   //  generate all polynomials to buffer
-  for (n = 1, buffer[0] = 0x2, p2 = 0, l = 4; n < NIEDERREITER_NDMS; ++n)
+  for (n = 1, buffer[0] = 0x2, p2 = 0, l = 4; n < NIEDERREITER_NTABS; ++n)
     {
     //  search for the next irreducable polynomial
     for (p1 = buffer[n - 1] + 1; ; ++p1)
@@ -162,7 +179,7 @@ void Niederreiter::GeneratePolynomials()
 
   //  convert all polynomials from buffer to polynomials table
   polynomials = new int[l];
-  for (n = 0, l = 0; n < NIEDERREITER_NDMS; ++n)
+  for (n = 0, l = 0; n < NIEDERREITER_NTABS; ++n)
     {
     //  find degree of polynomial p1
     for (p1 = buffer[n], e_p1 = 30; (p1 & (1 << e_p1)) == 0; --e_p1);
@@ -193,14 +210,14 @@ void Niederreiter::GenerateCJ()
   //  subsidiary variables
   int i, j, u, m1, ip, it;
 
-  cj = new INT64 *[NIEDERREITER_NDMS];
+  cj = new INT64 *[NIEDERREITER_NTABS];
 
   //  cycle over monic irreducible polynomials
   for (d = 0; p[0] != -1; p += e + 2)
     {
     //  allocate memory for cj array for dimention (ip + 1)
-    INT64 *cj_own = new INT64[NIEDERREITER_NBTS];
-    for (i = 0; i < NIEDERREITER_NBTS; ++i)
+    INT64 *cj_own = new INT64[NIEDERREITER_NCOLS];
+    for (i = 0; i < NIEDERREITER_NCOLS; ++i)
       {
       cj_own[i] = 0;
       }
@@ -209,8 +226,8 @@ void Niederreiter::GenerateCJ()
     for (e = 0; p[e + 1] != -1; ++e);
     //  polynomial b in the beginning is just '1'
     (b = b_arr + 1023)[m = 0] = 1;
-    //  v array needs only (NIEDERREITER_NBTS + e - 2) length
-    v = v_arr + 1023 - (NIEDERREITER_NBTS + e - 2);
+    //  v array needs only (NIEDERREITER_NCOLS + e - 2) length
+    v = v_arr + 1023 - (NIEDERREITER_NCOLS + e - 2);
 
     //  cycle over all coefficients
     for (j = NIEDERREITER_NBTS - 1, u = e; j >= 0; --j, ++u)
@@ -247,7 +264,7 @@ void Niederreiter::GenerateCJ()
           {
           v[i] = 1;
           }
-        for ( ; i <= NIEDERREITER_NBTS + e - 2; ++i)
+        for ( ; i <= NIEDERREITER_NCOLS + e - 2; ++i)
           {
           v[i] = 0;
           for (it = 1; it <= m; ++it)
@@ -258,7 +275,7 @@ void Niederreiter::GenerateCJ()
         }
 
       //  copy calculated v to cj
-      for (i = 0; i < NIEDERREITER_NBTS; ++i)
+      for (i = 0; i < NIEDERREITER_NCOLS; ++i)
         {
         cj_own[i] |= (INT64)v[i + u] << j;
         }
@@ -271,4 +288,106 @@ void Niederreiter::GenerateCJ()
   polynomials = NULL;
   }
 
+// ----------------------------------------------------
+//                 NiederreiterGray class
+// ----------------------------------------------------
+
+/**
+ * @class NiederreiterGray math/nrnd.hpp
+ *
+ * Niederreiter sequence in Gray code order, whole vectors per call.
+ *
+ * The same sequence as of the Niederreiter class, but the vector with index
+ * @a i is the Niederreiter vector with index gray(i) = i ^ (i >> 1). Gray
+ * codes of the consecutive indices differ in one bit, therefore transition
+ * to the next vector is a single XOR per dimension; the order is a
+ * permutation of every block of 2^k vectors, so low discrepancy properties
+ * are the same.
+ *
+ * All the components of the vector are generated at once (Next(), Block()),
+ * there are no virtual calls per component. Sample index has full 64 bits,
+ * number of dimensions is up to MaxDims() = 1024.
+ *
+ * Typical usage - all samples of a pixel for a path with n_dims decisions:
+ * @code
+ * NiederreiterGray qmc(n_dims);
+ * qmc.Block(first_sample, n_samples, values); // n_samples * n_dims floats
+ * @endcode
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+/// Constructor by number of dimensions and index of the first vector.
+///
+/// @param n_dims0 - number of dimensions, 1...MaxDims()
+/// @param index0 - index of the vector to start with
+NiederreiterGray::NiederreiterGray(int n_dims0, UINT64 index0)
+  {
+  Assert(n_dims0 > 0 && n_dims0 <= MaxDims());
+  Niederreiter::AddInstance();
+  n_dims = Min(Max(n_dims0, 1), MaxDims());
+  if (state.SetLength(n_dims) != SUCCESS)
+    n_dims = 0;
+  SetIndex(index0);
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Destructor releases the shared tables with the last instance
+NiederreiterGray::~NiederreiterGray()
+  {
+  Niederreiter::DelInstance();
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Set index of the next vector.
+///
+/// Vector is computed from the scratch: one XOR per set bit of the Gray code
+/// of the index per dimension.
+/// @param index0 - index of the next vector
+void NiederreiterGray::SetIndex(UINT64 index0)
+  {
+  index = index0;
+  UINT64 gray = index ^ (index >> 1);
+  for (int d = 0; d < n_dims; d++)
+    {
+    const INT64 *cj0 = Niederreiter::cj[d];
+    UINT64 irnd = 0;
+    for (UINT64 g = gray; g != 0; g >>= 1, cj0++)
+      {
+      if (g & 1)
+        irnd ^= (UINT64)*cj0;
+      }
+    state[d] = irnd;
+    }
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Generate block of consecutive vectors.
+///
+/// @param[in] first - index of the first vector
+/// @param[in] n_points - number of vectors
+/// @param[out] out - n_points * Dims() values, vector by vector
+void NiederreiterGray::Block(UINT64 first, int n_points, double *out)
+  {
+  Assert(n_points >= 0);
+  if (first != index)
+    SetIndex(first);
+  for (int i = 0; i < n_points; i++)
+    Next(out + i * n_dims);
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Generate block of consecutive vectors of float precision.
+///
+/// @param[in] first - index of the first vector
+/// @param[in] n_points - number of vectors
+/// @param[out] out - n_points * Dims() values, vector by vector
+void NiederreiterGray::Block(UINT64 first, int n_points, float *out)
+  {
+  Assert(n_points >= 0);
+  if (first != index)
+    SetIndex(first);
+  for (int i = 0; i < n_points; i++)
+    Next(out + i * n_dims);
+  }
+
 INTEGRA_NAMESPACE_END
@@ -23,12 +23,21 @@ INTEGRA_NAMESPACE_START
 /// Class for Niederreiter Random number generator
 class Niederreiter : public Rnd
   {
+  /// Gray code generator shares the cj tables
+  friend class NiederreiterGray;
+
   /// Number of bits actually used in sample
   static const int NIEDERREITER_NBTS;
 
+  /// Number of cj values per dimension (bits of the sample index)
+  static const int NIEDERREITER_NCOLS = 64;
+
   /// Number of dimensions of Niederreiter sequence (any reasonable number)
   static const int NIEDERREITER_NDMS = 26;
 
+  /// Number of dimensions with cj tables (NiederreiterGray limit)
+  static const int NIEDERREITER_NTABS = 1024;
+
   /// 1 / 2^63
   static const double NIEDERREITER_INVV;
 
@@ -38,7 +47,7 @@ class Niederreiter : public Rnd
     //@{
 
     /// Default constructor
-    Niederreiter(INT64 sample = 1, unsigned iseed = Time::Get());
+    Niederreiter(INT64 sample = 1, unsigned iseed = Rnd::DefaultSeed());
 
     /// Destructor
     ~Niederreiter();
@@ -89,6 +98,10 @@ class Niederreiter : public Rnd
     /// Cache used to accelerate computations
     INT64 cache[NIEDERREITER_NDMS][2];
 
+  /// Generate cj tables for the first instance.
+  static void AddInstance();
+  /// Release cj tables with the last instance.
+  static void DelInstance();
   /// Generate table of irreducable polynomials
   static void GeneratePolynomials();
   /// Generate cj values
@@ -101,6 +114,63 @@ class Niederreiter : public Rnd
   static int instances;
   };
 
+// ----------------------------------------------------
+//                 NiederreiterGray class
+// ----------------------------------------------------
+
+/// Niederreiter sequence in Gray code order, whole vectors per call
+class NiederreiterGray
+  {
+  public:
+
+    /// @name Constructor, destructor.
+    //@{
+
+    /// Constructor by number of dimensions and index of the first vector.
+    NiederreiterGray(int n_dims, UINT64 index = 0);
+
+    /// Destructor
+    ~NiederreiterGray();
+
+    //@}
+
+    /// @name Services.
+    //@{
+
+    /// Maximal number of dimensions.
+    inline static int MaxDims();
+    /// Number of dimensions.
+    inline int Dims() const;
+    /// Index of the next vector.
+    inline UINT64 Index() const;
+    /// Set index of the next vector.
+    void SetIndex(UINT64 index);
+    /// Generate next vector.
+    inline void Next(double *point);
+    /// Generate next vector of float precision.
+    inline void Next(float *point);
+    /// Generate block of consecutive vectors.
+    void Block(UINT64 first, int n_points, double *out);
+    /// Generate block of consecutive vectors of float precision.
+    void Block(UINT64 first, int n_points, float *out);
+
+    //@}
+
+  private:
+
+    /// Advance to the next index: one XOR per dimension.
+    inline void Advance();
+    /// Number of trailing zero bits.
+    inline static int TrailingZeros(UINT64 v);
+
+    /// Number of dimensions
+    int n_dims;
+    /// Index of the next vector
+    UINT64 index;
+    /// Integer components of the next vector (63 bits)
+    TArray<UINT64> state;
+  };
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Current quasi-random vector component - value in [0, 1).
 ///
@@ -219,5 +289,122 @@ bool Niederreiter::SetDimension(int dindex0)
   return dindex < NIEDERREITER_NDMS;
   }
 
+///////////////////////////////////////////////////////////////////////////////
+/// Maximal number of dimensions.
+///
+/// @return Number of dimensions with the Niederreiter tables.
+int NiederreiterGray::MaxDims()
+  {
+  return Niederreiter::NIEDERREITER_NTABS;
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Number of dimensions.
+///
+/// @return Number of components of the vectors.
+int NiederreiterGray::Dims() const
+  {
+  return n_dims;
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Index of the next vector.
+///
+/// @return Index of the vector to be returned by the next Next() call.
+UINT64 NiederreiterGray::Index() const
+  {
+  return index;
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Number of trailing zero bits.
+///
+/// @param v - Word, not 0.
+/// @return Index of the lowest set bit.
+int NiederreiterGray::TrailingZeros(UINT64 v)
+  {
+  Assert(v != 0);
+  int n = 0;
+  if ((v & 0xFFFFFFFF) == 0)
+    {
+    v >>= 32;
+    n += 32;
+    }
+  if ((v & 0xFFFF) == 0)
+    {
+    v >>= 16;
+    n += 16;
+    }
+  if ((v & 0xFF) == 0)
+    {
+    v >>= 8;
+    n += 8;
+    }
+  if ((v & 0xF) == 0)
+    {
+    v >>= 4;
+    n += 4;
+    }
+  if ((v & 0x3) == 0)
+    {
+    v >>= 2;
+    n += 2;
+    }
+  return n + (int)(1 - (v & 1));
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Advance to the next index: one XOR per dimension.
+///
+/// Gray codes of the consecutive indices differ in one bit - the lowest set
+/// bit of the new index, so all components are updated by the same cj column.
+void NiederreiterGray::Advance()
+  {
+  index++;
+  if (index == 0)
+    {
+    // Wrapped around 2^64: back to the first vector
+    state.Set(0);
+    return;
+    }
+  int c = TrailingZeros(index);
+  UINT64 *st = state.Data();
+  for (int d = 0; d < n_dims; d++)
+    st[d] ^= (UINT64)Niederreiter::cj[d][c];
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Generate next vector.
+///
+/// Components of the vector with current index are returned, the index
+/// is incremented.
+/// @param[out] point - Dims() components in [0, 1).
+void NiederreiterGray::Next(double *point)
+  {
+  // 2^-53
+  const double INV_2_53 = 1.0 / 9007199254740992.0;
+  const UINT64 *st = state.Data();
+  // 53 high bits of 63, so that the value is never rounded to 1
+  for (int d = 0; d < n_dims; d++)
+    point[d] = (double)(st[d] >> 10) * INV_2_53;
+  Advance();
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Generate next vector of float precision.
+///
+/// Components of the vector with current index are returned, the index
+/// is incremented.
+/// @param[out] point - Dims() components in [0, 1).
+void NiederreiterGray::Next(float *point)
+  {
+  // 2^-24
+  const float INV_2_24 = 1.0f / 16777216.0f;
+  const UINT64 *st = state.Data();
+  for (int d = 0; d < n_dims; d++)
+    point[d] = (float)(unsigned)(st[d] >> 39) * INV_2_24;
+  Advance();
+  }
+
 INTEGRA_NAMESPACE_END
 #endif
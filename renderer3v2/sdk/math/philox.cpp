@@ -0,0 +1,389 @@
+/// @internal
+/// @file
+///
+/// @brief Functions of the Philox class for calculation
+///        of the counter-based random numbers
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+#include <integra.hpp>
+
+// AVX2 kernel is compiled for x86 independently of the compiler options
+// and is called if the processor supports AVX2 (see Philox::HasAVX2())
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+/// AVX2 kernel is compiled
+#define PHILOX_AVX2
+/// Attribute of the functions with AVX2 instructions (not needed by MSVC)
+#define PHILOX_AVX2_FUNC
+#elif (defined(__GNUC__) || defined(__clang__)) && \
+      (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+/// AVX2 kernel is compiled
+#define PHILOX_AVX2
+/// Attribute of the functions with AVX2 instructions
+#define PHILOX_AVX2_FUNC __attribute__((target("avx2")))
+#endif
+
+#include "philox.hpp"
+
+INTEGRA_NAMESPACE_START
+
+// **********************************************************
+//                  STATIC VARIABLES
+// **********************************************************
+// CONSTANTS
+
+/// Multiplier of the first counter word
+static const unsigned PHILOX_M0 = 0xD2511F53;
+/// Multiplier of the third counter word
+static const unsigned PHILOX_M1 = 0xCD9E8D57;
+/// Increment of the first key word (golden ratio)
+static const unsigned PHILOX_W0 = 0x9E3779B9;
+/// Increment of the second key word (sqrt(3) - 1)
+static const unsigned PHILOX_W1 = 0xBB67AE85;
+/// Number of rounds
+static const int PHILOX_ROUNDS = 10;
+/// Number of words generated by batch conversions per step
+static const int PHILOX_CHUNK = 128;
+
+
+/**
+@class Philox math/philox.hpp
+
+Counter-based random number generator Philox4x32-10.
+
+The generator (J. Salmon et al, "Parallel random numbers: as easy as 1, 2,
+3", SC'11) is a bijection of 128 bit counter keyed by 64 bit key: block
+number @a i of the stream is computed directly from @a i without
+generation of the previous blocks. Therefore:
+- there is no serial dependency between the numbers, blocks are computed
+  in parallel by SIMD instructions (batch methods URnd(unsigned *, int),
+  DRnd(double *, int), FRnd(float *, int) use AVX2 on x86 processors
+  supporting it, see HasAVX2());
+- any stream position is reachable in constant time (SetCounter()), so the
+  stream of a pixel sample may be addressed by its coordinates;
+- the state is small, methods are not virtual and are inlined.
+
+The convenience API (DRnd(), IRnd(), Gauss(), SphrUnif()) is the same as
+of the Rnd class. Key is the seed, high half of the counter is the stream
+index, so generators with different stream indices (e.g. pixel indices)
+produce independent sequences.
+
+Sequence of the batch methods is exactly the same as the sequence of
+the corresponding single value methods.
+
+*/
+
+#ifdef PHILOX_AVX2
+// **********************************************************
+//                  LOCAL FUNCTIONS
+// **********************************************************
+
+///////////////////////////////////////////////////////////////////////////////
+/// Check the processor and OS support of AVX2.
+/// @return true if AVX2 instructions may be executed.
+static bool PhiloxCheckAVX2()
+  {
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    return false;
+  // AVX and OSXSAVE, then OS saves the YMM registers
+  __cpuid(info, 1);
+  if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+    return false;
+  if ((_xgetbv(0) & 6) != 6)
+    return false;
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  // libgcc checks the OS support of the YMM registers too
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Products of 8 pairs of 32 bit words.
+/// @param[in] a - Multiplicand words.
+/// @param[in] m - Multiplier (in all words).
+/// @param[out] hi - High halves of the products.
+/// @param[out] lo - Low halves of the products.
+PHILOX_AVX2_FUNC
+static inline void PhiloxMulHiLo(__m256i a, __m256i m, __m256i &hi, __m256i &lo)
+  {
+  __m256i even = _mm256_mul_epu32(a, m);
+  __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+  lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+  hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Generate blocks for consecutive counters by AVX2, 8 blocks at once.
+///
+/// Each 32 bit lane is a block. The blocks are the same as of Philox::Block().
+/// @param[in] key - Key, 2 words.
+/// @param[in] stream - Stream index, high half of the counter, 2 words.
+/// @param[in] counter - Counter of the first block.
+/// @param[out] out - Generated words.
+/// @param[in] n_blocks - Number of blocks requested.
+/// @return Number of blocks generated, multiple of 8 (the rest is
+/// left to the caller).
+PHILOX_AVX2_FUNC
+static int PhiloxBlocksAVX2(const unsigned key[2], const unsigned stream[2],
+                            UINT64 counter, unsigned *out, int n_blocks)
+  {
+  const __m256i m0 = _mm256_set1_epi32((int)PHILOX_M0);
+  const __m256i m1 = _mm256_set1_epi32((int)PHILOX_M1);
+  const __m256i w0 = _mm256_set1_epi32((int)PHILOX_W0);
+  const __m256i w1 = _mm256_set1_epi32((int)PHILOX_W1);
+  const int BLOCK_LEN = Philox::BLOCK_LEN;
+  int b = 0;
+  for ( ; b + 8 <= n_blocks; b += 8)
+    {
+    unsigned lanes[BLOCK_LEN][8];
+    for (int l = 0; l < 8; l++)
+      {
+      UINT64 ctr = counter + b + l;
+      lanes[0][l] = (unsigned)ctr;
+      lanes[1][l] = (unsigned)(ctr >> 32);
+      }
+    __m256i c0 = _mm256_loadu_si256((const __m256i *)lanes[0]);
+    __m256i c1 = _mm256_loadu_si256((const __m256i *)lanes[1]);
+    __m256i c2 = _mm256_set1_epi32((int)stream[0]);
+    __m256i c3 = _mm256_set1_epi32((int)stream[1]);
+    __m256i k0 = _mm256_set1_epi32((int)key[0]);
+    __m256i k1 = _mm256_set1_epi32((int)key[1]);
+    for (int r = 0; r < PHILOX_ROUNDS; r++)
+      {
+      __m256i hi0, lo0, hi1, lo1;
+      PhiloxMulHiLo(c0, m0, hi0, lo0);
+      PhiloxMulHiLo(c2, m1, hi1, lo1);
+      c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), k0);
+      c1 = lo1;
+      c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), k1);
+      c3 = lo0;
+      k0 = _mm256_add_epi32(k0, w0);
+      k1 = _mm256_add_epi32(k1, w1);
+      }
+    _mm256_storeu_si256((__m256i *)lanes[0], c0);
+    _mm256_storeu_si256((__m256i *)lanes[1], c1);
+    _mm256_storeu_si256((__m256i *)lanes[2], c2);
+    _mm256_storeu_si256((__m256i *)lanes[3], c3);
+    // lanes -> consecutive blocks
+    unsigned *dst = out + b * BLOCK_LEN;
+    for (int l = 0; l < 8; l++)
+      for (int w = 0; w < BLOCK_LEN; w++)
+        *dst++ = lanes[w][l];
+    }
+  return b;
+  } // PhiloxBlocksAVX2()
+#endif
+
+// **********************************************************
+//                  PUBLIC FUNCTIONS
+// **********************************************************
+
+///////////////////////////////////////////////////////////////////////////////
+/// Constructor by the seed and the stream index.
+///
+/// @note The seed and the stream index predetermine the @b full random
+/// sequence.
+///
+/// @param seed - Seed (key of the generator), current time by default.
+/// @param stream - Index of the stream (e.g. pixel index).
+Philox::Philox(UINT64 seed, UINT64 stream)
+  {
+  SetKey(seed, stream);
+  } // END OF Philox FUNCTION
+
+///////////////////////////////////////////////////////////////////////////////
+/// Set key: seed and stream index.
+///
+/// The counter is reset to the beginning of the stream.
+/// @param seed - Seed (key of the generator).
+/// @param stream - Index of the stream (e.g. pixel index).
+void Philox::SetKey(UINT64 seed, UINT64 the_stream)
+  {
+  key[0] = (unsigned)seed;
+  key[1] = (unsigned)(seed >> 32);
+  stream[0] = (unsigned)the_stream;
+  stream[1] = (unsigned)(the_stream >> 32);
+  gauss_prev = 0;
+  SetCounter(0);
+  } // SetKey()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Generate block of random words for the given key and counter.
+///
+/// Stateless function: Philox4x32 with 10 rounds.
+/// @param[in] key - Key, 2 words.
+/// @param[in] ctr - Counter, 4 words.
+/// @param[out] out - Generated words.
+void Philox::Block(const unsigned key[2], const unsigned ctr[BLOCK_LEN],
+                   unsigned out[BLOCK_LEN])
+  {
+  unsigned c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+  unsigned k0 = key[0], k1 = key[1];
+  for (int r = 0; r < PHILOX_ROUNDS; r++)
+    {
+    UINT64 p0 = (UINT64)PHILOX_M0 * c0;
+    UINT64 p1 = (UINT64)PHILOX_M1 * c2;
+    c0 = (unsigned)(p1 >> 32) ^ c1 ^ k0;
+    c1 = (unsigned)p1;
+    c2 = (unsigned)(p0 >> 32) ^ c3 ^ k1;
+    c3 = (unsigned)p0;
+    // bump the key
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+    }
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
+  } // Block()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Whether the batch methods use AVX2 instructions.
+///
+/// AVX2 is used on x86 processors supporting it (checked once at run time),
+/// the results are the same as of the scalar code.
+/// @return true if the AVX2 kernel is compiled and supported by the processor.
+bool Philox::HasAVX2()
+  {
+#ifdef PHILOX_AVX2
+  static const bool has_avx2 = PhiloxCheckAVX2();
+  return has_avx2;
+#else
+  return false;
+#endif
+  } // HasAVX2()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Generate blocks for consecutive counters.
+///
+/// Blocks are generated starting from the current counter, the counter is
+/// advanced. Buffer of the single value methods is not affected.
+/// @param[out] out - Generated words, n_blocks * BLOCK_LEN.
+/// @param[in] n_blocks - Number of blocks.
+void Philox::Blocks(unsigned *out, int n_blocks)
+  {
+  int b = 0;
+#ifdef PHILOX_AVX2
+  if (HasAVX2())
+    {
+    b = PhiloxBlocksAVX2(key, stream, counter, out, n_blocks);
+    counter += b;
+    }
+#endif
+  unsigned ctr[BLOCK_LEN];
+  ctr[2] = stream[0];
+  ctr[3] = stream[1];
+  for ( ; b < n_blocks; b++)
+    {
+    ctr[0] = (unsigned)counter;
+    ctr[1] = (unsigned)(counter >> 32);
+    Block(key, ctr, out + b * BLOCK_LEN);
+    counter++;
+    }
+  } // Blocks()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Fill array by pseudo-random 32 bit words.
+///
+/// The words are the same as returned by @a n calls of URnd().
+/// @param[out] out - Array to fill.
+/// @param[in] n - Number of words.
+void Philox::URnd(unsigned *out, int n)
+  {
+  Assert(n >= 0);
+  int i = 0;
+  // rest of the current block
+  while (i < n && buf_pos < BLOCK_LEN)
+    out[i++] = buf[buf_pos++];
+  // whole blocks
+  int n_blocks = (n - i) / BLOCK_LEN;
+  Blocks(out + i, n_blocks);
+  i += n_blocks * BLOCK_LEN;
+  // tail
+  while (i < n)
+    out[i++] = URnd();
+  } // URnd()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Fill array by pseudo-random numbers in segment [0, 1).
+///
+/// The numbers are the same as returned by @a n calls of DRnd().
+/// @param[out] out - Array to fill.
+/// @param[in] n - Number of values.
+void Philox::DRnd(double *out, int n)
+  {
+  // 2^-53
+  const double INV_2_53 = 1.0 / 9007199254740992.0;
+  unsigned words[PHILOX_CHUNK];
+  Assert(n >= 0);
+  for (int i = 0; i < n; )
+    {
+    int m = Min(n - i, PHILOX_CHUNK / 2);
+    URnd(words, 2 * m);
+    for (int j = 0; j < m; j++)
+      out[i + j] = ((words[2 * j] >> 5) * 67108864.0 + (words[2 * j + 1] >> 6)) * INV_2_53;
+    i += m;
+    }
+  } // DRnd()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Fill array by pseudo-random numbers in segment [0, 1) of float precision.
+///
+/// The numbers are the same as returned by @a n calls of FRnd().
+/// @param[out] out - Array to fill.
+/// @param[in] n - Number of values.
+void Philox::FRnd(float *out, int n)
+  {
+  // 2^-24
+  const float INV_2_24 = 1.0f / 16777216.0f;
+  unsigned words[PHILOX_CHUNK];
+  Assert(n >= 0);
+  for (int i = 0; i < n; )
+    {
+    int m = Min(n - i, PHILOX_CHUNK);
+    URnd(words, m);
+    for (int j = 0; j < m; j++)
+      out[i + j] = (words[j] >> 8) * INV_2_24;
+    i += m;
+    }
+  } // FRnd()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Picks normal deviate with zero mean and unit variance.
+///
+/// Polar form of the Box Miller algorithm, see Rnd::Gauss() for details.
+///
+/// @return Normal deviate.
+double Philox::Gauss()
+  {
+  double v1, v2, rsq, fac;
+
+  if (has_gauss_prev)
+    {
+    has_gauss_prev = false; // Spare deviate is exhausted
+    return gauss_prev;
+    }
+
+  do // Take two uniform deviates so that (v1, v2) is in unit circle
+    {
+    v1 = -1 + 2 * DRnd();   // uniform in [-1,1]
+    v2 = -1 + 2 * DRnd();   // uniform in [-1,1]
+    rsq = v1 * v1 + v2 * v2;
+    } while (rsq >= 1 || rsq == 0);
+
+  fac = Sqrt(-2 * Log(rsq) / rsq);
+  gauss_prev = v1 * fac;
+  has_gauss_prev = true; // Means that we HAVE an extra deviate handy!
+  return v2 * fac;
+  } // Gauss()
+
+INTEGRA_NAMESPACE_END
@@ -0,0 +1,219 @@
+/// @file
+///
+/// @brief Counter-based Philox random number generator class header file
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+#ifndef _KSML_PHILOX_HPP_
+#define _KSML_PHILOX_HPP_
+
+#include <base/base.hpp>
+
+#include "rnd.hpp"
+#include "vect2.hpp"
+
+INTEGRA_NAMESPACE_START
+
+/// Counter-based random number generator Philox4x32-10.
+class Philox
+  {
+  public:
+    /// Number of 32 bit words produced by one counter value
+    enum
+      {
+      BLOCK_LEN = 4
+      };
+
+    /// @name Constructors, destructor is default
+    //@{
+    /// Constructor by the seed and the stream index.
+    Philox(UINT64 seed = Rnd::DefaultSeed(), UINT64 stream = 0);
+    //@}
+
+    /// @name Counter and key.
+    //@{
+    /// Set counter (index of the next block in the stream).
+    inline void SetCounter(UINT64 ctr);
+    /// Get counter (index of the next block in the stream).
+    inline UINT64 Counter() const;
+    /// Set key: seed and stream index.
+    void SetKey(UINT64 seed, UINT64 stream);
+    /// Generate block of random words for the given key and counter.
+    static void Block(const unsigned key[2], const unsigned ctr[BLOCK_LEN],
+                      unsigned out[BLOCK_LEN]);
+    //@}
+
+    /// @name Services.
+    //@{
+    /// Pseudo-random 32 bit word.
+    inline unsigned URnd();
+    /// Pseudo-random number in segment [0, 1).
+    inline double DRnd();
+    /// Pseudo-random number in the arbitrary segment.
+    inline double DRnd(double a, double b);
+    /// Pseudo-random number in segment [0, 1) of float precision.
+    inline float FRnd();
+    /// Pseudo-random number in integer range [0, n - 1].
+    inline int IRnd(int n);
+    /// Picks normal deviate with zero mean and unit variance.
+    double Gauss();
+    /// @brief Pseudo-random point in the cell of the sphere with uniform
+    /// probability density.
+    inline Point2d SphrUnif(const double phi[2], const double cos_theta[2]);
+    //@}
+
+    /// @name Batch services.
+    //@{
+    /// Fill array by pseudo-random 32 bit words.
+    void URnd(unsigned *out, int n);
+    /// Fill array by pseudo-random numbers in segment [0, 1).
+    void DRnd(double *out, int n);
+    /// Fill array by pseudo-random numbers in segment [0, 1) of float precision.
+    void FRnd(float *out, int n);
+    /// Whether the batch methods use AVX2 instructions.
+    static bool HasAVX2();
+    //@}
+
+  private:
+    /// Generate next block into the buffer.
+    inline void Refill();
+    /// Generate blocks for consecutive counters.
+    void Blocks(unsigned *out, int n_blocks);
+
+  private:
+    /// Key (seed)
+    unsigned key[2];
+    /// Stream index, high half of the counter
+    unsigned stream[2];
+    /// Index of the next block in the stream
+    UINT64 counter;
+    /// Current block
+    unsigned buf[BLOCK_LEN];
+    /// Index of the next unused word in 'buf'
+    int buf_pos;
+    /// Spare normal deviate generated and rememberd by Gauss() on previous call
+    double gauss_prev;
+    /// Whether "gauss_prev" exists
+    bool has_gauss_prev;
+  }; // end class "Philox"
+
+
+///////////////////////////////////////////////////////////////////////////////
+/// Set counter (index of the next block in the stream).
+///
+/// Random access to the stream: after this call the generator returns the
+/// words of the given block, no matter what was generated before.
+/// @param ctr - Index of the block.
+void Philox::SetCounter(UINT64 ctr)
+  {
+  counter = ctr;
+  buf_pos = BLOCK_LEN;
+  has_gauss_prev = false;
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Get counter (index of the next block in the stream).
+/// @return Index of the block to be generated next.
+UINT64 Philox::Counter() const
+  {
+  return counter;
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Generate next block into the buffer.
+void Philox::Refill()
+  {
+  unsigned ctr[BLOCK_LEN];
+  ctr[0] = (unsigned)counter;
+  ctr[1] = (unsigned)(counter >> 32);
+  ctr[2] = stream[0];
+  ctr[3] = stream[1];
+  Block(key, ctr, buf);
+  counter++;
+  buf_pos = 0;
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Pseudo-random 32 bit word.
+/// @return Pseudo-random word, all bits are equiprobable.
+unsigned Philox::URnd()
+  {
+  if (buf_pos >= BLOCK_LEN)
+    Refill();
+  return buf[buf_pos++];
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Pseudo-random number in segment [0, 1).
+///
+/// Number has full double precision (53 bits), two words are used.
+/// @return Pseudo-random number in segment [0, 1).
+double Philox::DRnd()
+  {
+  // 2^-53
+  const double INV_2_53 = 1.0 / 9007199254740992.0;
+  unsigned a = URnd() >> 5;
+  unsigned b = URnd() >> 6;
+  return (a * 67108864.0 + b) * INV_2_53;
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Pseudo-random number in the arbitrary segment.
+///
+/// Method generates pseudo-random number in the segment [a, b), if a < b, and
+/// in  segment (b, a] if a > b.
+///
+/// @param  a - Begin of the segment,
+/// @param  b - End of the segment.
+/// @return Pseudo-random number in given segment.
+double Philox::DRnd(double a, double b)
+  {
+  return (a + (b - a) * DRnd());
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Pseudo-random number in segment [0, 1) of float precision.
+///
+/// Number has full float precision (24 bits), one word is used.
+/// @return Pseudo-random number in segment [0, 1).
+float Philox::FRnd()
+  {
+  // 2^-24
+  const float INV_2_24 = 1.0f / 16777216.0f;
+  return (URnd() >> 8) * INV_2_24;
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Pseudo-random number in integer range [0, n - 1].
+///
+/// @param n - Upper bound defines range: 0, 1, ... n - 1.
+///
+/// @return Pseudo-random number in range [0, n - 1].
+int Philox::IRnd(int n)
+  {
+  Assert(n > 0);
+  // scale [0, 2^32) to 0....n-1 without division
+  return (int)(((UINT64)URnd() * (unsigned)n) >> 32);
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+/// Pseudo-random point in the cell of the sphere with uniform probability
+/// density.
+///
+/// See Rnd::SphrUnif() for details.
+///
+/// @param phi - Array of two values, cell bounds in azimuth in ANY order.
+/// @param cos_theta -  Array of two values, cell bounds in polar angle
+/// (through its cosine) in @b any order.
+/// @return Pseudo - random in polar coordinates (@a phi, @a theta).
+Point2d Philox::SphrUnif(const double phi[2], const double cos_theta[2])
+  {
+  Point2d p;
+  p[0] = phi[0] + (phi[1] - phi[0]) * DRnd(); // phi
+  p[1] = cos_theta[0] + (cos_theta[1] - cos_theta[0]) * DRnd(); // cos(theta)
+  p[1] = ACos(p[1]);
+  return p;
+  }
+
+INTEGRA_NAMESPACE_END
+#endif // _KSML_PHILOX_HPP_
@@ -24,6 +24,9 @@ INTEGRA_NAMESPACE_START
 /// Number of handler fields
 static const int NUMBER_OF_HANDLER_FIELDS = 3;
 
+bool Rnd::deterministic = false;
+unsigned Rnd::det_seed = 0;
+
 
 /**
 @class Rnd math/rnd.hpp
@@ -47,6 +50,31 @@ constructor predetermines the @b full random sequence. For the prevention of
 the repeated sequence (with the same random values) generation the current 
 time is used as parameter of the constructor by the default.
 
+@section rnd_deterministic Deterministic mode
+
+Seeding from the current time makes every run different, and seeds created
+by CreateSeedsMultiRnd() are assigned to threads in creation order, so the
+result also depends on the number of threads. In deterministic mode
+(SetDeterministic()) the default seed and the seeds of CreateSeedsMultiRnd()
+are derived from the given scene seed only. Moreover the random stream of
+each pixel sample may be derived from its coordinates by counter-based
+hashing: either restart the thread generator by SetStream(pixel, sample)
+before tracing of the sample, or take stateless values by
+HashRnd(pixel, sample, dim). Then the image is bit-identical for any number
+of threads and any order of tiles.
+
+@code
+Rnd::SetDeterministic(true, scene_seed);
+...
+// in a thread
+Rnd rnd;
+for (...)  // pixel samples of the tile
+  {
+  rnd.SetStream(row * n_cols + col, sample);
+  TraceSample(rnd);
+  }
+@endcode
+
 */
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -208,17 +236,59 @@ void Rnd::CreateSeedsMultiRnd(int num, TArray<unsigned> &rnd_seeds)
   unsigned rnd_seed = Time::Get();
   for (int itd = 0; itd < num; itd++)
     {
-    do
+    if (deterministic)  // seed depends only on the scene seed and index
+      rnd_seed = StreamHash(itd, 0) & SEED_MASK;
+    else
+      rnd_seed = ((rnd_seed * Time::Get()) ^ Time::Get()) & SEED_MASK;
+    while (!IsRndSeedUnique(rnd_seed, itd, rnd_seeds))
       {
-      rnd_seed = (rnd_seed * Time::Get()) ^ Time::Get();
-      rnd_seed = rnd_seed & SEED_MASK;
+      if (deterministic)
+        rnd_seed = Hash(rnd_seed) & SEED_MASK;
+      else
+        rnd_seed = ((rnd_seed * Time::Get()) ^ Time::Get()) & SEED_MASK;
       }
-    while (!IsRndSeedUnique(rnd_seed, itd, rnd_seeds));
 
     rnd_seeds[itd] = rnd_seed;
     } 
   } // CreateSeedsMultiRnd()
 
+//////////////////////////////////////////////////////////////////////////////
+/// Switch deterministic mode on or off.
+///
+/// In deterministic mode the default seed of the generators and the seeds
+/// created by CreateSeedsMultiRnd() depend only on the given seed, and
+/// SetStream(), HashRnd() streams are decorrelated by it. Mode should be set
+/// before starting of the rendering threads.
+/// @param[in] on   true - switch deterministic mode on, false - off.
+/// @param[in] seed Seed of the deterministic mode (scene seed).
+void Rnd::SetDeterministic(bool on, unsigned seed)
+  {
+  deterministic = on;
+  det_seed = seed;
+  } // SetDeterministic()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Restart the generator with the stream of the given pixel sample.
+///
+/// Generator state is derived from the pixel sample coordinates by
+/// counter-based hashing, so the sequence of DRnd() values for the sample
+/// does not depend on which thread processes it and what was processed
+/// before.
+/// @param[in] pixel  Linear pixel index (e.g. row * n_columns + column).
+/// @param[in] sample Index of the sample in the pixel.
+void Rnd::SetStream(unsigned pixel, unsigned sample)
+  {
+  unsigned h = StreamHash(pixel, sample);
+  // Independent hash per field - seed modulo is too regular
+  m1 = Hash(h ^ 1) % (MOD1 - 1) + 1;
+  m2 = Hash(h ^ 2) % (MOD2 - 1) + 1;
+  m3 = Hash(h ^ 3) % (MOD3 - 1) + 1;
+
+  DRnd();  // actualize 'dvalue'
+  gauss_prev = 0;
+  has_gauss_prev = false;
+  } // SetStream()
+
 //////////////////////////////////////////////////////////////////////////////
 /// Checks if new random seed is unique in random seeds array.
 /// @param[in] seed Random seed.
@@ -37,7 +37,7 @@ class Rnd
     Rnd(const char *str);
     /// @brief Constructor with initializing class data fields
     /// by the given value (current time by default).
-    Rnd(unsigned iseed = Time::Get());
+    Rnd(unsigned iseed = DefaultSeed());
     /// Copy constructor.
     Rnd(const Rnd &u);
     //@}
@@ -84,6 +84,25 @@ class Rnd
     /// Create seeds for independent Rnds.
     static void CreateSeedsMultiRnd(int num, TArray<unsigned> &rnd_seeds);
 
+    /// @name Deterministic (reproducible) mode.
+    //@{
+    /// Switch deterministic mode on or off.
+    static void SetDeterministic(bool on, unsigned seed = 0);
+    /// Check whether deterministic mode is on.
+    inline static bool IsDeterministic();
+    /// Default seed: current time or seed of the deterministic mode.
+    inline static unsigned DefaultSeed();
+    /// Restart the generator with the stream of the given pixel sample.
+    void SetStream(unsigned pixel, unsigned sample);
+    /// Counter-based hash of the pixel sample coordinates.
+    inline static unsigned StreamHash(unsigned pixel, unsigned sample,
+                                      unsigned dim = 0);
+    /// Stateless pseudo-random number of the pixel sample dimension.
+    inline static double HashRnd(unsigned pixel, unsigned sample, unsigned dim);
+    /// Integer hash with good avalanche properties.
+    inline static unsigned Hash(unsigned u);
+    //@}
+
   private:
     enum
       {
@@ -113,6 +132,11 @@ class Rnd
     double gauss_prev;
     /// Whether "gauss_prev" exists
     bool   has_gauss_prev;
+
+    /// Whether deterministic mode is on
+    static bool deterministic;
+    /// Seed of the deterministic mode
+    static unsigned det_seed;
   }; // end class "Rnd"
 
 
@@ -405,6 +429,76 @@ bool Rnd::operator != (const Rnd &u) const
          (gauss_prev != u.gauss_prev) || (has_gauss_prev != u.has_gauss_prev);
   }
 
+//////////////////////////////////////////////////////////////////////////////
+/// Check whether deterministic mode is on.
+///
+/// @return true - if random streams are derived from the scene seed and
+/// pixel sample coordinates, false - if they are derived from current time.
+bool Rnd::IsDeterministic()
+  {
+  return deterministic;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Default seed: current time or seed of the deterministic mode.
+///
+/// @return Seed of the deterministic mode if it is on, current time otherwise.
+unsigned Rnd::DefaultSeed()
+  {
+  return deterministic ? det_seed : Time::Get();
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Integer hash with good avalanche properties.
+///
+/// Every input bit affects every output bit with probability about 1/2,
+/// so consecutive integers (pixel and sample indices) produce uncorrelated
+/// values. This is "lowbias32" mixer by C. Wellons.
+///
+/// @param u - Value to be hashed.
+/// @return Hashed value.
+unsigned Rnd::Hash(unsigned u)
+  {
+  u ^= u >> 16;
+  u *= 0x7feb352dU;
+  u ^= u >> 15;
+  u *= 0x846ca68bU;
+  u ^= u >> 16;
+  return u;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Counter-based hash of the pixel sample coordinates.
+///
+/// The result depends only on the arguments and on the seed of the
+/// deterministic mode, thus it is the same for any number of threads and
+/// any order of pixel processing.
+///
+/// @param pixel - Linear pixel index (e.g. row * n_columns + column).
+/// @param sample - Index of the sample in the pixel.
+/// @param dim - Index of the sample dimension.
+/// @return Hash value.
+unsigned Rnd::StreamHash(unsigned pixel, unsigned sample, unsigned dim)
+  {
+  return Hash(det_seed ^ Hash(pixel ^ Hash(sample ^ Hash(dim))));
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Stateless pseudo-random number of the pixel sample dimension.
+///
+/// The method does not change any state, so it may be called from any thread.
+///
+/// @param pixel - Linear pixel index (e.g. row * n_columns + column).
+/// @param sample - Index of the sample in the pixel.
+/// @param dim - Index of the sample dimension.
+/// @return Pseudo-random number in segment [0, 1).
+double Rnd::HashRnd(unsigned pixel, unsigned sample, unsigned dim)
+  {
+  // 2^-32
+  const double INV_2_32 = 1.0 / 4294967296.0;
+  return StreamHash(pixel, sample, dim) * INV_2_32;
+  }
+
 INTEGRA_NAMESPACE_END
 #endif // _KSML_RND_HPP_
 
@@ -0,0 +1,117 @@
+/// @internal
+/// @file
+///
+/// @brief Functions of the SobolSampler class
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+#include <integra.hpp>
+
+#include "sobol.hpp"
+
+INTEGRA_NAMESPACE_START
+
+/**
+@class SobolSampler math/sobol.hpp
+
+Owen-scrambled Sobol sampler with per-pixel decorrelation.
+
+The sampler is stateless: coordinate @a dim of the sample @a index of the
+pixel @a pixel is computed directly by Sample(), so it may be used from any
+thread without synchronization and in any order of the samples.
+
+Dimensions are grouped in pairs (padded 2D sample sets): each pair
+(2k, 2k + 1) is the 2D Sobol sequence (the first two Sobol dimensions,
+which form a (0, 2)-sequence) with
+- the sample index shuffled by the Owen scrambling seeded by the pixel and
+  the pair, so that the pairs are decorrelated from each other and the
+  pixels are decorrelated from the neighbours;
+- both coordinates Owen-scrambled by their own seeds.
+
+Any prefix of 2^k samples of the pixel stays well stratified in every
+pair, i.e. the convergence of the Sobol sequence is kept for arbitrary
+number of dimensions, while the scrambling makes the estimate unbiased.
+
+Coordinates have 32 bit precision. The same seed, pixel and index always
+give the same samples; use Rnd::DefaultSeed() to follow the deterministic
+mode of Rnd:
+@code
+SobolSampler sobol(Rnd::DefaultSeed());
+double u[2];
+sobol.Sample2D(pixel, sample, 0, u);  // e.g. pixel area
+sobol.Sample2D(pixel, sample, 1, u);  // e.g. lens
+@endcode
+
+*/
+
+///////////////////////////////////////////////////////////////////////////////
+/// Scrambled 32 bit value of the sample coordinate.
+/// @param pixel - Index of the pixel.
+/// @param index - Index of the sample in the pixel.
+/// @param dim - Dimension.
+/// @return Value as 32 bit fraction.
+unsigned SobolSampler::Bits(unsigned pixel, unsigned index, unsigned dim) const
+  {
+  unsigned pair = dim >> 1;
+  unsigned pair_seed = Rnd::Hash(seed ^ Rnd::Hash(pixel ^ Rnd::Hash(pair)));
+  // Shuffle of the sample index: Owen scrambling keeps every 2^k prefix
+  // a union of aligned blocks of the sequence, i.e. stratified
+  unsigned shuffled = OwenScramble(index, pair_seed);
+  unsigned v = SobolBits(shuffled, (int)(dim & 1));
+  return OwenScramble(v, Rnd::Hash(pair_seed + 1 + (dim & 1)));
+  } // Bits()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Coordinate of the sample - value in [0, 1).
+/// @param pixel - Index of the pixel (any unique number, e.g. y * width + x).
+/// @param index - Index of the sample in the pixel.
+/// @param dim - Dimension.
+/// @return Coordinate in [0, 1) with 32 bit precision.
+double SobolSampler::Sample(unsigned pixel, unsigned index, unsigned dim) const
+  {
+  // 2^-32
+  const double INV_2_32 = 1.0 / 4294967296.0;
+  return Bits(pixel, index, dim) * INV_2_32;
+  } // Sample()
+
+///////////////////////////////////////////////////////////////////////////////
+/// Coordinate of the sample of float precision - value in [0, 1).
+/// @param pixel - Index of the pixel (any unique number, e.g. y * width + x).
+/// @param index - Index of the sample in the pixel.
+/// @param dim - Dimension.
+/// @return Coordinate in [0, 1) with 24 bit precision.
+float SobolSampler::FSample(unsigned pixel, unsigned index, unsigned dim) const
+  {
+  // 2^-24
+  const float INV_2_24 = 1.0f / 16777216.0f;
+  return (Bits(pixel, index, dim) >> 8) * INV_2_24;
+  } // FSample()
+
+///////////////////////////////////////////////////////////////////////////////
+/// 2D sample of the pair of dimensions (2 * pair, 2 * pair + 1).
+/// @param[in] pixel - Index of the pixel.
+/// @param[in] index - Index of the sample in the pixel.
+/// @param[in] pair - Index of the pair of dimensions.
+/// @param[out] out - Two coordinates in [0, 1).
+void SobolSampler::Sample2D(unsigned pixel, unsigned index, unsigned pair,
+                            double out[2]) const
+  {
+  out[0] = Sample(pixel, index, 2 * pair);
+  out[1] = Sample(pixel, index, 2 * pair + 1);
+  } // Sample2D()
+
+///////////////////////////////////////////////////////////////////////////////
+/// All coordinates of the sample.
+/// @param[in] pixel - Index of the pixel.
+/// @param[in] index - Index of the sample in the pixel.
+/// @param[in] n_dims - Number of dimensions.
+/// @param[out] out - Coordinates of dimensions 0...n_dims - 1.
+void SobolSampler::Samples(unsigned pixel, unsigned index, int n_dims,
+                           double *out) const
+  {
+  Assert(n_dims >= 0);
+  for (int d = 0; d < n_dims; d++)
+    out[d] = Sample(pixel, index, (unsigned)d);
+  } // Samples()
+
+INTEGRA_NAMESPACE_END
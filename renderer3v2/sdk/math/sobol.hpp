@@ -0,0 +1,143 @@
+/// @file
+///
+/// @brief Owen-scrambled Sobol sampler class header file
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+
+#ifndef _KSML_SOBOL_HPP_
+#define _KSML_SOBOL_HPP_
+
+#include "rnd.hpp"
+
+INTEGRA_NAMESPACE_START
+
+/// Owen-scrambled Sobol sampler with padded 2D sample sets.
+class SobolSampler
+  {
+  public:
+    /// @name Constructor, destructor is default
+    //@{
+    /// Constructor by the seed of the scrambling.
+    inline SobolSampler(unsigned seed = 0);
+    //@}
+
+  public:
+    /// @name Sampling, stateless
+    //@{
+    /// Set the seed of the scrambling.
+    inline void SetSeed(unsigned seed);
+    /// Seed of the scrambling.
+    inline unsigned Seed() const;
+    /// Coordinate of the sample - value in [0, 1).
+    double Sample(unsigned pixel, unsigned index, unsigned dim) const;
+    /// Coordinate of the sample of float precision - value in [0, 1).
+    float FSample(unsigned pixel, unsigned index, unsigned dim) const;
+    /// 2D sample of the pair of dimensions (2 * pair, 2 * pair + 1).
+    void Sample2D(unsigned pixel, unsigned index, unsigned pair, double out[2]) const;
+    /// All coordinates of the sample.
+    void Samples(unsigned pixel, unsigned index, int n_dims, double *out) const;
+    //@}
+
+  public:
+    /// @name Building blocks
+    //@{
+    /// Unscrambled 32 bit Sobol value of the first two dimensions.
+    inline static unsigned SobolBits(unsigned index, int dim);
+    /// Nested uniform (Owen) scrambling of 32 bit fraction.
+    inline static unsigned OwenScramble(unsigned v, unsigned seed);
+    /// Reverse bit order of 32 bit word.
+    inline static unsigned ReverseBits(unsigned v);
+    //@}
+
+  private:
+    /// Scrambled 32 bit value of the sample coordinate.
+    unsigned Bits(unsigned pixel, unsigned index, unsigned dim) const;
+
+  private:
+    /// Seed of the scrambling
+    unsigned seed;
+  }; // class SobolSampler
+
+
+//////////////////////////////////////////////////////////////////////////////
+/// Constructor by the seed of the scrambling.
+/// @param the_seed - Seed, the same seed gives the same samples.
+SobolSampler::SobolSampler(unsigned the_seed)
+  {
+  seed = the_seed;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Set the seed of the scrambling.
+/// @param the_seed - Seed, the same seed gives the same samples.
+void SobolSampler::SetSeed(unsigned the_seed)
+  {
+  seed = the_seed;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Seed of the scrambling.
+/// @return Seed of the scrambling.
+unsigned SobolSampler::Seed() const
+  {
+  return seed;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Reverse bit order of 32 bit word.
+/// @param v - Word.
+/// @return Word with bit i moved to bit 31 - i.
+unsigned SobolSampler::ReverseBits(unsigned v)
+  {
+  v = ((v >> 1) & 0x55555555) | ((v & 0x55555555) << 1);
+  v = ((v >> 2) & 0x33333333) | ((v & 0x33333333) << 2);
+  v = ((v >> 4) & 0x0F0F0F0F) | ((v & 0x0F0F0F0F) << 4);
+  v = ((v >> 8) & 0x00FF00FF) | ((v & 0x00FF00FF) << 8);
+  return (v >> 16) | (v << 16);
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Unscrambled 32 bit Sobol value of the first two dimensions.
+///
+/// Dimension 0 is the radical inverse in base 2, dimension 1 is built from
+/// primitive polynomial x + 1: direction numbers v[i] = v[i-1] ^ (v[i-1] >> 1).
+/// @param index - Index of the point.
+/// @param dim - Dimension, 0 or 1.
+/// @return Value as 32 bit fraction.
+unsigned SobolSampler::SobolBits(unsigned index, int dim)
+  {
+  Assert(dim == 0 || dim == 1);
+  if (dim == 0)
+    return ReverseBits(index);
+  unsigned v = 0;
+  for (unsigned dir = 0x80000000; index != 0; index >>= 1, dir ^= dir >> 1)
+    {
+    if (index & 1)
+      v ^= dir;
+    }
+  return v;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Nested uniform (Owen) scrambling of 32 bit fraction.
+///
+/// Hash based scrambling (B. Burley, "Practical Hash-based Owen Scrambling",
+/// JCGT 2020): flip of every bit depends on the seed and the more significant
+/// bits only, so the stratification of the sequence is preserved.
+/// @param v - Value as 32 bit fraction.
+/// @param seed - Seed of the scrambling.
+/// @return Scrambled value.
+unsigned SobolSampler::OwenScramble(unsigned v, unsigned seed)
+  {
+  // Laine-Karras style permutation of the reversed bits
+  v = ReverseBits(v);
+  v ^= v * 0x3d20adea;
+  v += seed;
+  v *= (seed >> 16) | 1;
+  v ^= v * 0x05526c56;
+  v ^= v * 0x53a22864;
+  return ReverseBits(v);
+  }
+
+INTEGRA_NAMESPACE_END
+#endif // _KSML_SOBOL_HPP_
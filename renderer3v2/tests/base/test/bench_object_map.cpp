@@ -0,0 +1,133 @@
+/// @file
+///
+/// @brief Benchmark of ObjectMap against MapEnvelop.
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+///
+/// One million heap objects are added to the map in allocation order
+/// and looked up in shuffled order. Time of the addition and of the search
+/// is printed for MapEnvelop (std::map), ObjectMap and ObjectMap with
+/// Reserve(). The result is SUCCESS if all maps return the same indices.
+///
+/// Usage: bench_object_map [number_of_objects]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <integra.hpp>
+
+#include "base/map_envelop.h"
+#include "base/object_map.hpp"
+#include "base/time.hpp"
+
+using namespace Integra;
+
+/// Default number of objects
+#define N_OBJECTS 1000000
+
+/// Object of the map (size of a small scene object)
+struct BenchObj
+  {
+  /// Some data
+  double data[3];
+  };
+
+//////////////////////////////////////////////////////////////////////////////
+/// Random number for the shuffling (the same sequence on all platforms).
+/// @param[in, out] seed - State of the generator.
+/// @return Random number in [0, 2^31).
+static unsigned BenchRand(unsigned &seed)
+  {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 1) & 0x7fffffff;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Search all objects in ObjectMap.
+/// @param[in] map - Map to search in.
+/// @param[in] objs - Objects to search for.
+/// @param[in] n - Number of objects.
+/// @return Sum of the found indices.
+static INT64 FindAll(ObjectMap<BenchObj> &map, BenchObj **objs, int n)
+  {
+  INT64 sum = 0;
+  int ind;
+  for (int i = 0; i < n; i++)
+    {
+    if (map.FindObj(objs[i], &ind))
+      sum += ind;
+    }
+  return sum;
+  }
+
+//////////////////////////////////////////////////////////////////////////////
+/// Benchmark of ObjectMap.
+/// @param[in] argc - Number of arguments.
+/// @param[in] argv - Arguments: optional number of objects.
+/// @return 0 on success, 1 otherwise.
+int main(int argc, char *argv[])
+  {
+  int n = (argc > 1 ? atoi(argv[1]) : N_OBJECTS);
+  if (n <= 0)
+    n = N_OBJECTS;
+
+  BenchObj **objs = new BenchObj *[n];
+  BenchObj **shuffled = new BenchObj *[n];
+  int i;
+  for (i = 0; i < n; i++)
+    shuffled[i] = objs[i] = new BenchObj;
+  unsigned seed = 3;
+  for (i = n - 1; i > 0; i--)
+    Swap(shuffled[i], shuffled[BenchRand(seed) % (i + 1)]);
+
+  bool ok = true;
+  INT64 sum = 0;
+  int ind;
+  unsigned t_add, t_find;
+
+  // Reference: std::map behind MapEnvelop
+    {
+    Timer timer;
+    MapEnvelop map;
+    for (i = 0; i < n; i++)
+      map.AddObj(objs[i], i);
+    t_add = timer.Elapsed();
+    timer.Reset();
+    for (i = 0; i < n; i++)
+      {
+      if (map.FindObj(shuffled[i], &ind))
+        sum += ind;
+      }
+    t_find = timer.Elapsed();
+    printf("MapEnvelop:          add %6u ms, find %6u ms\n", t_add, t_find);
+    }
+  ok = ok && sum == (INT64)n * (n - 1) / 2;
+
+  // Hash table with and without preliminary Reserve()
+  for (int reserve = 0; reserve < 2; reserve++)
+    {
+    Timer timer;
+    ObjectMap<BenchObj> map;
+    if (reserve)
+      ok = ok && map.Reserve(n) == SUCCESS;
+    for (i = 0; i < n; i++)
+      map.AddObj(objs[i], i);
+    t_add = timer.Elapsed();
+    timer.Reset();
+    INT64 found = FindAll(map, shuffled, n);
+    t_find = timer.Elapsed();
+    printf("ObjectMap%s add %6u ms, find %6u ms\n",
+           reserve ? " + Reserve:" : ":          ", t_add, t_find);
+
+    BenchObj missing;
+    ok = ok && found == sum && map.Length() == n && !map.FindObj(&missing);
+    }
+
+  for (i = 0; i < n; i++)
+    delete objs[i];
+  delete [] shuffled;
+  delete [] objs;
+
+  printf("%s\n", ok ? "SUCCESS" : "FAILURE");
+  return ok ? 0 : 1;
+  }  // main()
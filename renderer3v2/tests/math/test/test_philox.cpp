@@ -0,0 +1,151 @@
+/// @file
+///
+/// @brief Test of the batch methods of Philox generator.
+///
+/// Copyright &copy; INTEGRA, Inc., 2026.
+///
+/// The batch methods URnd(unsigned *, int), DRnd(double *, int) and
+/// FRnd(float *, int) use the AVX2 kernel if the processor supports it.
+/// Their results are compared with the scalar Philox::Block() and with
+/// the single value methods, for various keys, counters (including the
+/// carry to the high word of the counter), array lengths and positions
+/// inside the current block. Known answers of Philox4x32-10 (Random123)
+/// are checked through the batch method too. Prints SUCCESS/FAILURE.
+///
+/// Usage: test_philox
+
+#include <stdio.h>
+
+#include <integra.hpp>
+
+#include "math/philox.hpp"
+
+using namespace Integra;
+
+/// Maximal number of words generated by the test
+#define MAX_WORDS 1000
+
+/// Known answer of Philox4x32-10
+struct PhiloxKat
+  {
+  /// Counter
+  unsigned ctr[Philox::BLOCK_LEN];
+  /// Key
+  unsigned key[2];
+  /// Expected block
+  unsigned out[Philox::BLOCK_LEN];
+  };
+
+/// Known answers from Random123 kat_vectors
+static const PhiloxKat KATS[] =
+  {
+    {{0x00000000, 0x00000000, 0x00000000, 0x00000000}, {0x00000000, 0x00000000},
+     {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+    {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff},
+     {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+    {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0},
+     {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}
+  };
+
+//////////////////////////////////////////////////////////////////////////////
+/// Check the batch methods against the scalar code.
+/// @param[in] seed - Seed of the generator.
+/// @param[in] stream - Stream index.
+/// @param[in] counter - Initial counter.
+/// @param[in] skip - Number of words taken by URnd() before the batch.
+/// @param[in] n - Number of words of the batch.
+/// @return true if the results are the same.
+static bool CheckBatch(UINT64 seed, UINT64 stream, UINT64 counter,
+                       int skip, int n)
+  {
+  static unsigned words[MAX_WORDS];
+  static double dvals[MAX_WORDS];
+  static float fvals[MAX_WORDS];
+  bool ok = true;
+  int i;
+
+  // Words: batch against Block()
+  Philox batch(seed, stream);
+  batch.SetCounter(counter);
+  for (i = 0; i < skip; i++)
+    batch.URnd();
+  batch.URnd(words, n);
+  unsigned key[2], ctr[Philox::BLOCK_LEN], block[Philox::BLOCK_LEN];
+  key[0] = (unsigned)seed;
+  key[1] = (unsigned)(seed >> 32);
+  ctr[2] = (unsigned)stream;
+  ctr[3] = (unsigned)(stream >> 32);
+  for (i = 0; i < n; i++)
+    {
+    int pos = skip + i;
+    UINT64 c = counter + pos / Philox::BLOCK_LEN;
+    ctr[0] = (unsigned)c;
+    ctr[1] = (unsigned)(c >> 32);
+    Philox::Block(key, ctr, block);
+    ok = ok && words[i] == block[pos % Philox::BLOCK_LEN];
+    }
+  // Stream continues after the batch as after the single calls
+  Philox single(seed, stream);
+  single.SetCounter(counter);
+  for (i = 0; i < skip + n; i++)
+    single.URnd();
+  ok = ok && batch.URnd() == single.URnd() && batch.Counter() == single.Counter();
+
+  // Doubles and floats: batch against the single calls
+  batch.SetCounter(counter);
+  single.SetCounter(counter);
+  for (i = 0; i < skip; i++)
+    {
+    batch.URnd();
+    single.URnd();
+    }
+  batch.DRnd(dvals, n);
+  for (i = 0; i < n; i++)
+    ok = ok && dvals[i] == single.DRnd();
+  batch.FRnd(fvals, n);
+  for (i = 0; i < n; i++)
+    ok = ok && fvals[i] == single.FRnd();
+  return ok;
+  }  // CheckBatch()
+
+//////////////////////////////////////////////////////////////////////////////
+/// Test of Philox batch methods.
+/// @return 0 on success, 1 otherwise.
+int main()
+  {
+  static const UINT64 SEEDS[] = {0, 1, 0x123456789ABCDEF0ULL, ~(UINT64)0};
+  static const UINT64 COUNTERS[] = {0, 5, 0xFFFFFFF0ULL, ~(UINT64)0 - 100};
+  static const int LENGTHS[] = {0, 1, 3, 4, 31, 32, 33, 64, 100, 997};
+  bool ok = true;
+
+  printf("AVX2: %s\n", Philox::HasAVX2() ? "yes" : "no");
+
+  // Known answers by the batch method (the first block of 16)
+  for (int k = 0; k < (int)(sizeof(KATS) / sizeof(KATS[0])); k++)
+    {
+    const PhiloxKat &kat = KATS[k];
+    unsigned words[16 * Philox::BLOCK_LEN];
+    Philox gen(kat.key[0] | ((UINT64)kat.key[1] << 32),
+               kat.ctr[2] | ((UINT64)kat.ctr[3] << 32));
+    gen.SetCounter(kat.ctr[0] | ((UINT64)kat.ctr[1] << 32));
+    gen.URnd(words, 16 * Philox::BLOCK_LEN);
+    for (int w = 0; w < Philox::BLOCK_LEN; w++)
+      ok = ok && words[w] == kat.out[w];
+    }
+  printf("Known answers: %s\n", ok ? "ok" : "failed");
+
+  int n_failed = 0;
+  for (int s = 0; s < (int)(sizeof(SEEDS) / sizeof(SEEDS[0])); s++)
+    for (int c = 0; c < (int)(sizeof(COUNTERS) / sizeof(COUNTERS[0])); c++)
+      for (int skip = 0; skip < Philox::BLOCK_LEN; skip++)
+        for (int l = 0; l < (int)(sizeof(LENGTHS) / sizeof(LENGTHS[0])); l++)
+          {
+          if (!CheckBatch(SEEDS[s], 7 * s + 1, COUNTERS[c], skip, LENGTHS[l]))
+            n_failed++;
+          }
+  printf("Batch against scalar: %d failed\n", n_failed);
+  ok = ok && n_failed == 0;
+
+  printf("%s\n", ok ? "SUCCESS" : "FAILURE");
+  return ok ? 0 : 1;
+  }  // main()